@@ -156,8 +156,14 @@ void ScreenManager::createReplayScreen() {
     lv_obj_set_width(dropdown_1, 120);  
     dropdown_2 = lv_dropdown_create(secondLabel_container_);
     lv_dropdown_set_options(dropdown_2, "Decoder\n"
+                                "Stream\n"
+                                "Triggered\n"
+                                "TPMS\n"
                                 "Raw only\n"
                                 "RC-Switch\n"
+                                "Decoder stats\n"
+                                "Batch decode\n"
+                                "History\n"
                              //   "ESPiLight\n"
                              //   "RTL_433\n"
                                 );
@@ -559,6 +559,21 @@ void EVENTS::btn_event_RAW_REC_run(lv_event_t* e)
         CC1101EV.enableReceiver();
         runningModule = MODULE_CC1101;
         C1101CurrentState = STATE_CODEGRABBER;   
+    } else if(strcmp(selected_text_type, "Stream") == 0) {
+        CC1101EV.setFrequency(CC1101_MHZ);
+        CC1101EV.enableReceiverStreaming();
+        runningModule = MODULE_CC1101;
+        C1101CurrentState = STATE_STREAM;
+    } else if(strcmp(selected_text_type, "Triggered") == 0) {
+        CC1101EV.setFrequency(CC1101_MHZ);
+        CC1101EV.enableReceiverTriggered();
+        runningModule = MODULE_CC1101;
+        C1101CurrentState = STATE_TRIGGERED;
+    } else if(strcmp(selected_text_type, "TPMS") == 0) {
+        CC1101EV.setFrequency(CC1101_MHZ);
+        CC1101EV.enableReceiverTpms();
+        runningModule = MODULE_CC1101;
+        C1101CurrentState = STATE_TPMS;
     } else if(strcmp(selected_text_type, "RC-Switch") == 0) {
         ////Serial.println("RCSwitch");
         CC1101EV.setFrequency(CC1101_MHZ);
@@ -570,6 +585,27 @@ void EVENTS::btn_event_RAW_REC_run(lv_event_t* e)
         CC1101EV.enableReceiver();
         runningModule = MODULE_CC1101;
         C1101CurrentState = STATE_RAWREC; 
+    } else if(strcmp(selected_text_type, "Decoder stats") == 0) {
+        // Counters since boot or the last reset; nothing is received.
+        DecodeResultView::show(CC1101EV.getDecoderMetrics());
+    } else if(strcmp(selected_text_type, "Batch decode") == 0) {
+        // Saved captures, indexed into decode_index.csv next to them.
+        const BatchStart started = CC1101EV.startBatchDecode(BATCH_DEFAULT_DIR);
+        if (started == BatchStart::Started) {
+            runningModule = MODULE_CC1101;
+            C1101CurrentState = STATE_BATCH;
+        } else if (started == BatchStart::Busy) {
+            lv_textarea_set_text(text_area, "Batch decode already running\nor a capture is being decoded.\n");
+        } else if (started == BatchStart::NoDirectory) {
+            lv_textarea_set_text(text_area, "Batch decode: cannot open\n" BATCH_DEFAULT_DIR "\n");
+        } else {
+            lv_textarea_set_text(text_area, "Batch decode: cannot write\n" BATCH_DEFAULT_DIR "/" BATCH_INDEX_FILE "\n");
+        }
+    } else if(strcmp(selected_text_type, "History") == 0) {
+        // Newest decoded events from decode_history.bin on SD.
+        if (!CC1101EV.showHistory()) {
+            lv_textarea_set_text(text_area, "History busy: a batch\nis being decoded.\n");
+        }
     }
     
     }
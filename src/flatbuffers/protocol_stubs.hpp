@@ -15,6 +15,7 @@ enum class CommandType : uint8_t {
     PING = 0,
     GET_STATUS = 1,
     RESET = 2,
+    GET_DECODER_METRICS = 42,
     // Add more as needed
 };
 
@@ -169,6 +169,10 @@ enum C1101State
   STATE_SEND_FLIPPER,
   STATE_BRUTE,
   STATE_DETECT,
+  STATE_STREAM,
+  STATE_TRIGGERED,
+  STATE_TPMS,
+  STATE_BATCH,
 };
 extern uint8_t C1101CurrentState;
 
@@ -3,6 +3,7 @@
 #include <SpareTools/HAL/Sunton/Display.h>
 #include "GUI/events.h"
 #include "modules/RF/CC1101.h"
+#include "modules/RF/FrameTimeStats.h"
 #include "modules/ETC/SDcard.h"
 #include <FFat.h>
 #include "lv_fs_if.h"
@@ -83,6 +84,9 @@ void setup() {
     if (CC1101.init()) {
         Serial.println(F("CC1101 initialized."));
         CC1101.emptyReceive();
+        Serial.printf("%u flex decoders loaded.\n", static_cast<unsigned>(CC1101.loadFlexDecoders()));
+        Serial.printf("%u known captures.\n", static_cast<unsigned>(CC1101.loadFingerprints()));
+        Serial.printf("%u events in history.\n", static_cast<unsigned>(CC1101.loadHistory()));
     } else {
         Serial.println(F("Failed to initialize CC1101."));
     }
@@ -101,22 +105,37 @@ void setup() {
  void CC1101Loop() {
     if(C1101CurrentState == STATE_ANALYZER) {
                // delay(50);
-                Serial.println(gpio_get_level(CC1101_CCGDO2A));
         if (CC1101.CheckReceived()) {
-             delay(50);
+            // The capture is analysed on the decoder worker; loop() shows
+            // the result once it is back.
             Serial.println("Received");
             CC1101.disableReceiver();
             Serial.println("Receiver disabled.");
-            delay(50);
-            Serial.println("Analyzing signal...");
-            CC1101.signalAnalyse();
-            Serial.println("Signal analyzed.");
-            CC1101.decode();
 
             C1101CurrentState = STATE_IDLE;
             runningModule = MODULE_NONE;
         }
     }
+    if(C1101CurrentState == STATE_STREAM) {
+        // Receiver stays enabled; completed blocks are decoded as they close.
+        CC1101.pollStream();
+    }
+    if(C1101CurrentState == STATE_TRIGGERED) {
+        // Receiver stays enabled; each capture is decoded when the signal drops.
+        CC1101.pollTriggered();
+    }
+    if(C1101CurrentState == STATE_TPMS) {
+        // Receiver stays enabled; the sensor table is shown as packets arrive.
+        CC1101.pollTpms();
+    }
+    if(C1101CurrentState == STATE_BATCH) {
+        // The batch decodes on its own task; this reads its files off SD,
+        // writes the index and shows its progress.
+        if (!CC1101.pollBatchDecode()) {
+            C1101CurrentState = STATE_IDLE;
+            runningModule = MODULE_NONE;
+        }
+    }
     if(C1101CurrentState == STATE_RCSWITCH) {
                // delay(50);
                // Serial.println(gpio_get_level(CC1101_CCGDO2A));
@@ -195,11 +214,19 @@ void setup() {
  auto previousMillis = esp_timer_get_time() / 1000;
  
  void loop() {
+     const uint32_t frameStart = micros();
+     const bool analysing = CC1101.decoding();
      auto const now = esp_timer_get_time() / 1000;
    lv_tick_inc(now - lv_last_tick);
    lv_last_tick = now;
    lv_timer_handler();
 
+   if (C1101CurrentState != STATE_BATCH && CC1101.getBatchProgress().running) {
+       // Left the batch screen, by its close button or another mode, so
+       // nothing polls the batch any more.
+       CC1101.cancelBatchDecode();
+   }
+
    switch (runningModule)
    {
     case MODULE_CC1101:
@@ -211,6 +238,8 @@ void setup() {
    default:
     break;
    }
+   // Decodes finished on the worker, whichever mode is running now.
+   CC1101.pollDecodeResults();
        if(updatetransmitLabel) {
         String text = "Transmitting\n Codes send: " + String(codesSend);
         lv_label_set_text(label_sub, text.c_str());        
@@ -219,7 +248,20 @@ void setup() {
   // Periodically update the NFC module.
   nfc.update();
 
-  delay(100);  // Adjust delay as needed.
+  // Capture latency is added as outcomes reach the screen, see
+  // CC1101_CLASS::recordFrameLatency().
+  FrameTimeStats& frameTimes = CC1101_CLASS::frameTimes;
+  frameTimes.add(micros() - frameStart, analysing || CC1101.decoding());
+  if (frameTimes.frames() >= FRAME_STATS_REPORT_FRAMES) {
+      char report[256];
+      frameTimes.format(report, sizeof(report));
+      Serial.println(report);
+      frameTimes.reset();
+  }
+
+  // Poll the receiver often enough that a closed frame is picked up well
+  // within the latency budget; everything else is fine at 100 ms.
+  delay(runningModule == MODULE_CC1101 ? 5 : 100);
 }
  
  bool touched() {
@@ -124,6 +124,11 @@ bool SDcard::deleteFile(const char* filePath) {
     return false;
 }
 
+// Fails if toPath exists; nothing is replaced.
+bool SDcard::renameFile(const char* fromPath, const char* toPath) {
+    return SD.rename(fromPath, toPath);
+}
+
 bool SDcard::fileExists(const char* filePath) {
     if (SD.exists(filePath)) {
         //Serial.println(F("File exists."));
@@ -218,7 +223,7 @@ lv_fs_res_t SDcard::readNextFileInDir(File32* dir, char* fn, size_t fn_len) {
         return LV_FS_RES_FS_ERR;  
     }
    
-    File32 entry = dir->openNextFile();
+    File32 entry;
       do {
         entry = dir->openNextFile(); 
         if (!entry) {
@@ -226,7 +231,7 @@ lv_fs_res_t SDcard::readNextFileInDir(File32* dir, char* fn, size_t fn_len) {
             return LV_FS_RES_OK;
         }
 
-        char name[13];  
+        char name[64];  // long names, not just 8.3
         
 
         entry.getName(name, sizeof(name)); 
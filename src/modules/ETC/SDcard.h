@@ -34,6 +34,7 @@ public:
     File32* createOrOpenFile(const char* filePath, oflag_t mode);
     bool closeFile(File32* file);
     bool deleteFile(const char* filePath);
+    bool renameFile(const char* fromPath, const char* toPath);
     bool fileExists(const char* filePath);
     size_t readFile(File32* file, void* buf, size_t bytesToRead);
     bool read_sd_card_flipper_file(String filename);
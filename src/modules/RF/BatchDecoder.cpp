@@ -0,0 +1,347 @@
+#include "BatchDecoder.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+#if defined(ARDUINO)
+#include <Arduino.h>
+#include "modules/ETC/SDcard.h"
+#else
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#endif
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+// Same framing as CC1101_CLASS::frameSegmenter, so files decode as the
+// capture they were saved from did.
+#define BATCH_GAP_MULTIPLIER FRAME_GAP_MULTIPLIER
+#define BATCH_TE_MIN_COUNT 5
+#define BATCH_FRAME_MIN_EDGES 16
+
+BatchDecoder::BatchDecoder(ProtocolRegistry& protocols, PulseHistogram& histogram)
+    : decoder(protocols, histogram, &batchMetrics),
+      binRaw(histogram),
+      segmenter(BATCH_GAP_MULTIPLIER, BATCH_TE_MIN_COUNT, BATCH_FRAME_MIN_EDGES, &histogram),
+      files(0),
+      done(0),
+      decoded(0),
+      binRawCount(0),
+      active(false),
+      cancelled(false),
+      taskDir() {}
+
+void BatchDecoder::decode(const SubFileSource& source, BatchEntry& entry) {
+    entry.pulses = source.size();
+    entry.truncated = source.wasTruncated();
+    entry.result = decoder.decode(source.data(), source.size(), segmenter);
+    entry.binRaw = BinRawSignal();
+    if (entry.result.valid()) {
+        return;
+    }
+    // No protocol knows it; the line code of its first frame that has one.
+    for (size_t i = 0; i < segmenter.size(); i++) {
+        if (binRaw.analyze(segmenter.frame(i))) {
+            entry.binRaw = binRaw.signal();
+            break;
+        }
+    }
+}
+
+BatchProgress BatchDecoder::progress() const {
+    BatchProgress now;
+    now.files = files.load(std::memory_order_relaxed);
+    now.done = done.load(std::memory_order_relaxed);
+    now.decoded = decoded.load(std::memory_order_relaxed);
+    now.binRaw = binRawCount.load(std::memory_order_relaxed);
+    now.running = running();
+    return now;
+}
+
+static void joinPath(char* out, size_t size, const char* dirPath, const char* name) {
+    const size_t length = strlen(dirPath);
+    const bool slash = length > 0 && dirPath[length - 1] == '/';
+    snprintf(out, size, "%s%s%s", dirPath, slash ? "" : "/", name);
+}
+
+// Loads one file into source; false if it holds no RAW pulses.
+bool BatchDecoder::read(const char* dirPath, const char* name, BatchEntry& entry) {
+    snprintf(entry.file, sizeof(entry.file), "%s", name);
+    char path[BATCH_PATH_SIZE];
+    joinPath(path, sizeof(path), dirPath, name);
+
+    source.clear();
+    source.setLimit(BATCH_MAX_PULSES);
+    bool loaded = false;
+#if defined(ARDUINO)
+    SDcard& sd = SDcard::getInstance();
+    File32* file = sd.createOrOpenFile(path, O_RDONLY);
+    if (file) {
+        loaded = source.load(*file);
+        sd.closeFile(file);
+    }
+#else
+    std::ifstream in(path, std::ios::binary);
+    loaded = in && source.load(in);
+#endif
+    return loaded;
+}
+
+// Loads and decodes one file, counting it.
+void BatchDecoder::load(const char* dirPath, const char* name, BatchEntry& entry) {
+    if (read(dirPath, name, entry)) {
+        decode(source, entry);
+    }
+    count(entry);
+}
+
+void BatchDecoder::count(const BatchEntry& entry) {
+    decoded.fetch_add(entry.result.valid(), std::memory_order_relaxed);
+    binRawCount.fetch_add(!entry.result.valid() && entry.binRaw.bits != 0, std::memory_order_relaxed);
+    done.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Zeroes the progress and the counters for a run over fileCount files.
+void BatchDecoder::restart(uint32_t fileCount) {
+    files = fileCount;
+    done = 0;
+    decoded = 0;
+    binRawCount = 0;
+    batchMetrics.reset();
+}
+
+#if defined(ARDUINO)
+// Counted before a run, so progress has a total to go by.
+static uint32_t countSubFiles(SDcard& sd, File32* dir) {
+    char name[BATCH_NAME_SIZE];
+    uint32_t total = 0;
+    while (sd.readNextFileInDir(dir, name, sizeof(name)) == LV_FS_RES_OK && name[0] != '\0') {
+        total += BatchDecoder::isSubFile(name);
+    }
+    dir->rewind();
+    return total;
+}
+
+bool BatchDecoder::run(const char* dirPath, const Sink& sink) {
+    SDcard& sd = SDcard::getInstance();
+    File32* dir = sd.getByPath(dirPath);
+    if (!dir) {
+        return false;
+    }
+    restart(countSubFiles(sd, dir));
+    cancelled = false;
+    active = true;
+
+    char name[BATCH_NAME_SIZE];
+    while (!cancelled && sd.readNextFileInDir(dir, name, sizeof(name)) == LV_FS_RES_OK && name[0] != '\0') {
+        if (isSubFile(name)) {
+            BatchEntry entry;
+            load(dirPath, name, entry);
+            sink(entry);
+        }
+    }
+    sd.closeFile(dir);
+    source = SubFileSource();   // hands its buffer back
+    active = false;
+    return true;
+}
+#else
+bool BatchDecoder::run(const char* dirPath, const Sink& sink) {
+    std::error_code error;
+    std::vector<std::string> names;
+    for (const auto& item : std::filesystem::directory_iterator(dirPath, error)) {
+        const std::string name = item.path().filename().string();
+        if (item.is_regular_file() && isSubFile(name.c_str())) {
+            names.push_back(name);
+        }
+    }
+    if (error) {
+        return false;
+    }
+    std::sort(names.begin(), names.end());
+    restart(static_cast<uint32_t>(names.size()));
+    cancelled = false;
+    active = true;
+    for (const std::string& name : names) {
+        if (cancelled) {
+            break;
+        }
+        BatchEntry entry;
+        load(dirPath, name.c_str(), entry);
+        sink(entry);
+    }
+    source = SubFileSource();   // hands its buffer back
+    active = false;
+    return true;
+}
+#endif
+
+// run() sees the flag between files; a batch on its task is ended here.
+void BatchDecoder::cancel() {
+    cancelled = true;
+#if defined(ESP32)
+    if (!index) {
+        return;
+    }
+    if (inFlight) {
+        // Its result would otherwise be taken for the task's end.
+        bool decodedFile = false;
+        finished.receive(decodedFile, QUEUE_WAIT_FOREVER);
+        inFlight = false;
+        count(entry);
+        writeLine(entry);
+    }
+    finish();
+#endif
+}
+
+#if defined(ESP32)
+BatchStart BatchDecoder::start(const char* dirPath) {
+    if (running()) {
+        return BatchStart::Busy;
+    }
+    SDcard& sd = SDcard::getInstance();
+    dir = sd.getByPath(dirPath);
+    if (!dir) {
+        Serial.printf("Batch decode: cannot open %s\n", dirPath);
+        return BatchStart::NoDirectory;
+    }
+    char path[BATCH_PATH_SIZE];
+    joinPath(path, sizeof(path), dirPath, BATCH_INDEX_FILE);
+    index = sd.createOrOpenFile(path, O_WRITE | O_CREAT | O_TRUNC);
+    if (!index || xTaskCreatePinnedToCore(task, "BatchDecoder", BATCH_TASK_STACK, this, BATCH_TASK_PRIORITY,
+                                          nullptr, BATCH_TASK_CORE) != pdPASS) {
+        Serial.printf("Batch decode: cannot write %s or start its task\n", path);
+        if (index) {
+            sd.closeFile(index);
+            index = nullptr;
+        }
+        sd.closeFile(dir);
+        dir = nullptr;
+        return BatchStart::NoIndex;
+    }
+    snprintf(taskDir, sizeof(taskDir), "%s", dirPath);
+    restart(countSubFiles(sd, dir));
+    inFlight = false;
+    cancelled = false;
+    active = true;
+    char line[256];
+    const int length = formatHeader(line, sizeof(line));
+    index->write(line, std::min(static_cast<size_t>(length), sizeof(line) - 1));
+    return BatchStart::Started;
+}
+
+// Decodes whatever step() hands over until it is told to end.
+void BatchDecoder::task(void* batch) {
+    BatchDecoder* self = static_cast<BatchDecoder*>(batch);
+    bool more = false;
+    while (self->work.receive(more, QUEUE_WAIT_FOREVER) && more) {
+        self->decode(self->source, self->entry);
+        self->finished.send(true, QUEUE_WAIT_FOREVER);
+    }
+    self->finished.send(false, QUEUE_WAIT_FOREVER);
+    vTaskDelete(nullptr);
+}
+
+bool BatchDecoder::step() {
+    if (!running()) {
+        return false;
+    }
+    if (inFlight) {
+        bool decodedFile = false;
+        if (!finished.receive(decodedFile)) {
+            return true;
+        }
+        inFlight = false;
+        count(entry);
+        writeLine(entry);
+    }
+    // One file per step, so the caller's other work goes on in between.
+    SDcard& sd = SDcard::getInstance();
+    char name[BATCH_NAME_SIZE];
+    while (sd.readNextFileInDir(dir, name, sizeof(name)) == LV_FS_RES_OK && name[0] != '\0') {
+        if (!isSubFile(name)) {
+            continue;
+        }
+        entry = BatchEntry();
+        if (read(taskDir, name, entry)) {
+            inFlight = true;
+            work.send(true, QUEUE_WAIT_FOREVER);
+        } else {
+            count(entry);
+            writeLine(entry);
+        }
+        return true;
+    }
+    finish();
+    return false;
+}
+
+void BatchDecoder::writeLine(const BatchEntry& entry) {
+    char line[256];
+    const int length = format(entry, line, sizeof(line));
+    if (length > 0) {
+        index->write(line, std::min(static_cast<size_t>(length), sizeof(line) - 1));
+    }
+}
+
+// Ends the task, waiting until it has, and closes the files.
+void BatchDecoder::finish() {
+    work.send(false, QUEUE_WAIT_FOREVER);
+    bool ended = false;
+    finished.receive(ended, QUEUE_WAIT_FOREVER);
+    source = SubFileSource();   // hands its buffer back
+    SDcard& sd = SDcard::getInstance();
+    sd.closeFile(index);
+    sd.closeFile(dir);
+    index = nullptr;
+    dir = nullptr;
+    active = false;
+}
+#endif
+
+int BatchDecoder::formatHeader(char* out, size_t size) {
+    return snprintf(out, size, "file,protocol,key,bits,te,confidence,frames,pulses\n");
+}
+
+// Pulses read get a + if the file held more.
+int BatchDecoder::format(const BatchEntry& entry, char* out, size_t size) {
+    const DecodeResult& result = entry.result;
+    const unsigned long pulses = static_cast<unsigned long>(entry.pulses);
+    const char* more = entry.truncated ? "+" : "";
+    if (result.valid()) {
+        return snprintf(out, size, "%s,%s,0x%llX,%u,%lu,%u,%u,%lu%s\n", entry.file, result.protocol,
+                        static_cast<unsigned long long>(result.code), result.bits,
+                        static_cast<unsigned long>(result.te), result.confidence, result.frames, pulses, more);
+    }
+    if (entry.binRaw.bits != 0) {
+        char key[2 * BINRAW_MAX_DATA_BYTES + 1] = {};
+        const size_t bytes = std::min<size_t>((entry.binRaw.bits + 7) / 8, BINRAW_MAX_DATA_BYTES);
+        for (size_t i = 0; i < bytes; i++) {
+            snprintf(key + 2 * i, sizeof(key) - 2 * i, "%02X", entry.binRaw.data[i]);
+        }
+        return snprintf(out, size, "%s,BinRAW/%s,0x%s,%u,%lu,,%u,%lu%s\n", entry.file,
+                        lineCodeName(entry.binRaw.code), key, entry.binRaw.bits,
+                        static_cast<unsigned long>(entry.binRaw.te), result.frames, pulses, more);
+    }
+    return snprintf(out, size, "%s,,,,,,%u,%lu%s\n", entry.file, result.frames, pulses, more);
+}
+
+// Directories come back from SDcard::readNextFileInDir() with a leading /.
+bool BatchDecoder::isSubFile(const char* name) {
+    const size_t length = strlen(name);
+    if (length <= 4 || name[0] == '/') {
+        return false;
+    }
+    const char* extension = name + length - 4;
+    return extension[0] == '.' && tolower(static_cast<unsigned char>(extension[1])) == 's' &&
+           tolower(static_cast<unsigned char>(extension[2])) == 'u' &&
+           tolower(static_cast<unsigned char>(extension[3])) == 'b';
+}
@@ -0,0 +1,151 @@
+#ifndef BATCH_DECODER_H
+#define BATCH_DECODER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "BinRawAnalyzer.h"
+#include "BoundedQueue.h"
+#include "CaptureDecoder.h"
+#include "DecodeResult.h"
+#include "FrameSegmenter.h"
+#include "PulseSource.h"
+
+#define BATCH_NAME_SIZE 64              // file name kept per entry, without its directory
+#define BATCH_PATH_SIZE 128             // directory plus file name
+#define BATCH_MAX_PULSES 16384          // read from one file, 64 KB; the rest is ignored
+#define BATCH_INDEX_FILE "decode_index.csv"
+#define BATCH_TASK_CORE 0               // loop() and LVGL run on core 1
+#define BATCH_TASK_STACK 12288          // decoders, the vote and BinRAW analysis
+#define BATCH_TASK_PRIORITY 1
+
+#if defined(ESP32)
+class File32;
+#endif
+
+// What the batch made of one file.
+struct BatchEntry {
+    char file[BATCH_NAME_SIZE] = {};
+    DecodeResult result;        // valid() if a protocol decoder took it
+    BinRawSignal binRaw;        // else its line code, if binRaw.bits
+    size_t pulses = 0;          // 0 if the file holds no RAW pulses
+    bool truncated = false;     // longer than BATCH_MAX_PULSES
+};
+
+// What start() made of a request for a batch.
+enum class BatchStart : uint8_t {
+    Started,
+    Busy,           // a batch, or a live decode through the same registry, is running
+    NoDirectory,    // the directory cannot be opened
+    NoIndex         // the index cannot be written next to it, or the task not started
+};
+
+// Where a run has got to.
+struct BatchProgress {
+    uint32_t files = 0;         // .sub files in the directory
+    uint32_t done = 0;          // read so far
+    uint32_t decoded = 0;       // of those, taken by a protocol decoder
+    uint32_t binRaw = 0;        // not decoded, but with a line code
+    bool running = false;
+};
+
+/**
+ * Decodes saved RAW .sub files the way live captures are decoded, for
+ * captures that were only ever replayed and for regression runs over a
+ * corpus. Every .sub file directly in a directory is read, passed through
+ * the CaptureDecoder and, if no protocol takes it, the BinRAW line code
+ * analysis; each gets a line of the CSV index.
+ *
+ * The directory is read from the SD card on the device, where start() and
+ * step() write the index next to the files, and from the file system on a
+ * host, where tools/batch_decode.cpp drives it. On the device the SD card
+ * shares its SPI bus with the radio, so the files are read and the index
+ * written by the task that calls step(); only the decoding of each file
+ * runs on a task of its own. It decodes through the registry it is given,
+ * so live decoding must not run through the same registry meanwhile, but
+ * counts what the decoders do in metrics() of its own. One SubFileSource
+ * is cleared and refilled for every file, so its buffer is only grown.
+ */
+class BatchDecoder {
+public:
+    using Sink = std::function<void(const BatchEntry& entry)>;
+
+    BatchDecoder(ProtocolRegistry& protocols, PulseHistogram& histogram);
+
+    // Decodes the pulses of one loaded file into entry; file is left alone.
+    void decode(const SubFileSource& source, BatchEntry& entry);
+
+    // Decodes every .sub file in dirPath, in directory order on the SD card
+    // and by name on a host, and hands each to sink until cancel(). Returns
+    // false if the directory could not be opened.
+    bool run(const char* dirPath, const Sink& sink);
+
+    // Ends the batch after the file being decoded, leaving the index with
+    // the files done so far; running() is false once it returns. Call from
+    // the task that runs the batch, or from sink.
+    void cancel();
+
+#if defined(ESP32)
+    // Opens dirPath and dirPath/BATCH_INDEX_FILE and starts the decoding
+    // task; anything but Started says why it did not.
+    BatchStart start(const char* dirPath);
+
+    // Writes the index line of a file once the task has decoded it and
+    // hands it the next one. Call from the task that uses the SD card;
+    // returns false once the batch is done.
+    bool step();
+#endif
+
+    BatchProgress progress() const;
+
+    bool running() const {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    // Per-decoder counters of the last run, apart from live decoding.
+    const DecoderMetrics& metrics() const {
+        return batchMetrics;
+    }
+
+    // CSV index: the header line, then one line per entry; both return the
+    // length as snprintf does.
+    static int formatHeader(char* out, size_t size);
+    static int format(const BatchEntry& entry, char* out, size_t size);
+
+    static bool isSubFile(const char* name);
+
+private:
+    bool read(const char* dirPath, const char* name, BatchEntry& entry);
+    void load(const char* dirPath, const char* name, BatchEntry& entry);
+    void count(const BatchEntry& entry);
+    void restart(uint32_t fileCount);
+#if defined(ESP32)
+    static void task(void* batch);
+    void writeLine(const BatchEntry& entry);
+    void finish();
+#endif
+
+    DecoderMetrics batchMetrics;
+    CaptureDecoder decoder;
+    BinRawAnalyzer binRaw;
+    FrameSegmenter segmenter;
+    std::atomic<uint32_t> files;
+    std::atomic<uint32_t> done;
+    std::atomic<uint32_t> decoded;
+    std::atomic<uint32_t> binRawCount;
+    std::atomic<bool> active;
+    std::atomic<bool> cancelled;
+    char taskDir[BATCH_PATH_SIZE];
+    SubFileSource source;               // file being decoded, cleared between files
+#if defined(ESP32)
+    File32* dir = nullptr;
+    File32* index = nullptr;
+    BatchEntry entry;                   // what it made of it
+    bool inFlight = false;
+    BoundedQueue<bool, 1> work;         // true: decode source, false: end the task
+    BoundedQueue<bool, 1> finished;     // source is decoded, or the task ended
+#endif
+};
+
+#endif // BATCH_DECODER_H
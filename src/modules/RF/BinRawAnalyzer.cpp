@@ -0,0 +1,312 @@
+#include "BinRawAnalyzer.h"
+#include "protocols/math.h"
+#include <cstdlib>
+#include <cstring>
+
+const char* lineCodeName(LineCode code) {
+    switch (code) {
+    case LineCode::Pwm:
+        return "PWM";
+    case LineCode::Ppm:
+        return "PPM";
+    case LineCode::Manchester:
+        return "Manchester";
+    case LineCode::Nrz:
+        return "NRZ";
+    default:
+        return "Unknown";
+    }
+}
+
+bool BinRawFrame::sameSlots(const BinRawFrame& other) const {
+    return bits == other.bits && std::memcmp(data, other.data, bytes()) == 0;
+}
+
+bool BinRawSignal::sameData(const BinRawSignal& other) const {
+    return code == other.code && bits == other.bits && std::memcmp(data, other.data, (bits + 7) / 8) == 0;
+}
+
+bool BinRawAnalyzer::analyze(PulseView frame) {
+    result = BinRawSignal();
+    const size_t clusters = histogram.build(frame);
+    uint32_t total = 0;
+    for (size_t i = 0; i < clusters; i++) {
+        total += histogram.cluster(i).count;
+    }
+    // Shortest cluster that is more than a glitch.
+    uint32_t te = 0;
+    for (size_t i = 0; i < clusters; i++) {
+        const PulseCluster& cluster = histogram.cluster(i);
+        if (cluster.count >= 2 && cluster.count * 16 >= total && (te == 0 || cluster.median < te)) {
+            te = cluster.median;
+        }
+    }
+    if (te == 0) {
+        return false;
+    }
+
+    uint64_t fitSum = 0;
+    uint32_t fitSlots = 0;
+    if (!quantize(frame, te, fitSum, fitSlots) || fitSlots == 0) {
+        return false;
+    }
+    te = static_cast<uint32_t>((fitSum + fitSlots / 2) / fitSlots);
+    if (!quantize(frame, te, fitSum, fitSlots) || !fillSlots(result.slots)) {
+        return false;
+    }
+    result.te = te;
+    classify();
+    return true;
+}
+
+bool BinRawAnalyzer::encode(PulseView frame, uint32_t te, BinRawFrame& out) {
+    uint64_t fitSum = 0;
+    uint32_t fitSlots = 0;
+    return te > 0 && quantize(frame, te, fitSum, fitSlots) && fillSlots(out);
+}
+
+size_t BinRawAnalyzer::toPulses(const BinRawFrame& frame, uint32_t te, PulseDuration* out, size_t maxOut) {
+    size_t count = 0;
+    size_t i = 0;
+    while (i < frame.bits && count < maxOut) {
+        const bool level = frame.slot(i);
+        uint32_t run = 0;
+        while (i < frame.bits && frame.slot(i) == level) {
+            run++;
+            i++;
+        }
+        const PulseDuration duration = static_cast<PulseDuration>(run * te);
+        out[count++] = level ? duration : -duration;
+    }
+    return count;
+}
+
+bool BinRawAnalyzer::quantize(PulseView frame, uint32_t te, uint64_t& fitSum, uint32_t& fitSlots) {
+    runCount = 0;
+    fitSum = 0;
+    fitSlots = 0;
+    uint32_t checked = 0;
+    uint32_t misfits = 0;
+    bool started = false;
+    for (PulseDuration pulse : frame) {
+        // The gap in front of the frame is the previous frame's.
+        if (!started && pulse <= 0) {
+            continue;
+        }
+        started = true;
+        if (runCount == sizeof(runs)) {
+            return false;
+        }
+        const uint32_t duration = static_cast<uint32_t>(pulse > 0 ? pulse : -pulse);
+        uint32_t slots = (duration + te / 2) / te;
+        if (slots <= BINRAW_MAX_RUN) {
+            checked++;
+            if (slots == 0 || DURATION_DIFF(duration, slots * te) * 100 > te * BINRAW_FIT_PERCENT) {
+                misfits++;
+                slots = slots ? slots : 1;
+            } else {
+                fitSum += duration;
+                fitSlots += slots;
+            }
+        } else if (slots > BINRAW_MAX_GAP_SLOTS) {
+            slots = BINRAW_MAX_GAP_SLOTS;
+        }
+        runs[runCount++] = static_cast<int8_t>(pulse > 0 ? slots : -static_cast<int32_t>(slots));
+    }
+    return checked > 0 && misfits * 100 <= checked * (100 - BINRAW_MIN_FIT_PERCENT);
+}
+
+bool BinRawAnalyzer::fillSlots(BinRawFrame& out) const {
+    out = BinRawFrame();
+    size_t slot = 0;
+    for (size_t i = 0; i < runCount; i++) {
+        const size_t width = static_cast<size_t>(std::abs(runs[i]));
+        if (slot + width > BINRAW_MAX_SLOT_BYTES * 8) {
+            return false;
+        }
+        if (runs[i] > 0) {
+            for (size_t s = slot; s < slot + width; s++) {
+                out.data[s / 8] |= 0x80 >> (s % 8);
+            }
+        }
+        slot += width;
+    }
+    out.bits = static_cast<uint16_t>(slot);
+    return true;
+}
+
+void BinRawAnalyzer::classify() {
+    size_t end = runCount;
+    // The gap closing the frame is no symbol.
+    if (end > 0 && runs[end - 1] < -BINRAW_MAX_RUN) {
+        end--;
+    }
+    if (end == 0) {
+        return;
+    }
+
+    size_t preamble = 1;
+    while (preamble < end && std::abs(runs[preamble]) == std::abs(runs[0])) {
+        preamble++;
+    }
+    if (preamble < BINRAW_MIN_PREAMBLE) {
+        preamble = 0;
+    }
+
+    // Data symbols are the widths making up a tenth of the rest; anything
+    // else before the first of them is sync.
+    uint16_t widths[BINRAW_MAX_GAP_SLOTS + 1] = {};
+    for (size_t i = preamble; i < end; i++) {
+        widths[std::abs(runs[i])]++;
+    }
+    size_t start = preamble;
+    while (start < end && widths[std::abs(runs[start])] * 10 < end - preamble) {
+        start++;
+    }
+    result.preamble = static_cast<uint16_t>(preamble);
+    result.sync = static_cast<uint16_t>(start - preamble);
+    if (end - start < 4) {
+        return;
+    }
+
+    if (!decodePwm(start, end) && !decodePpm(start, end) && !decodeManchester(start, end)) {
+        decodeNrz(start, end);
+    }
+}
+
+bool BinRawAnalyzer::decodePwm(size_t start, size_t end) {
+    // Pairs start on either level, so try both alignments.
+    for (size_t phase = 0; phase < 2; phase++) {
+        const size_t first = start + phase;
+        if (first + 8 > end) {
+            break;
+        }
+        const int length = std::abs(runs[first]) + std::abs(runs[first + 1]);
+        int shortWidth = BINRAW_MAX_GAP_SLOTS;
+        int longWidth = 0;
+        size_t i = first;
+        for (; i + 1 < end; i += 2) {
+            const int width = std::abs(runs[i]);
+            if (width + std::abs(runs[i + 1]) != length) {
+                break;
+            }
+            shortWidth = width < shortWidth ? width : shortWidth;
+            longWidth = width > longWidth ? width : longWidth;
+        }
+        if (i + 1 < end || shortWidth == longWidth) {
+            continue;
+        }
+
+        result.bits = 0;
+        for (i = first; i + 1 < end; i += 2) {
+            addBit(std::abs(runs[i]) == longWidth);
+        }
+        // A last pulse whose partner ran into the gap.
+        if (i < end && (std::abs(runs[i]) == shortWidth || std::abs(runs[i]) == longWidth)) {
+            addBit(std::abs(runs[i]) == longWidth);
+        }
+        result.sync += static_cast<uint16_t>(phase);
+        result.code = LineCode::Pwm;
+        return true;
+    }
+    return false;
+}
+
+bool BinRawAnalyzer::decodePpm(size_t start, size_t end) {
+    const size_t first = runs[start] > 0 ? start : start + 1;
+    if (first + 8 > end) {
+        return false;
+    }
+    const int8_t mark = runs[first];
+    int shortSpace = BINRAW_MAX_GAP_SLOTS;
+    int longSpace = 0;
+    for (size_t i = first; i < end; i++) {
+        if (runs[i] > 0 && runs[i] != mark) {
+            return false;
+        }
+        if (runs[i] < 0) {
+            shortSpace = -runs[i] < shortSpace ? -runs[i] : shortSpace;
+            longSpace = -runs[i] > longSpace ? -runs[i] : longSpace;
+        }
+    }
+    if (shortSpace == longSpace) {
+        return false;
+    }
+    for (size_t i = first; i < end; i++) {
+        if (runs[i] < 0 && -runs[i] != shortSpace && -runs[i] != longSpace) {
+            return false;
+        }
+    }
+
+    result.bits = 0;
+    for (size_t i = first; i < end; i++) {
+        if (runs[i] < 0) {
+            addBit(-runs[i] == longSpace);
+        }
+    }
+    result.sync += static_cast<uint16_t>(first - start);
+    result.code = LineCode::Ppm;
+    return true;
+}
+
+bool BinRawAnalyzer::decodeManchester(size_t start, size_t end) {
+    size_t slots = 0;
+    for (size_t i = start; i < end; i++) {
+        if (std::abs(runs[i]) > 2) {
+            return false;
+        }
+        slots += std::abs(runs[i]);
+    }
+    if (slots < 16) {
+        return false;
+    }
+
+    // A bit starts on every other slot from phase on; no double-width run
+    // may start where a bit does, or that bit would have no transition.
+    for (size_t phase = 0; phase < 2; phase++) {
+        bool aligned = true;
+        size_t slot = 0;
+        for (size_t i = start; i < end && aligned; i++) {
+            aligned = std::abs(runs[i]) == 1 || slot < phase || (slot - phase) % 2 != 0;
+            slot += std::abs(runs[i]);
+        }
+        if (!aligned) {
+            continue;
+        }
+
+        result.bits = 0;
+        slot = 0;
+        for (size_t i = start; i < end; i++) {
+            for (int s = 0; s < std::abs(runs[i]); s++, slot++) {
+                // A last high half whose low half ran into the gap still counts.
+                if (slot >= phase && (slot - phase) % 2 == 0 && (slot + 1 < slots || runs[i] > 0)) {
+                    addBit(runs[i] > 0);
+                }
+            }
+        }
+        result.sync += static_cast<uint16_t>(phase);
+        result.code = LineCode::Manchester;
+        return true;
+    }
+    return false;
+}
+
+void BinRawAnalyzer::decodeNrz(size_t start, size_t end) {
+    result.bits = 0;
+    for (size_t i = start; i < end; i++) {
+        for (int s = 0; s < std::abs(runs[i]); s++) {
+            addBit(runs[i] > 0);
+        }
+    }
+    result.code = LineCode::Nrz;
+}
+
+void BinRawAnalyzer::addBit(bool bit) {
+    if (result.bits == BINRAW_MAX_DATA_BYTES * 8) {
+        return;
+    }
+    if (bit) {
+        result.data[result.bits / 8] |= 0x80 >> (result.bits % 8);
+    }
+    result.bits++;
+}
@@ -0,0 +1,113 @@
+#ifndef BIN_RAW_ANALYZER_H
+#define BIN_RAW_ANALYZER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "PackedPulses.h"
+#include "PulseHistogram.h"
+
+#define BINRAW_MAX_SLOT_BYTES 160   // te slots kept per frame, 1280
+#define BINRAW_MAX_DATA_BYTES 32    // line-decoded bits kept per frame, 256
+#define BINRAW_MAX_RUN 8            // longest pulse, in te, that has to fit a whole multiple
+#define BINRAW_MAX_GAP_SLOTS 64     // longer pulses, the inter-frame gap, are cut to this many te
+#define BINRAW_MIN_PREAMBLE 8       // equal pulses in a row that make a preamble
+#define BINRAW_FIT_PERCENT 30       // a pulse is k te if within this share of te of it
+#define BINRAW_MIN_FIT_PERCENT 90   // share of pulses that must fit for te to be taken
+#define BINRAW_MAX_FRAMES 8         // distinct frames saved to one BinRAW file
+
+enum class LineCode : uint8_t {
+    Unknown,
+    Pwm,        // a bit per pulse pair of constant length, 1 when its first pulse is the long one
+    Ppm,        // constant marks, a bit per space, 1 for the long one
+    Manchester, // two te per bit, high-low for 1
+    Nrz         // a bit per te, its level
+};
+
+const char* lineCodeName(LineCode code);
+
+// One frame as te slots, the first in the top bit of data[0]: 1 for one te
+// high, 0 for one te low. A Bit_RAW/Data_RAW pair of a Flipper BinRAW file.
+struct BinRawFrame {
+    uint16_t bits = 0;
+    uint8_t data[BINRAW_MAX_SLOT_BYTES] = {};
+
+    bool slot(size_t i) const {
+        return data[i / 8] >> (7 - i % 8) & 1;
+    }
+
+    size_t bytes() const {
+        return (bits + 7) / 8;
+    }
+
+    bool sameSlots(const BinRawFrame& other) const;
+};
+
+// What the line code makes of a frame: preamble pulses, sync pulses, then
+// the data bits, first in the top bit of data[0].
+struct BinRawSignal {
+    uint32_t te = 0;
+    LineCode code = LineCode::Unknown;
+    uint16_t preamble = 0;  // leading run of equal pulses, 0 if shorter than BINRAW_MIN_PREAMBLE
+    uint16_t sync = 0;      // pulses between preamble and data
+    uint16_t bits = 0;
+    uint8_t data[BINRAW_MAX_DATA_BYTES] = {};
+    BinRawFrame slots;
+
+    bool bit(size_t i) const {
+        return data[i / 8] >> (7 - i % 8) & 1;
+    }
+
+    bool sameData(const BinRawSignal& other) const;
+};
+
+/**
+ * Makes sense of a frame no protocol decoder took, BinRAW style.
+ *
+ * te is the shortest well-populated cluster on the pulse histogram, refined
+ * to the mean over every pulse of up to BINRAW_MAX_RUN te that fits a whole
+ * multiple of it; the frame is rejected if too few do. The pulses from the
+ * first high on then become te slots, which is all a replay needs, and the
+ * slots are split into a preamble, a sync and data in the first line code
+ * that explains all of the data: PWM, PPM, Manchester, else NRZ.
+ */
+class BinRawAnalyzer {
+public:
+    explicit BinRawAnalyzer(PulseHistogram& histogram) : histogram(histogram), runCount(0) {}
+
+    // Returns false if the pulses are no whole multiples of one te, or the
+    // frame is longer than BINRAW_MAX_SLOT_BYTES holds.
+    bool analyze(PulseView frame);
+
+    // Slots of frame at a te found before, e.g. for the other frames of the
+    // capture. Returns false as analyze() does.
+    bool encode(PulseView frame, uint32_t te, BinRawFrame& out);
+
+    const BinRawSignal& signal() const {
+        return result;
+    }
+
+    // Pulses of frame replayed at te, merged per run of equal slots.
+    // Returns how many were written to out.
+    static size_t toPulses(const BinRawFrame& frame, uint32_t te, PulseDuration* out, size_t maxOut);
+
+private:
+    // Fills runs with the pulses of frame in te, signed by level, and
+    // returns false if too few fit. fitSum and fitSlots add up the pulses
+    // that were checked.
+    bool quantize(PulseView frame, uint32_t te, uint64_t& fitSum, uint32_t& fitSlots);
+    bool fillSlots(BinRawFrame& out) const;
+
+    void classify();
+    bool decodePwm(size_t start, size_t end);
+    bool decodePpm(size_t start, size_t end);
+    bool decodeManchester(size_t start, size_t end);
+    void decodeNrz(size_t start, size_t end);
+    void addBit(bool bit);
+
+    PulseHistogram& histogram;
+    int8_t runs[BINRAW_MAX_SLOT_BYTES * 8];
+    size_t runCount;
+    BinRawSignal result;
+};
+
+#endif // BIN_RAW_ANALYZER_H
@@ -0,0 +1,107 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#else
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#define QUEUE_WAIT_FOREVER UINT32_MAX   // waitMs that blocks until it succeeds
+
+/**
+ * Fixed-depth queue of items copied by value, for handing work between
+ * tasks. On the ESP32 it is a FreeRTOS queue on static storage, so it never
+ * touches the heap; on a host the same interface sits on a mutex, which lets
+ * the tests run both ends in threads. send() and receive() wait up to
+ * waitMs, 0 meaning not at all.
+ */
+template <typename T, size_t Depth>
+class BoundedQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "queue items are copied as bytes");
+    static_assert(Depth > 0, "BoundedQueue needs storage");
+
+public:
+#if defined(ESP32)
+    BoundedQueue() : handle(xQueueCreateStatic(Depth, sizeof(T), storage, &control)) {}
+
+    bool send(const T& item, uint32_t waitMs = 0) {
+        return xQueueSend(handle, &item, ticks(waitMs)) == pdTRUE;
+    }
+
+    bool receive(T& item, uint32_t waitMs = 0) {
+        return xQueueReceive(handle, &item, ticks(waitMs)) == pdTRUE;
+    }
+
+    size_t size() const {
+        return uxQueueMessagesWaiting(handle);
+    }
+
+private:
+    static TickType_t ticks(uint32_t waitMs) {
+        return waitMs == QUEUE_WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(waitMs);
+    }
+
+    uint8_t storage[Depth * sizeof(T)];
+    StaticQueue_t control;
+    QueueHandle_t handle;
+#else
+    BoundedQueue() : head(0), count(0) {}
+
+    bool send(const T& item, uint32_t waitMs = 0) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!wait(lock, waitMs, [this] { return count < Depth; })) {
+            return false;
+        }
+        items[(head + count) % Depth] = item;
+        count++;
+        changed.notify_all();
+        return true;
+    }
+
+    bool receive(T& item, uint32_t waitMs = 0) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!wait(lock, waitMs, [this] { return count > 0; })) {
+            return false;
+        }
+        item = items[head];
+        head = (head + 1) % Depth;
+        count--;
+        changed.notify_all();
+        return true;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return count;
+    }
+
+private:
+    template <typename Ready>
+    bool wait(std::unique_lock<std::mutex>& lock, uint32_t waitMs, Ready ready) {
+        if (waitMs == 0) {
+            return ready();
+        }
+        if (waitMs == QUEUE_WAIT_FOREVER) {
+            changed.wait(lock, ready);
+            return true;
+        }
+        return changed.wait_for(lock, std::chrono::milliseconds(waitMs), ready);
+    }
+
+    T items[Depth];
+    size_t head;
+    size_t count;
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+#endif
+};
+
+#endif // BOUNDED_QUEUE_H
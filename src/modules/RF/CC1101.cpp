@@ -83,6 +83,32 @@ RCSwitch CC1101_CLASS::getRCSwitch() {
 
 
 CC1101_CLASS::ReceivedData CC1101_CLASS::receivedData;
+EdgeRing<EDGE_RING_SIZE> DRAM_ATTR CC1101_CLASS::edgeRing;
+PulseBlockBuffer CC1101_CLASS::streamBlocks;
+EdgeRingSource<EDGE_RING_SIZE> CC1101_CLASS::ringSource(CC1101_CLASS::edgeRing);
+PulseSource* CC1101_CLASS::pulseSource = &CC1101_CLASS::ringSource;
+bool CC1101_CLASS::streamingEnabled = false;
+TriggeredCapture CC1101_CLASS::trigger;
+bool CC1101_CLASS::triggerEnabled = false;
+FrameAssembler CC1101_CLASS::frameAssembler(FRAME_MIN_EDGES, SAMPLE_SIZE, TE_MIN_COUNT, GAP_MULTIPLIER, EDGE_GAP_RESET);
+CaptureCollector CC1101_CLASS::analyzerCapture(ANALYZER_MAX_FRAMES, DECODE_JOB_PULSES, EDGE_GAP_RESET, ANALYZER_MAX_WAIT);
+FrameTimeStats CC1101_CLASS::frameTimes;
+PulseHistogram CC1101_CLASS::pulseHistogram;
+bool CC1101_CLASS::tpmsEnabled = false;
+volatile uint32_t DRAM_ATTR CC1101_CLASS::noiseFloor = NOISE_FLOOR_US;
+
+CC1101_CLASS::CC1101_CLASS()
+    : decodeWorker([this](PulseView capture, DecodeOutcome& outcome) {
+          return analyse(capture, outcome, captureSaves[outcome.job]);
+      }) {
+    registerProtocols();
+    protocols.build();
+}
+
+void CC1101_CLASS::registerProtocols() {
+    protocols.clear();
+    shipped.registerAll(protocols);
+}
 
 void IRAM_ATTR InterruptHandler(void *arg) {
     if (!gpio_get_level(CC1101_CCGDO0A)) {
@@ -96,28 +122,32 @@ void IRAM_ATTR InterruptHandler(void *arg) {
         startRec = esp_timer_get_time();
     }
     static volatile uint64_t DRAM_ATTR lastTime = 0;
-    volatile const uint64_t time = esp_timer_get_time();
+    const uint64_t time = esp_timer_get_time();
     int64_t  duration = time - lastTime;
     lastTime = time;
 
-
     // Simple noise filtering
-    if (((duration > 100) and (duration > 0)) or ((-duration > 100) and (-duration > 0))) { 
-        noInterrupts();
-        if (CC1101_CLASS::receivedData.samples.size() < SAMPLE_SIZE) {
-            if(reversed){
-                CC1101_CLASS::receivedData.samples.push_back(-duration);
-            } else {
-                CC1101_CLASS::receivedData.samples.push_back(duration);
-            }
-            CC1101_CLASS::receivedData.lastReceiveTime = esp_timer_get_time();
-            CC1101_CLASS::receivedData.sampleCount++;
+    if (duration > CC1101_CLASS::noiseFloor) {
+        if (duration > INT32_MAX) {
+            duration = INT32_MAX;
         }
-        if (duration > 50000 or duration < -50000) {
-                CC1101_CLASS::receivedData.samples.clear();
+        CC1101_CLASS::edgeRing.push(static_cast<uint32_t>(time),
+                                    reversed ? -static_cast<int32_t>(duration) : static_cast<int32_t>(duration));
+    }
+}
+
+// Feeds queued edges to the frame assembler. Runs on the loop side only.
+// Stops at the end of a frame so edges of the next one stay queued; returns
+// true once a frame is complete.
+bool CC1101_CLASS::drainEdges() {
+    Edge edge;
+    while (pulseSource->read(&edge, 1) == 1) {
+        receivedData.lastReceiveTime = edge.timestamp;
+        if (frameAssembler.addEdge(edge)) {
+            return true;
         }
-        interrupts();
     }
+    return frameAssembler.checkIdle(pulseSource->now());
 }
 
 
@@ -249,18 +279,121 @@ void CC1101_CLASS::enableReceiver() {
   //  ELECHOUSE_cc1101.SetRx();
     receiverEnabled = true;
 
+        CC1101_CLASS::edgeRing.clear();
+        CC1101_CLASS::edgeRing.resetDropped();
+        CC1101_CLASS::frameAssembler.reset();
+        CC1101_CLASS::analyzerCapture.reset();
         CC1101_CLASS::receivedData.samples.clear();
         CC1101_CLASS::receivedData.lastReceiveTime = 0;
         CC1101_CLASS::receivedData.sampleCount = 0;
         CC1101_CLASS::receivedData.signals.clear();
 
-        delay(500);
+        // Triggered mode ignores edges until the level rises, so it does
+        // not need to wait for the receiver to settle.
+        if (!triggerEnabled) {
+            delay(500);
+        }
     recordingStarted = true;
 
     interrupts();
 }
 
 
+// Continuous receive: the radio stays in RX and the ISR keeps filling the edge
+// ring while pollStream() cuts the stream into blocks and decodes them.
+void CC1101_CLASS::enableReceiverStreaming() {
+    streamBlocks.reset();
+    CC1101_CLASS::enableReceiver();
+    streamingEnabled = true;
+}
+
+bool CC1101_CLASS::pollStream() {
+    if (!streamingEnabled) {
+        return false;
+    }
+
+    if (!readBlock(*pulseSource, streamBlocks, STREAM_BLOCK_GAP)) {
+        return false;
+    }
+    const PulseBlock& block = *streamBlocks.completed();
+    const bool submitted = submitCapture(PulseView(block.data(), block.size()), block.endTime);
+    streamBlocks.release();
+    return submitted;
+}
+
+// Triggered receive: edges only become a capture while the RSSI is above the
+// trigger threshold, plus a short pre-trigger window so preambles survive.
+void CC1101_CLASS::enableReceiverTriggered() {
+    trigger.reset();
+    triggerEnabled = true;
+    CC1101_CLASS::enableReceiver();
+}
+
+bool CC1101_CLASS::pollTriggered() {
+    if (!triggerEnabled) {
+        return false;
+    }
+
+    Edge edges[64];
+    size_t count;
+    while ((count = pulseSource->read(edges, 64)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            trigger.addEdge(edges[i]);
+        }
+    }
+    if (!trigger.updateRssi(ELECHOUSE_cc1101.getRssi(), pulseSource->now())) {
+        return false;
+    }
+
+    const bool submitted = submitCapture(trigger.capture(), pulseSource->now());
+    trigger.release();
+    return submitted;
+}
+
+// TPMS receive: FSK sensors send short Manchester packets at any time, so
+// every edge goes straight to the monitor and the table is shown whenever a
+// packet passes its check. The noise floor drops so short chips survive.
+void CC1101_CLASS::enableReceiverTpms() {
+    if (C1101preset == AM650 || C1101preset == AM270 || C1101preset == CUSTOM) {
+        C1101preset = FM476;
+    }
+    tpms.reset();
+    noiseFloor = TPMS_NOISE_FLOOR_US;
+    CC1101_CLASS::enableReceiver();
+    tpmsEnabled = true;
+}
+
+bool CC1101_CLASS::pollTpms() {
+    if (!tpmsEnabled) {
+        return false;
+    }
+
+    Edge edges[64];
+    size_t count;
+    bool updated = false;
+    while ((count = pulseSource->read(edges, 64)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            updated |= tpms.feed(edges[i].duration, millis());
+        }
+    }
+    if (updated) {
+        DecodeResultView::show(tpms.sensors());
+    }
+    return updated;
+}
+
+// Swaps where receive edges come from, e.g. a SubFileSource to replay a
+// recording through the normal decode path. nullptr goes back to the radio.
+void CC1101_CLASS::setPulseSource(PulseSource* source) {
+    pulseSource = source ? source : &ringSource;
+    frameAssembler.reset();
+    analyzerCapture.reset();
+    receivedData.samples.clear();
+    receivedData.sampleCount = 0;
+    receivedData.lastReceiveTime = 0;
+    streamBlocks.reset();
+}
+
 void CC1101_CLASS::emptyReceive() {
        ELECHOUSE_cc1101.SpiStrobe(0x30); // Reset CC1101
      localSampleCount = 0;
@@ -376,6 +509,10 @@ void CC1101_CLASS::enableReceiverCustom() {
   //  ELECHOUSE_cc1101.SetRx();
     receiverEnabled = true;
 
+        CC1101_CLASS::edgeRing.clear();
+        CC1101_CLASS::edgeRing.resetDropped();
+        CC1101_CLASS::frameAssembler.reset();
+        CC1101_CLASS::analyzerCapture.reset();
         CC1101_CLASS::receivedData.samples.clear();
         CC1101_CLASS::receivedData.lastReceiveTime = 0;
         CC1101_CLASS::receivedData.sampleCount = 0;
@@ -395,6 +532,10 @@ void CC1101_CLASS::setCC1101Preset(CC1101_PRESET preset) {
 
 void CC1101_CLASS::disableReceiver()
 {
+    streamingEnabled = false;
+    triggerEnabled = false;
+    tpmsEnabled = false;
+    noiseFloor = NOISE_FLOOR_US;
     gpio_isr_handler_remove(GPIO_NUM_17);
     gpio_uninstall_isr_service();
     ELECHOUSE_cc1101.setSidle();
@@ -515,24 +656,95 @@ void CC1101_CLASS::loadPreset() {
     //Serial.print("preset loaded");
 }
 
+// A frame is complete as soon as a gap of GAP_MULTIPLIER * TE follows
+// enough edges, instead of after fixed 1 s / 3 s timeouts. Its repeats are
+// collected until ANALYZER_MAX_FRAMES are in, the line goes quiet or
+// ANALYZER_MAX_WAIT has passed since the first frame, which leaves half of
+// a 100 ms press-to-result budget for the vote and the screen. A 12-bit
+// Came or Princeton repeat takes about 25 ms, so those get three frames;
+// slower ones such as Nice FLO get two, KeeLoq one. The capture goes to
+// the decoder worker; pollDecodeResults() shows what came of it.
 bool CC1101_CLASS::CheckReceived() {
-    if(CC1101_CLASS::receivedData.sampleCount  > 2046) {
-        CC1101_CLASS::receivedData.sampleCount = 0;
-        CC1101_CLASS::receivedData.lastReceiveTime = 0;
-        return true;
+    bool complete = false;
+    while (!complete && drainEdges()) {
+        complete = analyzerCapture.addFrame(frameAssembler);
+        frameAssembler.next();
+    }
+    if (!complete && !analyzerCapture.checkIdle(receivedData.lastReceiveTime, pulseSource->now())) {
+        return false;
     }
-    else if (CC1101_CLASS::receivedData.sampleCount  < 24 or
-            (esp_timer_get_time() - CC1101_CLASS::receivedData.lastReceiveTime) > 3000000) {
-            return false;
+    // Latency counts the wait for repeats too.
+    submitCapture(analyzerCapture.capture(), analyzerCapture.firstEndTime());
+    analyzerCapture.next();
+    return true;
+}
+
+// Analysis runs on the worker task from here on; the UI only copies the
+// capture, and saves it once the outcome is back. Returns false if the
+// worker's slots are all taken.
+bool CC1101_CLASS::submitCapture(PulseView capture, uint32_t endTime) {
+    storeCapture(capture);
+    if (batchDecoder.running()) {
+        // The batch owns the decoders until it is done.
+        return false;
     }
-     else if (CC1101_CLASS::receivedData.sampleCount  > 24 and
-            (esp_timer_get_time() - startRec) > 1000000) {
-        CC1101_CLASS::receivedData.sampleCount = 0;
-        CC1101_CLASS::receivedData.lastReceiveTime = 0;
+    if (!decodeWorker.start()) {
+        // No task to hand it to, so the caller waits for it as before.
+        DecodeOutcome outcome;
+        outcome.endTime = endTime;
+        outcome.rssi = static_cast<int16_t>(ELECHOUSE_cc1101.getRssi());
+        outcome.found = analyse(capture, outcome, directSave);
+        if (outcome.found) {
+            saveCapture(capture, outcome, directSave);
+        }
+        showOutcome(outcome);
         return true;
-    
     }
-    return false;
+    // The RSSI now, just after the capture, stands in for its peak.
+    return decodeWorker.submit(capture, endTime, static_cast<int16_t>(ELECHOUSE_cc1101.getRssi()));
+}
+
+// Packs capture into allData for sendRaw(), whatever the decoders make of it.
+// Repeats of the same frame are stored once with a repeat count. UI task only,
+// as it uses frameSegmenter and storeSamples.
+void CC1101_CLASS::storeCapture(PulseView capture) {
+    if (capture.empty()) {
+        return;
+    }
+    storeSamples.assign(capture.begin(), capture.end());
+    frameSegmenter.split(storeSamples.data(), storeSamples.size());
+    CC1101_CLASS::allData.addSignal(capture, findRepeats(storeSamples.data(), storeSamples.size(), frameSegmenter));
+}
+
+// Saves and shows the outcomes the worker has queued. Call from the LVGL
+// thread, which is the only one to use the SD card and the radio.
+bool CC1101_CLASS::pollDecodeResults() {
+    DecodeOutcome outcome;
+    bool shown = false;
+    while (decodeWorker.poll(outcome)) {
+        if (outcome.found) {
+            saveCapture(decodeWorker.capture(outcome.job), outcome, captureSaves[outcome.job]);
+        }
+        decodeWorker.release(outcome.job);
+        showOutcome(outcome);
+        shown = true;
+    }
+    return shown;
+}
+
+void CC1101_CLASS::showOutcome(const DecodeOutcome& outcome) {
+    DecodeResultView::show(outcome);
+    recordFrameLatency(outcome.endTime);
+}
+
+bool CC1101_CLASS::decoding() const {
+    return decodeWorker.busy();
+}
+
+// Call once the result of a capture that ended at endTime is on screen.
+// Reported with the UI frame times by loop(), not per capture.
+void CC1101_CLASS::recordFrameLatency(uint32_t endTime) {
+    frameTimes.addLatency(pulseSource->now() - endTime);
 }
 
 void CC1101_CLASS::fskAnalyze() {
@@ -659,19 +871,9 @@ void CC1101_CLASS::startSignalAnalyseTask() {
 void CC1101_CLASS::handleSignal(){
 
 ////////////////////////////////////////////////////
-        Signal data;
-
-     //   //Serial.println(F("Raw samples: "));
-        CC1101_CLASS::receivedData.sampleCount = 0;
-        
-        for (const auto &sample : CC1101_CLASS::receivedData.samples) {
-            //Serial.print(sample);
-            data.addSample(sample);
-            //Serial.print(" ");
-            CC1101_CLASS::receivedData.sampleCount++;
-        }
-
-        CC1101_CLASS::allData.addSignal(data);
+        // Packed straight into the capture arena, no per-capture allocation.
+        CC1101_CLASS::receivedData.sampleCount = CC1101_CLASS::receivedData.samples.size();
+        storeCapture(CC1101_CLASS::receivedData.samples);
 
         
 
@@ -684,14 +886,6 @@ void CC1101_CLASS::handleSignal(){
 
     lv_textarea_set_text(textareaRC, "\nRAW signal");//, \nCount: ");
 
-    std::ostringstream  rawString;
-
-    for (const auto& sample : CC1101_CLASS::receivedData.samples) {
-        rawString << sample << " ";
-    }
-
-    void filterSignal();
-
 
 
 CC1101_CLASS::disableReceiver();
@@ -700,213 +894,182 @@ CC1101_CLASS::disableReceiver();
 }
 
 
-bool CC1101_CLASS::decode() {
-
-    delay(5);
-    for (int i=0; i >CC1101_CLASS::receivedData.samples.size(); i++) {
-        Serial.print(CC1101_CLASS::receivedData.samples[i]);
-        Serial.print(", ");
-    }
-
-    delay(5);
-    if (!CC1101_CLASS::receivedData.signals.empty()) {
-        const auto& lastSignal = CC1101_CLASS::receivedData.signals.back();
-        for (int i = 0; i < lastSignal.samples.size(); i++) {
-            Serial.print(lastSignal.samples[i]);
-            Serial.print(", ");
-        }
-    }
-
-    delay(5);
-    
-
-    if (CC1101_CLASS::receivedData.samples.empty()) {
-  Serial.println("No pulses to decode.");
+// Decodes capture and leaves what saveCapture() is to write in save. Runs on
+// the decoder worker: it uses the decoders, which the UI leaves alone while
+// decoding() is true, and its own buffers, but neither LVGL, receivedData,
+// the SD card nor the radio. Returns false if there is nothing to show or
+// save.
+bool CC1101_CLASS::analyse(PulseView capture, DecodeOutcome& outcome, CaptureSave& save) {
+    save.print = SignalFingerprint();
+    save.frameLength = 0;
+    save.repeats = 0;
+    save.binRawKept = 0;
+    if (capture.empty()) {
         return false;
     }
-            Serial.println("decode.");
-
-
-    filterSignal();
-   Serial.println("count:");
-   Serial.println(CC1101_CLASS::receivedData.samples.size());
-   Serial.println("Pulses:");
-   Serial.println(pulses[0]);
-   Serial.println(pulses[1]);
-   delay(5);
-    Serial.println("filtered values\n");
-    for(int i = 0; i < CC1101.receivedData.filtered.size(); i++) {
-        Serial.print(CC1101.receivedData.filtered[i]);
-        Serial.print(", ");
-    }
-    delay(5);
-    Serial.println("filtered values\n");
-    for(int i = 0; i < CC1101.receivedData.samples.size(); i++) {
-        Serial.print(CC1101.receivedData.samples[i]);
-        Serial.print(", ");
-    }
-    if ((DURATION_DIFF(pulses[0], 500) < 40) &&
-        (DURATION_DIFF(pulses[1], 1000) < 90)) {
-            //Serial.println("is Hormann");
-        if (hormannProtocol.decode(CC1101.receivedData.filtered.data(), CC1101_CLASS::receivedData.filtered.size())) {
-            hormannProtocol.getCodeString(pulses[0], pulses[1]);
-            return true;
-        }
-    }
-
-    if ((DURATION_DIFF(pulses[0], 320) < 50) &&
-        (DURATION_DIFF(pulses[1], 640) < 90)) {
-            //Serial.println("is Came");
-        if (cameProtocol.decode(CC1101.receivedData.filtered.data(), CC1101_CLASS::receivedData.filtered.size())) {
-            cameProtocol.getCodeString(pulses[0], pulses[1]);
-            return true;
-        }
+    decodeSamples.assign(capture.begin(), capture.end());
+
+    // Every repetition, and every remote, in the capture gets its own pass;
+    // only the code most frames agree on reaches the screen. The batch
+    // decode goes through the same CaptureDecoder::decode().
+    RepeatInfo repeats;
+    const DecodeResult result =
+        captureDecoder.decode(decodeSamples.data(), decodeSamples.size(), decodeSegmenter, &repeats);
+    const size_t frameCount = decodeSegmenter.size();
+#ifdef DEBUG_CC1101_DECODE
+    Serial.printf("frames: %u, repeats: %u\n", static_cast<unsigned>(frameCount), repeats.count);
+#endif
+    if (result.valid()) {
+        outcome.result = result;
+        save.print = fingerprint(result, captureDecoder.timing());
     }
 
-    if ((DURATION_DIFF(pulses[0], 555) < 40) &&
-        (DURATION_DIFF(pulses[1], 1111) < 90)) {
-            //Serial.println("is Ansonic");
-        if (ansonicProtocol.decode(CC1101.receivedData.filtered.data(), CC1101_CLASS::receivedData.filtered.size())) {
-            ansonicProtocol.getCodeString(pulses[0], pulses[1]);
-            return true;
+    // Only the first copy of a repeated frame goes to SD, with its count.
+    for (size_t i = 0; i < frameCount; i++) {
+        const bool canonical = !repeats.repeated() ||
+                               decodeSegmenter.start(i) + decodeSegmenter.length(i) == repeats.start + repeats.length;
+        if (canonical && captureDecoder.measure(decodeSegmenter, i).quantizer.enabled()) {
+            save.frameStart = static_cast<uint32_t>(decodeSegmenter.start(i));
+            save.frameLength = static_cast<uint32_t>(decodeSegmenter.length(i));
+            save.timing = captureDecoder.timing();
+            save.repeats = repeats.count;
+            break;
         }
     }
 
-    if ((DURATION_DIFF(pulses[0], 700) < 50) &&
-        (DURATION_DIFF(pulses[1], 1400) < 90)) {
-           //Serial.println("is NiceFlow");
-        if (niceFloProtocol.decode(CC1101.receivedData.filtered.data(), CC1101_CLASS::receivedData.filtered.size())) {
-            niceFloProtocol.getCodeString(pulses[0], pulses[1]);
-            return true;
+    if (!result.valid()) {
+        // No protocol knows it; keep it as bits and te if it has a line code.
+        size_t firstFrame = 0;
+        save.binRawKept = findBinRaw(frameCount, outcome.binRaw, firstFrame, save.binRawFrames);
+        if (save.binRawKept != 0) {
+            save.print = fingerprint(outcome.binRaw, captureDecoder.measure(decodeSegmenter, firstFrame));
         }
     }
+    return outcome.result.valid() || outcome.binRaw.bits != 0 || save.frameLength != 0;
+}
 
-    if ((DURATION_DIFF(pulses[0], 300) < 50) &&
-        (DURATION_DIFF(pulses[1], 900) < 90)) {
-            //Serial.println("is SMC5326");
-        if (smc5326Protocol.decode(CC1101.receivedData.filtered.data(), CC1101_CLASS::receivedData.filtered.size())) {
-            smc5326Protocol.getCodeString(pulses[0], pulses[1]);
-            return true;
+// Writes what analyse() left in save: the capture as a .sub if a frame had a
+// 1:n timing, else as BinRAW if it has a line code, under the name the
+// fingerprint index gives it, and the event to the history. UI task only, as
+// the SD card shares its SPI bus with the radio and the NFC reader.
+void CC1101_CLASS::saveCapture(PulseView capture, DecodeOutcome& outcome, const CaptureSave& save) {
+    // A remote seen before is saved over its earlier capture.
+    const String name = labelCapture(save.print, outcome);
+    recordEvent(outcome);
+    if (save.frameLength != 0) {
+        filterAll(capture, save);
+        if (!CC1101_CLASS::receivedData.filtered.empty()) {
+            saveFiltered(save.repeats, name);
         }
     }
-
-    if ((DURATION_DIFF(pulses[0], 250) < 50) &&
-    (DURATION_DIFF(pulses[1], 500) < 90)) {
-        //Serial.println("is SMC5326");
-    if (kiaProtocol.decode(CC1101.receivedData.filtered.data(), CC1101_CLASS::receivedData.filtered.size())) {
-        kiaProtocol.get_string(pulses[0], pulses[1]);
-        return true;
-    }
+    if (save.binRawKept != 0) {
+        saveBinRaw(save, outcome.binRaw.te, name);
     }
-
-    else if ((DURATION_DIFF(pulses[0], 400) < 100) &&
-    (DURATION_DIFF(pulses[1], 800) < 150)) {
-        Serial.println("KeeLoq structure detected (Timing match):");
-        for(int i = 0; i < CC1101.receivedData.samples.size(); i++) {
-            keeloqDecoder.feed(CC1101.receivedData.samples.data()[i] < 0, abs(CC1101.receivedData.samples.data()[i]));
-
-        }
-        
-
-        if (keeloqDecoder.hasResult()) {
- 
-   KeeLoqData keeloqResult;
-   KeeLoqStatus status = keeloqDecoder.getResult(
-       keeloqResult,
-       0ULL,
-       KeeLoqCommon::KeeLoqLearningType::Unknown,
-       ""
-   );
-
-   // Get the formatted string from the data object
-   std::string result_str_std = keeloqResult.getCodeString();
-   String result_str = result_str_std.c_str(); // Convert std::string to Arduino String
-
-   // --- Update UI (Ported from Hormann example) ---
-   ScreenManager& screenMgr = ScreenManager::getInstance(); // Get ScreenManager instance
-   lv_obj_t * textarea;
-   if(C1101preset == CUSTOM){ // Assuming C1101preset is accessible
-       textarea = screenMgr.text_area_SubGHzCustom;
-   } else {
-       textarea = screenMgr.getTextArea();
-   }
-   // Check if textarea is valid before using
-   if (textarea != nullptr) {
-        lv_textarea_set_text(textarea, result_str.c_str()); // Use C-string representation for LVGL
-   } else {
-        Serial.println("Error: Target text area is null!");
-        // Optionally print to Serial as fallback
-        Serial.println(result_str);
-   }
-   // --- End UI Update ---
-
-
-}
 }
 
 
+size_t CC1101_CLASS::loadFingerprints() {
+    if (!fingerprints.begin()) {
+        Serial.println("Fingerprint index unavailable.");
+        return 0;
+    }
+    return fingerprints.size();
+}
 
+size_t CC1101_CLASS::loadHistory() {
+    if (!history.begin(static_cast<uint32_t>(std::time(nullptr)))) {
+        Serial.println("Decode history unavailable.");
+        return 0;
+    }
+    return history.size();
+}
 
-
-    std::ostringstream samples;
-    for (size_t i = 0; i < CC1101.receivedData.filtered.size(); ++i) {
-        samples << CC1101.receivedData.filtered.data()[i];
-        if(i != CC1101.receivedData.filtered.size() - 1)
-            samples << " ";
+bool CC1101_CLASS::showHistory() {
+    if (batchDecoder.running()) {
+        return false;
     }
+    DecodedEvent events[HISTORY_SHOW_COUNT];
+    size_t count = 0;
+    history.latest(HISTORY_SHOW_COUNT, [&](const DecodedEvent& event) { events[count++] = event; });
+    DecodeResultView::show(events, count);
+    return true;
+}
 
+void CC1101_CLASS::resetDecoderMetrics() {
+    decoderMetrics.reset();
+}
 
-   
+// Refused while the worker has a capture, as both decode through protocols.
+BatchStart CC1101_CLASS::startBatchDecode(const char* dirPath) {
+    if (decoding()) {
+        return BatchStart::Busy;
+    }
+    const BatchStart started = batchDecoder.start(dirPath);
+    if (started == BatchStart::Started) {
+        batchShown = BatchProgress();
+        batchShown.done = UINT32_MAX;
+    }
+    return started;
+}
 
-    CC1101_CLASS::receivedData.samples.clear();
-    CC1101_CLASS::receivedData.sampleCount = 0;
+// Reads and indexes the batch's files, which the batch task only decodes,
+// and shows the progress when it moved on; false once the batch is done.
+bool CC1101_CLASS::pollBatchDecode() {
+    batchDecoder.step();
+    const BatchProgress progress = batchDecoder.progress();
+    if (progress.files != batchShown.files || progress.done != batchShown.done || !progress.running) {
+        DecodeResultView::show(progress);
+        batchShown = progress;
+    }
+    return progress.running;
+}
 
-    return false;
+// Once the batch screen is left nothing polls the batch, which would keep
+// live decoding and the history refused; it ends with the files done so far.
+void CC1101_CLASS::cancelBatchDecode() {
+    batchDecoder.cancel();
 }
 
 
 
 
+
 void CC1101_CLASS::sendRaw() {
     CC1101_CLASS::init();
     delay(5);
-            Signal samplesData;
+            RepeatedView samplesData;
+            Signal bruteSignal;
 
-            if(CC1101_CLASS::allData.signals.empty()) return;
+            if(CC1101_CLASS::allData.empty()) return;
 
             if(C1101CurrentState != STATE_BRUTE) {
             detachInterrupt(CC1101_CCGDO0A);
             detachInterrupt(CC1101_CCGDO0A);
 
 
-             if(!CC1101_CLASS::receivedData.filtered.empty()) {
-               Signal filtered;
-               for (int i = 0; CC1101_CLASS::receivedData.filtered.size() < i; i++){
-                        filtered.addSample(CC1101_CLASS::receivedData.filtered[i]);
-               }
-            }
-            samplesData = CC1101_CLASS::allData.getSignal(CC1101_CLASS::allData.signals.size() - 1);
+            samplesData = CC1101_CLASS::allData.lastSignal();
             CC1101_CLASS::initRaw();}
             else  {
                 CC1101_CLASS::allData.clear();
                 for (size_t i = 0; i < 26; i++)
                 {
-                    samplesData.addSample(samplesToSend[i]);
+                    bruteSignal.addSample(samplesToSend[i]);
 
                 }
+                samplesData = bruteSignal.view();
             }
 
 
 
            
-            CC1101_CLASS::levelFlag = samplesData.samples[0] > 0; 
+            CC1101_CLASS::levelFlag = *samplesData.begin() > 0; 
 
             samplesToSend.clear();
-            for (size_t j = 0; j < samplesData.samples.size(); ++j) {
-                if (samplesData.samples[j] > 0){
-                samplesToSend.push_back(samplesData.samples[j]);
+            for (PulseDuration sample : samplesData) {
+                if (sample > 0){
+                samplesToSend.push_back(sample);
                 } else {
-                    samplesToSend.push_back(-samplesData.samples[j]);
+                    samplesToSend.push_back(-sample);
                 }
 
             }
@@ -971,6 +1134,64 @@ String CC1101_CLASS::generateFilename(float frequency, int modulation, float ban
     return String(filenameBuffer);
 }
 
+// The same remote at the same frequency always gets the same name.
+String CC1101_CLASS::generateFilename(const SignalFingerprint& print)
+{
+    char filenameBuffer[32];
+
+    snprintf(filenameBuffer, sizeof(filenameBuffer), "%d_%08lX.sub", static_cast<int>(CC1101_MHZ * 100),
+             static_cast<unsigned long>(print.hash));
+
+    return String(filenameBuffer);
+}
+
+// Appends a decoded capture to the history: its code if a protocol took
+// it, else the first 64 bits of its BinRAW data.
+void CC1101_CLASS::recordEvent(const DecodeOutcome& outcome) {
+    DecodedEvent event;
+    if (outcome.result.valid()) {
+        snprintf(event.protocol, sizeof(event.protocol), "%s", outcome.result.protocol);
+        event.key = outcome.result.code;
+        event.bits = outcome.result.bits;
+    } else if (outcome.binRaw.bits != 0) {
+        snprintf(event.protocol, sizeof(event.protocol), "BinRAW/%s", lineCodeName(outcome.binRaw.code));
+        const size_t bytes = std::min<size_t>((outcome.binRaw.bits + 7) / 8, sizeof(event.key));
+        for (size_t i = 0; i < bytes; i++) {
+            event.key = event.key << 8 | outcome.binRaw.data[i];
+        }
+        event.bits = outcome.binRaw.bits;
+    } else {
+        return;
+    }
+    event.frequency = static_cast<uint32_t>(CC1101_MHZ * 1000000.0f + 0.5f);
+    event.preset = static_cast<uint8_t>(C1101preset);
+    event.rssi = static_cast<int8_t>(std::max<int16_t>(outcome.rssi, INT8_MIN));
+    if (!history.append(event, static_cast<uint32_t>(std::time(nullptr)))) {
+        Serial.println("Could not append to the decode history.");
+    }
+}
+
+// Looks the capture up among those saved before and fills in the label of
+// outcome; an unknown one is stored under a new label. Returns the file name
+// to save it as, a random one if it has no fingerprint.
+String CC1101_CLASS::labelCapture(const SignalFingerprint& print, DecodeOutcome& outcome)
+{
+    if (!print.valid()) {
+        return generateFilename(CC1101_MHZ, CC1101_MODULATION, CC1101_RX_BW);
+    }
+    FingerprintRecord known;
+    outcome.known = fingerprints.find(print, known);
+    if (outcome.known) {
+        snprintf(outcome.label, sizeof(outcome.label), "%s", known.label);
+    } else {
+        String filename = generateFilename(print);
+        snprintf(outcome.label, sizeof(outcome.label), "%.*s", static_cast<int>(filename.length()) - 4,
+                 filename.c_str());
+        fingerprints.add(print, outcome.label);
+    }
+    return String(outcome.label) + ".sub";
+}
+
 String CC1101_CLASS::generateRandomString(int length)
 {
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
@@ -1062,7 +1283,7 @@ void CC1101_CLASS::sendEncoded(RFProtocol protocol, float frequency, int16_t bit
 
     switch (protocol) {
         case CAME:
-                cameProtocol.yield(code);
+                shipped.cameProtocol.yield(code);
                 delay(5);
 
 
@@ -1079,7 +1300,7 @@ void CC1101_CLASS::sendEncoded(RFProtocol protocol, float frequency, int16_t bit
             break;
     
         case NICE:
-                niceFloProtocol.yield(code);
+                shipped.niceFloProtocol.yield(code);
                 delay(5);
 
 
@@ -1096,7 +1317,7 @@ void CC1101_CLASS::sendEncoded(RFProtocol protocol, float frequency, int16_t bit
             break; 
     
         case ANSONIC:
-                ansonicProtocol.yield(code);
+                shipped.ansonicProtocol.yield(code);
                 delay(5);
 
 
@@ -1137,7 +1358,7 @@ void CC1101_CLASS::sendEncoded(RFProtocol protocol, float frequency, int16_t bit
     
         case SMC5326:
             while(encoderState != EncoderStepReady) {
-                smc5326Protocol.yield(code);
+                shipped.smc5326Protocol.yield(code);
             }
             break;
     
@@ -1155,63 +1376,54 @@ void CC1101_CLASS::sendEncoded(RFProtocol protocol, float frequency, int16_t bit
 
 
 
-bool CC1101_CLASS::checkReversed(int64_t big) {
-    for(int i = 0; i < CC1101.receivedData.samples.size(); i++) {
-        if(CC1101.receivedData.samples[i] > (big *13)) return true;
-    }
-    return false;
-}
-
-void CC1101_CLASS::reverseLogicState() {
-    for(int i = 0; i < CC1101.receivedData.samples.size(); i++) {
-        CC1101.receivedData.samples[i] = -CC1101.receivedData.samples[i];
-    }
-}
-
-void CC1101_CLASS::filterAll() {
+// Quantizes the frame of capture analyse() chose into receivedData.filtered
+// for saving; the decoders get the same pulses from the receiver without
+// the copy. A reversed frame is inverted here, the capture itself is left
+// untouched since neighbouring frames share their gap pulse with it.
+void CC1101_CLASS::filterAll(PulseView capture, const CaptureSave& save) {
     CC1101.receivedData.filtered.clear();
-    int64_t shortMin = pulses[0] * 0.7;
-    int64_t shortMax = pulses[0] * 1.3;
-    int64_t longMin  = pulses[1] * 0.7;
-    int64_t longMax  = pulses[1] * 1.3;
-    int64_t spaceMin = pulses[1] * 13;
-    int64_t space    = pulses[1] * 18;
-    //Serial.println(spaceMin);
-
-    for (int i = 0; i < CC1101.receivedData.samples.size(); i++) {
-        int64_t sample = CC1101.receivedData.samples[i];
-        if (sample > 0) {
-            if (sample > spaceMin) {
-                CC1101.receivedData.filtered.push_back(space);
-            } else if (sample > shortMin && sample < shortMax) {
-                CC1101.receivedData.filtered.push_back(pulses[0]);
-            } else if (sample > longMin && sample < longMax) {
-                CC1101.receivedData.filtered.push_back(pulses[1]);
-            }
-        } else {
-            sample = -sample;
-            if (sample > spaceMin) {
-                CC1101.receivedData.filtered.push_back(-space);
-            } else if (sample > shortMin && sample < shortMax) {
-                CC1101.receivedData.filtered.push_back(-pulses[0]);
-            } else if (sample > longMin && sample < longMax) {
-                CC1101.receivedData.filtered.push_back(-pulses[1]);
-            }
+    if (!save.timing.quantizer.enabled()) {
+        return;
+    }
+    const uint32_t end = save.frameStart + save.frameLength;
+    uint32_t index = 0;
+    PulseDuration snapped;
+    for (PulseDuration pulse : capture) {
+        if (index >= end) {
+            break;
+        }
+        if (index++ >= save.frameStart &&
+            save.timing.quantizer.apply(save.timing.reversed ? -pulse : pulse, snapped)) {
+            CC1101.receivedData.filtered.push_back(snapped);
         }
     }
+}
 
-
+void CC1101_CLASS::saveFiltered(uint16_t repeatCount, const String& name) {
     if (!SD_RF.directoryExists("/recordedFilteredAll/")) {
         SD_RF.createDirectory("/recordedFilteredAll/");
     }
 
-    String filename = CC1101_CLASS::generateFilename(CC1101_MHZ, CC1101_MODULATION, CC1101_RX_BW);
-    String fullPath = "/recordedFilteredAll/" + filename;
+    String fullPath = "/recordedFilteredAll/" + name;
     FlipperSubFile subFile;
-    File32* outputFilePtr = SD_RF.createOrOpenFile(fullPath.c_str(), O_WRITE | O_CREAT);
+    File32* outputFilePtr = SD_RF.createOrOpenFile(fullPath.c_str(), O_WRITE | O_CREAT | O_TRUNC);
     if (outputFilePtr) {
         File32& outputFile = *outputFilePtr; 
-        std::vector<uint8_t> customPresetData;
+        RepeatInfo repeats;
+        if (repeatCount > 1) {
+            repeats.length = static_cast<uint32_t>(CC1101_CLASS::receivedData.filtered.size());
+            repeats.count = repeatCount;
+        }
+        subFile.generateRaw(outputFile, C1101preset, customPresetData(), PulseView(CC1101_CLASS::receivedData.filtered), CC1101_MHZ,
+                            repeats);
+        SD_RF.closeFile(outputFilePtr);
+    }
+}
+
+// Register/value pairs a CUSTOM preset .sub file needs to reproduce the current
+// radio setup, then the PA table; empty for the other presets.
+std::vector<uint8_t> CC1101_CLASS::customPresetData() {
+    std::vector<uint8_t> customPresetData;
     if (C1101preset == CUSTOM) {
         customPresetData.insert(customPresetData.end(), {
             CC1101_MDMCFG4, ELECHOUSE_cc1101.SpiReadReg(CC1101_MDMCFG4),
@@ -1226,131 +1438,82 @@ void CC1101_CLASS::filterAll() {
         ELECHOUSE_cc1101.SpiReadBurstReg(0x3E, paTable.data(), paTable.size());
         customPresetData.insert(customPresetData.end(), paTable.begin(), paTable.end());
     }
-    std::ostringstream filteredString;
-    for (const auto& sample : CC1101_CLASS::receivedData.filtered) {
-        filteredString << sample << " ";
-    }
-    subFile.generateRaw(outputFile, C1101preset, customPresetData, filteredString, CC1101_MHZ);
-    SD_RF.closeFile(outputFilePtr);
-}
-    
+    return customPresetData;
 }
 
-void CC1101_CLASS::filterSignal() {
-    if (CC1101.receivedData.samples.empty()) return;
-
-    std::vector<int64_t> absArr;
-    absArr.reserve(CC1101.receivedData.samples.size());
-    for (auto x : CC1101.receivedData.samples)
-        absArr.push_back(std::abs(x));
-
-    if (absArr.empty()) return;
-    std::sort(absArr.begin(), absArr.end());
-
-    std::vector<std::vector<int64_t>> groups;
-    std::vector<int64_t> currGroup;
-    currGroup.push_back(absArr[0]);
-    int64_t groupMin = absArr[0];
-
-    // Replace floating point multiplication with integer arithmetic:
-    // Instead of: if (x <= static_cast<int64_t>(1.3 * groupMin))
-    // We use:      if (x * 10 <= groupMin * 13)
-    for (size_t i = 1; i < absArr.size(); i++) {
-        int64_t x = absArr[i];
-        if (x * 10 <= groupMin * 13)
-            currGroup.push_back(x);
-        else {
-            groups.push_back(std::move(currGroup));
-            currGroup.clear();
-            currGroup.push_back(x);
-            groupMin = x;
+// Line-codes the frames analyse() split a capture no decoder took into
+// frames, keeping the distinct ones at the te of the first, which goes to
+// first and its index to firstFrame. Returns how many were kept, 0 if no
+// frame had a te all its pulses fit.
+size_t CC1101_CLASS::findBinRaw(size_t frameCount, BinRawSignal& first, size_t& firstFrame, BinRawFrame* frames) {
+    size_t kept = 0;
+    for (size_t i = 0; i < frameCount && kept < BINRAW_MAX_FRAMES; i++) {
+        if (!binRaw.analyze(decodeSegmenter.frame(i))) {
+            continue;
+        }
+        const BinRawSignal& signal = binRaw.signal();
+        if (kept == 0) {
+            first = signal;
+            firstFrame = i;
+            frames[kept++] = signal.slots;
+            continue;
+        }
+        // Repeats of the first frame add nothing; other remotes in the
+        // capture at another te do not fit this file.
+        if (signal.sameData(first) || DURATION_DIFF(signal.te, first.te) * 10 > first.te) {
+            continue;
+        }
+        if (binRaw.encode(decodeSegmenter.frame(i), first.te, frames[kept])) {
+            kept++;
         }
     }
-    if (!currGroup.empty())
-        groups.push_back(std::move(currGroup));
-
-    if (groups.empty()) return;
-
-    if (groups.size() == 1) {
-        std::sort(groups[0].begin(), groups[0].end());
-        int64_t median = computeMedian(&groups[0]);
-        pulses.clear();
-        pulses.push_back(median);
-        return;
+    if (kept == 0) {
+        first = BinRawSignal();
     }
+    return kept;
+}
 
-    std::vector<std::pair<int64_t, int64_t>> groupStats; // {count, median}
-    for (auto &g : groups) {
-        std::sort(g.begin(), g.end());
-        groupStats.push_back({ static_cast<int64_t>(g.size()), computeMedian(&g) });
+// Saves the frames findBinRaw() kept as a Flipper BinRAW key.
+void CC1101_CLASS::saveBinRaw(const CaptureSave& save, uint32_t te, const String& name) {
+    if (!SD_RF.directoryExists("/recordedBinRaw/")) {
+        SD_RF.createDirectory("/recordedBinRaw/");
     }
-
-    std::sort(groupStats.begin(), groupStats.end(), 
-        [](const std::pair<int64_t, int64_t>& a, const std::pair<int64_t, int64_t>& b) {
-            return (a.first == b.first) ? (a.second < b.second) : (a.first > b.first);
-        });
-
-    if (groupStats.size() < 2) return;
-
-    int64_t rep1 = groupStats[0].second;
-    int64_t rep2 = groupStats[1].second;
-    if (rep1 > rep2) std::swap(rep1, rep2);
-
-    int64_t smallCandidate1 = (rep1 + rep2) / 3;
-    int64_t bigCandidate1   = smallCandidate1 * 2;
-    int64_t smallCandidate2 = (rep1 + rep2) / 4;
-    int64_t bigCandidate2   = smallCandidate2 * 3;
-    int64_t smallCandidate3 = (rep1 + rep2) / 5;
-    int64_t bigCandidate3   = smallCandidate3 * 4;
-    int64_t smallCandidate4 = (rep1 + rep2) / 6;
-    int64_t bigCandidate4   = smallCandidate4 * 5;
-    int64_t smallCandidate5 = (rep1 + rep2) / 7;
-    int64_t bigCandidate5   = smallCandidate5 * 6;
-    int64_t smallCandidate6 = (rep1 + rep2) / 8;
-    int64_t bigCandidate6   = smallCandidate6 * 7;
-    int64_t smallCandidate7 = (rep1 + rep2) / 9;
-    int64_t bigCandidate7   = smallCandidate7 * 8;
-    int64_t smallCandidate8 = (rep1 + rep2) / 10;
-    int64_t bigCandidate8   = smallCandidate8 * 9;
-
-    uint32_t diff1 = DURATION_DIFF(rep1, smallCandidate1);
-    uint32_t diff2 = DURATION_DIFF(rep1, smallCandidate2);
-    uint32_t diff3 = DURATION_DIFF(rep1, smallCandidate3);
-    uint32_t diff4 = DURATION_DIFF(rep1, smallCandidate4);
-    uint32_t diff5 = DURATION_DIFF(rep1, smallCandidate5);
-    uint32_t diff6 = DURATION_DIFF(rep1, smallCandidate6);
-    uint32_t diff7 = DURATION_DIFF(rep1, smallCandidate7);
-    uint32_t diff8 = DURATION_DIFF(rep1, smallCandidate8);
-    uint32_t diffs[] = { diff1, diff2, diff3, diff4, diff5, diff6, diff7, diff8 };
-
-    auto minPtr = std::min_element(std::begin(diffs), std::end(diffs));
-    size_t index = std::distance(std::begin(diffs), minPtr);
-
-    pulses.clear();
-    switch (index) {
-        case 0: pulses.push_back(smallCandidate1);  pulses.push_back(bigCandidate1); break;
-        case 1: pulses.push_back(smallCandidate2);  pulses.push_back(bigCandidate2); break;
-        case 2: pulses.push_back(smallCandidate3);  pulses.push_back(bigCandidate3); break;
-        case 3: pulses.push_back(smallCandidate4);  pulses.push_back(bigCandidate4); break;
-        case 4: pulses.push_back(smallCandidate5);  pulses.push_back(bigCandidate5); break;
-        case 5: pulses.push_back(smallCandidate6);  pulses.push_back(bigCandidate6); break;
-        case 6: pulses.push_back(smallCandidate7);  pulses.push_back(bigCandidate7); break;
-        case 7: pulses.push_back(smallCandidate8);  pulses.push_back(bigCandidate8); break;
+    String fullPath = "/recordedBinRaw/" + name;
+    File32* outputFilePtr = SD_RF.createOrOpenFile(fullPath.c_str(), O_WRITE | O_CREAT | O_TRUNC);
+    if (outputFilePtr) {
+        FlipperSubFile subFile;
+        subFile.generateBinRaw(*outputFilePtr, C1101preset, customPresetData(), CC1101_MHZ, te, save.binRawFrames,
+                               save.binRawKept);
+        SD_RF.closeFile(outputFilePtr);
     }
+}
 
-    if (checkReversed(rep2))
-        reverseLogicState();
-
-    if (DURATION_DIFF(pulses[0], rep1) < 40 && DURATION_DIFF(pulses[1], rep2) < 80)
-        filterAll();
-    else {
-        pulses.clear();
-        pulses.push_back(rep1);
-        pulses.push_back(rep2);
+size_t CC1101_CLASS::loadFlexDecoders(const char* path) {
+    size_t loaded = 0;
+    File32* file = SD_RF.fileExists(path) ? SD_RF.createOrOpenFile(path, O_RDONLY) : nullptr;
+    if (file) {
+        int lineNumber = 0;
+        while (file->available() && loaded < FLEX_MAX_DECODERS) {
+            String line = file->readStringUntil('\n');
+            line.trim();
+            lineNumber++;
+            if (line.length() == 0 || line.startsWith("#")) {
+                continue;
+            }
+            FlexSpec spec;
+            if (!parseFlexSpec(line.c_str(), spec) || !flexDecoders[loaded].compile(spec)) {
+                Serial.printf("Flex spec %s:%d rejected: %s\n", path, lineNumber, line.c_str());
+                continue;
+            }
+            loaded++;
+        }
+        SD_RF.closeFile(file);
     }
 
-    Serial.print("Pulses Med: ");
-    Serial.print(rep1);
-    Serial.print(" ");
-    Serial.println(rep2);
+    registerProtocols();
+    for (size_t i = 0; i < loaded; i++) {
+        protocols.add(flexDecoders[i]);
+    }
+    protocols.build();
+    return loaded;
 }
@@ -6,22 +6,50 @@
 
 #include "SPI.h"
 #include <driver/timer.h>
+#include "EdgeRing.h"
+#include "PulseBlock.h"
+#include "PackedPulses.h"
+#include "CaptureArena.h"
+#include "PulseSource.h"
+#include "TriggeredCapture.h"
+#include "FrameAssembler.h"
+#include "FrameSegmenter.h"
+#include "RepeatedCapture.h"
+#include "DecodeResult.h"
+#include "DecodeResultView.h"
+#include "ProtocolRegistry.h"
+#include "CaptureDecoder.h"
+#include "BatchDecoder.h"
+#include "FingerprintIndex.h"
+#include "EventHistory.h"
+#include "PulseHistogram.h"
+#include "BinRawAnalyzer.h"
+#include "FlexDecoder.h"
+#include "TpmsMonitor.h"
+#include "DecodeWorker.h"
+#include "FrameTimeStats.h"
 //decoders/encoders
-#include "protocols/HormannProtocol.h" 
-#include "protocols/CameProtocol.h" 
-#include "protocols/NiceFloProtocol.h"
-#include "protocols/AnsonicProtocol.h"
-#include "protocols/Smc5326Protocol.h"
+#include "ShippedProtocols.h"
 #include "protocols/Holtek_HT12xProtocol.h"
-#include "protocols/kia.hpp"
-#include "protocols/KeeLoqProtocol.hpp"
 //#include "protocols/TPMSGenericData.h"
 
 #define SAMPLE_SIZE 2048
+#define CAPTURE_ARENA_WORDS 16384   // 32 KB of packed capture history
+#define CAPTURE_ARENA_RECORDS 32    // most captures kept at once
+#define EDGE_RING_SIZE 2048     // Edges buffered between the GDO0 ISR and the loop-side reader
+#define EDGE_GAP_RESET 50000    // A pulse longer than this (us) discards the partial capture
+#define STREAM_BLOCK_GAP 30000  // In streaming mode a pulse longer than this (us) closes the current block
 #define MAX_SIGNAL_LENGTH 10000000  
-#define TE_MIN_COUNT   5        // Minimum number of high pulses required to calculate TE
-#define GAP_MULTIPLIER 10       // A low pulse longer than GAP_MULTIPLIER * TE is considered a gap
-const float BIN_RAW_GAP_MULTIPLIER = 10.0;  // A low pulse longer than (TE * GAP_MULTIPLIER) is considered a gap
+#define TE_MIN_COUNT   5        // Minimum number of pulses required to calculate TE
+#define GAP_MULTIPLIER FRAME_GAP_MULTIPLIER  // A low pulse longer than GAP_MULTIPLIER * TE is considered a gap
+#define FRAME_MIN_EDGES 16      // Fewer pulses than this before a gap are treated as noise
+#define ANALYZER_MAX_FRAMES 3   // Repeats an analyzer capture collects, enough for a 2 of 3 vote
+#define ANALYZER_MAX_WAIT 50000 // Longest an analyzer capture waits for repeats after its first frame (us)
+#define NOISE_FLOOR_US 100      // The ISR drops pulses this short (us) as noise
+#define TPMS_NOISE_FLOOR_US 30  // Lower floor in TPMS mode, Manchester chips can be ~50us
+#define BATCH_DEFAULT_DIR "/recordedFilteredAll"  // Where saveFiltered() puts captures
+#define HISTORY_SHOW_COUNT 12   // Newest decoded events showHistory() lists
+const float BIN_RAW_GAP_MULTIPLIER = FRAME_GAP_MULTIPLIER;  // A low pulse longer than (TE * GAP_MULTIPLIER) is considered a gap
 const uint16_t BIN_RAW_TE_MIN_COUNT = 5;  // Minimum number of high pulses to compute TE
 
 //---------------------------------------------------------------------------//
@@ -42,14 +70,14 @@ extern uint32_t actualFreq;
 #include <vector>
 
 struct Signal {
-    std::vector<int64_t> samples;
+    PackedPulseBuffer samples;
 
-    void addSample(int64_t sample) {
+    void addSample(PulseDuration sample) {
         samples.push_back(sample);
     }
 
-    int64_t getSample(std::size_t index) const {
-        return samples[index];
+    PulseView view() const {
+        return samples.view();
     }
 
     bool empty() const {
@@ -65,41 +93,52 @@ struct Signal {
     }
 };
 
+// Capture history. Oldest captures are dropped once the arena is full.
+// Signals come back expanded; stored() on the view gives the compact form.
 struct SignalCollection {
-    std::vector<Signal> signals;
-    std::vector<Signal> ABSsignals;
+    CaptureArena<CAPTURE_ARENA_WORDS, CAPTURE_ARENA_RECORDS> captures;
 
-    Signal& getSignal(size_t i) {
-        return signals.at(i);
+    RepeatedView getSignal(size_t i) const {
+        return RepeatedView(captures.at(i), captures.repeatsAt(i));
     }
 
-     Signal& getABSSignal(size_t i) {
-        return ABSsignals.at(i);
+    RepeatedView getSignal(CaptureHandle handle) const {
+        return RepeatedView(captures.get(handle), captures.repeats(handle));
     }
 
-    void addSignal(const Signal& signal) {
-        signals.push_back(signal);
+    RepeatedView lastSignal() const {
+        return captures.empty() ? RepeatedView() : getSignal(captures.size() - 1);
     }
 
-     void addABSSignal(const Signal& signal) {
-        ABSsignals.push_back(signal);
+    CaptureHandle addSignal(PulseView signal, const RepeatInfo& repeats = RepeatInfo()) {
+        return captures.store(signal, repeats);
     }
 
-
     std::size_t size() const {
-        return signals.size();
+        return captures.size();
     }
 
     bool empty() const {        
-        return signals.empty();
+        return captures.empty();
     }
 
     void clear() {
-        signals.clear();
-        ABSsignals.clear();
+        captures.clear();
     }
 };
 
+// What analyse() leaves for saveCapture(): the frame to save as a .sub and
+// its timing, else the BinRAW frames, and the fingerprint to file it under.
+struct CaptureSave {
+    SignalFingerprint print;
+    uint32_t frameStart = 0;
+    uint32_t frameLength = 0;       // 0 if no frame had a 1:n timing
+    FrameTiming timing;             // of that frame
+    uint16_t repeats = 0;
+    size_t binRawKept = 0;
+    BinRawFrame binRawFrames[BINRAW_MAX_FRAMES];
+};
+
 enum RFProtocol {
     CAME,
     NICE,
@@ -141,10 +180,10 @@ struct CC1101TH {
 
 
 
-
-
 class CC1101_CLASS {
 public:
+    CC1101_CLASS();
+
     static SignalCollection allData;
     float CC1101_DRATE = 115.051;
     float CC1101_RX_BW = 650.00;
@@ -159,10 +198,9 @@ public:
 
 
     struct ReceivedData {
-        std::vector<int64_t> samples;
+        std::vector<PulseDuration> samples;
         std::vector<Signal> signals;
-        std::vector<int64_t> filtered;
-        std::vector<int64_t> filtered4;
+        std::vector<PulseDuration> filtered;
         volatile unsigned long lastReceiveTime = 0;
         volatile unsigned long sampleCount = 0;
         volatile unsigned long normalizedCount = 0;
@@ -174,6 +212,19 @@ public:
     };
 
     static ReceivedData receivedData;
+    static EdgeRing<EDGE_RING_SIZE> edgeRing;
+    static PulseBlockBuffer streamBlocks;
+    static bool streamingEnabled;
+    static TriggeredCapture trigger;
+    static bool triggerEnabled;
+    static FrameAssembler frameAssembler;
+    static CaptureCollector analyzerCapture;
+    static FrameTimeStats frameTimes;
+    static EdgeRingSource<EDGE_RING_SIZE> ringSource;
+    static PulseSource* pulseSource;
+    static PulseHistogram pulseHistogram;
+    static bool tpmsEnabled;
+    static volatile uint32_t noiseFloor;   // Read by the ISR, see NOISE_FLOOR_US
 
     bool init();
     RCSwitch getRCSwitch();
@@ -184,6 +235,28 @@ public:
     void enableRCSwitch();
     void setFrequency(float freq);
     void enableReceiver();
+    void enableReceiverStreaming();
+    bool pollStream();
+    void setPulseSource(PulseSource* source);
+    void enableReceiverTriggered();
+    bool pollTriggered();
+    // Continuous TPMS receive on an FSK preset; FM476 unless one is selected.
+    void enableReceiverTpms();
+    bool pollTpms();
+    const TpmsSensorTable& getTpmsSensors() const {
+        return tpms.sensors();
+    }
+    const DecoderMetrics& getDecoderMetrics() const {
+        return decoderMetrics;
+    }
+    void resetDecoderMetrics();
+    // Decodes the .sub files in dirPath in the background, see BatchDecoder.
+    BatchStart startBatchDecode(const char* dirPath);
+    BatchProgress getBatchProgress() const {
+        return batchDecoder.progress();
+    }
+    bool pollBatchDecode();
+    void cancelBatchDecode();
     void setSync(int sync);
     void setPTK(int ptk);
     void enableTransmit();
@@ -191,6 +264,13 @@ public:
     void saveSignal();
     void handleSignal();
     bool CheckReceived(void);
+    bool submitCapture(PulseView capture, uint32_t endTime);
+    void storeCapture(PulseView capture);
+    bool pollDecodeResults();
+    // A capture is waiting for or in analysis on the decoder worker.
+    bool decoding() const;
+    bool drainEdges();
+    void recordFrameLatency(uint32_t endTime);
     void initRaw();
     void sendRaw();
     void sendSamples(int timings[], int timingsLength, bool levelFlag);
@@ -200,37 +280,65 @@ public:
     void sendByteSequence(const uint8_t sequence[], const uint16_t pulseWidth, const uint8_t messageLength);
     void enableScanner(float start, float stop);
     void emptyReceive();
-    void filterSignal();
-    bool decode();
-    bool checkReversed(int64_t big);
-    void reverseLogicState();
-    void filterAll(); 
+    bool analyse(PulseView capture, DecodeOutcome& outcome, CaptureSave& save);
+    void saveCapture(PulseView capture, DecodeOutcome& outcome, const CaptureSave& save);
+    void filterAll(PulseView capture, const CaptureSave& save);
+    void saveFiltered(uint16_t repeatCount, const String& name);
+    size_t findBinRaw(size_t frameCount, BinRawSignal& first, size_t& firstFrame, BinRawFrame* frames);
+    void saveBinRaw(const CaptureSave& save, uint32_t te, const String& name);
+    // Compiles the flex specs in path, one per line, and registers them after
+    // the built-in decoders, replacing those of an earlier load. Returns how
+    // many were added.
+    size_t loadFlexDecoders(const char* path = FLEX_SPEC_PATH);
+    // Opens the fingerprint index on SD; returns how many captures it knows.
+    size_t loadFingerprints();
+    // Opens the decoded-event history on SD; returns how many events it holds.
+    size_t loadHistory();
+    // Puts the newest events of the history on screen; refused while a
+    // batch decode is reading SD.
+    bool showHistory();
     void sendEncoded(RFProtocol protocol, float frequency, int16_t bitLenght, int8_t repeats, int64_t code);
 
     void SaveToSD();
 private:
     //decoder instances
-    HormannProtocol hormannProtocol;
-    CameProtocol cameProtocol;
-    AnsonicProtocol ansonicProtocol;
+    ShippedProtocols shipped;               // What registerProtocols() adds; sendEncoded() encodes with it too
     HoltekProtocol holtekProtocol;
-    NiceFloProtocol niceFloProtocol;
-    SMC5326Protocol  smc5326Protocol;
-    KiaProtocol kiaProtocol;
-    KeeLoqProtocolDecoder keeloqDecoder;
-    //TPMSProtocolDecoder tpmsDecoder;
+    FlexDecoder flexDecoders[FLEX_MAX_DECODERS];   // Protocols from SD, see loadFlexDecoders()
+    TpmsMonitor tpms;
+    ProtocolRegistry protocols;
+    DecoderMetrics decoderMetrics;          // Per-decoder counters of live captures
+    CaptureDecoder captureDecoder{protocols, pulseHistogram, &decoderMetrics};
+    BatchDecoder batchDecoder{protocols, pulseHistogram};   // Shares the decoders, see submitCapture(), not the counters
+    BatchProgress batchShown;               // Last progress pollBatchDecode() put on screen
 
     
 
 
 
     String generateFilename(float frequency, int modulation, float bandwidth);
+    String generateFilename(const SignalFingerprint& print);
+    String labelCapture(const SignalFingerprint& print, DecodeOutcome& outcome);
+    void recordEvent(const DecodeOutcome& outcome);
     String generateRandomString(int length);
+    std::vector<uint8_t> customPresetData();
+    void registerProtocols();
+    void showOutcome(const DecodeOutcome& outcome);
    
 
     bool levelFlag;                         // Current GPIO level
     timer_idx_t timerIndex = TIMER_0;               // Timer index
-    std::vector<uint64_t> pulses;
+    FrameSegmenter frameSegmenter{BIN_RAW_GAP_MULTIPLIER, BIN_RAW_TE_MIN_COUNT, FRAME_MIN_EDGES};
+    std::vector<PulseDuration> storeSamples;    // Copy storeCapture() splits, UI task only
+    // Owned by whichever task runs analyse(), see decoding().
+    std::vector<PulseDuration> decodeSamples;
+    FrameSegmenter decodeSegmenter{BIN_RAW_GAP_MULTIPLIER, BIN_RAW_TE_MIN_COUNT, FRAME_MIN_EDGES, &pulseHistogram};
+    BinRawAnalyzer binRaw{pulseHistogram};  // Line code of captures no decoder took
+    CaptureSave captureSaves[DECODE_QUEUE_DEPTH];   // One per worker slot, read by pollDecodeResults()
+    CaptureSave directSave;                 // For captures analysed on the UI task
+    FingerprintIndex fingerprints;          // Every capture saved, see labelCapture()
+    EventHistory history;                   // Every capture decoded, see recordEvent()
+    DecodeWorker decodeWorker;              // Runs analyse() off the UI task, see submitCapture()
    
 };
 
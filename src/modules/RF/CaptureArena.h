@@ -0,0 +1,208 @@
+#ifndef CAPTURE_ARENA_H
+#define CAPTURE_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include "PackedPulses.h"
+#include "RepeatedCapture.h"
+
+// Refers to one stored capture. Stays cheap to copy; once the capture has
+// been evicted the handle simply resolves to an empty view.
+struct CaptureHandle {
+    uint32_t id = 0;
+
+    bool valid() const {
+        return id != 0;
+    }
+};
+
+/**
+ * Capture history in one preallocated arena.
+ *
+ * Captures are packed (see PackedPulses.h) into a fixed block of int16 words
+ * that is written front to back like a ring. A capture always occupies one
+ * contiguous run of words, so it can be handed out as a PulseView without a
+ * copy. When the next capture does not fit, the oldest ones are evicted: each
+ * eviction just advances the record index, never moves data and never touches
+ * the heap, so memory use is fixed for the whole session. A capture stored with
+ * RepeatInfo keeps only the first copy of its repeated frame.
+ */
+template <size_t Words, size_t MaxRecords>
+class CaptureArena {
+    static_assert(Words > 0 && MaxRecords > 0, "CaptureArena needs storage");
+
+public:
+    CaptureArena() {
+        clear();
+    }
+
+    // Packs pulses into the arena, evicting old captures as needed. Returns an
+    // invalid handle if the capture is empty or larger than the whole arena.
+    CaptureHandle store(PulseView pulses, const RepeatInfo& repeats = RepeatInfo()) {
+        const size_t skipFrom = repeats.start + repeats.length;
+        const size_t skipTo = skipFrom + repeats.elided();
+        size_t need = 0;
+        size_t index = 0;
+        for (PulseDuration pulse : pulses) {
+            if (index < skipFrom || index >= skipTo) {
+                need += packedWordCount(pulse);
+            }
+            index++;
+        }
+        if (need == 0 || need > Words) {
+            rejectedCount++;
+            return CaptureHandle();
+        }
+
+        size_t offset = writePos;
+        if (offset + need > Words) {
+            // Wrap: the tail behind writePos only holds the oldest captures.
+            while (count > 0 && records[oldest].offset >= writePos) {
+                evictOldest();
+            }
+            offset = 0;
+        }
+        while (count > 0 && (count == MaxRecords ||
+                             (records[oldest].offset >= offset && records[oldest].offset < offset + need))) {
+            evictOldest();
+        }
+        if (count == 0) {
+            offset = 0;
+        }
+
+        int16_t* out = words + offset;
+        index = 0;
+        for (PulseDuration pulse : pulses) {
+            if (index < skipFrom || index >= skipTo) {
+                out += packPulse(pulse, out);
+            }
+            index++;
+        }
+
+        Record& record = records[(oldest + count) % MaxRecords];
+        record.offset = static_cast<uint32_t>(offset);
+        record.wordCount = static_cast<uint32_t>(need);
+        record.pulseCount = static_cast<uint32_t>(pulses.size() - repeats.elided());
+        record.id = nextId++;
+        record.repeats = repeats;
+        count++;
+        writePos = offset + need;
+        liveWords += need;
+        if (liveWords > highWater) {
+            highWater = liveWords;
+        }
+
+        CaptureHandle handle;
+        handle.id = record.id;
+        return handle;
+    }
+
+    // Pulses of a stored capture, or an empty view if it has been evicted.
+    PulseView get(CaptureHandle handle) const {
+        if (!handle.valid() || count == 0) {
+            return PulseView();
+        }
+        const uint32_t age = handle.id - records[oldest].id;
+        if (age >= count) {
+            return PulseView();
+        }
+        return view(records[(oldest + age) % MaxRecords]);
+    }
+
+    // i-th capture counted from the oldest one still stored.
+    PulseView at(size_t i) const {
+        if (i >= count) {
+            return PulseView();
+        }
+        return view(records[(oldest + i) % MaxRecords]);
+    }
+
+    PulseView latest() const {
+        return count ? at(count - 1) : PulseView();
+    }
+
+    // Repeat info of a stored capture; count == 1 if it was stored as is.
+    RepeatInfo repeats(CaptureHandle handle) const {
+        if (!handle.valid() || count == 0) {
+            return RepeatInfo();
+        }
+        const uint32_t age = handle.id - records[oldest].id;
+        return age < count ? records[(oldest + age) % MaxRecords].repeats : RepeatInfo();
+    }
+
+    RepeatInfo repeatsAt(size_t i) const {
+        return i < count ? records[(oldest + i) % MaxRecords].repeats : RepeatInfo();
+    }
+
+    void evictOldest() {
+        if (count == 0) {
+            return;
+        }
+        liveWords -= records[oldest].wordCount;
+        oldest = (oldest + 1) % MaxRecords;
+        count--;
+        evictionCount++;
+    }
+
+    void clear() {
+        oldest = 0;
+        count = 0;
+        writePos = 0;
+        liveWords = 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    // Arena usage in bytes: currently live, and the most ever live at once.
+    size_t usedBytes() const {
+        return liveWords * sizeof(int16_t);
+    }
+
+    size_t highWaterBytes() const {
+        return highWater * sizeof(int16_t);
+    }
+
+    uint32_t evictions() const {
+        return evictionCount;
+    }
+
+    uint32_t rejected() const {
+        return rejectedCount;
+    }
+
+    static constexpr size_t capacityBytes() {
+        return Words * sizeof(int16_t);
+    }
+
+private:
+    struct Record {
+        uint32_t offset;
+        uint32_t wordCount;
+        uint32_t pulseCount;
+        uint32_t id;
+        RepeatInfo repeats;
+    };
+
+    PulseView view(const Record& record) const {
+        return PulseView(words + record.offset, record.wordCount, record.pulseCount);
+    }
+
+    int16_t words[Words];
+    Record records[MaxRecords];
+    size_t oldest;
+    size_t count;
+    size_t writePos;
+    size_t liveWords;
+    size_t highWater = 0;
+    uint32_t nextId = 1;
+    uint32_t evictionCount = 0;
+    uint32_t rejectedCount = 0;
+};
+
+#endif // CAPTURE_ARENA_H
@@ -0,0 +1,161 @@
+#include "CaptureDecoder.h"
+#include <cstdio>
+#include <string>
+#include <utility>
+
+// A high far longer than the long pulse means the levels came in inverted.
+static bool isReversed(PulseView frame, int64_t longPulse) {
+    for (PulseDuration sample : frame) {
+        if (sample > longPulse * 13) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const FrameTiming& CaptureDecoder::measure(PulseView frame) {
+    // Durations cluster on a log-scale histogram in one pass; the two most
+    // populated clusters are the short and long pulse.
+    histogram.build(frame);
+    return measure(frame, histogram.widths());
+}
+
+const FrameTiming& CaptureDecoder::measure(const FrameSegmenter& segmenter, size_t index) {
+    if (!segmenter.clustered()) {
+        return measure(segmenter.frame(index));
+    }
+    return measure(segmenter.frame(index), segmenter.widths(index));
+}
+
+const FrameTiming& CaptureDecoder::measure(PulseView frame, const PulseWidths& widths) {
+    current = FrameTiming();
+    if (widths.clusters == 0) {
+        return current;
+    }
+    if (widths.clusters == 1) {
+        current.shortPulse = widths.first;
+        return current;
+    }
+
+    int64_t rep1 = widths.first;
+    int64_t rep2 = widths.second;
+    if (rep1 > rep2) {
+        std::swap(rep1, rep2);
+    }
+
+    // Snap onto the 1:(n-1) ratio, n = 3..10, whose short pulse lies
+    // closest to rep1; the first one wins a tie.
+    int64_t bestSmall = (rep1 + rep2) / 3;
+    int64_t bestDivisor = 3;
+    for (int64_t divisor = 4; divisor <= 10; divisor++) {
+        const int64_t small = (rep1 + rep2) / divisor;
+        if (DURATION_DIFF(rep1, small) < DURATION_DIFF(rep1, bestSmall)) {
+            bestSmall = small;
+            bestDivisor = divisor;
+        }
+    }
+    const int64_t bestLong = bestSmall * (bestDivisor - 1);
+    current.reversed = isReversed(frame, rep2);
+
+    if (DURATION_DIFF(bestSmall, rep1) < 40 && DURATION_DIFF(bestLong, rep2) < 80) {
+        current.shortPulse = static_cast<uint32_t>(bestSmall);
+        current.longPulse = static_cast<uint32_t>(bestLong);
+        current.quantizer.configure(current.shortPulse, current.longPulse);
+    } else {
+        current.shortPulse = static_cast<uint32_t>(rep1);
+        current.longPulse = static_cast<uint32_t>(rep2);
+    }
+    return current;
+}
+
+// Feeds the frame in a single pass to every registered decoder whose timing
+// window holds the measured short and long pulse, and votes for each code
+// as soon as its decoder completes.
+size_t CaptureDecoder::decodeFrame(PulseView frame, uint16_t frameIndex, DecodeVote& vote) {
+    if (!current.measured()) {
+        return 0;
+    }
+    SubGhzDecoder* candidates[PROTOCOL_REGISTRY_SIZE];
+    const size_t candidateCount =
+        protocols.candidates(current.shortPulse, current.longPulse, candidates, PROTOCOL_REGISTRY_SIZE);
+    if (metrics) {
+        // Both lists are in registration order.
+        for (size_t i = 0, next = 0; i < protocols.size(); i++) {
+            const bool candidate = next < candidateCount && candidates[next] == &protocols[i];
+            metrics->offered(protocols[i], candidate);
+            next += candidate;
+        }
+    }
+    receiver.setMetrics(metrics);
+    receiver.setDecodeCallback([&vote, frameIndex](SubGhzDecoder& decoder) {
+        FrameDecode decoded;
+        decoded.protocol = decoder.name();
+        decoded.code = decoder.code();
+        decoded.identity = decoder.identity();
+        decoded.bits = decoder.bits();
+        vote.add(decoded, frameIndex);
+    });
+    receiver.begin(candidates, candidateCount, current.quantizer, current.reversed);
+    return receiver.run(frame);
+}
+
+void CaptureDecoder::countOutvoted(const DecodeVote& vote, const DecodeResult& result) {
+    if (!metrics) {
+        return;
+    }
+    FrameDecode winning;
+    winning.protocol = result.protocol;
+    winning.code = result.code;
+    winning.bits = result.bits;
+    for (size_t i = 0; i < vote.candidateCount(); i++) {
+        if (!vote.candidate(i).sameCode(winning)) {
+            metrics->reject(vote.candidate(i).protocol, DecodeReject::Outvoted, vote.votes(i));
+        }
+    }
+}
+
+bool CaptureDecoder::describe(PulseView frame, DecodeResult& result) {
+    result.te = current.shortPulse;
+    SubGhzDecoder* winner = result.valid() ? protocols.find(result.protocol) : nullptr;
+    if (!winner) {
+        return false;
+    }
+    // Not counted again: the frame was booked when it was voted on.
+    receiver.setDecodeCallback(nullptr);
+    receiver.setMetrics(nullptr);
+    receiver.begin(&winner, 1, current.quantizer, current.reversed);
+    if (receiver.run(frame) == 0) {
+        return false;
+    }
+    const std::string text = winner->describe(current.shortPulse, current.longPulse);
+    snprintf(result.text, sizeof(result.text), "%s", text.c_str());
+    // What the decoder scaled its windows to beats the histogram.
+    if (winner->te() != 0) {
+        result.te = winner->te();
+    }
+    return true;
+}
+
+DecodeResult CaptureDecoder::decode(const PulseDuration* samples, size_t count, FrameSegmenter& segmenter,
+                                    RepeatInfo* repeatsOut) {
+    const size_t frameCount = segmenter.split(samples, count);
+    const RepeatInfo repeats = findRepeats(samples, count, segmenter);
+    if (repeatsOut) {
+        *repeatsOut = repeats;
+    }
+    DecodeVote vote;
+    vote.reset(static_cast<uint16_t>(frameCount));
+    for (size_t i = 0; i < frameCount; i++) {
+        measure(segmenter, i);
+        decodeFrame(segmenter.frame(i), static_cast<uint16_t>(i), vote);
+    }
+
+    DecodeResult result = vote.result();
+    countOutvoted(vote, result);
+    if (result.valid()) {
+        measure(segmenter, vote.winningFrame());
+        describe(segmenter.frame(vote.winningFrame()), result);
+        result.repeats = repeats.count;
+    }
+    return result;
+}
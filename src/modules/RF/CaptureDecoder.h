@@ -0,0 +1,81 @@
+#ifndef CAPTURE_DECODER_H
+#define CAPTURE_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "DecodeResult.h"
+#include "DecoderMetrics.h"
+#include "FrameSegmenter.h"
+#include "PackedPulses.h"
+#include "ProtocolRegistry.h"
+#include "PulseHistogram.h"
+#include "PulseReceiver.h"
+#include "RepeatedCapture.h"
+
+// Short and long pulse of one frame, see CaptureDecoder::measure().
+struct FrameTiming {
+    uint32_t shortPulse = 0;    // 0 if the frame had no pulses
+    uint32_t longPulse = 0;     // 0 if it had a single width
+    bool reversed = false;      // levels are inverted
+    PulseQuantizer quantizer;   // enabled if the pulses fit a 1:n ratio
+
+    bool measured() const {
+        return longPulse != 0;
+    }
+};
+
+/**
+ * Protocol decoding of a capture, without the radio or the SD card around
+ * it, so live captures, saved .sub files and host tools share one path.
+ *
+ * Each frame is measured on the pulse histogram, fed in one pass to the
+ * registered decoders whose windows hold its timing, and voted on; the
+ * winner is run once more on a frame that produced it for its text. The
+ * decoders are stateful: only one thread may decode through a registry.
+ */
+class CaptureDecoder {
+public:
+    CaptureDecoder(ProtocolRegistry& protocols, PulseHistogram& histogram, DecoderMetrics* metrics = nullptr)
+        : protocols(protocols), histogram(histogram), metrics(metrics) {}
+
+    // Finds the short and long pulse of frame; decodeFrame() and describe()
+    // use the timing of the last frame measured.
+    const FrameTiming& measure(PulseView frame);
+
+    // Same from widths already clustered, such as those FrameSegmenter
+    // finds while it splits a capture.
+    const FrameTiming& measure(PulseView frame, const PulseWidths& widths);
+
+    // Frame index of segmenter, by its widths if it has them.
+    const FrameTiming& measure(const FrameSegmenter& segmenter, size_t index);
+
+    const FrameTiming& timing() const {
+        return current;
+    }
+
+    // Votes for every code the candidate decoders make of frame; returns
+    // how many decoders accepted it.
+    size_t decodeFrame(PulseView frame, uint16_t frameIndex, DecodeVote& vote);
+
+    // Codes that lost the vote count against the decoder that made them.
+    void countOutvoted(const DecodeVote& vote, const DecodeResult& result);
+
+    // Runs the winning decoder on frame, which produced its code, and fills
+    // in the text and te of result. Returns false if it did not decode again.
+    bool describe(PulseView frame, DecodeResult& result);
+
+    // All of the above for a whole capture, split by segmenter; the live
+    // receiver and the batch decode both go through here. repeats, if
+    // given, gets where the capture repeats itself.
+    DecodeResult decode(const PulseDuration* samples, size_t count, FrameSegmenter& segmenter,
+                        RepeatInfo* repeats = nullptr);
+
+private:
+    ProtocolRegistry& protocols;
+    PulseHistogram& histogram;
+    DecoderMetrics* metrics;
+    PulseReceiver receiver;
+    FrameTiming current;
+};
+
+#endif // CAPTURE_DECODER_H
@@ -0,0 +1,81 @@
+#include "DecodeResult.h"
+#include <cstring>
+
+bool FrameDecode::sameCode(const FrameDecode& other) const {
+    return valid() && other.valid() && code == other.code && bits == other.bits &&
+           std::strcmp(protocol, other.protocol) == 0;
+}
+
+uint64_t reverseBits(uint64_t code, uint8_t bits) {
+    uint64_t reversed = 0;
+    for (uint8_t i = 0; i < bits; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    return reversed;
+}
+
+void DecodeVote::reset(uint16_t frames) {
+    count = 0;
+    decodedCount = 0;
+    frameCount = frames;
+    lastDecodedFrame = -1;
+}
+
+void DecodeVote::add(const FrameDecode& decode, uint16_t frameIndex) {
+    if (!decode.valid()) {
+        return;
+    }
+    // Several decoders may accept the same frame; it still counts once.
+    if (frameIndex != lastDecodedFrame) {
+        decodedCount++;
+        lastDecodedFrame = frameIndex;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (candidates[i].decode.sameCode(decode)) {
+            candidates[i].votes++;
+            return;
+        }
+    }
+    if (count < VOTE_MAX_CANDIDATES) {
+        candidates[count].decode = decode;
+        candidates[count].votes = 1;
+        candidates[count].firstFrame = frameIndex;
+        count++;
+    }
+}
+
+const DecodeVote::Candidate* DecodeVote::winner() const {
+    const Candidate* best = nullptr;
+    for (size_t i = 0; i < count; i++) {
+        // Ties go to the code seen first.
+        if (!best || candidates[i].votes > best->votes) {
+            best = &candidates[i];
+        }
+    }
+    return best;
+}
+
+DecodeResult DecodeVote::result() const {
+    DecodeResult result;
+    result.decoded = decodedCount;
+    result.frames = frameCount;
+    const Candidate* best = winner();
+    if (!best) {
+        return result;
+    }
+    result.protocol = best->decode.protocol;
+    result.code = best->decode.code;
+    result.identity = best->decode.identity;
+    result.bits = best->decode.bits;
+    result.reversed = reverseBits(result.code, result.bits);
+    result.agreeing = best->votes;
+    // Share of decoded frames that agree, discounted for small samples: one
+    // clean frame gives 50%, three out of three 75%, nine out of ten 82%.
+    result.confidence = static_cast<uint8_t>(100u * best->votes / (decodedCount + 1u));
+    return result;
+}
+
+uint16_t DecodeVote::winningFrame() const {
+    const Candidate* best = winner();
+    return best ? best->firstFrame : 0;
+}
@@ -0,0 +1,99 @@
+#ifndef DECODE_RESULT_H
+#define DECODE_RESULT_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define VOTE_MAX_CANDIDATES 8   // distinct codes tracked per capture
+#define DECODE_TEXT_SIZE 192    // decoder's own lines: buttons, DIP switches, serial
+
+// What one decoder made of one frame; protocol is nullptr if nothing matched.
+struct FrameDecode {
+    const char* protocol = nullptr;
+    uint64_t code = 0;
+    uint64_t identity = 0; // SubGhzDecoder::identity() of code
+    uint8_t bits = 0;
+
+    bool valid() const {
+        return protocol != nullptr;
+    }
+
+    bool sameCode(const FrameDecode& other) const;
+};
+
+// Majority-voted outcome of all frames of a capture. Plain data with no
+// display code in it, so decoding can run off the LVGL thread or on a host;
+// DecodeResultView puts it on screen.
+struct DecodeResult {
+    const char* protocol = nullptr; // registry name, which identifies the decoder
+    uint64_t code = 0;
+    uint64_t reversed = 0;  // code with its bit order reversed
+    uint64_t identity = 0;  // part of code that names the remote, see SubGhzDecoder::identity()
+    uint8_t bits = 0;
+    uint32_t te = 0;        // short pulse, us: the decoder's estimate if it adapts, else measured
+    uint16_t repeats = 1;   // identical copies of the frame in the capture
+    uint16_t agreeing = 0;  // frames that decoded to this code
+    uint16_t decoded = 0;   // frames any decoder accepted
+    uint16_t frames = 0;    // frames in the capture
+    uint8_t confidence = 0; // percent, see DecodeVote::result()
+    char text[DECODE_TEXT_SIZE] = {};
+
+    bool valid() const {
+        return agreeing > 0;
+    }
+};
+
+// Lowest bits of code in reverse order.
+uint64_t reverseBits(uint64_t code, uint8_t bits);
+
+/**
+ * Collects the per-frame decodes of one capture and picks the code most
+ * frames agree on, so a single corrupted repetition cannot win on its own.
+ */
+class DecodeVote {
+public:
+    DecodeVote() {
+        reset(0);
+    }
+
+    void reset(uint16_t frameCount);
+
+    // Frames are added in order; one frame may be added once per decoder
+    // that accepted it.
+    void add(const FrameDecode& decode, uint16_t frameIndex);
+
+    DecodeResult result() const;
+
+    // First frame that decoded to the winning code, for displaying it.
+    uint16_t winningFrame() const;
+
+    // Every distinct code seen, winner included, and the frames behind it.
+    size_t candidateCount() const {
+        return count;
+    }
+
+    const FrameDecode& candidate(size_t i) const {
+        return candidates[i].decode;
+    }
+
+    uint16_t votes(size_t i) const {
+        return candidates[i].votes;
+    }
+
+private:
+    struct Candidate {
+        FrameDecode decode;
+        uint16_t votes;
+        uint16_t firstFrame;
+    };
+
+    const Candidate* winner() const;
+
+    Candidate candidates[VOTE_MAX_CANDIDATES];
+    size_t count;
+    uint16_t decodedCount;
+    uint16_t frameCount;
+    int32_t lastDecodedFrame;
+};
+
+#endif // DECODE_RESULT_H
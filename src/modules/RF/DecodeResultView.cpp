@@ -0,0 +1,157 @@
+#include "DecodeResultView.h"
+#include "Arduino.h"
+#include "GUI/ScreenManager.h"
+#include "globals.h"
+#include <cstdio>
+
+lv_obj_t* DecodeResultView::textArea() {
+    ScreenManager& screenMgr = ScreenManager::getInstance();
+    if (C1101preset == CUSTOM) {
+        return screenMgr.text_area_SubGHzCustom;
+    }
+    return screenMgr.getTextArea();
+}
+
+void DecodeResultView::show(const DecodeResult& result) {
+    Serial.printf("%s 0x%llX: %u of %u frames agree, confidence %u%%\n", result.protocol,
+                  static_cast<unsigned long long>(result.code), result.agreeing, result.decoded, result.confidence);
+
+    lv_obj_t* textarea = textArea();
+    if (textarea == nullptr) {
+        Serial.println(result.text);
+        return;
+    }
+    if (result.text[0] != '\0') {
+        lv_textarea_set_text(textarea, result.text);
+    } else {
+        // The decoder had nothing to add beyond the key.
+        char key[64];
+        snprintf(key, sizeof(key), "\n%s %ubit\r\nKey:0x%llX\r\n", result.protocol, result.bits,
+                 static_cast<unsigned long long>(result.code));
+        lv_textarea_set_text(textarea, key);
+    }
+    char line[64];
+    snprintf(line, sizeof(line), "\nFrames: %u/%u (%u%%)\nTE: %luus", result.agreeing, result.decoded,
+             result.confidence, static_cast<unsigned long>(result.te));
+    lv_textarea_add_text(textarea, line);
+}
+
+void DecodeResultView::show(const BinRawSignal& signal) {
+    char text[160];
+    int length = snprintf(text, sizeof(text), "\nBinRAW %s, TE %luus\r\nPreamble %u, sync %u\r\n%u bits:",
+                          lineCodeName(signal.code), static_cast<unsigned long>(signal.te), signal.preamble,
+                          signal.sync, signal.bits);
+    for (size_t i = 0; i < static_cast<size_t>((signal.bits + 7) / 8) && length > 0 &&
+                       static_cast<size_t>(length) + 4 < sizeof(text);
+         i++) {
+        length += snprintf(text + length, sizeof(text) - length, " %02X", signal.data[i]);
+    }
+    Serial.println(text);
+
+    lv_obj_t* textarea = textArea();
+    if (textarea != nullptr) {
+        lv_textarea_set_text(textarea, text);
+    }
+}
+
+void DecodeResultView::show(const DecodeOutcome& outcome) {
+    if (outcome.result.valid()) {
+        show(outcome.result);
+    } else if (outcome.binRaw.bits != 0) {
+        show(outcome.binRaw);
+    } else {
+        // Neither a protocol nor a line code; it may still have been saved.
+        Serial.println("No match");
+        lv_obj_t* textarea = textArea();
+        if (textarea != nullptr) {
+            lv_textarea_set_text(textarea, outcome.found ? "\nNo match, saved as RAW" : "\nNo match");
+        }
+    }
+    if (outcome.label[0] == '\0') {
+        return;
+    }
+    char line[64];
+    snprintf(line, sizeof(line), "\n%s %s", outcome.known ? "Seen before:" : "New:", outcome.label);
+    Serial.println(line);
+    lv_obj_t* textarea = textArea();
+    if (textarea != nullptr) {
+        lv_textarea_add_text(textarea, line);
+    }
+}
+
+void DecodeResultView::show(const TpmsSensorTable& sensors) {
+    lv_obj_t* textarea = textArea();
+    if (textarea != nullptr) {
+        lv_textarea_set_text(textarea, "");
+    }
+    for (size_t i = 0; i < sensors.size(); i++) {
+        const TPMSGenericData& reading = sensors[i].reading;
+        char line[80];
+        snprintf(line, sizeof(line), "%s %08lX: %.0fkPa %.0fC%s x%u\n", reading.protocolName.c_str(),
+                 static_cast<unsigned long>(reading.id), reading.pressure, reading.temperature,
+                 reading.batteryLow ? " LOW" : "", sensors[i].packets);
+        Serial.print(line);
+        if (textarea != nullptr) {
+            lv_textarea_add_text(textarea, line);
+        }
+    }
+}
+
+void DecodeResultView::show(const DecoderMetrics& metrics) {
+    static char csv[128 + PROTOCOL_REGISTRY_SIZE * 96];
+    if (metrics.format(csv, sizeof(csv)) > 0) {
+        Serial.print(csv);
+    }
+
+    lv_obj_t* textarea = textArea();
+    if (textarea == nullptr) {
+        return;
+    }
+    lv_textarea_set_text(textarea, "offered/synced/decoded\ntiming nosync incompl. outvoted\n");
+    for (size_t i = 0; i < metrics.size(); i++) {
+        const DecoderCounters& row = metrics[i];
+        char line[96];
+        snprintf(line, sizeof(line), "%s %lu/%lu/%lu\n %lu %lu %lu %lu, %lu/pulse\n", row.name,
+                 static_cast<unsigned long>(row.offered), static_cast<unsigned long>(row.synced),
+                 static_cast<unsigned long>(row.decoded),
+                 static_cast<unsigned long>(row.rejects(DecodeReject::Timing)),
+                 static_cast<unsigned long>(row.rejects(DecodeReject::NoSync)),
+                 static_cast<unsigned long>(row.rejects(DecodeReject::Incomplete)),
+                 static_cast<unsigned long>(row.rejects(DecodeReject::Outvoted)),
+                 static_cast<unsigned long>(row.pulses ? row.cycles / row.pulses : 0));
+        lv_textarea_add_text(textarea, line);
+    }
+}
+
+void DecodeResultView::show(const DecodedEvent* events, size_t count) {
+    lv_obj_t* textarea = textArea();
+    if (textarea != nullptr) {
+        lv_textarea_set_text(textarea, count ? "" : "No decoded events yet.\n");
+    }
+    for (size_t i = 0; i < count; i++) {
+        const DecodedEvent& event = events[i];
+        char line[96];
+        snprintf(line, sizeof(line), "#%lu %lus %.2fMHz %s %u bits %llX %ddBm\n", static_cast<unsigned long>(event.seq),
+                 static_cast<unsigned long>(event.time), event.frequency / 1e6, event.protocol, event.bits,
+                 static_cast<unsigned long long>(event.key), event.rssi);
+        Serial.print(line);
+        if (textarea != nullptr) {
+            lv_textarea_add_text(textarea, line);
+        }
+    }
+}
+
+void DecodeResultView::show(const BatchProgress& progress) {
+    char text[128];
+    snprintf(text, sizeof(text), "\nBatch decode%s\n%lu of %lu files\n%lu decoded, %lu BinRAW\n",
+             progress.running ? "" : " done", static_cast<unsigned long>(progress.done),
+             static_cast<unsigned long>(progress.files), static_cast<unsigned long>(progress.decoded),
+             static_cast<unsigned long>(progress.binRaw));
+    if (!progress.running) {
+        Serial.print(text);
+    }
+    lv_obj_t* textarea = textArea();
+    if (textarea != nullptr) {
+        lv_textarea_set_text(textarea, text);
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef DECODE_RESULT_VIEW_H
+#define DECODE_RESULT_VIEW_H
+
+#include "DecodeResult.h"
+#include "BinRawAnalyzer.h"
+#include "TpmsMonitor.h"
+#include "DecodeWorker.h"
+#include "DecoderMetrics.h"
+#include "BatchDecoder.h"
+#include "EventHistory.h"
+#include "lvgl.h"
+
+/**
+ * Puts a DecodeResult on the Sub-GHz screen. The decode path itself only
+ * fills in the result, so this is the one place it meets LVGL; call it from
+ * the LVGL thread.
+ */
+class DecodeResultView {
+public:
+    static void show(const DecodeResult& result);
+
+    // Line code, te and data of a capture no decoder took.
+    static void show(const BinRawSignal& signal);
+
+    // Whichever of the two the decoder worker came up with, or no match.
+    static void show(const DecodeOutcome& outcome);
+
+    // Every sensor heard in TPMS mode, with its last reading.
+    static void show(const TpmsSensorTable& sensors);
+
+    // Per-decoder counters: a short line each on screen, the CSV on Serial.
+    static void show(const DecoderMetrics& metrics);
+
+    // How far a batch decode of saved captures has got.
+    static void show(const BatchProgress& progress);
+
+    // Decoded events from the history, a line each.
+    static void show(const DecodedEvent* events, size_t count);
+
+private:
+    // Text area of the screen the capture was started from.
+    static lv_obj_t* textArea();
+};
+
+#endif // DECODE_RESULT_VIEW_H
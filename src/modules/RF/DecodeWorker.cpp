@@ -0,0 +1,94 @@
+#include "DecodeWorker.h"
+
+#if defined(ESP32)
+#include <esp_timer.h>
+#include <freertos/task.h>
+#else
+#include <chrono>
+#endif
+
+DecodeWorker::DecodeWorker(Analyse analyse)
+    : analyse(std::move(analyse)), inFlight(0), droppedCount(0), started(false) {
+    for (uint8_t i = 0; i < DECODE_QUEUE_DEPTH; i++) {
+        freeJobs.send(i);
+    }
+}
+
+bool DecodeWorker::start() {
+#if defined(ESP32)
+    if (!started) {
+        started = xTaskCreatePinnedToCore(task, "DecodeWorker", DECODE_WORKER_STACK, this, DECODE_WORKER_PRIORITY,
+                                          nullptr, DECODE_WORKER_CORE) == pdPASS;
+    }
+#endif
+    return started;
+}
+
+void DecodeWorker::task(void* worker) {
+    for (;;) {
+        static_cast<DecodeWorker*>(worker)->process(QUEUE_WAIT_FOREVER);
+    }
+}
+
+bool DecodeWorker::submit(PulseView capture, uint32_t endTime, int16_t rssi) {
+    uint8_t index;
+    if (capture.size() == 0 || !freeJobs.receive(index)) {
+        droppedCount += capture.size() != 0;
+        return false;
+    }
+    Job& job = jobs[index];
+    job.count = 0;
+    for (PulseDuration pulse : capture) {
+        if (job.count == DECODE_JOB_PULSES) {
+            break;
+        }
+        job.samples[job.count++] = pulse;
+    }
+    job.endTime = endTime;
+    job.rssi = rssi;
+    inFlight.fetch_add(1, std::memory_order_relaxed);
+    pending.send(index);
+    return true;
+}
+
+bool DecodeWorker::poll(DecodeOutcome& outcome) {
+    return outcomes.receive(outcome);
+}
+
+PulseView DecodeWorker::capture(uint8_t job) const {
+    return PulseView(jobs[job].samples, jobs[job].count);
+}
+
+void DecodeWorker::release(uint8_t job) {
+    freeJobs.send(job);
+}
+
+bool DecodeWorker::process(uint32_t waitMs) {
+    uint8_t index;
+    if (!pending.receive(index, waitMs)) {
+        return false;
+    }
+    const Job& job = jobs[index];
+    DecodeOutcome outcome;
+    // Set first, as analyse() records them along with the decode.
+    outcome.endTime = job.endTime;
+    outcome.rssi = job.rssi;
+    outcome.job = index;
+    const uint32_t start = nowUs();
+    outcome.found = analyse(PulseView(job.samples, job.count), outcome);
+    outcome.analyseUs = nowUs() - start;
+    outcomes.send(outcome, QUEUE_WAIT_FOREVER);
+    // Release: whoever sees busy() go false also sees what analyse() wrote.
+    inFlight.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+uint32_t DecodeWorker::nowUs() {
+#if defined(ESP32)
+    return static_cast<uint32_t>(esp_timer_get_time());
+#else
+    return static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+#endif
+}
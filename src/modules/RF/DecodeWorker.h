@@ -0,0 +1,103 @@
+#ifndef DECODE_WORKER_H
+#define DECODE_WORKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include "BinRawAnalyzer.h"
+#include "BoundedQueue.h"
+#include "DecodeResult.h"
+#include "PackedPulses.h"
+#include "SignalFingerprint.h"
+
+#define DECODE_QUEUE_DEPTH 2        // captures waiting for or in analysis
+#define DECODE_RESULT_DEPTH 4       // outcomes waiting for the UI
+#define DECODE_JOB_PULSES 2048      // longest capture, longer ones are cut
+#define DECODE_WORKER_CORE 0        // loop() and LVGL run on core 1
+#define DECODE_WORKER_STACK 12288   // decoders, the vote and BinRAW analysis
+#define DECODE_WORKER_PRIORITY 1
+
+// What the worker made of one capture, for the UI to show.
+struct DecodeOutcome {
+    DecodeResult result;        // valid() if a protocol decoder took it
+    BinRawSignal binRaw;        // else its line code, if binRaw.bits
+    uint32_t endTime = 0;       // when its first frame ended, latency counts from here (us)
+    int16_t rssi = 0;           // dBm when the capture was handed over
+    uint32_t analyseUs = 0;     // spent in the worker
+    bool known = false;         // its fingerprint was in the index already
+    bool found = false;         // the analysis returned true: there is something to save
+    uint8_t job = 0;            // slot of the capture, see DecodeWorker::release()
+    // Name it is saved under, empty if it has no fingerprint.
+    char label[FINGERPRINT_LABEL_SIZE] = {};
+};
+
+/**
+ * Runs capture analysis off the UI task.
+ *
+ * The UI side copies each completed capture into one of DECODE_QUEUE_DEPTH
+ * fixed slots and queues its index; the worker task, pinned to the other
+ * core, analyses it and queues the outcome back. Neither queue allocates.
+ * submit() and poll() never wait, so a burst of captures costs the UI a
+ * copy each and is dropped, counted in dropped(), once every slot is taken.
+ * The worker waits for the UI to make room for its outcome instead, so the
+ * order of outcomes is that of the captures. Every analysed capture gets
+ * an outcome, so the UI shows and times those nothing matched too. Its slot
+ * stays taken until the UI has release()d it, so the UI can save the
+ * capture without a copy of its own.
+ */
+class DecodeWorker {
+public:
+    // Analyses one capture on the worker; returns false if there is
+    // nothing to save. Its outcome is queued either way, with found set.
+    using Analyse = std::function<bool(PulseView capture, DecodeOutcome& outcome)>;
+
+    explicit DecodeWorker(Analyse analyse);
+
+    // Starts the task; false if it could not be created, or on a host,
+    // where the caller runs process() itself.
+    bool start();
+
+    // UI side.
+    bool submit(PulseView capture, uint32_t endTime, int16_t rssi = 0);
+    bool poll(DecodeOutcome& outcome);
+    // The capture of a polled outcome, valid until its slot is released.
+    PulseView capture(uint8_t job) const;
+    void release(uint8_t job);
+
+    // Worker side: analyses the next capture, waiting up to waitMs for one.
+    // Returns false if none came.
+    bool process(uint32_t waitMs);
+
+    // A capture is queued or being analysed.
+    bool busy() const {
+        return inFlight.load(std::memory_order_acquire) > 0;
+    }
+
+    uint32_t dropped() const {
+        return droppedCount;
+    }
+
+private:
+    struct Job {
+        PulseDuration samples[DECODE_JOB_PULSES];
+        uint16_t count;
+        uint32_t endTime;
+        int16_t rssi;
+    };
+
+    static void task(void* worker);
+    static uint32_t nowUs();
+
+    Analyse analyse;
+    Job jobs[DECODE_QUEUE_DEPTH];
+    BoundedQueue<uint8_t, DECODE_QUEUE_DEPTH> freeJobs;
+    BoundedQueue<uint8_t, DECODE_QUEUE_DEPTH> pending;
+    BoundedQueue<DecodeOutcome, DECODE_RESULT_DEPTH> outcomes;
+    std::atomic<uint32_t> inFlight;
+    uint32_t droppedCount;
+    bool started;
+};
+
+#endif // DECODE_WORKER_H
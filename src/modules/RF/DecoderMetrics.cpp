@@ -0,0 +1,86 @@
+#include "DecoderMetrics.h"
+#include <cstdio>
+#include <cstring>
+
+const char* rejectName(DecodeReject reason) {
+    switch (reason) {
+    case DecodeReject::Timing:
+        return "timing";
+    case DecodeReject::NoSync:
+        return "nosync";
+    case DecodeReject::Incomplete:
+        return "incomplete";
+    case DecodeReject::Outvoted:
+        return "outvoted";
+    default:
+        return "?";
+    }
+}
+
+DecoderCounters* DecoderMetrics::row(const char* name) {
+    for (size_t i = 0; i < count; i++) {
+        if (std::strcmp(rows[i].name, name) == 0) {
+            return &rows[i];
+        }
+    }
+    if (count == PROTOCOL_REGISTRY_SIZE) {
+        return nullptr;
+    }
+    rows[count] = DecoderCounters();
+    rows[count].name = name;
+    return &rows[count++];
+}
+
+const DecoderCounters* DecoderMetrics::find(const char* name) const {
+    for (size_t i = 0; i < count; i++) {
+        if (std::strcmp(rows[i].name, name) == 0) {
+            return &rows[i];
+        }
+    }
+    return nullptr;
+}
+
+void DecoderMetrics::offered(const SubGhzDecoder& decoder, bool candidate) {
+    DecoderCounters* counters = row(decoder.name());
+    if (counters) {
+        counters->offered++;
+        if (!candidate) {
+            counters->rejected[static_cast<size_t>(DecodeReject::Timing)]++;
+        }
+    }
+}
+
+void DecoderMetrics::reject(const char* name, DecodeReject reason, uint32_t frames) {
+    DecoderCounters* counters = row(name);
+    if (counters) {
+        counters->rejected[static_cast<size_t>(reason)] += frames;
+    }
+}
+
+void DecoderMetrics::reset() {
+    for (size_t i = 0; i < count; i++) {
+        const char* name = rows[i].name;
+        rows[i] = DecoderCounters();
+        rows[i].name = name;
+    }
+}
+
+int DecoderMetrics::format(char* out, size_t size) const {
+    int length = snprintf(out, size, "decoder,offered,synced,decoded,timing,nosync,incomplete,outvoted,pulses,"
+                                     "cycles_per_pulse\n");
+    for (size_t i = 0; i < count && length >= 0; i++) {
+        const DecoderCounters& r = rows[i];
+        const size_t used = static_cast<size_t>(length) < size ? static_cast<size_t>(length) : size;
+        const int added = snprintf(out + used, size - used, "%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\n", r.name,
+                                   static_cast<unsigned long>(r.offered), static_cast<unsigned long>(r.synced),
+                                   static_cast<unsigned long>(r.decoded),
+                                   static_cast<unsigned long>(r.rejects(DecodeReject::Timing)),
+                                   static_cast<unsigned long>(r.rejects(DecodeReject::NoSync)),
+                                   static_cast<unsigned long>(r.rejects(DecodeReject::Incomplete)),
+                                   static_cast<unsigned long>(r.rejects(DecodeReject::Outvoted)),
+                                   static_cast<unsigned long>(r.pulses),
+                                   static_cast<unsigned long>(r.pulses ? r.cycles / r.pulses : 0));
+        length = added < 0 ? added : length + added;
+    }
+    return length;
+}
@@ -0,0 +1,94 @@
+#ifndef DECODER_METRICS_H
+#define DECODER_METRICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "ProtocolRegistry.h"
+
+#if defined(ESP32)
+#include <xtensa/hal.h>
+#else
+#include <chrono>
+#endif
+
+// Why a decoder offered a frame did not produce the winning key from it.
+enum class DecodeReject : uint8_t {
+    Timing,     // the measured short/long pulse is outside its windows
+    NoSync,     // fed the frame, never got past its preamble
+    Incomplete, // lost sync again, bad bit or wrong length
+    Outvoted,   // decoded, but another key won the vote
+    Count
+};
+
+const char* rejectName(DecodeReject reason);
+
+// Counters of one decoder since the last reset.
+struct DecoderCounters {
+    const char* name = nullptr;
+    uint32_t offered = 0;   // frames whose timing could be measured
+    uint32_t synced = 0;    // frames it got past the preamble of
+    uint32_t decoded = 0;   // frames it produced a key from
+    uint32_t rejected[static_cast<size_t>(DecodeReject::Count)] = {};
+    uint32_t pulses = 0;    // fed to it
+    uint64_t cycles = 0;    // spent in its feed(), see DecoderMetrics::cycles()
+
+    uint32_t rejects(DecodeReject reason) const {
+        return rejected[static_cast<size_t>(reason)];
+    }
+};
+
+/**
+ * Per-decoder counters for tuning: how often each decoder is offered a frame,
+ * gets past its preamble, decodes, why it did not, and what its feed() costs.
+ * Rows are keyed by registry name and created on first use, one per name for
+ * the whole session, so reloading flex decoders keeps their history.
+ *
+ * PulseReceiver fills in the per-frame part and CC1101_CLASS the timing and
+ * vote outcome. Written on the decoder worker and read from the UI without a
+ * lock: a reader may see a row mid-update, which is fine for a debug view.
+ */
+class DecoderMetrics {
+public:
+    DecoderMetrics() : count(0) {}
+
+    // Row of name, added if new; nullptr once PROTOCOL_REGISTRY_SIZE names
+    // have rows.
+    DecoderCounters* row(const char* name);
+    const DecoderCounters* find(const char* name) const;
+
+    // A frame the decoder's windows did or did not take, by timing.
+    void offered(const SubGhzDecoder& decoder, bool candidate);
+    void reject(const char* name, DecodeReject reason, uint32_t frames = 1);
+
+    // Zeroes the counters; the rows stay.
+    void reset();
+
+    size_t size() const {
+        return count;
+    }
+
+    const DecoderCounters& operator[](size_t i) const {
+        return rows[i];
+    }
+
+    // CSV, a header line then one line per decoder; returns the length as
+    // snprintf does, so a short buffer is detected by the caller.
+    int format(char* out, size_t size) const;
+
+    // CPU cycles on the ESP32, nanoseconds on a host.
+    static uint32_t cycles() {
+#if defined(ESP32)
+        return xthal_get_ccount();
+#else
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+
+private:
+    DecoderCounters rows[PROTOCOL_REGISTRY_SIZE];
+    size_t count;
+};
+
+#endif // DECODER_METRICS_H
@@ -0,0 +1,116 @@
+#ifndef EDGE_RING_H
+#define EDGE_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(ESP32)
+#include <esp_attr.h>
+#define EDGE_RING_IRAM IRAM_ATTR
+#define EDGE_RING_CACHE_LINE 32
+#else
+#define EDGE_RING_IRAM
+#define EDGE_RING_CACHE_LINE 64
+#endif
+
+// One captured edge: when it happened and how long the previous level lasted.
+// The sign of duration carries the level (negative = low), as in RAW_Data.
+struct Edge {
+    uint32_t timestamp; // esp_timer time in microseconds (low 32 bits)
+    int32_t duration;   // microseconds, signed by level
+};
+
+/**
+ * Fixed-capacity single-producer/single-consumer ring of edges.
+ *
+ * The producer is the GDO0 edge ISR, the consumer is the loop/decoder side on
+ * the other core. push() never blocks, never allocates and never takes a lock;
+ * when the ring is full the edge is counted in dropped() and discarded.
+ * Capacity must be a power of two so indices wrap with a mask.
+ */
+template <size_t Capacity>
+class EdgeRing {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "EdgeRing capacity must be a power of two");
+
+public:
+    EdgeRing() : head(0), drops(0), tail(0) {}
+
+    // Producer side (ISR). Returns false if the edge was dropped.
+    inline __attribute__((always_inline)) bool EDGE_RING_IRAM push(uint32_t timestamp, int32_t duration) {
+        const uint32_t h = head.load(std::memory_order_relaxed);
+        const uint32_t t = tail.load(std::memory_order_acquire);
+        if (h - t >= Capacity) {
+            drops.store(drops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        Edge& slot = buffer[h & (Capacity - 1)];
+        slot.timestamp = timestamp;
+        slot.duration = duration;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. Returns false if the ring is empty.
+    bool pop(Edge& out) {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        const uint32_t h = head.load(std::memory_order_acquire);
+        if (t == h) {
+            return false;
+        }
+        out = buffer[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side bulk drain; returns the number of edges copied into out.
+    size_t popMany(Edge* out, size_t maxCount) {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        const uint32_t h = head.load(std::memory_order_acquire);
+        size_t count = h - t;
+        if (count > maxCount) {
+            count = maxCount;
+        }
+        for (size_t i = 0; i < count; i++) {
+            out[i] = buffer[(t + i) & (Capacity - 1)];
+        }
+        tail.store(t + static_cast<uint32_t>(count), std::memory_order_release);
+        return count;
+    }
+
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return size() == 0;
+    }
+
+    // Consumer side: discard everything currently queued.
+    void clear() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    uint32_t dropped() const {
+        return drops.load(std::memory_order_relaxed);
+    }
+
+    void resetDropped() {
+        drops.store(0, std::memory_order_relaxed);
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+private:
+    // head is written only by the producer, tail only by the consumer; keeping
+    // them on separate cache lines stops the two cores bouncing one line.
+    alignas(EDGE_RING_CACHE_LINE) std::atomic<uint32_t> head;
+    std::atomic<uint32_t> drops;
+    alignas(EDGE_RING_CACHE_LINE) std::atomic<uint32_t> tail;
+    alignas(EDGE_RING_CACHE_LINE) Edge buffer[Capacity];
+};
+
+#endif // EDGE_RING_H
@@ -0,0 +1,216 @@
+#include "EventHistory.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "RecordFile.h"
+
+#define HISTORY_CRC_OFFSET (HISTORY_RECORD_SIZE - 4)
+
+// CRC-32 as in zlib and Ethernet, a nibble at a time.
+static uint32_t crc32(const uint8_t* data, size_t size) {
+    static const uint32_t table[16] = {0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+                                       0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+                                       0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+    uint32_t crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+static void put(uint8_t* out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+static uint64_t get(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+void DecodedEvent::encode(uint8_t* out) const {
+    memset(out, 0, HISTORY_RECORD_SIZE);
+    put(out, seq, 4);
+    put(out + 4, time, 4);
+    put(out + 8, frequency, 4);
+    put(out + 12, key, 8);
+    put(out + 20, bits, 2);
+    out[22] = preset;
+    out[23] = static_cast<uint8_t>(rssi);
+    memcpy(out + 24, protocol, strnlen(protocol, HISTORY_PROTOCOL_SIZE - 1));
+    put(out + HISTORY_CRC_OFFSET, crc32(out, HISTORY_CRC_OFFSET), 4);
+}
+
+bool DecodedEvent::decode(const uint8_t* in) {
+    if (get(in + HISTORY_CRC_OFFSET, 4) != crc32(in, HISTORY_CRC_OFFSET)) {
+        return false;
+    }
+    seq = static_cast<uint32_t>(get(in, 4));
+    time = static_cast<uint32_t>(get(in + 4, 4));
+    frequency = static_cast<uint32_t>(get(in + 8, 4));
+    key = get(in + 12, 8);
+    bits = static_cast<uint16_t>(get(in + 20, 2));
+    preset = in[22];
+    rssi = static_cast<int8_t>(in[23]);
+    memcpy(protocol, in + 24, HISTORY_PROTOCOL_SIZE - 1);
+    protocol[HISTORY_PROTOCOL_SIZE - 1] = '\0';
+    return true;
+}
+
+EventHistory::EventHistory(const char* path, size_t capacity)
+    : path(), capacity(capacity), ready(false), nextSeq(0), count(0), newestTime(0), clockOffset(0), reads(0) {
+    snprintf(this->path, sizeof(this->path), "%s", path);
+}
+
+// Every slot is read once; the newest record that is whole, and sits in
+// the slot its seq belongs to, is where the ring goes on.
+bool EventHistory::begin(uint32_t clock) {
+    ready = false;
+    nextSeq = 0;
+    count = 0;
+    newestTime = 0;
+    clockOffset = 0;
+    reads = 0;
+    RecordFile file(HISTORY_RECORD_SIZE);
+    if (!file.openUpdate(path)) {
+        return false;
+    }
+
+    const size_t slots = std::min(file.records(), capacity);
+    std::vector<uint8_t> block(HISTORY_BLOCK_RECORDS * HISTORY_RECORD_SIZE);
+    DecodedEvent event;
+    bool found = false;
+    uint32_t newest = 0;
+    for (size_t first = 0; first < slots; first += HISTORY_BLOCK_RECORDS) {
+        const size_t read = file.read(first, block.data(), std::min<size_t>(HISTORY_BLOCK_RECORDS, slots - first));
+        for (size_t i = 0; i < read; i++) {
+            if (event.decode(block.data() + i * HISTORY_RECORD_SIZE) && event.seq % capacity == first + i &&
+                (!found || event.seq > newest)) {
+                found = true;
+                newest = event.seq;
+                newestTime = event.time;
+            }
+        }
+        if (read == 0) {
+            break;
+        }
+    }
+    if (found) {
+        nextSeq = newest + 1;
+        count = std::min<size_t>(nextSeq, capacity);
+    }
+    clockOffset = clock < newestTime ? newestTime - clock : 0;
+    ready = true;
+    return true;
+}
+
+uint32_t EventHistory::stamp(uint32_t clock) const {
+    return std::max(clock + clockOffset, newestTime);
+}
+
+bool EventHistory::append(DecodedEvent& event, uint32_t clock) {
+    if (!ready) {
+        return false;
+    }
+    event.seq = nextSeq;
+    event.time = stamp(clock);
+    uint8_t data[HISTORY_RECORD_SIZE];
+    event.encode(data);
+    RecordFile file(HISTORY_RECORD_SIZE);
+    if (!file.openUpdate(path) || !file.writeAt(event.seq % capacity, data, 1)) {
+        return false;
+    }
+    file.close();
+    nextSeq++;
+    count = std::min(count + 1, capacity);
+    newestTime = event.time;
+    return true;
+}
+
+// False for a slot whose write was cut short or still holds an older lap.
+bool EventHistory::read(RecordFile& file, uint32_t seq, DecodedEvent& event) {
+    uint8_t data[HISTORY_RECORD_SIZE];
+    reads++;
+    return file.read(seq % capacity, data, 1) == 1 && event.decode(data) && event.seq == seq;
+}
+
+size_t EventHistory::query(const HistoryQuery& query, const Sink& sink) {
+    if (!ready || count == 0 || query.from > query.to || query.limit == 0) {
+        return 0;
+    }
+    RecordFile file(HISTORY_RECORD_SIZE);
+    if (!file.openRead(path)) {
+        return 0;
+    }
+
+    // Binary search for the first event at or after from; a slot that does
+    // not read back is passed over to the next one that does.
+    uint32_t low = nextSeq - static_cast<uint32_t>(count);
+    uint32_t high = nextSeq;
+    DecodedEvent event;
+    while (low < high) {
+        const uint32_t middle = low + (high - low) / 2;
+        uint32_t probe = middle;
+        while (probe < high && !read(file, probe, event)) {
+            probe++;
+        }
+        if (probe < high && event.time < query.from) {
+            low = probe + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    // Then forward a block at a time until the first event past to.
+    const bool anyProtocol = query.protocol == nullptr || query.protocol[0] == '\0';
+    std::vector<uint8_t> block(HISTORY_BLOCK_RECORDS * HISTORY_RECORD_SIZE);
+    size_t found = 0;
+    for (uint32_t seq = low; seq < nextSeq && found < query.limit;) {
+        const size_t slot = seq % capacity;
+        const size_t wanted = std::min<size_t>({HISTORY_BLOCK_RECORDS, capacity - slot, nextSeq - seq});
+        const size_t got = file.read(slot, block.data(), wanted);
+        reads += static_cast<uint32_t>(got);
+        for (size_t i = 0; i < got && found < query.limit; i++) {
+            if (!event.decode(block.data() + i * HISTORY_RECORD_SIZE) || event.seq != seq + i ||
+                event.time < query.from) {
+                continue;
+            }
+            if (event.time > query.to) {
+                return found;
+            }
+            if (anyProtocol || strcmp(event.protocol, query.protocol) == 0) {
+                sink(event);
+                found++;
+            }
+        }
+        seq += static_cast<uint32_t>(wanted);
+    }
+    return found;
+}
+
+size_t EventHistory::latest(size_t wanted, const Sink& sink) {
+    if (!ready || count == 0) {
+        return 0;
+    }
+    RecordFile file(HISTORY_RECORD_SIZE);
+    if (!file.openRead(path)) {
+        return 0;
+    }
+    const uint32_t oldest = nextSeq - static_cast<uint32_t>(count);
+    DecodedEvent event;
+    size_t found = 0;
+    for (uint32_t seq = nextSeq; seq > oldest && found < wanted;) {
+        seq--;
+        if (read(file, seq, event)) {
+            sink(event);
+            found++;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,101 @@
+#ifndef EVENT_HISTORY_H
+#define EVENT_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+class RecordFile;
+
+#define HISTORY_FILE "/decode_history.bin"
+#define HISTORY_CAPACITY 2048           // events kept, 96 KB on SD; the oldest is overwritten
+#define HISTORY_RECORD_SIZE 48          // on SD, CRC-32 last
+#define HISTORY_PROTOCOL_SIZE 20        // protocol name with its terminator
+#define HISTORY_BLOCK_RECORDS 32        // records per read while recovering and querying, 1.5 KB
+
+// One decoded capture.
+struct DecodedEvent {
+    uint32_t seq = 0;           // set by EventHistory::append(), counts up from 0
+    uint32_t time = 0;          // s, never less than that of an earlier event
+    uint32_t frequency = 0;     // Hz
+    uint64_t key = 0;           // code, or the first 64 bits of a BinRAW capture
+    uint16_t bits = 0;
+    uint8_t preset = 0;         // CC1101_PRESET
+    int8_t rssi = 0;            // dBm
+    char protocol[HISTORY_PROTOCOL_SIZE] = {};
+
+    // Fixed little-endian layout of HISTORY_RECORD_SIZE bytes.
+    void encode(uint8_t* out) const;
+
+    // False if the CRC does not match, e.g. a write cut short.
+    bool decode(const uint8_t* in);
+};
+
+// Events from time `from` to time `to`, both included, of one protocol or
+// of any if protocol is null or empty; at most limit of them, oldest first.
+struct HistoryQuery {
+    uint32_t from = 0;
+    uint32_t to = UINT32_MAX;
+    const char* protocol = nullptr;
+    size_t limit = SIZE_MAX;
+};
+
+/**
+ * The last HISTORY_CAPACITY decoded events, on the SD card.
+ *
+ * The file is a ring of fixed-size slots; event seq goes to slot
+ * seq % capacity, so an append is one write in place and never touches
+ * another record. Each record carries its seq and a CRC-32. After a power
+ * cut begin() scans every slot and continues after the newest record whose
+ * CRC holds; a slot whose write was cut short is skipped from then on.
+ *
+ * Times only go forward: without an RTC the clock restarts at boot, so
+ * times continue from the newest event. That keeps the ring sorted by
+ * time and lets a query find its start by binary search.
+ *
+ * Not thread-safe: on the device the UI task owns it, appending from
+ * saveCapture() and querying from showHistory().
+ */
+class EventHistory {
+public:
+    using Sink = std::function<void(const DecodedEvent& event)>;
+
+    explicit EventHistory(const char* path = HISTORY_FILE, size_t capacity = HISTORY_CAPACITY);
+
+    // Recovers the ring; clock is the time now, in s. False if the file
+    // cannot be opened or created.
+    bool begin(uint32_t clock);
+
+    // Stores event as the newest, stamping its seq and, from clock, its time.
+    bool append(DecodedEvent& event, uint32_t clock);
+
+    // Hands the events query selects to sink; returns how many.
+    size_t query(const HistoryQuery& query, const Sink& sink);
+
+    // Hands the newest count events to sink, newest first; returns how many.
+    size_t latest(size_t count, const Sink& sink);
+
+    size_t size() const {
+        return count;
+    }
+
+    // Records read from the card since begin(), recovery excluded.
+    uint32_t recordReads() const {
+        return reads;
+    }
+
+private:
+    bool read(RecordFile& file, uint32_t seq, DecodedEvent& event);
+    uint32_t stamp(uint32_t clock) const;
+
+    char path[64];
+    size_t capacity;
+    bool ready;
+    uint32_t nextSeq;
+    size_t count;
+    uint32_t newestTime;
+    uint32_t clockOffset;       // added to the clock so times go on from before the boot
+    uint32_t reads;
+};
+
+#endif // EVENT_HISTORY_H
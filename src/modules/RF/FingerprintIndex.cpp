@@ -0,0 +1,243 @@
+#include "FingerprintIndex.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include "RecordFile.h"
+
+FingerprintIndex::FingerprintIndex(const char* dirPath)
+    : dirPath(), ready(false), indexed(0), fences(), block(), pending(), pendingCount(0), reads(0) {
+    snprintf(this->dirPath, sizeof(this->dirPath), "%s", dirPath);
+}
+
+void FingerprintIndex::path(char* out, const char* file) const {
+    snprintf(out, FINGERPRINT_PATH_SIZE, "%s/%s", dirPath, file);
+}
+
+bool FingerprintIndex::begin() {
+    ready = false;
+    indexed = 0;
+    fences.clear();
+    pendingCount = 0;
+    reads = 0;
+    if (!RecordFile::makeDirectory(dirPath)) {
+        return false;
+    }
+
+    char indexPath[FINGERPRINT_PATH_SIZE];
+    char mergePath[FINGERPRINT_PATH_SIZE];
+    char pendingPath[FINGERPRINT_PATH_SIZE];
+    path(indexPath, FINGERPRINT_INDEX_FILE);
+    path(mergePath, FINGERPRINT_MERGE_FILE);
+    path(pendingPath, FINGERPRINT_PENDING_FILE);
+    // A merge that got as far as dropping the old index was complete.
+    if (RecordFile::exists(mergePath)) {
+        if (RecordFile::exists(indexPath)) {
+            RecordFile::remove(mergePath);
+        } else {
+            RecordFile::rename(mergePath, indexPath);
+        }
+    }
+
+    RecordFile index(FINGERPRINT_RECORD_SIZE);
+    if (index.openRead(indexPath)) {
+        indexed = index.records();
+        fences.reserve((indexed + FINGERPRINT_BLOCK_RECORDS - 1) / FINGERPRINT_BLOCK_RECORDS);
+        uint8_t data[FINGERPRINT_RECORD_SIZE];
+        FingerprintRecord record;
+        for (size_t i = 0; i < indexed; i += FINGERPRINT_BLOCK_RECORDS) {
+            if (index.read(i, data, 1) != 1) {
+                return false;
+            }
+            record.decode(data);
+            fences.push_back(record.print.hash);
+        }
+    }
+
+    RecordFile added(FINGERPRINT_RECORD_SIZE);
+    if (added.openRead(pendingPath)) {
+        uint8_t data[FINGERPRINT_RECORD_SIZE];
+        while (pendingCount < FINGERPRINT_PENDING_MAX && added.read(pendingCount, data, 1) == 1) {
+            pending[pendingCount++].decode(data);
+        }
+    }
+    ready = true;
+    if (pendingCount == FINGERPRINT_PENDING_MAX) {
+        // Retried by add() if it fails.
+        added.close();
+        merge();
+    }
+    return true;
+}
+
+bool FingerprintIndex::find(const SignalFingerprint& print, FingerprintRecord& out) {
+    if (!ready || !print.valid()) {
+        return false;
+    }
+    // Newest first, like a re-captured remote.
+    for (size_t i = pendingCount; i-- > 0;) {
+        if (pending[i].print.matches(print)) {
+            out = pending[i];
+            return true;
+        }
+    }
+    return findIndexed(print, out);
+}
+
+// The records of one hash start in the block after the last fence below it.
+bool FingerprintIndex::findIndexed(const SignalFingerprint& print, FingerprintRecord& out) {
+    if (indexed == 0) {
+        return false;
+    }
+    size_t start = static_cast<size_t>(std::lower_bound(fences.begin(), fences.end(), print.hash) - fences.begin());
+    if (start > 0) {
+        start--;
+    }
+
+    char indexPath[FINGERPRINT_PATH_SIZE];
+    path(indexPath, FINGERPRINT_INDEX_FILE);
+    RecordFile index(FINGERPRINT_RECORD_SIZE);
+    if (!index.openRead(indexPath)) {
+        return false;
+    }
+    block.resize(FINGERPRINT_BLOCK_RECORDS * FINGERPRINT_RECORD_SIZE);
+    FingerprintRecord record;
+    for (size_t first = start * FINGERPRINT_BLOCK_RECORDS; first < indexed; first += FINGERPRINT_BLOCK_RECORDS) {
+        const size_t count = index.read(first, block.data(), std::min<size_t>(FINGERPRINT_BLOCK_RECORDS, indexed - first));
+        reads++;
+        if (count == 0) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            record.decode(block.data() + i * FINGERPRINT_RECORD_SIZE);
+            if (record.print.hash > print.hash) {
+                return false;
+            }
+            if (record.print.matches(print)) {
+                out = record;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool FingerprintIndex::add(const SignalFingerprint& print, const char* label) {
+    if (!ready || !print.valid()) {
+        return false;
+    }
+    // Until a merge gets through, the pending records are full and nothing
+    // more is stored.
+    if (pendingCount == FINGERPRINT_PENDING_MAX && !merge()) {
+        return false;
+    }
+    FingerprintRecord& record = pending[pendingCount];
+    record = FingerprintRecord();
+    record.print = print;
+    snprintf(record.label, sizeof(record.label), "%s", label);
+
+    char pendingPath[FINGERPRINT_PATH_SIZE];
+    path(pendingPath, FINGERPRINT_PENDING_FILE);
+    uint8_t data[FINGERPRINT_RECORD_SIZE];
+    record.encode(data);
+    RecordFile added(FINGERPRINT_RECORD_SIZE);
+    if (!added.openWrite(pendingPath, true) || !added.write(data, 1)) {
+        return false;
+    }
+    added.close();
+    if (++pendingCount == FINGERPRINT_PENDING_MAX) {
+        merge();
+    }
+    return true;
+}
+
+// One pass over the index, the sorted pending records spliced in; the
+// fences are rebuilt as the blocks go out.
+bool FingerprintIndex::merge() {
+    if (!ready || pendingCount == 0) {
+        return ready;
+    }
+    std::stable_sort(pending, pending + pendingCount, [](const FingerprintRecord& a, const FingerprintRecord& b) {
+        return a.print.hash < b.print.hash;
+    });
+
+    char indexPath[FINGERPRINT_PATH_SIZE];
+    char mergePath[FINGERPRINT_PATH_SIZE];
+    char pendingPath[FINGERPRINT_PATH_SIZE];
+    path(indexPath, FINGERPRINT_INDEX_FILE);
+    path(mergePath, FINGERPRINT_MERGE_FILE);
+    path(pendingPath, FINGERPRINT_PENDING_FILE);
+
+    RecordFile index(FINGERPRINT_RECORD_SIZE);
+    if (indexed != 0 && !index.openRead(indexPath)) {
+        return false;
+    }
+    RecordFile merged(FINGERPRINT_RECORD_SIZE);
+    if (!merged.openWrite(mergePath, false)) {
+        return false;
+    }
+    std::vector<uint8_t> in(FINGERPRINT_BLOCK_RECORDS * FINGERPRINT_RECORD_SIZE);
+    std::vector<uint8_t> out(FINGERPRINT_BLOCK_RECORDS * FINGERPRINT_RECORD_SIZE);
+    std::vector<uint32_t> mergedFences;
+    mergedFences.reserve((indexed + pendingCount) / FINGERPRINT_BLOCK_RECORDS + 1);
+    size_t inCount = 0;
+    size_t inNext = 0;
+    size_t readTo = 0;
+    size_t outCount = 0;
+    size_t written = 0;
+    size_t next = 0;
+    FingerprintRecord current;
+    while (true) {
+        if (inNext == inCount && readTo < indexed) {
+            inCount = index.read(readTo, in.data(), std::min<size_t>(FINGERPRINT_BLOCK_RECORDS, indexed - readTo));
+            if (inCount == 0) {
+                return false;
+            }
+            readTo += inCount;
+            inNext = 0;
+        }
+        const bool fromIndex = inNext < inCount;
+        if (fromIndex) {
+            current.decode(in.data() + inNext * FINGERPRINT_RECORD_SIZE);
+        }
+        // Equal hashes keep the older record first.
+        if (next < pendingCount && (!fromIndex || pending[next].print.hash < current.print.hash)) {
+            current = pending[next++];
+        } else if (fromIndex) {
+            inNext++;
+        } else {
+            break;
+        }
+        if ((written + outCount) % FINGERPRINT_BLOCK_RECORDS == 0) {
+            mergedFences.push_back(current.print.hash);
+        }
+        current.encode(out.data() + outCount * FINGERPRINT_RECORD_SIZE);
+        if (++outCount == FINGERPRINT_BLOCK_RECORDS) {
+            if (!merged.write(out.data(), outCount)) {
+                return false;
+            }
+            written += outCount;
+            outCount = 0;
+        }
+    }
+    if (outCount != 0 && !merged.write(out.data(), outCount)) {
+        return false;
+    }
+    written += outCount;
+    merged.close();
+    index.close();
+
+    if (RecordFile::exists(indexPath) && !RecordFile::remove(indexPath)) {
+        return false;
+    }
+    if (!RecordFile::rename(mergePath, indexPath)) {
+        return false;
+    }
+    indexed = written;
+    fences.swap(mergedFences);
+    pendingCount = 0;
+    // A power cut before this leaves the pending records in the index twice,
+    // which only costs the space.
+    RecordFile added(FINGERPRINT_RECORD_SIZE);
+    added.openWrite(pendingPath, false);
+    return true;
+}
@@ -0,0 +1,77 @@
+#ifndef FINGERPRINT_INDEX_H
+#define FINGERPRINT_INDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SignalFingerprint.h"
+
+#define FINGERPRINT_DIR "/fingerprints"
+#define FINGERPRINT_INDEX_FILE "index.bin"      // sorted by hash
+#define FINGERPRINT_PENDING_FILE "pending.bin"  // added since the last merge, unsorted
+#define FINGERPRINT_MERGE_FILE "merge.bin"      // the next index while it is written
+#define FINGERPRINT_PENDING_MAX 64              // merged into the index when this many are pending, 2 KB
+#define FINGERPRINT_BLOCK_RECORDS 32            // records per fence and per read, 1 KB
+#define FINGERPRINT_DIR_SIZE 48                // directory path kept
+#define FINGERPRINT_PATH_SIZE 64               // directory plus file name
+
+/**
+ * Fingerprints of every capture seen, on the SD card, so a new capture can
+ * be recognised among thousands of stored ones.
+ *
+ * The index file is sorted by hash. The first hash of every block of
+ * FINGERPRINT_BLOCK_RECORDS records is kept in RAM, so a lookup is a binary
+ * search there and a single block read from the card. New fingerprints are
+ * appended to a small pending file, mirrored in RAM and searched linearly,
+ * until FINGERPRINT_PENDING_MAX of them are merged into the index in one
+ * sequential pass. The merge writes a new file before the old one is
+ * dropped, so a power cut leaves either index whole.
+ *
+ * Not thread-safe: on the device only the UI task uses it, as it owns the
+ * SD card.
+ */
+class FingerprintIndex {
+public:
+    explicit FingerprintIndex(const char* dirPath = FINGERPRINT_DIR);
+
+    // Opens the directory, creating it if missing, finishes a merge a power
+    // cut interrupted and loads the pending records, merging them if they
+    // are full. False if the card or directory cannot be used; every other
+    // call then fails too.
+    bool begin();
+
+    // Finds a stored record whose fingerprint matches print.
+    bool find(const SignalFingerprint& print, FingerprintRecord& out);
+
+    // Stores print under label; merges when the pending file is full. A
+    // merge that failed is retried first, and print refused if it fails
+    // again.
+    bool add(const SignalFingerprint& print, const char* label);
+
+    // Sorts the pending records into the index.
+    bool merge();
+
+    size_t size() const {
+        return indexed + pendingCount;
+    }
+
+    // Blocks read from the card by find() since begin().
+    uint32_t blockReads() const {
+        return reads;
+    }
+
+private:
+    bool findIndexed(const SignalFingerprint& print, FingerprintRecord& out);
+    void path(char* out, const char* file) const;
+
+    char dirPath[FINGERPRINT_DIR_SIZE];
+    bool ready;
+    size_t indexed;                     // records in the index file
+    std::vector<uint32_t> fences;       // first hash of every block of the index
+    std::vector<uint8_t> block;         // one block read by find()
+    FingerprintRecord pending[FINGERPRINT_PENDING_MAX];
+    size_t pendingCount;
+    uint32_t reads;
+};
+
+#endif // FINGERPRINT_INDEX_H
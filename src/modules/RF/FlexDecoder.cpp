@@ -0,0 +1,365 @@
+#include "FlexDecoder.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define FLEX_EMIT 0x10      // shift a bit into the code
+#define FLEX_ONE 0x20       // that bit is 1
+#define FLEX_DONE 0x40      // the frame ended; check the bits before anything else
+
+enum FlexState : uint8_t {
+    StateWait,      // for a gap
+    StateArmed,     // gap seen, for the first pulse
+    StateSpace,     // PWM/PPM: after a high
+    StateMark,      // PWM/PPM: after a low
+    StateStart = StateSpace,    // Manchester: at a bit boundary
+    StateMidHigh = StateMark,   // Manchester: first half of the bit was high
+    StateMidLow                 // Manchester: first half of the bit was low
+};
+
+static const int ClassGap = FLEX_MAX_WIDTHS;
+static const int ClassOther = FLEX_MAX_WIDTHS + 1;
+
+// Value of key=value with the key matched, else nullptr.
+static const char* valueOf(const char* token, size_t length, const char* key) {
+    const size_t keyLength = std::strlen(key);
+    if (length <= keyLength || std::strncmp(token, key, keyLength) != 0 || token[keyLength] != '=') {
+        return nullptr;
+    }
+    return token + keyLength + 1;
+}
+
+static bool parseNumber(const char* value, size_t length, uint32_t max, uint32_t& out) {
+    char* end = nullptr;
+    const unsigned long number = std::strtoul(value, &end, 10);
+    if (end == value || static_cast<size_t>(end - value) != length || number > max) {
+        return false;
+    }
+    out = static_cast<uint32_t>(number);
+    return true;
+}
+
+static bool matches(const char* value, size_t length, const char* word) {
+    return std::strlen(word) == length && std::strncmp(value, word, length) == 0;
+}
+
+static bool parsePair(const char* token, size_t length, FlexSpec& spec) {
+    const char* value = nullptr;
+    uint32_t number = 0;
+    if ((value = valueOf(token, length, "name"))) {
+        const size_t size = length - (value - token);
+        if (size == 0 || size >= FLEX_NAME_SIZE) {
+            return false;
+        }
+        std::memcpy(spec.name, value, size);
+        spec.name[size] = '\0';
+        return true;
+    }
+    if ((value = valueOf(token, length, "mod"))) {
+        const size_t size = length - (value - token);
+        if (matches(value, size, "pwm")) {
+            spec.modulation = FlexModulation::Pwm;
+        } else if (matches(value, size, "ppm")) {
+            spec.modulation = FlexModulation::Ppm;
+        } else if (matches(value, size, "manchester")) {
+            spec.modulation = FlexModulation::Manchester;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    if ((value = valueOf(token, length, "check"))) {
+        const size_t size = length - (value - token);
+        if (matches(value, size, "none")) {
+            spec.check = FlexCheck::None;
+        } else if (matches(value, size, "even")) {
+            spec.check = FlexCheck::EvenParity;
+        } else if (matches(value, size, "odd")) {
+            spec.check = FlexCheck::OddParity;
+        } else if (matches(value, size, "xor8")) {
+            spec.check = FlexCheck::Xor8;
+        } else if (matches(value, size, "sum8")) {
+            spec.check = FlexCheck::Sum8;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    struct NumberKey {
+        const char* key;
+        uint32_t max;
+    };
+    static const NumberKey keys[] = {
+        {"short", UINT16_MAX}, {"long", UINT16_MAX}, {"pulse", UINT16_MAX}, {"sync", UINT16_MAX},
+        {"gap", 1000000},      {"tolerance", UINT16_MAX}, {"bits", 64},     {"invert", 1},
+    };
+    for (size_t k = 0; k < sizeof(keys) / sizeof(keys[0]); k++) {
+        if (!(value = valueOf(token, length, keys[k].key))) {
+            continue;
+        }
+        if (!parseNumber(value, length - (value - token), keys[k].max, number)) {
+            return false;
+        }
+        switch (k) {
+        case 0: spec.shortWidth = static_cast<uint16_t>(number); break;
+        case 1: spec.longWidth = static_cast<uint16_t>(number); break;
+        case 2: spec.pulseWidth = static_cast<uint16_t>(number); break;
+        case 3: spec.syncWidth = static_cast<uint16_t>(number); break;
+        case 4: spec.gapWidth = number; break;
+        case 5: spec.tolerance = static_cast<uint16_t>(number); break;
+        case 6: spec.bits = static_cast<uint8_t>(number); break;
+        default: spec.invert = number != 0; break;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool parseFlexSpec(const char* line, FlexSpec& spec) {
+    spec = FlexSpec();
+    const char* token = line;
+    while (*token) {
+        while (*token == ',' || std::isspace(static_cast<unsigned char>(*token))) {
+            token++;
+        }
+        size_t length = 0;
+        while (token[length] && token[length] != ',') {
+            length++;
+        }
+        const char* next = token + length;
+        while (length > 0 && std::isspace(static_cast<unsigned char>(token[length - 1]))) {
+            length--;
+        }
+        if (length > 0 && !parsePair(token, length, spec)) {
+            return false;
+        }
+        token = next;
+    }
+
+    if (spec.modulation == FlexModulation::Manchester && spec.longWidth == 0) {
+        spec.longWidth = static_cast<uint16_t>(spec.shortWidth * 2);
+    }
+    if (spec.pulseWidth == 0) {
+        spec.pulseWidth = spec.shortWidth;
+    }
+    if (spec.tolerance == 0) {
+        // Half the closest two widths are apart, so no windows overlap.
+        const uint16_t widths[] = {spec.shortWidth, spec.longWidth, spec.pulseWidth, spec.syncWidth};
+        uint32_t closest = UINT16_MAX;
+        for (uint16_t a : widths) {
+            closest = a && a < closest ? a : closest;
+            for (uint16_t b : widths) {
+                closest = a && b && a != b && DURATION_DIFF(a, b) < static_cast<int>(closest) ? DURATION_DIFF(a, b)
+                                                                                            : closest;
+            }
+        }
+        spec.tolerance = static_cast<uint16_t>(closest / 2);
+    }
+    return spec.name[0] && spec.shortWidth && spec.longWidth > spec.shortWidth && spec.gapWidth && spec.bits;
+}
+
+FlexDecoder::FlexDecoder() : blockTiming{0, 0, 0, 0}, span(0), widthCount(0) {
+    std::memset(table, StateWait, sizeof(table));
+    reset();
+}
+
+int FlexDecoder::addWidth(uint16_t width) {
+    for (uint8_t i = 0; i < widthCount; i++) {
+        if (widths[i] == width) {
+            return i;
+        }
+        // Windows are 2 * tolerance - 1 wide.
+        if (static_cast<uint32_t>(DURATION_DIFF(widths[i], width)) + 2 <= 2u * spec.tolerance) {
+            return -1;
+        }
+    }
+    if (widthCount == FLEX_MAX_WIDTHS || width <= spec.tolerance) {
+        return -1;
+    }
+    widths[widthCount] = width;
+    from[widthCount] = width - spec.tolerance + 1u;
+    return widthCount++;
+}
+
+void FlexDecoder::set(uint8_t at, int widthClass, bool level, uint8_t entry) {
+    table[at][widthClass * 2 + level] = entry;
+}
+
+bool FlexDecoder::compile(const FlexSpec& source) {
+    spec = source;
+    widthCount = 0;
+    span = 2u * spec.tolerance - 1;
+    std::memset(table, StateWait, sizeof(table));
+    validCodeFound = false;
+    if (spec.tolerance == 0 || spec.bits == 0 || spec.bits > 64) {
+        return false;
+    }
+    if ((spec.check == FlexCheck::Xor8 || spec.check == FlexCheck::Sum8) && (spec.bits % 8 != 0 || spec.bits < 16)) {
+        return false;
+    }
+
+    const int shortClass = addWidth(spec.shortWidth);
+    const int longClass = addWidth(spec.longWidth);
+    const int pulseClass = spec.modulation == FlexModulation::Ppm ? addWidth(spec.pulseWidth) : shortClass;
+    const int syncClass = spec.syncWidth ? addWidth(spec.syncWidth) : -1;
+    if (shortClass < 0 || longClass < 0 || pulseClass < 0 || (spec.syncWidth && syncClass < 0)) {
+        return false;
+    }
+    for (uint8_t i = 0; i < widthCount; i++) {
+        if (from[i] + span > spec.gapWidth) {
+            return false;
+        }
+    }
+
+    // A bit is one entry flag, so inverting the code is swapping them here.
+    const uint8_t one = spec.invert ? FLEX_EMIT : FLEX_EMIT | FLEX_ONE;
+    const uint8_t zero = spec.invert ? FLEX_EMIT | FLEX_ONE : FLEX_EMIT;
+
+    // A gap arms every state; everything not set below drops back to Wait.
+    for (uint8_t s = 0; s < FLEX_MAX_STATES; s++) {
+        set(s, ClassGap, false, StateArmed);
+    }
+    switch (spec.modulation) {
+    case FlexModulation::Pwm:
+        if (syncClass >= 0) {
+            set(StateArmed, syncClass, true, StateSpace);
+        } else {
+            set(StateArmed, shortClass, true, StateSpace | one);
+            set(StateArmed, longClass, true, StateSpace | zero);
+        }
+        set(StateSpace, shortClass, false, StateMark);
+        set(StateSpace, longClass, false, StateMark);
+        set(StateSpace, ClassGap, false, StateArmed | FLEX_DONE);
+        set(StateMark, shortClass, true, StateSpace | one);
+        set(StateMark, longClass, true, StateSpace | zero);
+        break;
+
+    case FlexModulation::Ppm:
+        set(StateArmed, syncClass >= 0 ? syncClass : pulseClass, true, StateSpace);
+        set(StateSpace, shortClass, false, StateMark | zero);
+        set(StateSpace, longClass, false, StateMark | one);
+        set(StateMark, pulseClass, true, StateSpace);
+        // The last mark is followed by the gap.
+        set(StateSpace, ClassGap, false, StateArmed | FLEX_DONE);
+        break;
+
+    case FlexModulation::Manchester:
+        if (syncClass >= 0) {
+            set(StateArmed, syncClass, true, StateStart);
+        } else {
+            // The gap swallows the low first half of a leading 0.
+            set(StateArmed, shortClass, true, StateMidHigh);
+            set(StateArmed, longClass, true, StateMidHigh | zero);
+        }
+        set(StateStart, shortClass, true, StateMidHigh);
+        set(StateStart, shortClass, false, StateMidLow);
+        set(StateStart, ClassGap, false, StateArmed | FLEX_DONE);
+        set(StateMidHigh, shortClass, false, StateStart | one);
+        set(StateMidHigh, longClass, false, StateMidLow | one);
+        // ...and the gap the low second half of a trailing 1.
+        set(StateMidHigh, ClassGap, false, StateArmed | one | FLEX_DONE);
+        set(StateMidLow, shortClass, true, StateStart | zero);
+        set(StateMidLow, longClass, true, StateMidHigh | zero);
+        break;
+    }
+
+    // The registry indexes the two shortest widths.
+    uint16_t first = UINT16_MAX;
+    uint16_t second = UINT16_MAX;
+    for (uint8_t i = 0; i < widthCount; i++) {
+        if (widths[i] < first) {
+            second = first;
+            first = widths[i];
+        } else if (widths[i] < second) {
+            second = widths[i];
+        }
+    }
+    blockTiming = SubGhzBlockConst{second, first, spec.tolerance, spec.bits};
+    reset();
+    return true;
+}
+
+// Past the gap and the first pulse after it.
+bool FlexDecoder::synced() const {
+    return state >= StateSpace;
+}
+
+void FlexDecoder::reset() {
+    state = StateWait;
+    decodeData = 0;
+    decodeCountBit = 0;
+    validCodeFound = false;
+    finalCode = 0;
+    finalBitCount = 0;
+}
+
+uint8_t FlexDecoder::classify(bool level, uint32_t duration) const {
+    int widthClass = duration >= spec.gapWidth ? ClassGap : ClassOther;
+    for (uint8_t i = 0; i < widthCount; i++) {
+        if (duration - from[i] < span) {
+            widthClass = i;
+        }
+    }
+    return static_cast<uint8_t>(widthClass * 2 + level);
+}
+
+bool FlexDecoder::feed(bool level, uint32_t duration) {
+    const uint8_t entry = table[state][classify(level, duration)];
+    state = entry & 0x0F;
+    if (entry & FLEX_DONE) {
+        if (entry & FLEX_EMIT) {
+            decodeData = decodeData << 1 | ((entry & FLEX_ONE) != 0);
+            decodeCountBit++;
+        }
+        if (decodeCountBit == spec.bits && checkPasses()) {
+            validCodeFound = true;
+            finalCode = decodeData;
+            finalBitCount = decodeCountBit;
+        }
+    } else if (entry & FLEX_EMIT) {
+        if (decodeCountBit == spec.bits) {
+            // Longer than the spec; wait for the next frame.
+            state = StateWait;
+        }
+        decodeData = decodeData << 1 | ((entry & FLEX_ONE) != 0);
+        decodeCountBit++;
+    }
+    if (state <= StateArmed) {
+        decodeData = 0;
+        decodeCountBit = 0;
+    }
+    return validCodeFound;
+}
+
+bool FlexDecoder::checkPasses() const {
+    uint8_t folded = 0;
+    switch (spec.check) {
+    case FlexCheck::None:
+        return true;
+    case FlexCheck::EvenParity:
+        return __builtin_popcountll(decodeData) % 2 == 0;
+    case FlexCheck::OddParity:
+        return __builtin_popcountll(decodeData) % 2 == 1;
+    case FlexCheck::Xor8:
+        for (uint8_t shift = 0; shift < decodeCountBit; shift += 8) {
+            folded ^= static_cast<uint8_t>(decodeData >> shift);
+        }
+        return folded == 0;
+    case FlexCheck::Sum8:
+        for (uint8_t shift = 8; shift < decodeCountBit; shift += 8) {
+            folded += static_cast<uint8_t>(decodeData >> shift);
+        }
+        return folded == static_cast<uint8_t>(decodeData);
+    }
+    return false;
+}
+
+std::string FlexDecoder::describe(uint64_t shortPulse, uint64_t longPulse) {
+    char buf[96];
+    const int digits = (finalBitCount + 3) / 4;
+    snprintf(buf, sizeof(buf), "\n%s %ubit\r\nKey:0x%0*llX\r\n", spec.name, static_cast<unsigned>(finalBitCount),
+             digits, static_cast<unsigned long long>(finalCode));
+    return std::string(buf);
+}
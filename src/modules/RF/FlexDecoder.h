@@ -0,0 +1,135 @@
+#ifndef FLEX_DECODER_H
+#define FLEX_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "ProtocolRegistry.h"
+
+#define FLEX_NAME_SIZE 16       // protocol name, terminator included
+#define FLEX_MAX_DECODERS 8     // specs loaded from SD at once
+#define FLEX_MAX_WIDTHS 4       // distinct pulse widths a spec may use
+#define FLEX_MAX_STATES 5       // states of the largest modulation, Manchester
+#define FLEX_SYMBOLS ((FLEX_MAX_WIDTHS + 2) * 2)   // width classes, gap and other, times level
+#define FLEX_SPEC_PATH "/flex_decoders.txt"
+
+enum class FlexModulation : uint8_t {
+    Pwm,        // a bit per high pulse, short for 1; the lows between are short or long
+    Ppm,        // highs of pulse width, a bit per low between, long for 1
+    Manchester  // te of short, two per bit, high-low for 1
+};
+
+enum class FlexCheck : uint8_t {
+    None,
+    EvenParity, // over all bits, parity bit included
+    OddParity,
+    Xor8,       // bytes, last included, xor to 0
+    Sum8        // last byte is the sum of the others
+};
+
+/**
+ * A fixed-code protocol described as data, one line of key=value pairs
+ * separated by commas, in the spirit of rtl_433's flex decoder:
+ *
+ *     name=Holtek,mod=pwm,short=400,long=800,sync=400,gap=4400,bits=12
+ *
+ * name, mod (pwm, ppm, manchester), short, gap and bits are required; long
+ * defaults to twice short for Manchester, pulse (the PPM mark) to short.
+ * sync is a high pulse that opens the frame instead of the first data
+ * pulse. A low of at least gap closes the frame. tolerance defaults to half
+ * the distance between the two closest widths, or half the shortest, check
+ * to none (even, odd, xor8, sum8), invert to 0.
+ */
+struct FlexSpec {
+    char name[FLEX_NAME_SIZE] = {};
+    FlexModulation modulation = FlexModulation::Pwm;
+    uint16_t shortWidth = 0;
+    uint16_t longWidth = 0;
+    uint16_t pulseWidth = 0;
+    uint16_t syncWidth = 0;     // 0 for none
+    uint32_t gapWidth = 0;
+    uint16_t tolerance = 0;
+    uint8_t bits = 0;
+    FlexCheck check = FlexCheck::None;
+    bool invert = false;
+};
+
+// Parses one spec line and fills in the defaults. Returns false on an
+// unknown key or value, or a missing required key.
+bool parseFlexSpec(const char* line, FlexSpec& spec);
+
+/**
+ * The one engine every flex protocol runs on. compile() turns a spec into a
+ * transition table over (state, pulse class); feed() then classifies the
+ * pulse against at most FLEX_MAX_WIDTHS windows and takes one table step,
+ * whatever the protocol. Bits, inversion included, and frame ends are in the
+ * table entries, so the per-pulse cost does not depend on the spec.
+ */
+class FlexDecoder : public SubGhzDecoder {
+public:
+    FlexDecoder();
+
+    // Returns false if the spec's widths overlap or do not fit the gap, or
+    // the check does not fit the bit count.
+    bool compile(const FlexSpec& spec);
+
+    const char* name() const override {
+        return spec.name;
+    }
+
+    // Shortest and second shortest width, as the pulse histogram finds them.
+    const SubGhzBlockConst& timing() const override {
+        return blockTiming;
+    }
+
+    // The windows are the spec's, not the measured short and long pulse.
+    bool rawInput() const override {
+        return true;
+    }
+
+    void reset() override;
+    bool feed(bool level, uint32_t duration) override;
+    bool synced() const override;
+
+    bool hasResult() const override {
+        return validCodeFound;
+    }
+
+    uint64_t code() const override {
+        return finalCode;
+    }
+
+    uint8_t bits() const override {
+        return finalBitCount;
+    }
+
+    std::string describe(uint64_t shortPulse, uint64_t longPulse) override;
+
+private:
+    // Returns the index of the window of width, adding it if none is within
+    // the tolerance, or -1 if it overlaps one or no room is left.
+    int addWidth(uint16_t width);
+    uint8_t classify(bool level, uint32_t duration) const;
+    void set(uint8_t at, int widthClass, bool level, uint8_t entry);
+    bool checkPasses() const;
+
+    FlexSpec spec;
+    SubGhzBlockConst blockTiming;
+    // Class i is a pulse within tolerance of widths[i], in the form
+    // PwmDecoder::within() compares against.
+    uint32_t from[FLEX_MAX_WIDTHS];
+    uint32_t span;
+    uint16_t widths[FLEX_MAX_WIDTHS];
+    uint8_t widthCount;
+    // Low nibble the next state, high bits what the step does.
+    uint8_t table[FLEX_MAX_STATES][FLEX_SYMBOLS];
+
+    uint8_t state;
+    uint64_t decodeData;
+    uint8_t decodeCountBit;
+    bool validCodeFound;
+    uint64_t finalCode;
+    uint8_t finalBitCount;
+};
+
+#endif // FLEX_DECODER_H
@@ -26,8 +26,59 @@ void FlipperSubFile::generateRaw(
     writeRawProtocolData(file, samples);
 }
 
-void FlipperSubFile::writeHeader(File32& file, float frequency) {
-    file.println("Filetype: Flipper SubGhz RAW File");
+void FlipperSubFile::generateRaw(
+    File32& file,
+    CC1101_PRESET presetName,
+    const std::vector<uint8_t>& customPresetData,
+    PulseView samples,
+    float frequency,
+    const RepeatInfo& repeats
+) {
+    if (!file) {
+        return;
+    }
+    writeHeader(file, frequency);
+    writePresetInfo(file, presetName, customPresetData);
+    writeRawProtocolData(file, samples, repeats);
+}
+
+void FlipperSubFile::generateBinRaw(
+    File32& file,
+    CC1101_PRESET presetName,
+    const std::vector<uint8_t>& customPresetData,
+    float frequency,
+    uint32_t te,
+    const BinRawFrame* frames,
+    size_t frameCount
+) {
+    if (!file) {
+        return;
+    }
+    writeHeader(file, frequency, "Key File");
+    writePresetInfo(file, presetName, customPresetData);
+    file.println("Protocol: BinRAW");
+    unsigned long totalBits = 0;
+    for (size_t i = 0; i < frameCount; i++) {
+        totalBits += frames[i].bits;
+    }
+    file.printf("Bit: %lu", totalBits);
+    file.println();
+    file.printf("TE: %lu", static_cast<unsigned long>(te));
+    file.println();
+    for (size_t i = 0; i < frameCount; i++) {
+        file.printf("Bit_RAW: %u", static_cast<unsigned>(frames[i].bits));
+        file.println();
+        file.print("Data_RAW:");
+        for (size_t b = 0; b < frames[i].bytes(); b++) {
+            file.printf(" %02X", frames[i].data[b]);
+        }
+        file.println();
+    }
+}
+
+void FlipperSubFile::writeHeader(File32& file, float frequency, const char* fileType) {
+    file.print("Filetype: Flipper SubGhz ");
+    file.println(fileType);
     file.println("Version: 1");
     file.print("Frequency: ");
     file.print(frequency * 1e6, 0);
@@ -75,6 +126,28 @@ void FlipperSubFile::writeRawProtocolData(File32& file, std::ostringstream& samp
     file.println();
 }
 
+void FlipperSubFile::writeRawProtocolData(File32& file, PulseView samples, const RepeatInfo& repeats) {
+    file.println("Protocol: RAW");
+    if (repeats.repeated()) {
+        // Not a Flipper key; Flipper skips it and plays the frame once.
+        file.printf("Repeat: %u %u %u", repeats.start, repeats.length, repeats.count);
+        file.println();
+    }
+    file.print("RAW_Data: ");
+
+    int wordCount = 0;
+    for (PulseDuration sample : samples) {
+        if (wordCount > 0 && wordCount % 512 == 0) {
+            file.println();
+            file.print("RAW_Data: ");
+        }
+        file.print(sample);
+        file.print(' ');
+        wordCount++;
+    }
+    file.println();
+}
+
 
 std::string FlipperSubFile::getPresetName(CC1101_PRESET preset) {
     auto it = presetMapping.find(preset);
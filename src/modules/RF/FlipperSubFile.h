@@ -6,6 +6,9 @@
 #include <vector>
 #include <map>
 #include "globals.h"
+#include "PackedPulses.h"
+#include "RepeatedCapture.h"
+#include "BinRawAnalyzer.h"
 
 
 class FlipperSubFile {
@@ -22,13 +25,30 @@ public:
 File32&, CC1101_PRESET, const std::vector<unsigned char>&, std::ostringstream& , float
     );
 
+    /**
+     * Same as above, but writes the pulses straight from a PulseView without
+     * formatting the whole capture into a string first. With repeats, samples
+     * is the compact form and a Repeat: line tells the player to expand it.
+     */
+    void generateRaw(File32& file, CC1101_PRESET presetName, const std::vector<uint8_t>& customPresetData,
+                     PulseView samples, float frequency, const RepeatInfo& repeats = RepeatInfo());
+
+    /**
+     * Generate a Flipper SubGhz key file with Protocol: BinRAW.
+     * @param te Slot length of all frames in microseconds.
+     * @param frames The frames as te slots, one Bit_RAW/Data_RAW pair each.
+     */
+    void generateBinRaw(File32& file, CC1101_PRESET presetName, const std::vector<uint8_t>& customPresetData,
+                        float frequency, uint32_t te, const BinRawFrame* frames, size_t frameCount);
+
 private:
     /**
      * Writes the header information to the file.
      * @param file Reference to the SD card file.
      * @param frequency The frequency of the signal in MHz.
+     * @param fileType What follows "Filetype: Flipper SubGhz".
      */
-    void writeHeader(File32& file, float frequency);
+    void writeHeader(File32& file, float frequency, const char* fileType = "RAW File");
 
     /**
      * Writes preset information to the file.
@@ -44,6 +64,7 @@ private:
      * @param samples String containing the raw signal samples.
      */
     void writeRawProtocolData(File32& file, std::ostringstream& samples);
+    void writeRawProtocolData(File32& file, PulseView samples, const RepeatInfo& repeats);
 
     /**
      * Retrieves the name of the preset as a string.
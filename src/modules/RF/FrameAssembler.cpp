@@ -0,0 +1,181 @@
+#include "FrameAssembler.h"
+#include <algorithm>
+
+void TeEstimator::add(uint32_t pulse) {
+    window[next] = pulse;
+    next = (next + 1) % TE_WINDOW;
+    if (count < TE_WINDOW) {
+        count++;
+    }
+}
+
+void TeEstimator::reset() {
+    next = 0;
+    count = 0;
+}
+
+uint32_t TeEstimator::te(size_t minCount) const {
+    if (count < minCount || count == 0) {
+        return 0;
+    }
+    uint32_t sorted[TE_WINDOW];
+    std::copy(window, window + count, sorted);
+    const size_t quarter = count / 4;
+    std::nth_element(sorted, sorted + quarter, sorted + count);
+    return sorted[quarter];
+}
+
+FrameAssembler::FrameAssembler(size_t minEdges, size_t maxEdges, uint32_t teMinCount, uint32_t gapMultiplier,
+                               uint32_t resetGap)
+    : minEdges(minEdges),
+      maxEdges(maxEdges),
+      teMinCount(teMinCount),
+      gapMultiplier(gapMultiplier),
+      resetGap(resetGap),
+      lastEdge(0),
+      dataEnd(0),
+      carry(0),
+      carried(false),
+      done(false)
+{
+    pulses.reserve(maxEdges);
+}
+
+void FrameAssembler::reset() {
+    estimator.reset();
+    pulses.clear();
+    lastEdge = 0;
+    dataEnd = 0;
+    carry = 0;
+    carried = false;
+    done = false;
+}
+
+bool FrameAssembler::addEdge(const Edge& edge) {
+    if (done) {
+        return true;
+    }
+    lastEdge = edge.timestamp;
+
+    const uint32_t magnitude = static_cast<uint32_t>(edge.duration < 0 ? -edge.duration : edge.duration);
+    const uint32_t limit = te() * gapMultiplier;
+    if (limit == 0 && magnitude > resetGap) {
+        estimator.reset();
+        restart(edge.duration);
+        return false;
+    }
+    if (edge.duration < 0 && limit > 0 && magnitude > limit) {
+        if (pulses.size() < minEdges) {
+            // Too short to be a frame: start over with the gap as the header.
+            restart(edge.duration);
+            return false;
+        }
+        pulses.push_back(edge.duration);
+        carry = edge.duration;
+        done = true;
+        return true;
+    }
+
+    pulses.push_back(edge.duration);
+    dataEnd = edge.timestamp;
+    estimator.add(magnitude);
+    if (pulses.size() >= maxEdges) {
+        carry = 0;
+        done = true;
+    }
+    return done;
+}
+
+bool FrameAssembler::checkIdle(uint32_t now) {
+    if (done) {
+        return true;
+    }
+    // Waiting for resetGap rather than the gap limit lets a guard gap that is
+    // still in progress finish and close the frame with its real length.
+    const uint32_t limit = std::max(te() * gapMultiplier, resetGap);
+    if (te() == 0 || pulses.size() < minEdges || now - lastEdge <= limit) {
+        return false;
+    }
+    // The level after the last edge is the opposite of the last pulse; after
+    // a high pulse that is the trailing gap the decoders expect to see.
+    if (pulses.back() > 0) {
+        pulses.push_back(-static_cast<PulseDuration>(now - lastEdge));
+    }
+    carry = 0;
+    done = true;
+    return true;
+}
+
+void FrameAssembler::next() {
+    pulses.clear();
+    if (carry != 0) {
+        pulses.push_back(carry);
+    } else {
+        estimator.reset();
+    }
+    carried = carry != 0;
+    carry = 0;
+    done = false;
+}
+
+void FrameAssembler::restart(PulseDuration header) {
+    pulses.clear();
+    pulses.push_back(header);
+    carried = false;
+}
+
+CaptureCollector::CaptureCollector(size_t maxFrames, size_t maxPulses, uint32_t silenceUs, uint32_t maxWaitUs)
+    : maxFrames(maxFrames),
+      maxPulses(maxPulses),
+      silenceUs(silenceUs),
+      maxWaitUs(maxWaitUs),
+      frameCount(0),
+      firstClose(0),
+      dataEnd(0),
+      done(false)
+{
+    pulses.reserve(maxPulses);
+}
+
+void CaptureCollector::reset() {
+    pulses.clear();
+    frameCount = 0;
+    firstClose = 0;
+    dataEnd = 0;
+    done = false;
+}
+
+bool CaptureCollector::addFrame(const FrameAssembler& assembler) {
+    if (done) {
+        return true;
+    }
+    const PulseView frame = assembler.frame();
+    auto pulse = frame.begin();
+    if (!pulses.empty() && assembler.continues() && pulse != frame.end()) {
+        ++pulse;
+    }
+    for (; pulse != frame.end() && pulses.size() < maxPulses; ++pulse) {
+        pulses.push_back(*pulse);
+    }
+    if (frameCount++ == 0) {
+        firstClose = assembler.dataEndTime();
+    }
+    dataEnd = assembler.dataEndTime();
+    done = frameCount >= maxFrames || pulses.size() >= maxPulses;
+    return done;
+}
+
+bool CaptureCollector::checkIdle(uint32_t lastEdge, uint32_t now) {
+    if (done) {
+        return true;
+    }
+    if (frameCount == 0) {
+        return false;
+    }
+    done = now - lastEdge > silenceUs || now - firstClose > maxWaitUs;
+    return done;
+}
+
+void CaptureCollector::next() {
+    reset();
+}
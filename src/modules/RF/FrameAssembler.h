@@ -0,0 +1,164 @@
+#ifndef FRAME_ASSEMBLER_H
+#define FRAME_ASSEMBLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "EdgeRing.h"
+#include "PackedPulses.h"
+
+#define TE_WINDOW 16   // recent pulses used for the TE estimate
+#define FRAME_GAP_MULTIPLIER 16 // low pulses longer than this many TE end a frame
+
+/**
+ * Online estimate of the elementary period (TE) of the signal being received.
+ * Uses the 25th percentile of the last TE_WINDOW pulses, which lands on the
+ * short pulse of PWM and Manchester codes while ignoring the odd spike. Both
+ * levels count: a PWM code of mostly one bit value can have nearly all of
+ * its highs long, but then its lows are short.
+ */
+class TeEstimator {
+public:
+    TeEstimator() : next(0), count(0) {}
+
+    void add(uint32_t pulse);
+    void reset();
+
+    // 0 until at least minCount pulses have been seen.
+    uint32_t te(size_t minCount) const;
+
+private:
+    uint32_t window[TE_WINDOW];
+    size_t next;
+    size_t count;
+};
+
+/**
+ * Cuts the edge stream into frames at gaps instead of fixed timeouts.
+ *
+ * Once TE_MIN_COUNT pulses have given a TE estimate, a low pulse longer
+ * than GAP_MULTIPLIER * TE ends the frame. That has to stay above every gap
+ * inside a frame, such as KeeLoq's 10 TE header, and below the guard gaps
+ * between repeats, 24 TE and up; hence FRAME_GAP_MULTIPLIER. The gap is kept as the last pulse
+ * (decoders use it to finish the last bit) and also starts the next frame,
+ * where it serves as the header. If no edge arrives at all, checkIdle() closes
+ * the frame once the silence is longer than resetGap. Before there is a TE
+ * estimate, any pulse longer than resetGap throws away what came before.
+ */
+class FrameAssembler {
+public:
+    FrameAssembler(size_t minEdges, size_t maxEdges, uint32_t teMinCount, uint32_t gapMultiplier,
+                   uint32_t resetGap);
+
+    void reset();
+
+    // Adds one edge; returns true if the frame is now complete.
+    bool addEdge(const Edge& edge);
+
+    // Closes the frame if the line has been quiet for longer than resetGap;
+    // returns true if the frame is now complete.
+    bool checkIdle(uint32_t now);
+
+    bool complete() const {
+        return done;
+    }
+
+    PulseView frame() const {
+        return PulseView(pulses);
+    }
+
+    // Time of the last edge that belongs to the frame data, for latency figures.
+    uint32_t dataEndTime() const {
+        return dataEnd;
+    }
+
+    uint32_t te() const {
+        return estimator.te(teMinCount);
+    }
+
+    // The frame starts with the gap that closed the one before it.
+    bool continues() const {
+        return carried;
+    }
+
+    // Starts the next frame after a completed one has been consumed.
+    void next();
+
+private:
+    void restart(PulseDuration header);
+
+    TeEstimator estimator;
+    std::vector<PulseDuration> pulses;
+    size_t minEdges;
+    size_t maxEdges;
+    uint32_t teMinCount;
+    uint32_t gapMultiplier;
+    uint32_t resetGap;
+    uint32_t lastEdge;
+    uint32_t dataEnd;
+    PulseDuration carry;
+    bool carried;
+    bool done;
+};
+
+/**
+ * Joins the frames a FrameAssembler closes into one capture of every repeat
+ * of a transmission, so the vote has more than one frame to go by. A frame
+ * that continues() the one before it leaves out the gap the capture already
+ * ends with. The capture is complete once it holds maxFrames frames or
+ * maxPulses pulses, once the line has been quiet for silenceUs after its last
+ * edge, or maxWaitUs after its first frame closed, whichever comes first.
+ */
+class CaptureCollector {
+public:
+    CaptureCollector(size_t maxFrames, size_t maxPulses, uint32_t silenceUs, uint32_t maxWaitUs);
+
+    void reset();
+
+    // Takes the frame assembler has just completed; returns true if the
+    // capture is now complete.
+    bool addFrame(const FrameAssembler& assembler);
+
+    // lastEdge is the time of the last edge received, frame or not; returns
+    // true if the capture is now complete.
+    bool checkIdle(uint32_t lastEdge, uint32_t now);
+
+    bool complete() const {
+        return done;
+    }
+
+    PulseView capture() const {
+        return PulseView(pulses);
+    }
+
+    size_t frames() const {
+        return frameCount;
+    }
+
+    // Time of the last data edge of the last frame, see FrameAssembler.
+    uint32_t dataEndTime() const {
+        return dataEnd;
+    }
+
+    // Time of the last data edge of the first frame, which could have been
+    // decoded on its own; press-to-result latency is measured from it.
+    uint32_t firstEndTime() const {
+        return firstClose;
+    }
+
+    // Starts the next capture after a completed one has been consumed.
+    void next();
+
+private:
+    std::vector<PulseDuration> pulses;
+    size_t maxFrames;
+    size_t maxPulses;
+    uint32_t silenceUs;
+    uint32_t maxWaitUs;
+    size_t frameCount;
+    uint32_t firstClose;
+    uint32_t dataEnd;
+    bool done;
+};
+
+#endif // FRAME_ASSEMBLER_H
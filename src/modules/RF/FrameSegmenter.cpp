@@ -0,0 +1,72 @@
+#include "FrameSegmenter.h"
+
+FrameSegmenter::FrameSegmenter(float gapMultiplier, uint16_t teMinCount, size_t minPulses,
+                               PulseHistogram* histogram)
+    : histogram(histogram),
+      base(nullptr),
+      count(0),
+      gapMultiplier(gapMultiplier),
+      teMinCount(teMinCount),
+      minPulses(minPulses)
+{
+}
+
+size_t FrameSegmenter::split(const PulseDuration* data, size_t size) {
+    base = data;
+    count = 0;
+    estimator.reset();
+    if (histogram) {
+        histogram->clear();
+    }
+
+    size_t start = 0;
+    size_t i = 0;
+    for (; i < size && count < SEGMENT_MAX_FRAMES - 1; i++) {
+        const PulseDuration pulse = data[i];
+        const uint32_t te = estimator.te(teMinCount);
+        bin(pulse);
+        if (pulse > 0 || te == 0 || static_cast<float>(-pulse) <= te * gapMultiplier) {
+            estimator.add(static_cast<uint32_t>(pulse > 0 ? pulse : -pulse));
+            continue;
+        }
+        // Frames too short to decode (noise between repeats) are skipped,
+        // but still end at this gap.
+        add(start, i + 1, te);
+        start = i;
+        estimator.reset();
+        // The gap also heads the next frame.
+        bin(pulse);
+    }
+    if (start < size) {
+        // Whatever follows the last gap; the final frame of a capture usually
+        // has no trailing gap of its own.
+        for (; i < size; i++) {
+            bin(data[i]);
+        }
+        add(start, size, estimator.te(teMinCount));
+    }
+    return count;
+}
+
+void FrameSegmenter::bin(PulseDuration pulse) {
+    if (histogram) {
+        histogram->add(pulse);
+    }
+}
+
+void FrameSegmenter::add(size_t start, size_t end, uint32_t te) {
+    PulseWidths widths;
+    if (histogram) {
+        histogram->finish();
+        widths = histogram->widths();
+        histogram->clear();
+    }
+    if (end - start < minPulses) {
+        return;
+    }
+    spans[count].start = static_cast<uint32_t>(start);
+    spans[count].length = static_cast<uint32_t>(end - start);
+    spans[count].te = te;
+    spans[count].widths = widths;
+    count++;
+}
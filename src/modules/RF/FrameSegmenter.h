@@ -0,0 +1,90 @@
+#ifndef FRAME_SEGMENTER_H
+#define FRAME_SEGMENTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "FrameAssembler.h"
+#include "PackedPulses.h"
+#include "PulseHistogram.h"
+
+#define SEGMENT_MAX_FRAMES 32   // frames tracked per capture; the rest stays in the last one
+
+/**
+ * Splits a capture into frames at inter-frame gaps, BinRAW style.
+ *
+ * TE is estimated per frame from its own pulses, so a capture holding
+ * several remotes with different timings is cut correctly. Once teMinCount
+ * pulses have been seen, a low pulse longer than gapMultiplier * TE ends the
+ * frame; FRAME_GAP_MULTIPLIER keeps headers such as KeeLoq's in their frame,
+ * which decoders that take the frame as received need whole. The gap is the
+ * last pulse of that frame and the first pulse of the next one, where
+ * decoders look for the header. Frames are views into the
+ * capture; nothing is copied, so the capture must outlive them.
+ *
+ * Given a histogram, every pulse is also binned on it during the same pass,
+ * so each frame's pulse widths come out of split() with its span and the
+ * decoders do not walk the frame again to time it.
+ */
+class FrameSegmenter {
+public:
+    FrameSegmenter(float gapMultiplier, uint16_t teMinCount, size_t minPulses,
+                   PulseHistogram* histogram = nullptr);
+
+    // Returns the number of frames found. Without any gap the whole capture
+    // is one frame.
+    size_t split(const PulseDuration* data, size_t size);
+
+    size_t size() const {
+        return count;
+    }
+
+    PulseView frame(size_t index) const {
+        return PulseView(base + spans[index].start, spans[index].length);
+    }
+
+    // Position of the frame in the capture, in pulses.
+    size_t start(size_t index) const {
+        return spans[index].start;
+    }
+
+    size_t length(size_t index) const {
+        return spans[index].length;
+    }
+
+    // TE estimate of the frame, 0 if it had too few high pulses.
+    uint32_t te(size_t index) const {
+        return spans[index].te;
+    }
+
+    // split() had a histogram to find widths() on.
+    bool clustered() const {
+        return histogram != nullptr;
+    }
+
+    // The frame's two most common pulse widths; empty unless clustered().
+    const PulseWidths& widths(size_t index) const {
+        return spans[index].widths;
+    }
+
+private:
+    struct Span {
+        uint32_t start;
+        uint32_t length;
+        uint32_t te;
+        PulseWidths widths;
+    };
+
+    void add(size_t start, size_t end, uint32_t te);
+    void bin(PulseDuration pulse);
+
+    TeEstimator estimator;
+    PulseHistogram* histogram;
+    Span spans[SEGMENT_MAX_FRAMES];
+    const PulseDuration* base;
+    size_t count;
+    float gapMultiplier;
+    uint16_t teMinCount;
+    size_t minPulses;
+};
+
+#endif // FRAME_SEGMENTER_H
@@ -0,0 +1,46 @@
+#include "FrameTimeStats.h"
+#include <cstdio>
+
+void FrameTimePercentiles::add(uint32_t us) {
+    p50.add(static_cast<float>(us));
+    p95.add(static_cast<float>(us));
+    p99.add(static_cast<float>(us));
+    if (us > max) {
+        max = us;
+    }
+}
+
+void FrameTimePercentiles::reset() {
+    p50.reset();
+    p95.reset();
+    p99.reset();
+    max = 0;
+}
+
+void FrameTimeStats::add(uint32_t us, bool analysing) {
+    (analysing ? analysingFrames : idleFrames).add(us);
+}
+
+void FrameTimeStats::addLatency(uint32_t us) {
+    captureLatency.add(us);
+}
+
+void FrameTimeStats::reset() {
+    idleFrames.reset();
+    analysingFrames.reset();
+    captureLatency.reset();
+}
+
+int FrameTimeStats::format(char* out, size_t size) const {
+    const FrameTimePercentiles& i = idleFrames;
+    const FrameTimePercentiles& a = analysingFrames;
+    const FrameTimePercentiles& l = captureLatency;
+    return snprintf(out, size,
+                    "UI frame us p50/p95/p99/max: idle %.0f/%.0f/%.0f/%lu (n=%lu), "
+                    "analysing %.0f/%.0f/%.0f/%lu (n=%lu), capture latency %.0f/%.0f/%.0f/%lu (n=%lu)",
+                    i.p50.value(), i.p95.value(), i.p99.value(), static_cast<unsigned long>(i.max),
+                    static_cast<unsigned long>(i.count()), a.p50.value(), a.p95.value(), a.p99.value(),
+                    static_cast<unsigned long>(a.max), static_cast<unsigned long>(a.count()), l.p50.value(),
+                    l.p95.value(), l.p99.value(), static_cast<unsigned long>(l.max),
+                    static_cast<unsigned long>(l.count()));
+}
@@ -0,0 +1,63 @@
+#ifndef FRAME_TIME_STATS_H
+#define FRAME_TIME_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "protocols/math.h"
+
+#define FRAME_STATS_REPORT_FRAMES 2000  // UI frames between two reports
+
+// Running p50/p95/p99 and maximum of one kind of UI frame, in us.
+struct FrameTimePercentiles {
+    StreamingQuantile p50{0.50f};
+    StreamingQuantile p95{0.95f};
+    StreamingQuantile p99{0.99f};
+    uint32_t max = 0;
+
+    void add(uint32_t us);
+    void reset();
+
+    uint32_t count() const {
+        return p50.count();
+    }
+};
+
+/**
+ * How long the UI loop takes per frame, kept apart for frames during which a
+ * capture was being analysed and frames without one, so the cost of
+ * analysis to the UI shows on its own. Also keeps the latency from the end
+ * of a capture to its outcome on screen, so it is reported in the same
+ * summary rather than per capture.
+ */
+class FrameTimeStats {
+public:
+    void add(uint32_t us, bool analysing);
+    void addLatency(uint32_t us);
+    void reset();
+
+    const FrameTimePercentiles& idle() const {
+        return idleFrames;
+    }
+
+    const FrameTimePercentiles& analysing() const {
+        return analysingFrames;
+    }
+
+    const FrameTimePercentiles& latency() const {
+        return captureLatency;
+    }
+
+    uint32_t frames() const {
+        return idleFrames.count() + analysingFrames.count();
+    }
+
+    // One line with all three sets of figures; returns its length as snprintf.
+    int format(char* out, size_t size) const;
+
+private:
+    FrameTimePercentiles idleFrames;
+    FrameTimePercentiles analysingFrames;
+    FrameTimePercentiles captureLatency;
+};
+
+#endif // FRAME_TIME_STATS_H
@@ -0,0 +1,15 @@
+#include "KeeLoqEntry.h"
+
+void KeeLoqEntry::reset() {
+    decoder.reset();
+    found = false;
+}
+
+bool KeeLoqEntry::feed(bool level, uint32_t duration) {
+    decoder.feed(level, duration);
+    if (!found && decoder.hasResult()) {
+        decoder.getResult(result, 0ULL, KeeLoqCommon::KeeLoqLearningType::Unknown, "");
+        found = true;
+    }
+    return found;
+}
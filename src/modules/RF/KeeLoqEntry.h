@@ -0,0 +1,72 @@
+#ifndef KEELOQ_ENTRY_H
+#define KEELOQ_ENTRY_H
+
+#include <cstdint>
+#include <string>
+#include "ProtocolRegistry.h"
+#include "protocols/KeeLoqProtocol.hpp"
+
+/**
+ * Registry entry for KeeLoq, which runs its own timing on the frame as
+ * received instead of the filtered copy and decrypts into KeeLoqData.
+ */
+class KeeLoqEntry : public SubGhzDecoder {
+public:
+    explicit KeeLoqEntry(KeeLoqProtocolDecoder& decoder) : decoder(decoder), found(false) {}
+
+    const char* name() const override {
+        return "KeeLoq";
+    }
+
+    const SubGhzBlockConst& timing() const override {
+        return KeeLoqProtocolDecoder::timing;
+    }
+
+    bool rawInput() const override {
+        return true;
+    }
+
+    // Data bits are read at the te of the preamble.
+    bool adaptiveTe() const override {
+        return true;
+    }
+
+    void reset() override;
+    bool feed(bool level, uint32_t duration) override;
+
+    bool hasResult() const override {
+        return found;
+    }
+
+    bool synced() const override {
+        return decoder.isSynced();
+    }
+
+    uint64_t code() const override {
+        return result.data;
+    }
+
+    uint8_t bits() const override {
+        return result.data_count_bit;
+    }
+
+    // Serial and button; the hop word changes on every press.
+    uint64_t identity() const override {
+        return result.fix_part;
+    }
+
+    uint32_t te() const override {
+        return decoder.getTe();
+    }
+
+    std::string describe(uint64_t shortPulse, uint64_t longPulse) override {
+        return result.getCodeString();
+    }
+
+private:
+    KeeLoqProtocolDecoder& decoder;
+    KeeLoqData result;
+    bool found;
+};
+
+#endif // KEELOQ_ENTRY_H
@@ -0,0 +1,76 @@
+#include "ManchesterSlicer.h"
+#include <cstring>
+
+void ManchesterSlicer::configure(uint32_t te) {
+    chipTe = te;
+    // Windows of te / 2 either side, in the form PwmDecoder::within() uses.
+    const uint32_t delta = te / 2;
+    oneFrom = te - delta + 1;
+    twoFrom = 2 * te - delta + 1;
+    span = delta ? 2 * delta - 1 : 0;
+    reset();
+}
+
+void ManchesterSlicer::append(bool level, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++, chipCount++) {
+        if (level) {
+            chips[chipCount / 8] |= 0x80 >> (chipCount % 8);
+        } else {
+            chips[chipCount / 8] &= ~(0x80 >> (chipCount % 8));
+        }
+    }
+}
+
+bool ManchesterSlicer::feed(bool level, uint32_t duration) {
+    if (ready) {
+        reset();
+    }
+    const uint32_t count = duration - oneFrom < span ? 1 : duration - twoFrom < span ? 2 : 0;
+    if (count && chipCount + count <= SLICER_MAX_CHIPS) {
+        append(level, count);
+        return false;
+    }
+    // The line settling after the packet swallows its last half bit.
+    if (duration >= twoFrom + span && chipCount > 0 && chipCount < SLICER_MAX_CHIPS) {
+        append(level, 1);
+    }
+    ready = chipCount >= SLICER_MIN_CHIPS;
+    if (!ready) {
+        chipCount = 0;
+    }
+    return ready;
+}
+
+size_t ManchesterSlicer::find(uint16_t bits, uint8_t bitCount, size_t from) const {
+    uint32_t pattern = 0;
+    for (int i = bitCount - 1; i >= 0; i--) {
+        pattern = pattern << 2 | ((bits >> i) & 1 ? 0x2 : 0x1);
+    }
+    const size_t length = 2u * bitCount;
+    const uint32_t mask = length < 32 ? (1u << length) - 1 : 0xFFFFFFFFu;
+    uint32_t window = 0;
+    for (size_t i = from; i < chipCount; i++) {
+        window = window << 1 | chip(i);
+        if (i + 1 - from >= length && (window & mask) == pattern) {
+            return i + 1;
+        }
+    }
+    return SIZE_MAX;
+}
+
+bool ManchesterSlicer::decode(size_t at, uint8_t* out, size_t bytes) const {
+    if (at + bytes * 16 > chipCount) {
+        return false;
+    }
+    std::memset(out, 0, bytes);
+    for (size_t bit = 0; bit < bytes * 8; bit++, at += 2) {
+        const bool first = chip(at);
+        if (first == chip(at + 1)) {
+            return false;
+        }
+        if (first) {
+            out[bit / 8] |= 0x80 >> (bit % 8);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,70 @@
+#ifndef MANCHESTER_SLICER_H
+#define MANCHESTER_SLICER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define SLICER_MAX_CHIPS 512    // half bits kept per packet, 256 bits
+#define SLICER_MIN_CHIPS 64     // shorter runs of fitting pulses are noise
+
+/**
+ * Cuts the demodulated output of an FSK receiver into Manchester chips, the
+ * half-bit slots of one te each, on the fly. FSK has no quiet line between
+ * packets, only noise, so a packet is a run of pulses that each fit one or
+ * two te; the first pulse that does not ends it. Which chip pairs are bits,
+ * and what they mean, is left to the protocol: find() looks for its sync and
+ * decode() reads its payload.
+ */
+class ManchesterSlicer {
+public:
+    ManchesterSlicer() {
+        configure(0);
+    }
+
+    // Pulses within te / 2 of te or 2 * te fit.
+    void configure(uint32_t te);
+
+    uint32_t te() const {
+        return chipTe;
+    }
+
+    // Adds one pulse; returns true if it ended a packet of at least
+    // SLICER_MIN_CHIPS chips, which stays readable until the next feed().
+    bool feed(bool level, uint32_t duration);
+
+    void reset() {
+        chipCount = 0;
+        ready = false;
+    }
+
+    // Chips of the packet, 1 for high.
+    size_t size() const {
+        return chipCount;
+    }
+
+    bool chip(size_t i) const {
+        return chips[i / 8] >> (7 - i % 8) & 1;
+    }
+
+    // Chip index right after the first match at or after from of the
+    // bitCount (<= 16) low bits of bits sent high-low for 1, low-high for 0.
+    // SIZE_MAX if there is none.
+    size_t find(uint16_t bits, uint8_t bitCount, size_t from) const;
+
+    // Reads bytes from chip at on, a bit per chip pair, first bit in the top
+    // of out[0]. Returns false if a pair has no transition or the packet ends.
+    bool decode(size_t at, uint8_t* out, size_t bytes) const;
+
+private:
+    void append(bool level, uint32_t count);
+
+    uint32_t chipTe;
+    uint32_t oneFrom;
+    uint32_t twoFrom;
+    uint32_t span;
+    uint8_t chips[SLICER_MAX_CHIPS / 8];
+    size_t chipCount;
+    bool ready;
+};
+
+#endif // MANCHESTER_SLICER_H
@@ -0,0 +1,165 @@
+#ifndef PACKED_PULSES_H
+#define PACKED_PULSES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+// Signed pulse duration in microseconds; the sign carries the level
+// (positive = high, negative = low), same convention as Flipper RAW_Data.
+using PulseDuration = int32_t;
+
+// Packed encoding: one int16 word per pulse. Durations outside the int16 range
+// are written as PULSE_ESCAPE followed by the high and low halves of the value.
+#define PULSE_ESCAPE INT16_MIN
+
+// Number of int16 words a pulse takes in the packed encoding (1 or 3).
+inline size_t packedWordCount(PulseDuration pulse) {
+    return (pulse > INT16_MIN && pulse <= INT16_MAX) ? 1 : 3;
+}
+
+// Writes one pulse in packed form to out; returns the number of words written.
+inline size_t packPulse(PulseDuration pulse, int16_t* out) {
+    if (packedWordCount(pulse) == 1) {
+        out[0] = static_cast<int16_t>(pulse);
+        return 1;
+    }
+    const uint32_t raw = static_cast<uint32_t>(pulse);
+    out[0] = PULSE_ESCAPE;
+    out[1] = static_cast<int16_t>(static_cast<uint16_t>(raw >> 16));
+    out[2] = static_cast<int16_t>(static_cast<uint16_t>(raw & 0xFFFF));
+    return 3;
+}
+
+/**
+ * Forward iterator over either a contiguous PulseDuration array or a packed
+ * int16 stream. Decoders only walk pulses front to back, so this is all they need.
+ */
+class PulseIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = PulseDuration;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const PulseDuration*;
+    using reference = PulseDuration;
+
+    PulseIterator() : wide(nullptr), packed(nullptr) {}
+    explicit PulseIterator(const PulseDuration* p) : wide(p), packed(nullptr) {}
+    explicit PulseIterator(const int16_t* p) : wide(nullptr), packed(p) {}
+
+    PulseDuration operator*() const {
+        if (wide) {
+            return *wide;
+        }
+        if (*packed != PULSE_ESCAPE) {
+            return *packed;
+        }
+        return static_cast<PulseDuration>((static_cast<uint32_t>(static_cast<uint16_t>(packed[1])) << 16) |
+                                          static_cast<uint16_t>(packed[2]));
+    }
+
+    PulseIterator& operator++() {
+        if (wide) {
+            ++wide;
+        } else {
+            packed += (*packed == PULSE_ESCAPE) ? 3 : 1;
+        }
+        return *this;
+    }
+
+    PulseIterator operator++(int) {
+        PulseIterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const PulseIterator& other) const {
+        return wide == other.wide && packed == other.packed;
+    }
+
+    bool operator!=(const PulseIterator& other) const {
+        return !(*this == other);
+    }
+
+private:
+    const PulseDuration* wide;
+    const int16_t* packed;
+};
+
+/**
+ * Non-owning view of a pulse sequence. Cheap to copy; pass by value.
+ */
+class PulseView {
+public:
+    PulseView() : first(), last(), count(0) {}
+    PulseView(const PulseDuration* data, size_t size)
+        : first(data), last(data + size), count(size) {}
+    PulseView(const std::vector<PulseDuration>& pulses)
+        : PulseView(pulses.data(), pulses.size()) {}
+    PulseView(const int16_t* words, size_t wordCount, size_t pulseCount)
+        : first(words), last(words + wordCount), count(pulseCount) {}
+
+    PulseIterator begin() const { return first; }
+    PulseIterator end() const { return last; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+private:
+    PulseIterator first;
+    PulseIterator last;
+    size_t count;
+};
+
+/**
+ * Owning, append-only packed pulse storage: 2 bytes per pulse for anything
+ * under 32.767 ms, 6 bytes for the rare longer gap.
+ */
+class PackedPulseBuffer {
+public:
+    void push_back(PulseDuration pulse) {
+        int16_t packed[3];
+        const size_t n = packPulse(pulse, packed);
+        words.insert(words.end(), packed, packed + n);
+        count++;
+    }
+
+    void assign(PulseView pulses) {
+        clear();
+        words.reserve(pulses.size());
+        for (PulseDuration pulse : pulses) {
+            push_back(pulse);
+        }
+    }
+
+    PulseView view() const {
+        return PulseView(words.data(), words.size(), count);
+    }
+
+    operator PulseView() const {
+        return view();
+    }
+
+    PulseIterator begin() const { return view().begin(); }
+    PulseIterator end() const { return view().end(); }
+
+    PulseDuration front() const { return *begin(); }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t bytes() const { return words.size() * sizeof(int16_t); }
+
+    void clear() {
+        words.clear();
+        count = 0;
+    }
+
+    void shrink_to_fit() {
+        words.shrink_to_fit();
+    }
+
+private:
+    std::vector<int16_t> words;
+    size_t count = 0;
+};
+
+#endif // PACKED_PULSES_H
@@ -0,0 +1,101 @@
+#include "ProtocolRegistry.h"
+#include <algorithm>
+#include <cstring>
+
+static uint32_t windowLow(uint16_t te, uint16_t delta) {
+    return te > delta ? te - delta : 0;
+}
+
+static uint32_t windowHigh(uint16_t te, uint16_t delta) {
+    return static_cast<uint32_t>(te) + delta;
+}
+
+// Short pulses an adaptive decoder can read: te taken anywhere in the
+// nominal window, then te_delta scaled along with it.
+static uint32_t adaptiveLow(const SubGhzBlockConst& timing) {
+    const uint32_t te = windowLow(timing.te_short, timing.te_delta);
+    return te - te * timing.te_delta / timing.te_short;
+}
+
+static uint32_t adaptiveHigh(const SubGhzBlockConst& timing) {
+    const uint32_t te = windowHigh(timing.te_short, timing.te_delta);
+    return te + te * timing.te_delta / timing.te_short;
+}
+
+// The te_short interval a decoder is indexed under.
+static uint32_t indexLow(const SubGhzDecoder& decoder) {
+    const SubGhzBlockConst& timing = decoder.timing();
+    return decoder.adaptiveTe() ? adaptiveLow(timing) : windowLow(timing.te_short, timing.te_delta);
+}
+
+static uint32_t indexHigh(const SubGhzDecoder& decoder) {
+    const SubGhzBlockConst& timing = decoder.timing();
+    return decoder.adaptiveTe() ? adaptiveHigh(timing) : windowHigh(timing.te_short, timing.te_delta);
+}
+
+bool ProtocolRegistry::add(SubGhzDecoder& decoder) {
+    if (count == PROTOCOL_REGISTRY_SIZE) {
+        return false;
+    }
+    decoders[count++] = &decoder;
+    return true;
+}
+
+void ProtocolRegistry::build() {
+    boundCount = 0;
+    adaptiveMask = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (decoders[i]->adaptiveTe()) {
+            adaptiveMask |= 1u << i;
+        }
+        bounds[boundCount++] = indexLow(*decoders[i]);
+        bounds[boundCount++] = indexHigh(*decoders[i]) + 1;
+    }
+    std::sort(bounds, bounds + boundCount);
+    boundCount = std::unique(bounds, bounds + boundCount) - bounds;
+
+    for (size_t b = 0; b < boundCount; b++) {
+        masks[b] = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (bounds[b] >= indexLow(*decoders[i]) && bounds[b] <= indexHigh(*decoders[i])) {
+                masks[b] |= 1u << i;
+            }
+        }
+    }
+}
+
+size_t ProtocolRegistry::candidates(uint32_t shortPulse, uint32_t longPulse, SubGhzDecoder** out,
+                                    size_t maxOut) const {
+    const uint32_t* interval = std::upper_bound(bounds, bounds + boundCount, shortPulse);
+    if (interval == bounds) {
+        return 0;
+    }
+    uint32_t mask = masks[interval - bounds - 1];
+    size_t found = 0;
+    while (mask && found < maxOut) {
+        const size_t i = __builtin_ctz(mask);
+        mask &= mask - 1;
+        const SubGhzBlockConst& timing = decoders[i]->timing();
+        if (adaptiveMask & (1u << i)) {
+            // Cross-multiplied by te_short so nothing is rounded.
+            const uint64_t scaledLong = static_cast<uint64_t>(longPulse) * timing.te_short;
+            const uint64_t expected = static_cast<uint64_t>(shortPulse) * timing.te_long;
+            if (DURATION_DIFF(scaledLong, expected) <= static_cast<uint64_t>(shortPulse) * timing.te_delta) {
+                out[found++] = decoders[i];
+            }
+        } else if (longPulse >= windowLow(timing.te_long, timing.te_delta) &&
+                   longPulse <= windowHigh(timing.te_long, timing.te_delta)) {
+            out[found++] = decoders[i];
+        }
+    }
+    return found;
+}
+
+SubGhzDecoder* ProtocolRegistry::find(const char* name) const {
+    for (size_t i = 0; i < count; i++) {
+        if (std::strcmp(decoders[i]->name(), name) == 0) {
+            return decoders[i];
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,204 @@
+#ifndef PROTOCOL_REGISTRY_H
+#define PROTOCOL_REGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "protocols/math.h"
+
+#define PROTOCOL_REGISTRY_SIZE 16   // decoders the registry can hold
+
+/**
+ * What the registry needs from a decoder: its declared timing, its feed()
+ * state machine, the key it found and a text description of that key.
+ */
+class SubGhzDecoder {
+public:
+    virtual ~SubGhzDecoder() {}
+
+    virtual const char* name() const = 0;
+    virtual const SubGhzBlockConst& timing() const = 0;
+
+    // Decoders that do their own timing get the pulses as received instead
+    // of quantized onto the measured short and long pulse.
+    virtual bool rawInput() const {
+        return false;
+    }
+
+    // Decoders that measure te on each frame and scale their windows to it
+    // take any short pulse in their te_short window, with the long pulse in
+    // proportion.
+    virtual bool adaptiveTe() const {
+        return false;
+    }
+
+    virtual void reset() = 0;
+    // Returns true once a key has been found.
+    virtual bool feed(bool level, uint32_t duration) = 0;
+    virtual bool hasResult() const = 0;
+    virtual uint64_t code() const = 0;
+    virtual uint8_t bits() const = 0;
+
+    // The part of the key that is the same on every press of one remote, for
+    // recognising it again; rolling-code decoders leave the hop word out.
+    virtual uint64_t identity() const {
+        return code();
+    }
+
+    // te the last key was decoded against; 0 unless adaptiveTe().
+    virtual uint32_t te() const {
+        return 0;
+    }
+
+    // Out of its reset state: the decoder took the frame's preamble or start
+    // bit. Only read for DecoderMetrics; false if the decoder cannot tell.
+    virtual bool synced() const {
+        return false;
+    }
+
+    // Protocol-specific lines for the last decoded key (buttons, DIP
+    // switches, serial); plain text, rendering is up to the caller.
+    virtual std::string describe(uint64_t shortPulse, uint64_t longPulse) = 0;
+};
+
+// Decoders that estimate te per frame have `uint32_t getTe() const`.
+template <typename Decoder, typename = void>
+struct EstimatesTe : std::false_type {};
+
+template <typename Decoder>
+struct EstimatesTe<Decoder, decltype(void(std::declval<const Decoder&>().getTe()))> : std::true_type {};
+
+// Decoders that tell whether they are past their preamble have
+// `bool isSynced() const`.
+template <typename Decoder, typename = void>
+struct TracksSync : std::false_type {};
+
+template <typename Decoder>
+struct TracksSync<Decoder, decltype(void(std::declval<const Decoder&>().isSynced()))> : std::true_type {};
+
+/**
+ * Registry entry for the usual decoder class: reset()/feed()/hasValidCode(),
+ * getCode()/getBitCount(), getCodeString() for the text and a static
+ * SubGhzBlockConst timing, plus getTe() if it adapts to the frame's te and
+ * isSynced() if it can tell it is past its preamble.
+ */
+template <typename Decoder>
+class DecoderAdapter : public SubGhzDecoder {
+public:
+    DecoderAdapter(const char* name, Decoder& decoder) : label(name), decoder(decoder) {}
+
+    const char* name() const override {
+        return label;
+    }
+
+    const SubGhzBlockConst& timing() const override {
+        return Decoder::timing;
+    }
+
+    void reset() override {
+        decoder.reset();
+    }
+
+    bool feed(bool level, uint32_t duration) override {
+        decoder.feed(level, duration);
+        return decoder.hasValidCode();
+    }
+
+    bool hasResult() const override {
+        return decoder.hasValidCode();
+    }
+
+    uint64_t code() const override {
+        return decoder.getCode();
+    }
+
+    uint8_t bits() const override {
+        return decoder.getBitCount();
+    }
+
+    bool adaptiveTe() const override {
+        return EstimatesTe<Decoder>::value;
+    }
+
+    uint32_t te() const override {
+        if constexpr (EstimatesTe<Decoder>::value) {
+            return decoder.getTe();
+        } else {
+            return 0;
+        }
+    }
+
+    bool synced() const override {
+        if constexpr (TracksSync<Decoder>::value) {
+            return decoder.isSynced();
+        } else {
+            return false;
+        }
+    }
+
+    std::string describe(uint64_t shortPulse, uint64_t longPulse) override {
+        return decoder.getCodeString(shortPulse, longPulse);
+    }
+
+private:
+    const char* label;
+    Decoder& decoder;
+};
+
+/**
+ * Decoders indexed by the timing they declare.
+ *
+ * Every decoder accepts a short pulse within te_short +- te_delta. build()
+ * cuts the te_short axis at all window edges into intervals, each with a
+ * bitmask of the decoders whose window covers it, so candidates() is a
+ * binary search plus a te_long check per hit instead of a compare against
+ * every protocol. Adaptive decoders take te from any start bit or preamble
+ * in that window and scale te_delta with it, so their interval is widened by
+ * te_delta scaled to either end of the window, and their te_long and
+ * te_delta are scaled by shortPulse / te_short first, as the decoder will
+ * scale them.
+ */
+class ProtocolRegistry {
+public:
+    ProtocolRegistry() : count(0), adaptiveMask(0), boundCount(0) {}
+
+    // Returns false if the registry is full.
+    bool add(SubGhzDecoder& decoder);
+
+    // Drops all decoders, e.g. before registering a reloaded set.
+    void clear() {
+        count = 0;
+        adaptiveMask = 0;
+        boundCount = 0;
+    }
+
+    // Recomputes the index; call after the last add().
+    void build();
+
+    // Fills out with the decoders whose short and long windows both contain
+    // the measured pulses, in registration order. Returns how many matched.
+    size_t candidates(uint32_t shortPulse, uint32_t longPulse, SubGhzDecoder** out, size_t maxOut) const;
+
+    SubGhzDecoder* find(const char* name) const;
+
+    size_t size() const {
+        return count;
+    }
+
+    SubGhzDecoder& operator[](size_t i) const {
+        return *decoders[i];
+    }
+
+private:
+    SubGhzDecoder* decoders[PROTOCOL_REGISTRY_SIZE];
+    size_t count;
+    uint32_t adaptiveMask;  // bit i set if decoders[i] has adaptiveTe()
+    // Interval i is [bounds[i], bounds[i + 1]); masks[i] holds its decoders.
+    uint32_t bounds[PROTOCOL_REGISTRY_SIZE * 2];
+    uint32_t masks[PROTOCOL_REGISTRY_SIZE * 2];
+    size_t boundCount;
+};
+
+#endif // PROTOCOL_REGISTRY_H
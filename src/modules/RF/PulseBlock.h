@@ -0,0 +1,122 @@
+#ifndef PULSE_BLOCK_H
+#define PULSE_BLOCK_H
+
+#include <cstddef>
+#include <cstdint>
+#include "PackedPulses.h"
+
+#define PULSE_BLOCK_SIZE 1024     // Pulses per streaming block
+#define PULSE_BLOCK_MIN_COUNT 24  // Blocks shorter than this are treated as noise
+
+// A run of consecutive pulses cut from the continuous receive stream.
+struct PulseBlock {
+    PulseDuration samples[PULSE_BLOCK_SIZE];
+    uint16_t count = 0;
+    uint32_t startTime = 0;   // timestamp of the first edge (us)
+    uint32_t endTime = 0;     // timestamp of the last edge (us)
+
+    void clear() {
+        count = 0;
+        startTime = 0;
+        endTime = 0;
+    }
+
+    bool full() const {
+        return count >= PULSE_BLOCK_SIZE;
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    const PulseDuration* data() const {
+        return samples;
+    }
+
+    size_t size() const {
+        return count;
+    }
+};
+
+/**
+ * Double-buffered pulse blocks for continuous receive.
+ *
+ * The receive side appends into the active block. When the block fills up or
+ * the caller closes it at a frame gap, it is handed over as the completed block
+ * and appending switches to the other one, so capture never waits for the
+ * decoders. If the decoders still hold the previous completed block when the
+ * next one closes, the new block is dropped and counted in overruns().
+ */
+class PulseBlockBuffer {
+public:
+    PulseBlockBuffer() : active(0), ready(-1), overrunCount(0) {}
+
+    // Appends one pulse; returns true if this completed a block.
+    bool append(PulseDuration pulse, uint32_t timestamp) {
+        PulseBlock& block = blocks[active];
+        if (block.empty()) {
+            block.startTime = timestamp;
+        }
+        block.samples[block.count++] = pulse;
+        block.endTime = timestamp;
+        if (block.full()) {
+            return closeBlock();
+        }
+        return false;
+    }
+
+    // Ends the active block at a frame gap. Short blocks are discarded as noise.
+    bool closeBlock() {
+        PulseBlock& block = blocks[active];
+        if (block.count < PULSE_BLOCK_MIN_COUNT) {
+            block.clear();
+            return false;
+        }
+        if (ready >= 0) {
+            overrunCount++;
+            block.clear();
+            return false;
+        }
+        ready = active;
+        active ^= 1;
+        blocks[active].clear();
+        return true;
+    }
+
+    // Completed block waiting for the decoders, or nullptr.
+    const PulseBlock* completed() const {
+        return ready >= 0 ? &blocks[ready] : nullptr;
+    }
+
+    // Called by the decoder side once it is done with completed().
+    void release() {
+        if (ready >= 0) {
+            blocks[ready].clear();
+            ready = -1;
+        }
+    }
+
+    const PulseBlock& current() const {
+        return blocks[active];
+    }
+
+    void reset() {
+        blocks[0].clear();
+        blocks[1].clear();
+        active = 0;
+        ready = -1;
+        overrunCount = 0;
+    }
+
+    uint32_t overruns() const {
+        return overrunCount;
+    }
+
+private:
+    PulseBlock blocks[2];
+    int active;
+    int ready;
+    uint32_t overrunCount;
+};
+
+#endif // PULSE_BLOCK_H
@@ -0,0 +1,126 @@
+#include "PulseHistogram.h"
+
+// Octave from the leading one, then the next four bits as the sub-bin.
+size_t PulseHistogram::binOf(uint32_t duration) {
+    const uint32_t octave = 31 - __builtin_clz(duration);
+    const uint32_t mantissa = octave >= 4 ? duration >> (octave - 4) : duration << (4 - octave);
+    return octave * HISTOGRAM_SUBBINS + (mantissa & (HISTOGRAM_SUBBINS - 1));
+}
+
+uint32_t PulseHistogram::binStart(size_t bin) {
+    const uint32_t octave = bin / HISTOGRAM_SUBBINS;
+    const uint32_t mantissa = HISTOGRAM_SUBBINS + bin % HISTOGRAM_SUBBINS;
+    return octave >= 4 ? mantissa << (octave - 4) : mantissa >> (4 - octave);
+}
+
+PulseHistogram::PulseHistogram() : lowBin(0), highBin(HISTOGRAM_BINS - 1), clusterCount(0) {
+    clear();
+}
+
+void PulseHistogram::clear() {
+    for (size_t b = lowBin; b <= highBin; b++) {
+        counts[b] = 0;
+        sums[b] = 0;
+    }
+    lowBin = HISTOGRAM_BINS;
+    highBin = 0;
+    clusterCount = 0;
+}
+
+size_t PulseHistogram::build(PulseView frame) {
+    clear();
+    for (PulseDuration pulse : frame) {
+        add(pulse);
+    }
+    return finish();
+}
+
+void PulseHistogram::add(PulseDuration pulse) {
+    const uint32_t duration = pulse < 0 ? -static_cast<uint32_t>(pulse) : static_cast<uint32_t>(pulse);
+    if (duration == 0) {
+        return;
+    }
+    const size_t bin = binOf(duration);
+    counts[bin]++;
+    sums[bin] += duration;
+    if (bin < lowBin) {
+        lowBin = bin;
+    }
+    if (bin > highBin) {
+        highBin = bin;
+    }
+}
+
+PulseWidths PulseHistogram::widths() const {
+    PulseWidths widths;
+    widths.clusters = static_cast<uint32_t>(clusterCount);
+    if (clusterCount > 0) {
+        widths.first = clusters[0].median;
+    }
+    if (clusterCount > 1) {
+        widths.second = clusters[1].median;
+    }
+    return widths;
+}
+
+size_t PulseHistogram::finish() {
+    clusterCount = 0;
+    if (lowBin > highBin) {
+        return 0;
+    }
+
+    size_t first = lowBin;
+    while (first <= highBin) {
+        // The cluster's shortest pulse is taken as the mean of its first bin.
+        const uint64_t shortest = sums[first] / counts[first];
+        size_t last = first;
+        uint32_t count = 0;
+        size_t next = first;
+        for (; next <= highBin; next++) {
+            if (!counts[next]) {
+                continue;
+            }
+            if (static_cast<uint64_t>(binStart(next)) * CLUSTER_SPREAD_DEN > shortest * CLUSTER_SPREAD_NUM) {
+                break;
+            }
+            count += counts[next];
+            last = next;
+        }
+
+        uint32_t seen = 0;
+        size_t middle = first;
+        for (size_t b = first; b <= last; b++) {
+            seen += counts[b];
+            if (seen * 2 > count) {
+                middle = b;
+                break;
+            }
+        }
+        PulseCluster cluster;
+        cluster.count = count;
+        cluster.median = static_cast<uint32_t>(sums[middle] / counts[middle]);
+
+        // Insert in order; clusters beyond the table would be the emptiest.
+        size_t at = clusterCount;
+        while (at > 0 && (clusters[at - 1].count < cluster.count ||
+                          (clusters[at - 1].count == cluster.count && clusters[at - 1].median > cluster.median))) {
+            at--;
+        }
+        if (at < HISTOGRAM_MAX_CLUSTERS) {
+            const size_t end = clusterCount < HISTOGRAM_MAX_CLUSTERS ? clusterCount : HISTOGRAM_MAX_CLUSTERS - 1;
+            for (size_t i = end; i > at; i--) {
+                clusters[i] = clusters[i - 1];
+            }
+            clusters[at] = cluster;
+            if (clusterCount < HISTOGRAM_MAX_CLUSTERS) {
+                clusterCount++;
+            }
+        }
+
+        first = next;
+        while (first <= highBin && !counts[first]) {
+            first++;
+        }
+    }
+    return clusterCount;
+}
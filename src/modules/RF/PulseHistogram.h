@@ -0,0 +1,75 @@
+#ifndef PULSE_HISTOGRAM_H
+#define PULSE_HISTOGRAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include "PackedPulses.h"
+
+#define HISTOGRAM_SUBBINS 16        // bins per octave, about 4.4% wide
+#define HISTOGRAM_BINS (32 * HISTOGRAM_SUBBINS)
+#define HISTOGRAM_MAX_CLUSTERS 96   // a 1.3x spread fits 85 times into 32 octaves
+#define CLUSTER_SPREAD_NUM 13       // a cluster spans up to 1.3x its shortest pulse
+#define CLUSTER_SPREAD_DEN 10
+
+struct PulseCluster {
+    uint32_t count;
+    uint32_t median;    // mean of the bin holding the middle pulse
+};
+
+// The two most populated clusters of a frame, what CaptureDecoder::measure()
+// times it by.
+struct PulseWidths {
+    uint32_t clusters = 0;  // in the frame
+    uint32_t first = 0;     // median of the most populated, 0 if none
+    uint32_t second = 0;    // of the next, 0 if the frame had one
+};
+
+/**
+ * Groups pulse durations of a frame on a log-scale histogram.
+ *
+ * One pass bins every duration (levels ignored), a walk over the occupied
+ * bins cuts them into clusters no wider than 1.3x their shortest pulse, the
+ * rule filterSignal() used to apply on the sorted durations. Linear in the
+ * frame length with no allocations; only the touched bin range is cleared
+ * for the next frame. build() is clear(), add() for every pulse and finish()
+ * on a whole frame; FrameSegmenter calls add() as it walks a capture
+ * instead, so each frame's widths are known as soon as its gap is found.
+ */
+class PulseHistogram {
+public:
+    PulseHistogram();
+
+    // clear(), add() for every pulse, then finish().
+    size_t build(PulseView frame);
+
+    void clear();
+    void add(PulseDuration pulse);
+
+    // Groups the pulses added since clear(); returns the number of clusters.
+    size_t finish();
+
+    size_t size() const {
+        return clusterCount;
+    }
+
+    // Most populated first, ties going to the shorter duration.
+    const PulseCluster& cluster(size_t i) const {
+        return clusters[i];
+    }
+
+    // The two most populated clusters found by finish().
+    PulseWidths widths() const;
+
+    static size_t binOf(uint32_t duration);
+    static uint32_t binStart(size_t bin);
+
+private:
+    uint32_t counts[HISTOGRAM_BINS];
+    uint64_t sums[HISTOGRAM_BINS];
+    size_t lowBin;
+    size_t highBin;
+    PulseCluster clusters[HISTOGRAM_MAX_CLUSTERS];
+    size_t clusterCount;
+};
+
+#endif // PULSE_HISTOGRAM_H
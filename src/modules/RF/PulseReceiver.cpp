@@ -0,0 +1,134 @@
+#include "PulseReceiver.h"
+
+void PulseQuantizer::configure(uint32_t shortPulse, uint32_t longPulse) {
+    active = true;
+    this->shortPulse = static_cast<PulseDuration>(shortPulse);
+    this->longPulse = static_cast<PulseDuration>(longPulse);
+    shortMin = shortPulse * 0.7;
+    shortMax = shortPulse * 1.3;
+    longMin = longPulse * 0.7;
+    longMax = longPulse * 1.3;
+    spaceMin = static_cast<int64_t>(longPulse) * 13;
+    space = static_cast<PulseDuration>(longPulse * 18);
+}
+
+bool PulseQuantizer::apply(PulseDuration pulse, PulseDuration& out) const {
+    const int64_t sample = pulse < 0 ? -static_cast<int64_t>(pulse) : pulse;
+    PulseDuration snapped;
+    if (sample > spaceMin) {
+        snapped = space;
+    } else if (sample > shortMin && sample < shortMax) {
+        snapped = shortPulse;
+    } else if (sample > longMin && sample < longMax) {
+        snapped = longPulse;
+    } else {
+        return false;
+    }
+    out = pulse < 0 ? -snapped : snapped;
+    return true;
+}
+
+void PulseReceiver::begin(SubGhzDecoder* const* decoders, size_t count, const PulseQuantizer& quantizer,
+                          bool reversed) {
+    listeningCount = count < PROTOCOL_REGISTRY_SIZE ? count : PROTOCOL_REGISTRY_SIZE;
+    active = 0;
+    rawMask = 0;
+    completedCount = 0;
+    for (size_t i = 0; i < listeningCount; i++) {
+        listening[i] = decoders[i];
+        listening[i]->reset();
+        if (listening[i]->rawInput()) {
+            rawMask |= 1u << i;
+        }
+        // Without measured timing the quantized decoders have nothing to see.
+        if (quantizer.enabled() || listening[i]->rawInput()) {
+            active |= 1u << i;
+        }
+        counters[i] = metrics ? metrics->row(listening[i]->name()) : nullptr;
+    }
+    fedMask = active;
+    syncedMask = 0;
+    this->quantizer = quantizer;
+    this->reversed = reversed;
+}
+
+bool PulseReceiver::feed(PulseDuration pulse) {
+    if (reversed) {
+        pulse = -pulse;
+    }
+    PulseDuration snapped = 0;
+    uint32_t pending = active & rawMask;
+    if (quantizer.enabled() && quantizer.apply(pulse, snapped)) {
+        pending = active;
+    }
+
+    // One clock read per feed: each decoder's cost runs from the previous
+    // read to the one after its feed().
+    uint32_t mark = metrics ? DecoderMetrics::cycles() : 0;
+    while (pending) {
+        const size_t i = __builtin_ctz(pending);
+        pending &= pending - 1;
+        SubGhzDecoder& decoder = *listening[i];
+        const PulseDuration sample = rawMask & (1u << i) ? pulse : snapped;
+        const bool done = decoder.feed(sample > 0, static_cast<uint32_t>(sample > 0 ? sample : -sample));
+        if (metrics) {
+            mark = track(i, decoder, mark);
+        }
+        if (done) {
+            active &= ~(1u << i);
+            completedCount++;
+            if (callback) {
+                callback(decoder);
+                mark = metrics ? DecoderMetrics::cycles() : 0;
+            }
+        }
+    }
+    return active != 0;
+}
+
+size_t PulseReceiver::run(PulseView frame) {
+    for (PulseDuration pulse : frame) {
+        if (!active || !feed(pulse)) {
+            break;
+        }
+    }
+    finish();
+    return completedCount;
+}
+
+uint32_t PulseReceiver::track(size_t i, const SubGhzDecoder& decoder, uint32_t since) {
+    const uint32_t now = DecoderMetrics::cycles();
+    DecoderCounters* row = counters[i];
+    if (!row) {
+        return now;
+    }
+    row->cycles += now - since;
+    row->pulses++;
+    if (!(syncedMask & (1u << i)) && decoder.synced()) {
+        syncedMask |= 1u << i;
+    }
+    return now;
+}
+
+// Books the frame for every decoder that was fed it.
+void PulseReceiver::finish() {
+    if (!metrics) {
+        return;
+    }
+    const uint32_t completedMask = fedMask & ~active;
+    for (size_t i = 0; i < listeningCount; i++) {
+        const uint32_t bit = 1u << i;
+        DecoderCounters* row = counters[i];
+        if (!row || !(fedMask & bit)) {
+            continue;
+        }
+        if ((syncedMask | completedMask) & bit) {
+            row->synced++;
+        }
+        if (completedMask & bit) {
+            row->decoded++;
+        } else {
+            row->rejected[static_cast<size_t>(syncedMask & bit ? DecodeReject::Incomplete : DecodeReject::NoSync)]++;
+        }
+    }
+}
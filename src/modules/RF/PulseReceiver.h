@@ -0,0 +1,103 @@
+#ifndef PULSE_RECEIVER_H
+#define PULSE_RECEIVER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include "DecoderMetrics.h"
+#include "PackedPulses.h"
+#include "ProtocolRegistry.h"
+
+/**
+ * Snaps pulses onto the measured short and long pulse, with anything past 13
+ * long pulses becoming an 18-long space. Pulses outside every band are
+ * dropped. Disabled when the frame's timing could not be measured.
+ */
+class PulseQuantizer {
+public:
+    PulseQuantizer() : active(false) {}
+
+    void configure(uint32_t shortPulse, uint32_t longPulse);
+
+    void disable() {
+        active = false;
+    }
+
+    bool enabled() const {
+        return active;
+    }
+
+    // Returns false if the pulse is dropped.
+    bool apply(PulseDuration pulse, PulseDuration& out) const;
+
+private:
+    bool active;
+    PulseDuration shortPulse;
+    PulseDuration longPulse;
+    PulseDuration space;
+    int64_t shortMin;
+    int64_t shortMax;
+    int64_t longMin;
+    int64_t longMax;
+    int64_t spaceMin;
+};
+
+/**
+ * Walks a pulse stream once and pushes every pulse to all listening decoders'
+ * feed() in lockstep, quantized or as received depending on the decoder. A
+ * decoder is reported through the callback the moment its state machine
+ * completes and stops listening. With metrics set, each decoder's feed() is
+ * timed and run() books how the frame went for it.
+ */
+class PulseReceiver {
+public:
+    using DecodeCallback = std::function<void(SubGhzDecoder& decoder)>;
+
+    PulseReceiver()
+        : listeningCount(0), active(0), rawMask(0), fedMask(0), syncedMask(0), completedCount(0), reversed(false),
+          metrics(nullptr) {}
+
+    void setDecodeCallback(DecodeCallback callback) {
+        this->callback = callback;
+    }
+
+    // Takes effect from the next begin(); nullptr stops counting.
+    void setMetrics(DecoderMetrics* metrics) {
+        this->metrics = metrics;
+    }
+
+    // Resets the decoders and makes them the ones listening. Levels are
+    // inverted for a reversed stream.
+    void begin(SubGhzDecoder* const* decoders, size_t count, const PulseQuantizer& quantizer, bool reversed);
+
+    // Pushes one pulse; returns false once no decoder is listening.
+    bool feed(PulseDuration pulse);
+
+    // Feeds a whole frame, stopping early once every decoder completed.
+    // Returns how many decoders completed.
+    size_t run(PulseView frame);
+
+    size_t completed() const {
+        return completedCount;
+    }
+
+private:
+    // Books a feed() that started at since; returns the clock now.
+    uint32_t track(size_t i, const SubGhzDecoder& decoder, uint32_t since);
+    void finish();
+
+    SubGhzDecoder* listening[PROTOCOL_REGISTRY_SIZE];
+    DecoderCounters* counters[PROTOCOL_REGISTRY_SIZE];
+    size_t listeningCount;
+    uint32_t active;        // bit i set while listening[i] has no result yet
+    uint32_t rawMask;       // bit i set if listening[i] takes raw pulses
+    uint32_t fedMask;       // active as of begin()
+    uint32_t syncedMask;    // bit i set once listening[i] was synced()
+    size_t completedCount;
+    PulseQuantizer quantizer;
+    bool reversed;
+    DecodeCallback callback;
+    DecoderMetrics* metrics;
+};
+
+#endif // PULSE_RECEIVER_H
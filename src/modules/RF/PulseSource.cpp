@@ -0,0 +1,257 @@
+#include "PulseSource.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// How far the replay clock jumps once the last pulse has been read; longer than
+// any end-of-frame gap used by the receive path.
+#define REPLAY_IDLE_JUMP 1000000
+
+size_t ReplayPulseSource::read(Edge* out, size_t maxCount) {
+    size_t count = 0;
+    while (count < maxCount && position < samples.size()) {
+        const PulseDuration pulse = samples[position++];
+        clock += static_cast<uint32_t>(pulse < 0 ? -pulse : pulse);
+        out[count].timestamp = clock;
+        out[count].duration = pulse;
+        count++;
+    }
+    return count;
+}
+
+uint32_t ReplayPulseSource::now() const {
+    return finished() ? clock + REPLAY_IDLE_JUMP : clock;
+}
+
+bool ReplayPulseSource::finished() const {
+    return position >= samples.size();
+}
+
+void ReplayPulseSource::rewind() {
+    position = 0;
+    clock = 0;
+}
+
+void ReplayPulseSource::clear() {
+    samples.clear();
+    rewind();
+}
+
+void ReplayPulseSource::append(PulseDuration pulse) {
+    samples.push_back(pulse);
+}
+
+void SubFileSource::parse(const char* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] == '\n') {
+            parseLine(line);
+            line.clear();
+        } else {
+            line += data[i];
+        }
+    }
+}
+
+void SubFileSource::clear() {
+    ReplayPulseSource::clear();
+    line.clear();
+    frequency = 0;
+    preset.clear();
+    raw = false;
+    repeats = RepeatInfo();
+    truncated = false;
+}
+
+// Plays the repeated frame count times where it is, up to limit pulses, so
+// a buffer kept from an earlier file is reused rather than copied.
+static bool expandInPlace(std::vector<PulseDuration>& samples, const RepeatInfo& info, size_t limit) {
+    if (!info.repeated() || info.start + info.length > samples.size()) {
+        return false;
+    }
+    const size_t stored = samples.size();
+    const size_t frameEnd = info.start + info.length;
+    const size_t tailStart = frameEnd + info.elided();
+    const size_t size = std::min(stored + info.elided(), std::max(limit, stored));
+    samples.resize(size);
+    for (size_t i = stored; i-- > frameEnd;) {
+        const size_t to = tailStart + (i - frameEnd);
+        if (to < size) {
+            samples[to] = samples[i];
+        }
+    }
+    for (size_t i = frameEnd; i < std::min(tailStart, size); i++) {
+        samples[i] = samples[i - info.length];
+    }
+    return stored + info.elided() > size;
+}
+
+void SubFileSource::finish() {
+    if (!line.empty()) {
+        parseLine(line);
+        line.clear();
+    }
+    if (repeats.repeated()) {
+        truncated |= expandInPlace(samples, repeats, limit);
+        repeats = RepeatInfo();
+    }
+    if (samples.size() > limit) {
+        samples.resize(limit);
+        truncated = true;
+    }
+}
+
+#if defined(ARDUINO)
+bool SubFileSource::load(File32& file) {
+    char buffer[256];
+    int n;
+    while ((n = file.read(buffer, sizeof(buffer))) > 0) {
+        parse(buffer, static_cast<size_t>(n));
+    }
+    finish();
+    return raw && !samples.empty();
+}
+#else
+bool SubFileSource::load(std::istream& in) {
+    char buffer[256];
+    while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+        parse(buffer, static_cast<size_t>(in.gcount()));
+    }
+    finish();
+    return raw && !samples.empty();
+}
+#endif
+
+static bool startsWith(const std::string& text, const char* prefix) {
+    return text.compare(0, strlen(prefix), prefix) == 0;
+}
+
+static std::string trimmed(const std::string& text, size_t from) {
+    size_t begin = from;
+    size_t end = text.size();
+    while (begin < end && (text[begin] == ' ' || text[begin] == '\t')) {
+        begin++;
+    }
+    while (end > begin && (text[end - 1] == ' ' || text[end - 1] == '\t' || text[end - 1] == '\r')) {
+        end--;
+    }
+    return text.substr(begin, end - begin);
+}
+
+void SubFileSource::parseLine(const std::string& text) {
+    if (startsWith(text, "Frequency:")) {
+        frequency = static_cast<uint32_t>(strtoul(text.c_str() + 10, nullptr, 10));
+    } else if (startsWith(text, "Preset:")) {
+        preset = trimmed(text, 7);
+    } else if (startsWith(text, "Protocol:")) {
+        raw = trimmed(text, 9) == "RAW";
+    } else if (startsWith(text, "Repeat:")) {
+        unsigned start = 0;
+        unsigned length = 0;
+        unsigned count = 1;
+        if (sscanf(text.c_str() + 7, "%u %u %u", &start, &length, &count) == 3 && count > 1) {
+            repeats.start = start;
+            repeats.length = length;
+            repeats.count = static_cast<uint16_t>(count);
+        }
+    } else if (startsWith(text, "RAW_Data:")) {
+        const char* p = text.c_str() + 9;
+        char* end;
+        for (;;) {
+            const long value = strtol(p, &end, 10);
+            if (end == p) {
+                break;
+            }
+            if (value != 0) {
+                if (samples.size() == limit) {
+                    truncated = true;
+                    break;
+                }
+                append(static_cast<PulseDuration>(value));
+            }
+            p = end;
+        }
+    }
+}
+
+void SyntheticPulseSource::setJitter(uint32_t jitterUs, uint32_t randomSeed) {
+    jitter = jitterUs;
+    seed = randomSeed ? randomSeed : 1;
+}
+
+void SyntheticPulseSource::addFrame(PulseView frame, int repeats, uint32_t gapUs) {
+    for (int r = 0; r < repeats; r++) {
+        for (PulseDuration pulse : frame) {
+            addPulse(pulse);
+        }
+        addSilence(gapUs);
+    }
+}
+
+void SyntheticPulseSource::addAlternating(const std::vector<int64_t>& durations, bool firstLevel, int repeats, uint32_t gapUs) {
+    for (int r = 0; r < repeats; r++) {
+        bool level = firstLevel;
+        for (int64_t duration : durations) {
+            addPulse(level ? static_cast<PulseDuration>(duration) : -static_cast<PulseDuration>(duration));
+            level = !level;
+        }
+        addSilence(gapUs);
+    }
+}
+
+void SyntheticPulseSource::addPulse(PulseDuration pulse) {
+    if (jitter > 0) {
+        const int32_t error = static_cast<int32_t>(nextRandom() % (2 * jitter + 1)) - static_cast<int32_t>(jitter);
+        PulseDuration magnitude = (pulse < 0 ? -pulse : pulse) + error;
+        if (magnitude < 1) {
+            magnitude = 1;
+        }
+        pulse = pulse < 0 ? -magnitude : magnitude;
+    }
+    append(pulse);
+}
+
+void SyntheticPulseSource::addSilence(uint32_t us) {
+    if (us == 0) {
+        return;
+    }
+    if (!samples.empty() && samples.back() < 0) {
+        samples.back() -= static_cast<PulseDuration>(us);
+    } else {
+        append(-static_cast<PulseDuration>(us));
+    }
+}
+
+// xorshift32: cheap and repeatable, so a failing run can be reproduced.
+uint32_t SyntheticPulseSource::nextRandom() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+bool readBlock(PulseSource& source, PulseBlockBuffer& blocks, int32_t gapUs) {
+    if (blocks.completed() != nullptr) {
+        return true;
+    }
+
+    Edge edge;
+    while (source.read(&edge, 1) == 1) {
+        if (edge.duration > gapUs || edge.duration < -gapUs) {
+            if (blocks.closeBlock()) {
+                return true;
+            }
+            continue;
+        }
+        if (blocks.append(edge.duration, edge.timestamp)) {
+            return true;
+        }
+    }
+
+    // Nothing arrived for a whole gap: the frame is over.
+    const PulseBlock& current = blocks.current();
+    if (!current.empty() && (source.now() - current.endTime) > static_cast<uint32_t>(gapUs)) {
+        return blocks.closeBlock();
+    }
+    return false;
+}
@@ -0,0 +1,216 @@
+#ifndef PULSE_SOURCE_H
+#define PULSE_SOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "EdgeRing.h"
+#include "PackedPulses.h"
+#include "PulseBlock.h"
+#include "RepeatedCapture.h"
+
+#if defined(ESP32)
+#include <esp_timer.h>
+#else
+#include <chrono>
+#endif
+
+#if defined(ARDUINO)
+#include <SdFat.h>
+#else
+#include <istream>
+#endif
+
+/**
+ * Where the receive path gets its edges from.
+ *
+ * CC1101_CLASS drains whatever source is installed, so the same framing and
+ * decode code runs on live radio edges, on a recorded .sub file or on frames
+ * generated from the protocol encoders.
+ */
+class PulseSource {
+public:
+    virtual ~PulseSource() {}
+
+    // Copies up to maxCount edges into out; returns how many were copied.
+    // 0 means nothing is available right now, not necessarily the end.
+    virtual size_t read(Edge* out, size_t maxCount) = 0;
+
+    // Current time on the same clock as Edge::timestamp, in microseconds.
+    // Used for the "nothing arrived for a while" end-of-frame checks.
+    virtual uint32_t now() const = 0;
+
+    // True once the source will never produce another edge.
+    virtual bool finished() const {
+        return false;
+    }
+};
+
+// Live edges captured by the GDO0 ISR.
+template <size_t Capacity>
+class EdgeRingSource : public PulseSource {
+public:
+    explicit EdgeRingSource(EdgeRing<Capacity>& ring) : ring(ring) {}
+
+    size_t read(Edge* out, size_t maxCount) override {
+        return ring.popMany(out, maxCount);
+    }
+
+    uint32_t now() const override {
+#if defined(ESP32)
+        return static_cast<uint32_t>(esp_timer_get_time());
+#else
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+private:
+    EdgeRing<Capacity>& ring;
+};
+
+/**
+ * Plays back a prepared pulse list as if it had just been received. Edge
+ * timestamps advance by each pulse duration; once everything has been read the
+ * clock jumps ahead so pending frames are closed by the idle checks.
+ */
+class ReplayPulseSource : public PulseSource {
+public:
+    ReplayPulseSource() : position(0), clock(0) {}
+
+    size_t read(Edge* out, size_t maxCount) override;
+    uint32_t now() const override;
+    bool finished() const override;
+
+    // Starts playback from the first pulse again.
+    void rewind();
+    void clear();
+
+    PulseView pulses() const {
+        return PulseView(samples);
+    }
+
+    const PulseDuration* data() const {
+        return samples.data();
+    }
+
+    size_t size() const {
+        return samples.size();
+    }
+
+protected:
+    void append(PulseDuration pulse);
+
+    std::vector<PulseDuration> samples;
+
+private:
+    size_t position;
+    uint32_t clock;
+};
+
+/**
+ * Replays the RAW_Data of a Flipper .sub file.
+ *
+ * The parser takes the file in arbitrary chunks, so the same code reads from
+ * an SD card on the device and from a std::istream on a host build, and long
+ * RAW_Data lines never need a line buffer of their own size. A Repeat: line
+ * (written for captures stored with one copy of their frame) is expanded by
+ * finish(), so playback matches the original capture.
+ */
+class SubFileSource : public ReplayPulseSource {
+public:
+    SubFileSource() : frequency(0), raw(false), limit(SIZE_MAX), truncated(false) {}
+
+    // Keeps at most maxPulses of the file, so a long recording cannot take
+    // all of the heap; see wasTruncated().
+    void setLimit(size_t maxPulses) {
+        limit = maxPulses;
+    }
+
+    bool wasTruncated() const {
+        return truncated;
+    }
+
+    // Forgets the file but keeps the pulse buffer, so one source can read
+    // file after file without going back to the heap; the limit stays.
+    void clear();
+
+    // Feeds the next chunk of the file.
+    void parse(const char* data, size_t length);
+
+    // Flushes a last line that has no line ending.
+    void finish();
+
+    // Reads a whole .sub file; returns false if it holds no RAW pulses.
+#if defined(ARDUINO)
+    bool load(File32& file);
+#else
+    bool load(std::istream& in);
+#endif
+
+    // Frequency in Hz as written in the header, 0 if missing.
+    uint32_t getFrequency() const {
+        return frequency;
+    }
+
+    const std::string& getPreset() const {
+        return preset;
+    }
+
+    bool isRaw() const {
+        return raw;
+    }
+
+private:
+    void parseLine(const std::string& text);
+
+    std::string line;
+    uint32_t frequency;
+    std::string preset;
+    bool raw;
+    RepeatInfo repeats;
+    size_t limit;
+    bool truncated;
+};
+
+/**
+ * Builds test traffic from encoder output: frames are repeated with a fixed
+ * gap and can be given deterministic timing jitter.
+ */
+class SyntheticPulseSource : public ReplayPulseSource {
+public:
+    SyntheticPulseSource() : jitter(0), seed(0x12345678) {}
+
+    // Adds +/- jitterUs of pseudo-random error to every following pulse.
+    void setJitter(uint32_t jitterUs, uint32_t randomSeed = 0x12345678);
+
+    // Sends a signed frame (e.g. LinearProtocol::getEncodedSamples()) repeats
+    // times, with gapUs of low time after each repeat.
+    void addFrame(PulseView frame, int repeats, uint32_t gapUs);
+
+    // Same for unsigned alternating durations as the encoders leave them in
+    // samplesToSend, starting with firstLevel.
+    void addAlternating(const std::vector<int64_t>& durations, bool firstLevel, int repeats, uint32_t gapUs);
+
+    // Low time between transmissions. It stretches a trailing low pulse.
+    void addSilence(uint32_t us);
+
+private:
+    void addPulse(PulseDuration pulse);
+    uint32_t nextRandom();
+
+    uint32_t jitter;
+    uint32_t seed;
+};
+
+/**
+ * Pulls edges from source into blocks, cutting at pulses longer than gapUs
+ * and closing the current block once the source has been idle for gapUs.
+ * Stops as soon as a block is completed, so edges of the next frame stay in
+ * the source instead of overrunning the decoder. Returns true when
+ * blocks.completed() has a block ready.
+ */
+bool readBlock(PulseSource& source, PulseBlockBuffer& blocks, int32_t gapUs);
+
+#endif // PULSE_SOURCE_H
@@ -0,0 +1,145 @@
+#include "RecordFile.h"
+
+#if defined(ARDUINO)
+#include "modules/ETC/SDcard.h"
+
+bool RecordFile::openRead(const char* path) {
+    file = SDcard::getInstance().createOrOpenFile(path, O_RDONLY);
+    return file != nullptr;
+}
+
+bool RecordFile::openWrite(const char* path, bool append) {
+    file = SDcard::getInstance().createOrOpenFile(path, O_WRITE | O_CREAT | (append ? O_APPEND : O_TRUNC));
+    return file != nullptr;
+}
+
+bool RecordFile::openUpdate(const char* path) {
+    file = SDcard::getInstance().createOrOpenFile(path, O_RDWR | O_CREAT);
+    return file != nullptr;
+}
+
+size_t RecordFile::records() {
+    return static_cast<size_t>(file->fileSize() / recordSize);
+}
+
+size_t RecordFile::read(size_t first, uint8_t* out, size_t count) {
+    if (!file->seekSet(static_cast<uint32_t>(first * recordSize))) {
+        return 0;
+    }
+    const int bytes = file->read(out, count * recordSize);
+    return bytes > 0 ? static_cast<size_t>(bytes) / recordSize : 0;
+}
+
+bool RecordFile::write(const uint8_t* data, size_t count) {
+    return file->write(data, count * recordSize) == count * recordSize;
+}
+
+// SdFat will not seek past the end, hence the limit.
+bool RecordFile::writeAt(size_t first, const uint8_t* data, size_t count) {
+    return file->seekSet(static_cast<uint32_t>(first * recordSize)) && write(data, count);
+}
+
+void RecordFile::close() {
+    if (file) {
+        SDcard::getInstance().closeFile(file);
+        file = nullptr;
+    }
+}
+
+bool RecordFile::exists(const char* path) {
+    return SDcard::getInstance().fileExists(path);
+}
+
+bool RecordFile::remove(const char* path) {
+    return SDcard::getInstance().deleteFile(path);
+}
+
+bool RecordFile::rename(const char* fromPath, const char* toPath) {
+    return SDcard::getInstance().renameFile(fromPath, toPath);
+}
+
+bool RecordFile::makeDirectory(const char* path) {
+    SDcard& sd = SDcard::getInstance();
+    return sd.directoryExists(path) || sd.createDirectory(path);
+}
+
+#else
+#include <filesystem>
+#include <system_error>
+
+bool RecordFile::openRead(const char* path) {
+    file.open(path, std::ios::in | std::ios::binary);
+    return file.is_open();
+}
+
+bool RecordFile::openWrite(const char* path, bool append) {
+    file.open(path, std::ios::out | std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    return file.is_open();
+}
+
+bool RecordFile::openUpdate(const char* path) {
+    if (!exists(path)) {
+        std::ofstream(path, std::ios::binary);
+    }
+    file.open(path, std::ios::in | std::ios::out | std::ios::binary);
+    return file.is_open();
+}
+
+size_t RecordFile::records() {
+    file.clear();
+    file.seekg(0, std::ios::end);
+    return static_cast<size_t>(file.tellg()) / recordSize;
+}
+
+size_t RecordFile::read(size_t first, uint8_t* out, size_t count) {
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(first * recordSize));
+    file.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(count * recordSize));
+    return static_cast<size_t>(file.gcount()) / recordSize;
+}
+
+bool RecordFile::write(const uint8_t* data, size_t count) {
+    file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(count * recordSize));
+    return static_cast<bool>(file);
+}
+
+bool RecordFile::writeAt(size_t first, const uint8_t* data, size_t count) {
+    if (first > records()) {
+        return false;
+    }
+    file.clear();
+    file.seekp(static_cast<std::streamoff>(first * recordSize));
+    return write(data, count);
+}
+
+void RecordFile::close() {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+
+bool RecordFile::exists(const char* path) {
+    std::error_code error;
+    return std::filesystem::exists(path, error);
+}
+
+bool RecordFile::remove(const char* path) {
+    std::error_code error;
+    return std::filesystem::remove(path, error);
+}
+
+bool RecordFile::rename(const char* fromPath, const char* toPath) {
+    std::error_code error;
+    if (std::filesystem::exists(toPath, error)) {
+        return false;
+    }
+    std::filesystem::rename(fromPath, toPath, error);
+    return !error;
+}
+
+bool RecordFile::makeDirectory(const char* path) {
+    std::error_code error;
+    std::filesystem::create_directories(path, error);
+    return std::filesystem::is_directory(path, error);
+}
+#endif
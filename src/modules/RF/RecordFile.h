@@ -0,0 +1,69 @@
+#ifndef RECORD_FILE_H
+#define RECORD_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(ARDUINO)
+class File32;
+#else
+#include <fstream>
+#endif
+
+/**
+ * A file of fixed-size binary records, on the SD card on the device and on
+ * the file system on a host, for the indexes and logs kept next to the
+ * captures. Holds at most one open file, closed with the object.
+ */
+class RecordFile {
+public:
+    explicit RecordFile(size_t recordSize) : recordSize(recordSize) {}
+    RecordFile(const RecordFile&) = delete;
+    RecordFile& operator=(const RecordFile&) = delete;
+
+    ~RecordFile() {
+        close();
+    }
+
+    bool openRead(const char* path);
+
+    // Appends to the file, or starts it over.
+    bool openWrite(const char* path, bool append);
+
+    // Reads and overwrites records in place; creates the file if missing.
+    bool openUpdate(const char* path);
+
+    // Whole records in the file.
+    size_t records();
+
+    // Reads up to count records from record first; returns how many it read.
+    size_t read(size_t first, uint8_t* out, size_t count);
+
+    // Writes count records where the file is, its end after openWrite().
+    bool write(const uint8_t* data, size_t count);
+
+    // Writes count records from record first, which may be the end of the
+    // file but not past it.
+    bool writeAt(size_t first, const uint8_t* data, size_t count);
+
+    void close();
+
+    static bool exists(const char* path);
+    static bool remove(const char* path);
+
+    // Fails if toPath exists.
+    static bool rename(const char* fromPath, const char* toPath);
+
+    // Creates path unless it is a directory already.
+    static bool makeDirectory(const char* path);
+
+private:
+    size_t recordSize;
+#if defined(ARDUINO)
+    File32* file = nullptr;
+#else
+    std::fstream file;
+#endif
+};
+
+#endif // RECORD_FILE_H
@@ -0,0 +1,60 @@
+#include "RepeatedCapture.h"
+
+bool pulsesMatch(PulseDuration a, PulseDuration b) {
+    if ((a > 0) != (b > 0)) {
+        return false;
+    }
+    const int64_t magnitude = a < 0 ? -static_cast<int64_t>(a) : a;
+    const int64_t diff = static_cast<int64_t>(a) - b;
+    const int64_t tolerance = magnitude * REPEAT_DELTA_PERCENT / 100;
+    return (diff < 0 ? -diff : diff) <= (tolerance > REPEAT_MIN_DELTA_US ? tolerance : REPEAT_MIN_DELTA_US);
+}
+
+static bool framesMatch(const PulseDuration* a, const PulseDuration* b, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (!pulsesMatch(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RepeatInfo findRepeats(const PulseDuration* data, size_t size, const FrameSegmenter& segmenter) {
+    // A frame that follows another one starts with the gap that ended it;
+    // the repeating unit is everything after that, up to and including its
+    // own gap.
+    struct Unit {
+        size_t start;
+        size_t length;
+    };
+    Unit units[SEGMENT_MAX_FRAMES];
+    const size_t unitCount = segmenter.size();
+    for (size_t i = 0; i < unitCount; i++) {
+        const bool follows = i > 0 && segmenter.start(i) + 1 == units[i - 1].start + units[i - 1].length;
+        units[i].start = segmenter.start(i) + (follows ? 1 : 0);
+        units[i].length = segmenter.length(i) - (follows ? 1 : 0);
+    }
+
+    RepeatInfo best;
+    size_t bestSaved = 0;
+    for (size_t i = 0; i < unitCount; i++) {
+        const Unit& first = units[i];
+        size_t count = 1;
+        while (i + count < unitCount) {
+            const Unit& next = units[i + count];
+            if (next.start != first.start + first.length * count || next.length != first.length ||
+                next.start + next.length > size || !framesMatch(data + first.start, data + next.start, first.length)) {
+                break;
+            }
+            count++;
+        }
+        const size_t saved = first.length * (count - 1);
+        if (saved > bestSaved) {
+            bestSaved = saved;
+            best.start = static_cast<uint32_t>(first.start);
+            best.length = static_cast<uint32_t>(first.length);
+            best.count = static_cast<uint16_t>(count);
+        }
+    }
+    return best;
+}
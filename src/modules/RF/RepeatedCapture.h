@@ -0,0 +1,166 @@
+#ifndef REPEATED_CAPTURE_H
+#define REPEATED_CAPTURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "FrameSegmenter.h"
+#include "PackedPulses.h"
+
+#define REPEAT_DELTA_PERCENT 20   // pulses within this much of each other count as equal
+#define REPEAT_MIN_DELTA_US 80    // ... or within this many microseconds, for short pulses
+
+/**
+ * Where a capture repeats itself. The pulses [start, start + length) are one
+ * frame, including the gap after it, and the capture holds count copies of it
+ * back to back. Stored captures keep only the first copy; count == 1 means the
+ * capture is stored as is.
+ */
+struct RepeatInfo {
+    uint32_t start = 0;
+    uint32_t length = 0;
+    uint16_t count = 1;
+
+    bool repeated() const {
+        return count > 1 && length > 0;
+    }
+
+    // Pulses elided from a stored capture.
+    size_t elided() const {
+        return repeated() ? static_cast<size_t>(length) * (count - 1) : 0;
+    }
+};
+
+// Finds the run of near-identical consecutive frames that saves the most
+// pulses. segmenter must hold the result of split() on the same pulses.
+RepeatInfo findRepeats(const PulseDuration* data, size_t size, const FrameSegmenter& segmenter);
+
+// True if two pulses have the same level and are equal within tolerance.
+bool pulsesMatch(PulseDuration a, PulseDuration b);
+
+// Expanded copy of a compact pulse list, e.g. RAW_Data read back from a .sub
+// file that has a Repeat: line.
+template <typename T>
+std::vector<T> expandRepeats(const std::vector<T>& stored, const RepeatInfo& info) {
+    if (!info.repeated() || info.start + info.length > stored.size()) {
+        return stored;
+    }
+    std::vector<T> out;
+    out.reserve(stored.size() + info.elided());
+    const auto frameBegin = stored.begin() + info.start;
+    const auto frameEnd = frameBegin + info.length;
+    out.insert(out.end(), stored.begin(), frameBegin);
+    for (uint16_t r = 0; r < info.count; r++) {
+        out.insert(out.end(), frameBegin, frameEnd);
+    }
+    out.insert(out.end(), frameEnd, stored.end());
+    return out;
+}
+
+/**
+ * Walks a stored capture with its repeated frame played count times, i.e. the
+ * pulses as they were received (within tolerance).
+ */
+class RepeatIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = PulseDuration;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const PulseDuration*;
+    using reference = PulseDuration;
+
+    RepeatIterator() : index(0), start(0), end(0), left(1) {}
+    RepeatIterator(PulseIterator pos, const RepeatInfo& info, PulseIterator frameStart)
+        : pos(pos),
+          frameStart(frameStart),
+          index(0),
+          start(info.start),
+          end(info.repeated() ? info.start + info.length : 0),
+          left(info.repeated() ? info.count : 1) {}
+
+    // Past-the-end iterator.
+    explicit RepeatIterator(PulseIterator last)
+        : pos(last), index(0), start(0), end(0), left(1) {}
+
+    PulseDuration operator*() const {
+        return *pos;
+    }
+
+    RepeatIterator& operator++() {
+        ++pos;
+        ++index;
+        if (index == end && left > 1) {
+            left--;
+            pos = frameStart;
+            index = start;
+        }
+        return *this;
+    }
+
+    RepeatIterator operator++(int) {
+        RepeatIterator tmp = *this;
+        ++(*this);
+        return tmp;
+    }
+
+    bool operator==(const RepeatIterator& other) const {
+        return pos == other.pos && left == other.left;
+    }
+
+    bool operator!=(const RepeatIterator& other) const {
+        return !(*this == other);
+    }
+
+private:
+    PulseIterator pos;
+    PulseIterator frameStart;
+    uint32_t index;
+    uint32_t start;
+    uint32_t end;
+    uint16_t left;
+};
+
+/**
+ * A stored capture together with its repeat info. Iterates the expanded
+ * pulses; stored() gives the compact form for writing out.
+ */
+class RepeatedView {
+public:
+    RepeatedView() {}
+    RepeatedView(PulseView pulses) : pulses(pulses) {}
+    RepeatedView(PulseView pulses, const RepeatInfo& info) : pulses(pulses), info(info) {}
+
+    RepeatIterator begin() const {
+        PulseIterator frameStart = pulses.begin();
+        for (uint32_t i = 0; i < info.start; i++) {
+            ++frameStart;
+        }
+        return RepeatIterator(pulses.begin(), info, frameStart);
+    }
+
+    RepeatIterator end() const {
+        return RepeatIterator(pulses.end());
+    }
+
+    size_t size() const {
+        return pulses.size() + info.elided();
+    }
+
+    bool empty() const {
+        return pulses.empty();
+    }
+
+    PulseView stored() const {
+        return pulses;
+    }
+
+    const RepeatInfo& repeats() const {
+        return info;
+    }
+
+private:
+    PulseView pulses;
+    RepeatInfo info;
+};
+
+#endif // REPEATED_CAPTURE_H
@@ -0,0 +1,11 @@
+#include "ShippedProtocols.h"
+
+void ShippedProtocols::registerAll(ProtocolRegistry& protocols) {
+    protocols.add(hormannEntry);
+    protocols.add(cameEntry);
+    protocols.add(ansonicEntry);
+    protocols.add(niceFloEntry);
+    protocols.add(smc5326Entry);
+    protocols.add(kiaEntry);
+    protocols.add(keeloqEntry);
+}
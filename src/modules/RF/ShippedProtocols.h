@@ -0,0 +1,42 @@
+#ifndef SHIPPED_PROTOCOLS_H
+#define SHIPPED_PROTOCOLS_H
+
+#include "ProtocolRegistry.h"
+#include "KeeLoqEntry.h"
+#include "protocols/CameProtocol.h"
+#include "protocols/NiceFloProtocol.h"
+#include "protocols/kia.hpp"
+#include "protocols/AnsonicProtocol.h"
+#include "protocols/HormannProtocol.h"
+#include "protocols/Smc5326Protocol.h"
+
+/**
+ * The decoders the firmware ships with, in the order they are registered, so
+ * the receiver and tools/batch_decode decode captures alike.
+ */
+class ShippedProtocols {
+public:
+    // Adds every decoder below to protocols; build() is up to the caller.
+    // Registration order breaks ties between codes with equal votes.
+    void registerAll(ProtocolRegistry& protocols);
+
+    HormannProtocol hormannProtocol;
+    AnsonicProtocol ansonicProtocol;
+    SMC5326Protocol smc5326Protocol;
+    CameProtocol cameProtocol;
+    NiceFloProtocol niceFloProtocol;
+    KiaProtocol kiaProtocol;
+    KeeLoqProtocolDecoder keeloqDecoder;
+
+private:
+    // Registry entries for the decoders above; must follow them.
+    DecoderAdapter<HormannProtocol> hormannEntry{"Hormann", hormannProtocol};
+    DecoderAdapter<AnsonicProtocol> ansonicEntry{"Ansonic", ansonicProtocol};
+    DecoderAdapter<SMC5326Protocol> smc5326Entry{"SMC5326", smc5326Protocol};
+    DecoderAdapter<CameProtocol> cameEntry{"Came", cameProtocol};
+    DecoderAdapter<NiceFloProtocol> niceFloEntry{"NiceFlo", niceFloProtocol};
+    DecoderAdapter<KiaProtocol> kiaEntry{"Kia", kiaProtocol};
+    KeeLoqEntry keeloqEntry{keeloqDecoder};
+};
+
+#endif // SHIPPED_PROTOCOLS_H
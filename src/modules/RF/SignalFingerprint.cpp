@@ -0,0 +1,102 @@
+#include "SignalFingerprint.h"
+#include <algorithm>
+#include <cstring>
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+static uint32_t fnv1a(uint32_t hash, const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t fnv1a(uint32_t hash, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) {
+        hash = (hash ^ static_cast<uint8_t>(value >> (8 * i))) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint16_t quantiseTe(uint32_t te) {
+    return static_cast<uint16_t>(std::min<uint32_t>((te + FINGERPRINT_TE_STEP / 2) / FINGERPRINT_TE_STEP, UINT16_MAX));
+}
+
+static uint8_t pulseRatio(const FrameTiming& timing) {
+    if (!timing.measured() || timing.shortPulse == 0) {
+        return 0;
+    }
+    return static_cast<uint8_t>(std::min<uint32_t>((timing.longPulse * 10 + timing.shortPulse / 2) / timing.shortPulse,
+                                                   UINT8_MAX));
+}
+
+bool SignalFingerprint::matches(const SignalFingerprint& other) const {
+    if (kind != other.kind || hash != other.hash || bits != other.bits) {
+        return false;
+    }
+    const uint32_t teDiff = DURATION_DIFF(te, other.te);
+    if (teDiff * 100 > static_cast<uint32_t>(std::max(te, other.te)) * FINGERPRINT_TE_PERCENT) {
+        return false;
+    }
+    // A capture whose frame had one pulse width says nothing about it.
+    return ratio == 0 || other.ratio == 0 || DURATION_DIFF(ratio, other.ratio) <= FINGERPRINT_RATIO_SLACK;
+}
+
+SignalFingerprint fingerprint(const DecodeResult& result, const FrameTiming& timing) {
+    SignalFingerprint print;
+    if (!result.valid()) {
+        return print;
+    }
+    uint32_t hash = fnv1a(FNV_OFFSET, reinterpret_cast<const uint8_t*>(result.protocol), strlen(result.protocol));
+    // Identity, not code: a rolling-code remote sends a new code every press.
+    print.hash = fnv1a(hash, result.identity, sizeof(result.identity));
+    print.te = quantiseTe(result.te);
+    print.bits = result.bits;
+    print.ratio = pulseRatio(timing);
+    print.kind = FingerprintKind::Decoded;
+    return print;
+}
+
+SignalFingerprint fingerprint(const BinRawSignal& signal, const FrameTiming& timing) {
+    SignalFingerprint print;
+    if (signal.bits == 0) {
+        return print;
+    }
+    const size_t bytes = std::min<size_t>((signal.bits + 7) / 8, BINRAW_MAX_DATA_BYTES);
+    uint32_t hash = fnv1a(FNV_OFFSET, static_cast<uint64_t>(signal.code), 1);
+    print.hash = fnv1a(hash, signal.data, bytes);
+    print.te = quantiseTe(signal.te);
+    print.bits = signal.bits;
+    print.ratio = pulseRatio(timing);
+    print.kind = FingerprintKind::BinRaw;
+    return print;
+}
+
+void FingerprintRecord::encode(uint8_t* out) const {
+    memset(out, 0, FINGERPRINT_RECORD_SIZE);
+    for (int i = 0; i < 4; i++) {
+        out[i] = static_cast<uint8_t>(print.hash >> (8 * i));
+    }
+    out[4] = static_cast<uint8_t>(print.te);
+    out[5] = static_cast<uint8_t>(print.te >> 8);
+    out[6] = static_cast<uint8_t>(print.bits);
+    out[7] = static_cast<uint8_t>(print.bits >> 8);
+    out[8] = print.ratio;
+    out[9] = static_cast<uint8_t>(print.kind);
+    memcpy(out + 10, label, strnlen(label, FINGERPRINT_LABEL_SIZE - 1));
+}
+
+void FingerprintRecord::decode(const uint8_t* in) {
+    print.hash = 0;
+    for (int i = 0; i < 4; i++) {
+        print.hash |= static_cast<uint32_t>(in[i]) << (8 * i);
+    }
+    print.te = static_cast<uint16_t>(in[4] | in[5] << 8);
+    print.bits = static_cast<uint16_t>(in[6] | in[7] << 8);
+    print.ratio = in[8];
+    print.kind = in[9] <= static_cast<uint8_t>(FingerprintKind::BinRaw) ? static_cast<FingerprintKind>(in[9])
+                                                                        : FingerprintKind::None;
+    memcpy(label, in + 10, FINGERPRINT_LABEL_SIZE - 1);
+    label[FINGERPRINT_LABEL_SIZE - 1] = '\0';
+}
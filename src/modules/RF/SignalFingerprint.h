@@ -0,0 +1,58 @@
+#ifndef SIGNAL_FINGERPRINT_H
+#define SIGNAL_FINGERPRINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include "BinRawAnalyzer.h"
+#include "CaptureDecoder.h"
+#include "DecodeResult.h"
+
+#define FINGERPRINT_TE_STEP 4           // us per unit of the te kept
+#define FINGERPRINT_TE_PERCENT 15       // te of two captures of one remote differ by at most this
+#define FINGERPRINT_RATIO_SLACK 3       // long:short ratios, in tenths, likewise
+#define FINGERPRINT_LABEL_SIZE 22       // label with its terminator
+#define FINGERPRINT_RECORD_SIZE 32      // on SD: fingerprint, then label
+
+enum class FingerprintKind : uint8_t {
+    None,
+    Decoded,    // a protocol decoder took it
+    BinRaw      // only its line code is known
+};
+
+/**
+ * What a capture looks like, in a few bytes: quantised te, the ratio of its
+ * long to short pulse, its bit length and a hash of its bits. Two captures
+ * of one remote have the same hash and bits, and te and ratio within
+ * tolerance, so the hash is the key a FingerprintIndex is sorted by.
+ */
+struct SignalFingerprint {
+    uint32_t hash = 0;          // FNV-1a of protocol and identity, or line code and data
+    uint16_t te = 0;            // in FINGERPRINT_TE_STEP us
+    uint16_t bits = 0;
+    uint8_t ratio = 0;          // long over short pulse in tenths, 0 if unknown
+    FingerprintKind kind = FingerprintKind::None;
+
+    bool valid() const {
+        return kind != FingerprintKind::None;
+    }
+
+    bool matches(const SignalFingerprint& other) const;
+};
+
+// A fingerprint and the name it was stored under.
+struct FingerprintRecord {
+    SignalFingerprint print;
+    char label[FINGERPRINT_LABEL_SIZE] = {};
+
+    // Fixed little-endian layout of FINGERPRINT_RECORD_SIZE bytes.
+    void encode(uint8_t* out) const;
+    void decode(const uint8_t* in);
+};
+
+// Fingerprint of a decoded capture; timing is that of a frame it came from.
+SignalFingerprint fingerprint(const DecodeResult& result, const FrameTiming& timing);
+
+// Fingerprint of a capture only the BinRAW analysis made sense of.
+SignalFingerprint fingerprint(const BinRawSignal& signal, const FrameTiming& timing);
+
+#endif // SIGNAL_FINGERPRINT_H
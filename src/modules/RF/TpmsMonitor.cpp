@@ -0,0 +1,95 @@
+#include "TpmsMonitor.h"
+
+const TpmsSensor& TpmsSensorTable::update(const TPMSGenericData& reading) {
+    TpmsSensor* slot = nullptr;
+    for (size_t i = 0; i < count && !slot; i++) {
+        if (entries[i].reading.id == reading.id) {
+            slot = &entries[i];
+        }
+    }
+    if (!slot && count < TPMS_MAX_SENSORS) {
+        slot = &entries[count++];
+        slot->packets = 0;
+    }
+    if (!slot) {
+        slot = &entries[0];
+        for (size_t i = 1; i < count; i++) {
+            if (entries[i].reading.timestamp < slot->reading.timestamp) {
+                slot = &entries[i];
+            }
+        }
+        slot->packets = 0;
+    }
+    slot->reading = reading;
+    slot->packets++;
+    return *slot;
+}
+
+const TpmsSensor* TpmsSensorTable::find(uint32_t id) const {
+    for (size_t i = 0; i < count; i++) {
+        if (entries[i].reading.id == id) {
+            return &entries[i];
+        }
+    }
+    return nullptr;
+}
+
+TpmsMonitor::TpmsMonitor() : slicerCount(0), lastSensor(nullptr), valid(0), sliced(0) {
+    for (size_t l = 0; l < tpmsLayoutCount; l++) {
+        bool known = false;
+        for (size_t s = 0; s < slicerCount; s++) {
+            known = known || slicers[s].te() == tpmsLayouts[l].te;
+        }
+        if (!known && slicerCount < TPMS_MAX_SLICERS) {
+            slicers[slicerCount++].configure(tpmsLayouts[l].te);
+        }
+    }
+}
+
+void TpmsMonitor::reset() {
+    for (size_t s = 0; s < slicerCount; s++) {
+        slicers[s].reset();
+    }
+    table.clear();
+    lastSensor = nullptr;
+    valid = 0;
+    sliced = 0;
+}
+
+bool TpmsMonitor::feed(PulseDuration pulse, uint32_t now) {
+    const bool level = pulse > 0;
+    const uint32_t duration = static_cast<uint32_t>(level ? pulse : -pulse);
+    bool found = false;
+    for (size_t s = 0; s < slicerCount; s++) {
+        if (slicers[s].feed(level, duration)) {
+            sliced++;
+            found |= decodePacket(slicers[s], now);
+        }
+    }
+    return found;
+}
+
+bool TpmsMonitor::decodePacket(const ManchesterSlicer& slicer, uint32_t now) {
+    bool found = false;
+    uint8_t payload[TPMS_MAX_PAYLOAD];
+    for (size_t l = 0; l < tpmsLayoutCount; l++) {
+        const TpmsLayout& layout = tpmsLayouts[l];
+        if (layout.te != slicer.te()) {
+            continue;
+        }
+        // One run may hold back-to-back repeats of the packet.
+        size_t at = slicer.find(layout.sync, layout.syncBits, 0);
+        while (at != SIZE_MAX) {
+            TPMSGenericData reading;
+            if (slicer.decode(at, payload, layout.bytes) && layout.parse(payload, reading)) {
+                reading.timestamp = now;
+                lastSensor = &table.update(reading);
+                valid++;
+                found = true;
+                at += layout.bytes * 16u;
+            }
+            at = slicer.find(layout.sync, layout.syncBits, at);
+        }
+    }
+    return found;
+}
@@ -0,0 +1,94 @@
+#ifndef TPMS_MONITOR_H
+#define TPMS_MONITOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include "PackedPulses.h"
+#include "ManchesterSlicer.h"
+#include "protocols/TpmsProtocols.h"
+
+#define TPMS_MAX_SENSORS 16     // sensors tracked at once
+#define TPMS_MAX_SLICERS 4      // distinct te among the layouts
+
+// Last reading of one sensor, timestamp in ms of when it was heard.
+struct TpmsSensor {
+    TPMSGenericData reading;
+    uint16_t packets = 0;   // valid packets heard from it
+};
+
+/**
+ * Sensors heard, keyed by id. Fixed size; once full, a new sensor takes the
+ * slot of the one heard least recently.
+ */
+class TpmsSensorTable {
+public:
+    TpmsSensorTable() : count(0) {}
+
+    // Stores reading as the last one of its sensor and returns its entry.
+    const TpmsSensor& update(const TPMSGenericData& reading);
+
+    const TpmsSensor* find(uint32_t id) const;
+
+    void clear() {
+        count = 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    const TpmsSensor& operator[](size_t i) const {
+        return entries[i];
+    }
+
+private:
+    TpmsSensor entries[TPMS_MAX_SENSORS];
+    size_t count;
+};
+
+/**
+ * Continuous TPMS receive on an FSK preset: every pulse goes to one
+ * ManchesterSlicer per te the layouts use, and each packet a slicer closes
+ * is searched for the sync of the layouts at its te. Payloads that pass
+ * their check update the sensor table, so any number of sensors is followed
+ * without re-arming the receiver between packets.
+ */
+class TpmsMonitor {
+public:
+    TpmsMonitor();
+
+    // Returns true if the pulse completed at least one valid reading.
+    bool feed(PulseDuration pulse, uint32_t now);
+
+    void reset();
+
+    const TpmsSensorTable& sensors() const {
+        return table;
+    }
+
+    // Entry of the sensor the last valid reading came from.
+    const TpmsSensor& last() const {
+        return *lastSensor;
+    }
+
+    // Packets that passed a layout's check, and that a slicer closed.
+    uint32_t validPackets() const {
+        return valid;
+    }
+
+    uint32_t slicedPackets() const {
+        return sliced;
+    }
+
+private:
+    bool decodePacket(const ManchesterSlicer& slicer, uint32_t now);
+
+    ManchesterSlicer slicers[TPMS_MAX_SLICERS];
+    size_t slicerCount;
+    TpmsSensorTable table;
+    const TpmsSensor* lastSensor;
+    uint32_t valid;
+    uint32_t sliced;
+};
+
+#endif // TPMS_MONITOR_H
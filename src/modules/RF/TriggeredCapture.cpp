@@ -0,0 +1,115 @@
+#include "TriggeredCapture.h"
+
+TriggeredCapture::TriggeredCapture()
+    : state(Idle),
+      historyHead(0),
+      historyCount(0),
+      belowThreshold(false),
+      belowSince(0),
+      lengthAtDrop(0),
+      seenCount(0),
+      capturedCount(0),
+      captureCount(0)
+{
+    pulses.reserve(config.maxEdges);
+}
+
+void TriggeredCapture::setConfig(const TriggerConfig& newConfig) {
+    config = newConfig;
+    pulses.reserve(config.maxEdges);
+    reset();
+}
+
+void TriggeredCapture::reset() {
+    state = Idle;
+    historyHead = 0;
+    historyCount = 0;
+    pulses.clear();
+    belowThreshold = false;
+    belowSince = 0;
+}
+
+void TriggeredCapture::addEdge(const Edge& edge) {
+    seenCount++;
+    if (state == Recording) {
+        if (pulses.size() < config.maxEdges) {
+            pulses.push_back(edge.duration);
+        }
+        return;
+    }
+    // Idle, or waiting for the last capture to be released: keep history only.
+    history[historyHead] = edge;
+    historyHead = (historyHead + 1) % PRE_TRIGGER_EDGES;
+    if (historyCount < PRE_TRIGGER_EDGES) {
+        historyCount++;
+    }
+}
+
+bool TriggeredCapture::updateRssi(int rssi, uint32_t now) {
+    switch (state) {
+        case Idle:
+            if (rssi >= config.rssiThreshold) {
+                start(now);
+            }
+            break;
+
+        case Recording:
+            if (pulses.size() >= config.maxEdges) {
+                return finish();
+            }
+            if (rssi >= config.rssiThreshold - config.hysteresis) {
+                belowThreshold = false;
+                break;
+            }
+            if (!belowThreshold) {
+                belowThreshold = true;
+                belowSince = now;
+                lengthAtDrop = pulses.size();
+            } else if (now - belowSince >= config.releaseUs) {
+                return finish();
+            }
+            break;
+
+        case Complete:
+            break;
+    }
+    return false;
+}
+
+void TriggeredCapture::release() {
+    if (state == Complete) {
+        pulses.clear();
+        state = Idle;
+    }
+}
+
+void TriggeredCapture::start(uint32_t now) {
+    pulses.clear();
+    // Oldest first, skipping whatever is older than the pre-trigger window.
+    const size_t first = (historyHead + PRE_TRIGGER_EDGES - historyCount) % PRE_TRIGGER_EDGES;
+    for (size_t i = 0; i < historyCount; i++) {
+        const Edge& edge = history[(first + i) % PRE_TRIGGER_EDGES];
+        if (now - edge.timestamp <= config.preTriggerUs && pulses.size() < config.maxEdges) {
+            pulses.push_back(edge.duration);
+        }
+    }
+    historyCount = 0;
+    belowThreshold = false;
+    state = Recording;
+}
+
+bool TriggeredCapture::finish() {
+    // Edges that came in after the level dropped are trailing noise.
+    if (belowThreshold && lengthAtDrop < pulses.size()) {
+        pulses.resize(lengthAtDrop);
+    }
+    if (pulses.size() < config.minEdges) {
+        pulses.clear();
+        state = Idle;
+        return false;
+    }
+    capturedCount += pulses.size();
+    captureCount++;
+    state = Complete;
+    return true;
+}
@@ -0,0 +1,101 @@
+#ifndef TRIGGERED_CAPTURE_H
+#define TRIGGERED_CAPTURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "EdgeRing.h"
+#include "PackedPulses.h"
+
+#define PRE_TRIGGER_EDGES 256   // edges kept while waiting for a trigger
+
+struct TriggerConfig {
+    int rssiThreshold = -75;        // dBm; at or above this starts a capture
+    int hysteresis = 6;             // dB below the threshold before release
+    uint32_t preTriggerUs = 150000; // history kept from before the trigger
+    uint32_t releaseUs = 20000;     // signal must stay low this long to stop
+    uint16_t minEdges = 24;         // shorter captures are dropped as noise
+    uint16_t maxEdges = 2048;       // capture is closed when it reaches this
+};
+
+/**
+ * Signal-level triggered capture.
+ *
+ * While idle, edges only go into a small pre-trigger ring. When the RSSI
+ * reaches the threshold, the edges from the last preTriggerUs are taken over
+ * as the start of the capture, so the preamble that arrived before the level
+ * was sampled is kept. Recording stops once the RSSI has stayed below
+ * threshold - hysteresis for releaseUs. Edges outside a capture are never
+ * handed to the decoders.
+ */
+class TriggeredCapture {
+public:
+    TriggeredCapture();
+
+    void setConfig(const TriggerConfig& newConfig);
+    const TriggerConfig& getConfig() const {
+        return config;
+    }
+
+    // Back to idle, dropping the pre-trigger history and any capture.
+    void reset();
+
+    // Feed every edge in arrival order.
+    void addEdge(const Edge& edge);
+
+    // Feed an RSSI reading taken at time now (same clock as the edges).
+    // Returns true when this reading completed a capture.
+    bool updateRssi(int rssi, uint32_t now);
+
+    bool complete() const {
+        return state == Complete;
+    }
+
+    bool recording() const {
+        return state == Recording;
+    }
+
+    PulseView capture() const {
+        return PulseView(pulses);
+    }
+
+    // Called once the completed capture has been consumed; rearms the trigger.
+    void release();
+
+    uint32_t edgesSeen() const {
+        return seenCount;
+    }
+
+    uint32_t edgesCaptured() const {
+        return capturedCount;
+    }
+
+    uint32_t captures() const {
+        return captureCount;
+    }
+
+private:
+    enum State {
+        Idle,
+        Recording,
+        Complete
+    };
+
+    void start(uint32_t now);
+    bool finish();
+
+    TriggerConfig config;
+    State state;
+    Edge history[PRE_TRIGGER_EDGES];
+    size_t historyHead;
+    size_t historyCount;
+    std::vector<PulseDuration> pulses;
+    bool belowThreshold;
+    uint32_t belowSince;
+    size_t lengthAtDrop;
+    uint32_t seenCount;
+    uint32_t capturedCount;
+    uint32_t captureCount;
+};
+
+#endif // TRIGGERED_CAPTURE_H
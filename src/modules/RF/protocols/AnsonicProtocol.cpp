@@ -1,6 +1,8 @@
  #include "AnsonicProtocol.h"
  #include <stdio.h>
+#if defined(ARDUINO)
  #include "globals.h"
+#endif
  #include "math.h"
 
  #define DURATION_DIFF(x, y) (((x) < (y)) ? ((y) - (x)) : ((x) - (y)))
@@ -14,13 +16,10 @@
      (dip & 0x0008 ? '1' : '0')
  
 
+const SubGhzBlockConst AnsonicProtocol::timing = {1111, 555, 120, 12};
+
  AnsonicProtocol::AnsonicProtocol()
-     : te_short(555),
-       te_long(1111),
-       te_delta(120),
-        space(19425),
-       min_count_bit(12),
-       DecoderState(DecoderStepReset),
+     : DecoderState(DecoderStepReset),
        decodeData(0),
        decodeCountBit(0),
        te_last(0),
@@ -29,8 +28,12 @@
        finalBitCount(0),
        finalBtn(0),
        finalDip(0),
-       binaryValue(0),
-       preset(AM650) {
+       te_short(timing.te_short),
+       te_long(timing.te_long),
+       te_delta(timing.te_delta),
+       space(19425),
+       min_count_bit(timing.min_count_bit_for_found),
+       binaryValue(0) {
  }
  
  void AnsonicProtocol::reset() {
@@ -44,7 +47,9 @@
      finalBtn = 0;
      finalDip = 0;
      encoderState = EncoderStepStart;
+#if defined(ARDUINO)
      samplesToSend.clear();
+#endif
  }
  
  inline void AnsonicProtocol::addBit(uint8_t bit) {
@@ -56,6 +61,7 @@
      binaryValue = std::bitset<12>(hexValue);
  }
  
+#if defined(ARDUINO)
  void AnsonicProtocol::yield(unsigned int hexValue) {
 
     samplesToSend.clear();
@@ -85,6 +91,7 @@
         delay(5);
 
 }
+#endif
 
 void AnsonicProtocol::feed(bool level, uint32_t duration) {
     switch(DecoderState) {
@@ -144,16 +151,24 @@ void AnsonicProtocol::feed(bool level, uint32_t duration) {
                 DecoderState = DecoderStepReset;
             }
             break;
+
+        case DecoderStepFound:
+            // The code is kept until reset().
+            break;
     }
 }
 
-bool AnsonicProtocol::decode(long long int* samples, size_t sampleCount) {
+bool AnsonicProtocol::hasValidCode() const {
+    return validCodeFound;
+}
+
+bool AnsonicProtocol::decode(PulseView samples) {
     reset();
-    for(size_t i = 0; i < sampleCount; i++) {
-        if(samples[i] > 0) {
-            feed(true, (uint32_t)samples[i]);
+    for (PulseDuration sample : samples) {
+        if(sample > 0) {
+            feed(true, (uint32_t)sample);
         } else {
-            feed(false, (uint32_t)(-samples[i]));
+            feed(false, (uint32_t)(-sample));
         }
         if(validCodeFound) {
             //Serial.println(F("Valid code found"));
@@ -182,27 +197,20 @@ void AnsonicProtocol::checkRemoteController() {
 }
 
 
-String AnsonicProtocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) const {
+std::string AnsonicProtocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) const {
     uint16_t localDip = (finalCode & 0x0FFF);
     uint8_t  localBtn = ((finalCode >> 1) & 0x3);
 
-    ScreenManager& screenMgr = ScreenManager::getInstance();
-    lv_obj_t* textarea;
-    if(C1101preset == CUSTOM) {
-        textarea = screenMgr.text_area_SubGHzCustom;
-    } else {
-        textarea = screenMgr.getTextArea();
-    }
-
     char buf[128];
-    sprintf(
+    snprintf(
         buf,
+        sizeof(buf),
         "Ansonic %dbit\r\n"
         "Key:%03lX\r\n"
         "Btn:%X\r\n"
         "DIP:" DIP_PATTERN "\r\n",
         finalBitCount,
-        (finalCode & 0xFFF),  // 12-bit portion
+        (unsigned long)(finalCode & 0xFFF),  // 12-bit portion
         localBtn,
         (localDip & 0x0800 ? '1' : '0'),
         (localDip & 0x0400 ? '1' : '0'),
@@ -213,27 +221,8 @@ String AnsonicProtocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) c
         (localDip & 0x0020 ? '1' : '0'),
         (localDip & 0x0010 ? '1' : '0'),
         (localDip & 0x0001 ? '1' : '0'),
-        (localDip & 0x0008 ? '1' : '0'),
-        "Short pulse:",
-        shortPulse,
-        "\n",
-        "Short pulse:",
-        longPulse,
-        "\n"
+        (localDip & 0x0008 ? '1' : '0')
     );
 
-    lv_textarea_set_text(textarea, buf);
-
-    // Debug prints
-    //Serial.println(F("AnsonicProtocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) called"));
-    //Serial.print(F(" finalBitCount: "));
-    //Serial.println(finalBitCount);
-    //Serial.print(F(" finalCode: 0x"));
-    //Serial.println(finalCode, HEX);
-    //Serial.print(F(" finalDip (local): 0x"));
-    //Serial.println(localDip, HEX);
-    //Serial.print(F(" finalBtn (local): 0x"));
-    //Serial.println(localBtn, HEX);
-
-    return String(buf);
+    return std::string(buf);
 }
\ No newline at end of file
@@ -1,33 +1,35 @@
 #ifndef ANSONIC_PROTOCOL_H
 #define ANSONIC_PROTOCOL_H
 
+#if defined(ARDUINO)
 #include <Arduino.h>
+#endif
 #include <stdint.h>
+#include "../PackedPulses.h"
 #include <bitset>
 #include <vector>
-#include "globals.h"
+#include <string>
 #include "math.h"
-#include "GUI/ScreenManager.h"
-
-#define DIP_PATTERN "%c%c%c%c%c%c%c%c%c%c"
-#define CNT_TO_DIP(dip) \
-    (dip & 0x0800 ? '1' : '0'), (dip & 0x0400 ? '1' : '0'), (dip & 0x0200 ? '1' : '0'), \
-    (dip & 0x0100 ? '1' : '0'), (dip & 0x0080 ? '1' : '0'), (dip & 0x0040 ? '1' : '0'), \
-    (dip & 0x0020 ? '1' : '0'), (dip & 0x0010 ? '1' : '0'), (dip & 0x0001 ? '1' : '0'), \
-    (dip & 0x0008 ? '1' : '0')
-
 
 class AnsonicProtocol {
 public:
     AnsonicProtocol();
     void reset();
     void feed(bool level, uint32_t duration);
-    bool decode(long long int* samples, size_t sampleCount);
-    String getCodeString(uint64_t shortPulse, uint64_t longPulse) const;
+    bool decode(PulseView samples);
+    std::string getCodeString(uint64_t shortPulse, uint64_t longPulse) const;
     bool hasValidCode() const;
+    bool isSynced() const { return DecoderState != DecoderStepReset; }
+    // Key and bit count of the last valid code.
+    uint64_t getCode() const { return finalCode; }
+    uint8_t getBitCount() const { return static_cast<uint8_t>(finalBitCount); }
+
+    // Timing the protocol registry indexes this decoder by.
+    static const SubGhzBlockConst timing;
+#if defined(ARDUINO)
     void yield(unsigned int hexValue);
+#endif
     void checkRemoteController();
-    CC1101_PRESET preset;
 
 private:
     enum DecoderStep {
@@ -149,13 +149,13 @@ void HoltekProtocol::feed(bool level, uint32_t duration) {
     }
 }
 
-bool HoltekProtocol::decode(long long int* samples, size_t sampleCount) {
+bool HoltekProtocol::decode(PulseView samples) {
     reset();
-    for(size_t i = 0; i < sampleCount; i++) {
-        if(samples[i] > 0) {
-            feed(true,  (uint32_t)samples[i]);
+    for (PulseDuration sample : samples) {
+        if(sample > 0) {
+            feed(true,  (uint32_t)sample);
         } else {
-            feed(false, (uint32_t)(-samples[i]));
+            feed(false, (uint32_t)(-sample));
         }
         if(validCodeFound) {
             //Serial.println(F("Holtek: valid code found"));
@@ -166,25 +166,15 @@ bool HoltekProtocol::decode(long long int* samples, size_t sampleCount) {
     return false;
 }
 
-String HoltekProtocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) const {
-
-    ScreenManager& screenMgr = ScreenManager::getInstance();
-    lv_obj_t* textarea;
-    if(C1101preset == CUSTOM) {
-        textarea = screenMgr.text_area_SubGHzCustom;
-    } else {
-        textarea = screenMgr.getTextArea();
-    }
-
-
+std::string HoltekProtocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) const {
     char buf[128];
 
     snprintf(
         buf,
         sizeof(buf),
-        "Holtek HT12X %db\r\nKey:0x%03lX\r\nBtn: ",
-        finalBitCount,
-        (finalCode & 0xFFF)
+        "Holtek HT12X %ub\r\nKey:0x%03lX\r\nBtn: ",
+        (unsigned)finalBitCount,
+        (unsigned long)(finalCode & 0xFFF)
     );
 
     char btnText[32];
@@ -213,32 +203,11 @@ String HoltekProtocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) co
         (finalDIP & 0x04 ? '0' : '1'),
         (finalDIP & 0x02 ? '0' : '1'),
         (finalDIP & 0x01 ? '0' : '1'),
-        (unsigned long)te,
-        "Short pulse:",
-        shortPulse,
-        "\n",
-        "Short pulse:",
-        longPulse,
-        "\n"
+        (unsigned long)te
     );
     strlcat(buf, line2, sizeof(buf));
 
-    lv_textarea_set_text(textarea, buf);
-
-
-    //Serial.println(F("HoltekProtocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) called"));
-    //Serial.print(F(" finalBitCount: "));
-    //Serial.println(finalBitCount);
-    //Serial.print(F(" finalCode: 0x"));
-    //Serial.println(finalCode, HEX);
-    //Serial.print(F(" finalBtn: 0x"));
-    //Serial.println(finalBtn, HEX);
-    //Serial.print(F(" finalDIP: 0x"));
-    //Serial.println(finalDIP, HEX);
-    //Serial.print(F(" te: "));
-    //Serial.println(te);
-
-    return String(buf);
+    return std::string(buf);
 }
 
 
@@ -3,8 +3,9 @@
 
 #include <Arduino.h>
 #include <stdint.h>
+#include "../PackedPulses.h"
 #include <vector>
-#include "GUI/ScreenManager.h"
+#include <string>
 #include "globals.h"
 
 
@@ -25,12 +26,12 @@ public:
 
     std::bitset<12> binaryValue;
 
-    bool decode(long long int* samples, size_t sampleCount);
+    bool decode(PulseView samples);
     void toBits(unsigned int hexValue);
     
     CC1101_PRESET preset;
 
-    String getCodeString(uint64_t shortPulse, uint64_t longPulse) const;
+    std::string getCodeString(uint64_t shortPulse, uint64_t longPulse) const;
 
 
     bool hasValidCode() const;
@@ -1,22 +1,21 @@
 #include "HormannProtocol.h"
-#include "lvgl.h"
-#include "GUI/ScreenManager.h"
-#include "globals.h"
+
+const SubGhzBlockConst HormannProtocol::timing = {1000, 500, 200, 44};
 
 HormannProtocol::HormannProtocol()
-    : te_short(500),
-      te_long(1000),
-      te_delta(200),
-      min_count_bit(44),
+    : hormanEncoderState(HormanEncoderStepStart),
+      bitCount(44),
       state(StepReset),
+      te_short(timing.te_short),
+      te_long(timing.te_long),
+      te_delta(timing.te_delta),
+      min_count_bit(timing.min_count_bit_for_found),
       decodeData(0),
       decodeCountBit(0),
       te_last(0),
       validCodeFound(false),
       finalCode(0),
-      finalBitCount(0),
-      hormanEncoderState(HormanEncoderStepStart),
-      bitCount(44)
+      finalBitCount(0)
 {
     //Serial.println("HormannProtocol: Constructor called");
 }
@@ -180,16 +179,16 @@ void HormannProtocol::feed(bool level, uint32_t duration) {
     }
 }
 
-bool HormannProtocol::decode(long long int* samples, size_t sampleCount) {
+bool HormannProtocol::decode(PulseView samples) {
     //Serial.print("HormannProtocol: Decoding ");
-    //Serial.print(sampleCount);
+    //Serial.print(samples.size());
     //Serial.println(" samples");
     reset();
-    for(size_t i = 0; i < sampleCount; i++) {
-        if(samples[i] > 0) {
-            feed(true, samples[i]);
+    for (PulseDuration sample : samples) {
+        if(sample > 0) {
+            feed(true, sample);
         } else {
-            feed(false, -samples[i]);
+            feed(false, -sample);
         }
         if(validCodeFound) {
             //Serial.println("HormannProtocol: Valid code found, exiting decode loop");
@@ -199,36 +198,18 @@ bool HormannProtocol::decode(long long int* samples, size_t sampleCount) {
     return false;
 }
 
-String HormannProtocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) const {
-    ScreenManager& screenMgr = ScreenManager::getInstance();
-
-    char buf[256];
+std::string HormannProtocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) const {
+    char buf[128];
     uint32_t high = (uint32_t)(finalCode >> 32);
     uint32_t low  = (uint32_t)(finalCode & 0xFFFFFFFF);
     uint8_t btn = (finalCode >> 8) & 0xF;
     uint64_t reversed = reverseKey(finalCode, finalBitCount);
     uint32_t rev_high = (uint32_t)(reversed >> 32);
     uint32_t rev_low  = (uint32_t)(reversed & 0xFFFFFFFF);
-    sprintf(buf, "Hormann HSM\r\n%dbit\r\nKey:0x%03lX%08lX\r\nRev:0x%03lX%08lX\r\nBtn:0x%01X\r\n",
-            finalBitCount, high, low, rev_high, rev_low, btn,
-            "Short pulse:",
-            shortPulse,
-            "\n",
-            "Short pulse:",
-            longPulse,
-            "\n"
-        );
-
-    lv_obj_t * textarea;
-    if(C1101preset == CUSTOM){
-        textarea = screenMgr.text_area_SubGHzCustom;        
-    } else {
-        textarea = screenMgr.getTextArea();
-    }
-    //Serial.println("HormannProtocol: getCodeString generated:");
-    //Serial.println(buf);
-    lv_textarea_set_text(textarea, buf);
-    return String(buf);
+    snprintf(buf, sizeof(buf), "Hormann HSM\r\n%dbit\r\nKey:0x%03lX%08lX\r\nRev:0x%03lX%08lX\r\nBtn:0x%01X\r\n",
+             finalBitCount, (unsigned long)high, (unsigned long)low, (unsigned long)rev_high,
+             (unsigned long)rev_low, btn);
+    return std::string(buf);
 }
 
 bool HormannProtocol::hasValidCode() const {
@@ -1,11 +1,15 @@
 #ifndef HORMANN_DECODER_H
 #define HORMANN_DECODER_H
 
+#if defined(ARDUINO)
 #include <Arduino.h>
+#endif
 #include <stdint.h>
+#include "../PackedPulses.h"
 #include "math.h"
 #include <bitset>
-#include "globals.h"
+#include <string>
+#include <vector>
 
 
 enum HormanEncoderState {
@@ -34,14 +38,25 @@ public:
     // Resets internal state.
     void reset();
 
+    // Feeds one pulse to the state machine.
+    void feed(bool level, uint32_t duration);
+
     // Feeds an array of samples; returns true if a valid code is detected.
-    bool decode(long long int* samples, size_t sampleCount);
+    bool decode(PulseView samples);
 
     // Returns a formatted string with the decoded key, its reverse, and button field.
-    String getCodeString(uint64_t shortPulse, uint64_t longPulse) const;
+    std::string getCodeString(uint64_t shortPulse, uint64_t longPulse) const;
 
     // Returns true if a valid code was detected.
     bool hasValidCode() const;
+    // Past the header, on the start bit or the data.
+    bool isSynced() const { return state != StepReset; }
+    // Key and bit count of the last valid code.
+    uint64_t getCode() const { return finalCode; }
+    uint8_t getBitCount() const { return static_cast<uint8_t>(finalBitCount); }
+
+    // Timing the protocol registry indexes this decoder by.
+    static const SubGhzBlockConst timing;
 
 private:
     enum DecoderStep {
@@ -73,7 +88,6 @@ private:
     void addBit(uint8_t bit);
     uint64_t reverseKey(uint64_t code, uint8_t bitCount) const;
     bool checkPattern() const;
-    void feed(bool level, uint32_t duration);
 };
 
 #endif // HORMANN_DECODER_H
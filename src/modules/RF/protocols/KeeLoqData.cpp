@@ -13,14 +13,9 @@ std::string KeeLoqData::getCodeString() const {
     uint32_t data_hi = static_cast<uint32_t>(data >> 32);
     uint32_t data_lo = static_cast<uint32_t>(data & 0xFFFFFFFFULL);
 
-    // Reverse the raw key data for display
-    uint64_t reversed_key = KeeLoqData::reverseBits(data);
-    uint32_t rev_key_hi = static_cast<uint32_t>(reversed_key >> 32);
-    uint32_t rev_key_lo = static_cast<uint32_t>(reversed_key & 0xFFFFFFFFULL);
-
     // Note: fix_part and hop_part are already calculated based on the *reversed* key
-    // in updateDerivedPartsFromData(). So fix_part corresponds to rev_key_hi,
-    // and hop_part corresponds to rev_key_lo.
+    // in updateDerivedPartsFromData(). So fix_part corresponds to its high
+    // half, and hop_part to its low half.
 
     // Choose how to display the counter based on manufacturer context
     const char* cnt_str;
@@ -45,17 +40,17 @@ std::string KeeLoqData::getCodeString() const {
              "MF:%s",
              "KeeLoq", // Use specific name
              data_count_bit,
-             data_hi, data_lo,         // Raw key high/low
-             fix_part, cnt_str,        // Fix part, Counter string
-             hop_part, btn,            // Hop part, Button (hex)
+             static_cast<unsigned long>(data_hi), static_cast<unsigned long>(data_lo), // Raw key high/low
+             static_cast<unsigned long>(fix_part), cnt_str,     // Fix part, Counter string
+             static_cast<unsigned long>(hop_part), static_cast<unsigned>(btn), // Hop part, Button (hex)
              manufacturer_name.c_str() // Manufacturer name
     );
 
     // Add Seed if relevant (e.g., for BFT or if non-zero)
     if (manufacturer_name == "BFT" || seed != 0) {
          // Check remaining buffer space before appending
-         if (offset < sizeof(buf) - 20) { // Need space for " Sd:0x........\0"
-             snprintf(buf + offset, sizeof(buf) - offset, " Sd:%08lX", seed);
+         if (offset >= 0 && static_cast<size_t>(offset) < sizeof(buf) - 20) { // Need space for " Sd:0x........\0"
+             snprintf(buf + offset, sizeof(buf) - offset, " Sd:%08lX", static_cast<unsigned long>(seed));
          }
     }
 
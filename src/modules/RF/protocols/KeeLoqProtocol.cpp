@@ -1,7 +1,8 @@
-// Add these defines at the top of the file or pass them as build flags
- #define DEBUG_KEELOQ_DECODER
- #define DEBUG_KEELOQ_ENCODER
- #define DEBUG_KEELOQ_DECODER_VERBOSE // For more detailed feed prints
+// Pass these as build flags to trace the decoder and encoder on Serial. The
+// decoder runs on every frame of every capture, so they stay off by default.
+// #define DEBUG_KEELOQ_DECODER
+// #define DEBUG_KEELOQ_ENCODER
+// #define DEBUG_KEELOQ_DECODER_VERBOSE // For more detailed feed prints
 
 #include "KeeLoqProtocol.hpp"
 #include "KeeLoqCommon.hpp"
@@ -40,11 +41,12 @@
 #endif
 
 
-// Helper macro for duration comparison
-#define DURATION_DIFF(a, b) (std::abs(static_cast<int32_t>(a) - static_cast<int32_t>(b)))
+// DURATION_DIFF comes from math.h.
 
 // --- KeeLoqProtocolDecoder Implementation ---
 
+const SubGhzBlockConst KeeLoqProtocolDecoder::timing = {TE_LONG, TE_SHORT, TE_DELTA, MIN_COUNT_BIT};
+
 KeeLoqProtocolDecoder::KeeLoqProtocolDecoder() {
     reset();
 }
@@ -62,14 +64,24 @@ void KeeLoqProtocolDecoder::reset() {
     last_duration_ = 0;
     has_valid_packet_ = false;
     last_decoded_packet_ = {};
+    preamble_sum_ = 0;
+    preamble_pulses_ = 0;
+    te_ = 0;
+    adaptTo(TE_SHORT);
+}
+
+void KeeLoqProtocolDecoder::adaptTo(uint32_t te) {
+    te_short_ = te;
+    te_long_ = te * TE_LONG / TE_SHORT;
+    te_delta_ = te * TE_DELTA / TE_SHORT;
 }
 
 bool KeeLoqProtocolDecoder::isDurationShort(uint32_t duration) const {
-     return DURATION_DIFF(duration, TE_SHORT) < TE_DELTA;
+     return DURATION_DIFF(duration, te_short_) < te_delta_;
 }
 
 bool KeeLoqProtocolDecoder::isDurationLong(uint32_t duration) const {
-     return DURATION_DIFF(duration, TE_LONG) < TE_DELTA * 2;
+     return DURATION_DIFF(duration, te_long_) < te_delta_ * 2;
 }
 
 void KeeLoqProtocolDecoder::addBit(bool bit) {
@@ -99,7 +111,9 @@ void KeeLoqProtocolDecoder::feed(bool level, uint32_t duration) {
         // Define the minimum acceptable preamble pulse pairs
         const uint16_t MIN_PREAMBLE_COUNT = 8;
     
+    #ifdef DEBUG_KEELOQ_DECODER_VERBOSE
         DecoderStep prev_step = parser_step_;
+    #endif
     
         switch (parser_step_) {
         case DecoderStep::Reset:
@@ -109,6 +123,8 @@ void KeeLoqProtocolDecoder::feed(bool level, uint32_t duration) {
                 last_duration_ = duration; // Store this high pulse duration
                 header_count_ = 1;       // Start count at 1 pulse
                 has_valid_packet_ = false;
+                preamble_sum_ = duration;
+                preamble_pulses_ = 1;
             }
             // Ignore other pulses in Reset state
             break;
@@ -123,6 +139,8 @@ void KeeLoqProtocolDecoder::feed(bool level, uint32_t duration) {
                         // Valid Short Low gap -> Part of preamble confirmed.
                         // Stay in CheckPreambula state, wait for next HIGH pulse.
                         header_count_++; // Increment count of *full pairs* processed.
+                        preamble_sum_ += duration;
+                        preamble_pulses_++;
                         // We don't change state here, just wait for the next level=1 pulse.
     #ifdef DEBUG_KEELOQ_DECODER_VERBOSE
                         Serial.print("KL_Dec: Preamble pair OK, count = "); Serial.println(header_count_);
@@ -136,6 +154,8 @@ void KeeLoqProtocolDecoder::feed(bool level, uint32_t duration) {
                         parser_step_ = DecoderStep::SaveDuration; // Transition to data saving state
                         current_data_ = 0;
                         decoded_bit_count_ = 0;
+                        // The data bits are read at the te this remote actually sends.
+                        adaptTo(preamble_sum_ / preamble_pulses_);
     #ifdef DEBUG_KEELOQ_DECODER
                         Serial.print("KL_Dec: Header Gap Found after "); Serial.print(header_count_); Serial.println(" preamble pairs.");
     #endif
@@ -160,6 +180,8 @@ void KeeLoqProtocolDecoder::feed(bool level, uint32_t duration) {
             else { // level is true
                  // Store this high pulse duration for the *next* check when the low gap arrives
                  last_duration_ = duration;
+                 preamble_sum_ += duration;
+                 preamble_pulses_++;
                  // Stay in CheckPreambula state.
                  // Do NOT increment header_count here, only after a complete pair (H+L) is validated.
             }
@@ -190,6 +212,7 @@ void KeeLoqProtocolDecoder::feed(bool level, uint32_t duration) {
                          last_decoded_packet_.data_count_bit = MIN_COUNT_BIT;
                          last_decoded_packet_.updateDerivedPartsFromData();
                          has_valid_packet_ = true;
+                         te_ = te_short_;
     #ifdef DEBUG_KEELOQ_DECODER
                           Serial.print("KL_Dec: Packet potentially valid ("); Serial.print(decoded_bit_count_); Serial.println(" bits). Ready for getResult().");
                          uint32_t high = (uint32_t)(last_decoded_packet_.data >> 32); uint32_t low = (uint32_t)(last_decoded_packet_.data & 0xFFFFFFFF);
@@ -204,6 +227,8 @@ void KeeLoqProtocolDecoder::feed(bool level, uint32_t duration) {
                      }
                      header_count_ = 0;
                      parser_step_ = next_step;
+                     // The next preamble is looked for at nominal timing again.
+                     adaptTo(TE_SHORT);
     
                  } else if (isDurationShort(last_duration_) && isDurationLong(duration)) { // Manchester '1'
                     addBit(1);
@@ -564,7 +589,9 @@ bool KeeLoqProtocolEncoder::generateNextPayload() {
     Serial.println("KL_Enc: generateNextPayload");
 #endif
     uint16_t increment = 1;
+#ifdef DEBUG_KEELOQ_ENCODER
     uint16_t old_cnt = data_to_encode_.cnt;
+#endif
     if (data_to_encode_.cnt > 0xFFFF - increment) {
         data_to_encode_.cnt = 0;
     } else {
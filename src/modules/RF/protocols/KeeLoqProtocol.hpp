@@ -9,6 +9,7 @@
 
 #include "KeeLoqData.hpp"
 #include "KeeLoqCommon.hpp"
+#include "math.h"
 
 // Define a structure for pulses if not already available
 struct Pulse {
@@ -41,6 +42,20 @@ public:
      */
     bool hasResult() const;
 
+    /**
+     * @brief te averaged over the preamble of the last valid packet, 0 if none.
+     */
+    uint32_t getTe() const {
+        return te_;
+    }
+
+    /**
+     * @brief True once the decoder has left its reset state for the current packet.
+     */
+    bool isSynced() const {
+        return parser_step_ != DecoderStep::Reset;
+    }
+
     /**
      * @brief Attempts to decrypt the last received packet and get the decoded data.
      * @param result Output parameter where the KeeLoqData will be stored if successful.
@@ -58,6 +73,9 @@ public:
     KeeLoqStatus serialize(std::ostream& outputStream) const;
     KeeLoqStatus deserialize(std::istream& inputStream);
 
+    // Timing the protocol registry indexes this decoder by.
+    static const SubGhzBlockConst timing;
+
 
 private:
     // Timing constants (taken from subghz_protocol_keeloq_const)
@@ -81,6 +99,14 @@ private:
     uint8_t decoded_bit_count_ = 0;
     uint32_t last_duration_ = 0;
 
+    // Preamble pulses so far; their mean is the te the data bits are read at.
+    uint32_t preamble_sum_ = 0;
+    uint16_t preamble_pulses_ = 0;
+    uint32_t te_short_ = TE_SHORT;
+    uint32_t te_long_ = TE_LONG;
+    uint32_t te_delta_ = TE_DELTA;
+    uint32_t te_ = 0;
+
     KeeLoqData last_decoded_packet_; // Store the last successfully received raw packet
     bool has_valid_packet_ = false;
 
@@ -94,6 +120,11 @@ private:
      */
     bool isDurationLong(uint32_t duration) const;
 
+    /**
+     * @brief Scales the short and long windows, tolerance included, to te.
+     */
+    void adaptTo(uint32_t te);
+
     /**
      * @brief Adds a bit to the currently assembling data.
      */
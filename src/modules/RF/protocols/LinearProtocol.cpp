@@ -2,6 +2,8 @@
 #include <cstdio>
 #include <sstream>
 
+const SubGhzBlockConst LinearProtocol::timing = {te_long, te_short, te_delta, min_count_bit};
+
 LinearProtocol::LinearProtocol()
     : decodeData(0),
       decodeCountBit(0),
@@ -90,13 +92,13 @@ void LinearProtocol::feed(bool level, uint32_t duration) {
     }
 }
 
-bool LinearProtocol::decode(const long long int* samples, size_t sampleCount) {
+bool LinearProtocol::decode(PulseView samples) {
     reset();
-    for (size_t i = 0; i < sampleCount; i++) {
-        if (samples[i] > 0)
-            feed(true, static_cast<uint32_t>(samples[i]));
+    for (PulseDuration sample : samples) {
+        if (sample > 0)
+            feed(true, static_cast<uint32_t>(sample));
         else
-            feed(false, static_cast<uint32_t>(-samples[i]));
+            feed(false, static_cast<uint32_t>(-sample));
         if (validCodeFound)
             return true;
     }
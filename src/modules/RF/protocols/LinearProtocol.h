@@ -2,6 +2,8 @@
 #define LINEAR_PROTOCOL_H
 
 #include <cstdint>
+#include "../PackedPulses.h"
+#include "math.h"
 #include <vector>
 #include <string>
 
@@ -12,10 +14,17 @@ public:
     // Decoder interface
     void reset();
     void feed(bool level, uint32_t duration);
-    bool decode(const long long int* samples, size_t sampleCount);
+    bool decode(PulseView samples);
     std::string getCodeString(uint64_t shortPulse, uint64_t longPulse) const;
     bool hasValidCode() const;
 
+    // Key and bit count of the last valid code.
+    uint64_t getCode() const { return finalData; }
+    uint8_t getBitCount() const { return finalBitCount; }
+
+    // Timing the protocol registry indexes this decoder by.
+    static const SubGhzBlockConst timing;
+
     // Encoder interface
     void startEncoding(uint32_t code, uint8_t bitCount);
     const std::vector<long long int>& getEncodedSamples() const;
@@ -1,54 +1,49 @@
 #ifndef NICE_FLO_DECODER_H
 #define NICE_FLO_DECODER_H
 
+#if defined(ARDUINO)
 #include <Arduino.h>
+#endif
 #include <stdint.h>
+#include "../PackedPulses.h"
 #include "math.h"
-#include <bitset>
+#include "PwmDecoder.h"
+#include <string>
+#if defined(ARDUINO)
 #include "../FlipperSubFile.h"
+#endif
 
-class NiceFloProtocol {
+// reset(), feed(), decode(), hasValidCode() and the key come from PwmDecoder.
+class NiceFloProtocol : public PwmDecoder<NiceFloProtocol> {
 public:
-    NiceFloProtocol();
+    NiceFloProtocol() {}
 
-    void reset();
-    bool decode(long long int* samples, size_t sampleCount);
-    String getCodeString(uint64_t shortPulse, uint64_t longPulse) const;
-    bool hasValidCode() const;
+    std::string getCodeString(uint64_t shortPulse, uint64_t longPulse) const;
+
+    // Timing the protocol registry indexes this decoder by.
+    static constexpr SubGhzBlockConst timing = {1400, 700, 200, 12};
+#if defined(ARDUINO)
     void yield(unsigned int hexValue);
     CC1101_PRESET preset;
+#endif
 
 private:
-    enum DecoderStep {
-        StepReset,
-        StepFoundStartBit,
-        StepSaveDuration,
-        StepCheckDuration
-    };
-
-    DecoderStep state;
-
-      std::bitset<12> binaryValue; 
-
-    const uint32_t te_short;  // 700 us
-    const uint32_t te_long;   // 1400 us
-    const uint32_t te_delta;  // 200 us tolerance
-    const uint8_t  min_count_bit; // 12 bits
-
-    uint32_t decodeData;
-    uint8_t  decodeCountBit;
-    uint32_t te_last;
+    friend class PwmDecoder<NiceFloProtocol>;
 
-    bool validCodeFound;
-    uint32_t finalCode;
-    uint8_t  finalBitCount;
+    // Header low of 36 te_short.
+    static constexpr bool isHeader(uint32_t low) {
+        return within(low, timing.te_short * 36u, timing.te_delta * 36u);
+    }
 
+    static constexpr bool isGap(uint32_t low) {
+        return low >= timing.te_short * 4u;
+    }
 
+    static constexpr bool acceptBitCount(uint8_t bits) {
+        return bits >= timing.min_count_bit_for_found;
+    }
 
-    inline void addBit(uint8_t bit);
-    void toBits(unsigned int hexValue);
     uint32_t reverseKey(uint32_t code, uint8_t bitCount) const;
-    void feed(bool level, uint32_t duration);
 };
 
 #endif // NICE_FLO_DECODER_H
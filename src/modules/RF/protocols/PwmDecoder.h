@@ -0,0 +1,199 @@
+#ifndef PWM_DECODER_H
+#define PWM_DECODER_H
+
+#include <cstdint>
+#include "../PackedPulses.h"
+#include "math.h"
+
+/**
+ * Receive side shared by the fixed-code PWM remotes (Came, Nice FLO): a long
+ * low header, a short high start bit, then one bit per low/high pair - short
+ * low and long high for 0, long low and short high for 1 - until a low gap
+ * closes the frame.
+ *
+ * Derived declares `static constexpr SubGhzBlockConst timing` and three
+ * static hooks, which may be private if it befriends PwmDecoder<Derived>:
+ *
+ *     static bool isHeader(uint32_t low);
+ *     static bool isGap(uint32_t low);
+ *     static bool acceptBitCount(uint8_t bits);
+ *
+ * Remotes drift off their nominal te with temperature and battery, and the
+ * header length differs between models, so the start bit - one te - is what
+ * the frame's timing is taken from: it is checked against the nominal short
+ * window, then the bit windows are scaled to it, tolerance included. The
+ * per-pulse checks stay one unsigned compare each, against bounds set once
+ * per frame. The hooks resolve at compile time; within() is there for them.
+ */
+template <typename Derived>
+class PwmDecoder {
+public:
+    void reset() {
+        step = StepReset;
+        decodeData = 0;
+        decodeCountBit = 0;
+        te_last = 0;
+        validCodeFound = false;
+        finalCode = 0;
+        finalBitCount = 0;
+        finalTe = 0;
+        adaptTo(Derived::timing.te_short);
+    }
+
+    // Feeds one pulse to the state machine.
+    void feed(bool level, uint32_t duration);
+
+    // Feeds a frame; returns true as soon as a valid code was detected.
+    bool decode(PulseView samples) {
+        reset();
+        for (PulseDuration sample : samples) {
+            feed(sample > 0, static_cast<uint32_t>(sample > 0 ? sample : -sample));
+            if (validCodeFound) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool hasValidCode() const {
+        return validCodeFound;
+    }
+
+    // Key and bit count of the last valid code.
+    uint64_t getCode() const {
+        return finalCode;
+    }
+
+    uint8_t getBitCount() const {
+        return finalBitCount;
+    }
+
+    // te measured on the start bit of the last valid code's frame.
+    uint32_t getTe() const {
+        return finalTe;
+    }
+
+    // Past the header, on the start bit or the data.
+    bool isSynced() const {
+        return step != StepReset;
+    }
+
+protected:
+    PwmDecoder() {
+        reset();
+    }
+
+    // DURATION_DIFF(duration, target) < tolerance as one unsigned compare:
+    // with constant operands the difference would otherwise become a branch
+    // on which side of target the pulse fell. Needs tolerance <= target.
+    static constexpr bool within(uint32_t duration, uint32_t target, uint32_t tolerance) {
+        return duration - (target - tolerance + 1) < 2 * tolerance - 1;
+    }
+
+    static constexpr bool isNominalShort(uint32_t duration) {
+        return within(duration, Derived::timing.te_short, Derived::timing.te_delta);
+    }
+
+    // Against the windows of the current frame, see adaptTo().
+    bool isShort(uint32_t duration) const {
+        return duration - shortFrom < span;
+    }
+
+    bool isLong(uint32_t duration) const {
+        return duration - longFrom < span;
+    }
+
+    uint32_t finalCode;
+    uint8_t finalBitCount;
+    uint32_t finalTe;
+
+private:
+    enum Step {
+        StepReset,
+        StepFoundStartBit,
+        StepSaveDuration,
+        StepCheckDuration
+    };
+
+    // Windows of te_short and te_long scaled by te / te_short, in the form
+    // within() compares against.
+    void adaptTo(uint32_t te) {
+        const uint32_t delta = te * Derived::timing.te_delta / Derived::timing.te_short;
+        frameTe = te;
+        shortFrom = te - delta + 1;
+        longFrom = te * Derived::timing.te_long / Derived::timing.te_short - delta + 1;
+        span = 2 * delta - 1;
+    }
+
+    void addBit(uint32_t bit) {
+        decodeData = decodeData << 1 | bit;
+        decodeCountBit++;
+        step = StepSaveDuration;
+    }
+
+    Step step;
+    uint32_t decodeData;
+    uint8_t decodeCountBit;
+    uint32_t te_last;
+    bool validCodeFound;
+    uint32_t frameTe;
+    uint32_t shortFrom;
+    uint32_t longFrom;
+    uint32_t span;
+};
+
+template <typename Derived>
+inline void PwmDecoder<Derived>::feed(bool level, uint32_t duration) {
+    static_assert(Derived::timing.te_delta <= Derived::timing.te_short, "te_delta wider than te_short");
+    switch (step) {
+    case StepReset:
+        if (!level && Derived::isHeader(duration)) {
+            step = StepFoundStartBit;
+        }
+        break;
+
+    case StepFoundStartBit:
+        if (!level) {
+            break;
+        } else if (isNominalShort(duration)) {
+            adaptTo(duration);
+            step = StepSaveDuration;
+            decodeData = 0;
+            decodeCountBit = 0;
+        } else {
+            step = StepReset;
+        }
+        break;
+
+    case StepSaveDuration:
+        if (!level) {
+            if (Derived::isGap(duration)) {
+                step = StepFoundStartBit;
+                if (Derived::acceptBitCount(decodeCountBit)) {
+                    validCodeFound = true;
+                    finalCode = decodeData;
+                    finalBitCount = decodeCountBit;
+                    finalTe = frameTe;
+                }
+                break;
+            }
+            te_last = duration;
+            step = StepCheckDuration;
+        } else {
+            step = StepReset;
+        }
+        break;
+
+    case StepCheckDuration:
+        if (level && isShort(te_last) && isLong(duration)) {
+            addBit(0);
+        } else if (level && isLong(te_last) && isShort(duration)) {
+            addBit(1);
+        } else {
+            step = StepReset;
+        }
+        break;
+    }
+}
+
+#endif // PWM_DECODER_H
@@ -1,17 +1,37 @@
 #include "Smc5326Protocol.h"
 #include <stdio.h>
-#
+#include <algorithm>
+#include <vector>
+#if defined(ARDUINO)
+#include "globals.h"
+#endif
+
+#define DIP_PATTERN "%c%c%c%c%c%c%c%c"
+#define DIP_P 0b11 
+#define DIP_O 0b10  
+#define DIP_N 0b00 
+#define SHOW_DIP_P(dip, check_dip)                         \
+    ((((dip >> 0xE) & 0x3) == check_dip) ? '*' : '_'),     \
+    ((((dip >> 0xC) & 0x3) == check_dip) ? '*' : '_'),     \
+    ((((dip >> 0xA) & 0x3) == check_dip) ? '*' : '_'),     \
+    ((((dip >> 0x8) & 0x3) == check_dip) ? '*' : '_'),     \
+    ((((dip >> 0x6) & 0x3) == check_dip) ? '*' : '_'),     \
+    ((((dip >> 0x4) & 0x3) == check_dip) ? '*' : '_'),     \
+    ((((dip >> 0x2) & 0x3) == check_dip) ? '*' : '_'),     \
+    ((((dip >> 0x0) & 0x3) == check_dip) ? '*' : '_')
 
 static inline uint32_t duration_diff(uint32_t a, uint32_t b) {
     return (a > b) ? (a - b) : (b - a);
 }
 
+const SubGhzBlockConst SMC5326Protocol::timing = {900, 300, 200, 25};
+
 SMC5326Protocol::SMC5326Protocol()
     : decoderState(DecoderStepReset),
-      te_short(300),
-      te_long(900),
-      te_delta(200),
-      min_count_bit(25),
+      te_short(timing.te_short),
+      te_long(timing.te_long),
+      te_delta(timing.te_delta),
+      min_count_bit(timing.min_count_bit_for_found),
       validCodeFound(false),
       decodeCountBit(0),
       decodedData(0),
@@ -21,8 +41,7 @@ SMC5326Protocol::SMC5326Protocol()
       finalBitCount(0),
       finalBtn(0),
       finalDIP(0),
-      te(0),
-      preset(AM650) {
+      te(0) {
 }
 
 void SMC5326Protocol::reset() {
@@ -44,16 +63,10 @@ inline void SMC5326Protocol::addBit(uint8_t bit) {
     decodeCountBit++;
 }
 
-bool SMC5326Protocol::decodeReversed(long long int* samples, size_t sampleCount) {
-    reset();
-    int j = 0;
-    std::vector<long long int> samplesReversed(sampleCount);
-    for (int i = sampleCount ; i > 0; i--) {
-        samplesReversed[j] = samples[i];
-        j++;
-    }
-    decode(samplesReversed.data(), sampleCount);
-    return false;
+bool SMC5326Protocol::decodeReversed(PulseView samples) {
+    std::vector<PulseDuration> samplesReversed(samples.begin(), samples.end());
+    std::reverse(samplesReversed.begin(), samplesReversed.end());
+    return decode(samplesReversed);
 }
 
 void SMC5326Protocol::feed(bool level, uint32_t duration) {
@@ -131,13 +144,13 @@ void SMC5326Protocol::feed(bool level, uint32_t duration) {
 }
 
 
-bool SMC5326Protocol::decode(long long int* samples, size_t sampleCount) {
+bool SMC5326Protocol::decode(PulseView samples) {
     reset();
-    for (size_t i = 0; i < sampleCount; i++) {
-        if (samples[i] > 0) {
-            feed(true, (uint32_t)samples[i]);
+    for (PulseDuration sample : samples) {
+        if (sample > 0) {
+            feed(true, (uint32_t)sample);
         } else {
-            feed(false, (uint32_t)(-samples[i]));
+            feed(false, (uint32_t)(-sample));
         }
         if (validCodeFound) {
             //Serial.println(F("SMC5326: valid code found"));
@@ -148,6 +161,7 @@ bool SMC5326Protocol::decode(long long int* samples, size_t sampleCount) {
     return false;
 }
 
+#if defined(ARDUINO)
 void SMC5326Protocol::yield(unsigned int code) {
     samplesToSend.clear();
     
@@ -186,15 +200,13 @@ void SMC5326Protocol::yield(unsigned int code) {
     //Serial.println();
     delay(5);
 }
+#endif
 
 
-String SMC5326Protocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) const {
+std::string SMC5326Protocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) const {
     uint32_t data = (finalCode >> 9) & 0xFFFF;
     uint8_t event = (finalCode >> 1) & 0xFF;
 
-    ScreenManager& screenMgr = ScreenManager::getInstance();
-    lv_obj_t* textarea = (C1101preset == CUSTOM) ? screenMgr.text_area_SubGHzCustom : screenMgr.getTextArea();
-
     char buf[192];
     snprintf(
         buf,
@@ -202,8 +214,8 @@ String SMC5326Protocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) c
         "SMC5326 %ubit\r\nKey:%07lX         Te:%luus\r\n"
         "  +:   " DIP_PATTERN "\r\n"
         "  o:   " DIP_PATTERN "    ",
-        finalBitCount,
-        (finalCode & 0x1FFFFFF),
+        (unsigned)finalBitCount,
+        (unsigned long)(finalCode & 0x1FFFFFF),
         (unsigned long)te,
         SHOW_DIP_P(data, DIP_P),
         SHOW_DIP_P(data, DIP_O)
@@ -218,7 +230,8 @@ String SMC5326Protocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) c
         (((event >> 2) & 0x3) == 0x3 ? "B3 " : ""),
         (((event >> 0) & 0x3) == 0x3 ? "B4 " : "")
     );
-    strlcat(buf, btnLine, sizeof(buf));
+    std::string code(buf);
+    code += btnLine;
     char minusLine[48];
     snprintf(
         minusLine,
@@ -226,19 +239,9 @@ String SMC5326Protocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) c
         "  -:   " DIP_PATTERN "\r\n",
         SHOW_DIP_P(data, DIP_N)
     );
-    strlcat(buf, minusLine, sizeof(buf));
-
-    lv_textarea_set_text(textarea, buf);
-
-    //Serial.println(F("SMC5326Protocol::getCodeString(uint64_t shortPulse, uint64_t longPulse) called"));
-    //Serial.print(F(" finalCode=0x"));
-    //Serial.println(finalCode, HEX);
-    //Serial.print(F(" finalBitCount="));
-    //Serial.println(finalBitCount);
-    //Serial.print(F(" te="));
-    //Serial.println(te);
+    code += minusLine;
 
-    return String(buf);
+    return code;
 }
 
 bool SMC5326Protocol::hasValidCode() const {
@@ -1,42 +1,38 @@
 #ifndef SMC5326_PROTOCOL_H
 #define SMC5326_PROTOCOL_H
 
+#if defined(ARDUINO)
 #include <Arduino.h>
+#endif
 #include <stdint.h>
-#include "GUI/ScreenManager.h"
-#include "globals.h"
-#include "../FlipperSubFile.h"
-
-#define DIP_PATTERN "%c%c%c%c%c%c%c%c"
-#define DIP_P 0b11 
-#define DIP_O 0b10  
-#define DIP_N 0b00 
-#define SHOW_DIP_P(dip, check_dip)                         \
-    ((((dip >> 0xE) & 0x3) == check_dip) ? '*' : '_'),     \
-    ((((dip >> 0xC) & 0x3) == check_dip) ? '*' : '_'),     \
-    ((((dip >> 0xA) & 0x3) == check_dip) ? '*' : '_'),     \
-    ((((dip >> 0x8) & 0x3) == check_dip) ? '*' : '_'),     \
-    ((((dip >> 0x6) & 0x3) == check_dip) ? '*' : '_'),     \
-    ((((dip >> 0x4) & 0x3) == check_dip) ? '*' : '_'),     \
-    ((((dip >> 0x2) & 0x3) == check_dip) ? '*' : '_'),     \
-    ((((dip >> 0x0) & 0x3) == check_dip) ? '*' : '_')
+#include "../PackedPulses.h"
+#include "math.h"
+#include <string>
 
 class SMC5326Protocol {
 public:
     SMC5326Protocol();
 
     void reset();
+    void feed(bool level, uint32_t duration);
 
+    bool decode(PulseView samples);
 
-    bool decode(long long int* samples, size_t sampleCount);
-
-    CC1101_PRESET preset;
-    String getCodeString(uint64_t shortPulse, uint64_t longPulse) const;
+    std::string getCodeString(uint64_t shortPulse, uint64_t longPulse) const;
 
     bool hasValidCode() const;
-    bool decodeReversed(long long int* samples, size_t sampleCount);
+    bool isSynced() const { return decoderState != DecoderStepReset; }
+    // Key and bit count of the last valid code.
+    uint64_t getCode() const { return finalCode; }
+    uint8_t getBitCount() const { return static_cast<uint8_t>(finalBitCount); }
 
+    // Timing the protocol registry indexes this decoder by.
+    static const SubGhzBlockConst timing;
+    bool decodeReversed(PulseView samples);
+
+#if defined(ARDUINO)
     void yield(unsigned int code);
+#endif
 
 
 private:
@@ -65,7 +61,6 @@ private:
     uint32_t finalDIP;
     uint32_t te; 
 
-    void feed(bool level, uint32_t duration);
     inline void addBit(uint8_t bit);
 };
 
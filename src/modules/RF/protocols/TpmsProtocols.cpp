@@ -0,0 +1,84 @@
+#include "TpmsProtocols.h"
+
+#define CITROEN_BATTERY_LOW 2   // battery byte below which the cell is reported low
+
+uint8_t tpmsCrc8(const uint8_t* data, size_t length, uint8_t polynomial, uint8_t init) {
+    uint8_t crc = init;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = crc & 0x80 ? static_cast<uint8_t>(crc << 1 ^ polynomial) : static_cast<uint8_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// First up to 8 payload bytes, for TPMSGenericData::data.
+static void storeRaw(const uint8_t* payload, size_t bytes, TPMSGenericData& reading) {
+    reading.data = 0;
+    reading.dataCountBit = static_cast<uint8_t>((bytes < 8 ? bytes : 8) * 8);
+    for (size_t i = 0; i < bytes && i < 8; i++) {
+        reading.data = reading.data << 8 | payload[i];
+    }
+}
+
+/*
+ * Renault, as rtl_433 documents it: the same raw preamble as Citroen below,
+ * then
+ *
+ *     FP PP TT II II II UU UU CC
+ *
+ * F 6 bits of flags and P a 10-bit pressure in 0.75 kPa, T temperature + 30
+ * C, I a 24-bit id, little-endian, U unknown, C CRC-8 (poly 0x07, init 0)
+ * of the eight bytes before it. It has no battery flag.
+ */
+static bool parseRenault(const uint8_t* b, TPMSGenericData& reading) {
+    const uint32_t id = static_cast<uint32_t>(b[5]) << 16 | static_cast<uint32_t>(b[4]) << 8 | b[3];
+    if (tpmsCrc8(b, 8, 0x07, 0x00) != b[8] || id == 0) {
+        return false;
+    }
+    reading.protocolName = "Renault";
+    reading.id = id;
+    reading.pressure = ((b[0] & 0x03) << 8 | b[1]) * 0.75f;
+    reading.temperature = b[2] - 30.0f;
+    reading.batteryLow = false;
+    storeRaw(b, 9, reading);
+    return true;
+}
+
+/*
+ * Citroen/Peugeot (VDO), as rtl_433 documents it: raw preamble 55 55 55 56,
+ * which is 0x0001 in bits, then
+ *
+ *     UU II II II II FR PP TT BB CC
+ *
+ * U state, I a 32-bit id, F flags and R repeat count, P pressure in
+ * 1.364 kPa, T temperature + 50 C, B battery, which counts down as the cell
+ * drains, C such that bytes 1 to 9 xor to 0.
+ */
+static bool parseCitroen(const uint8_t* b, TPMSGenericData& reading) {
+    uint8_t folded = 0;
+    for (int i = 1; i < 10; i++) {
+        folded ^= b[i];
+    }
+    const uint32_t id = static_cast<uint32_t>(b[1]) << 24 | static_cast<uint32_t>(b[2]) << 16 |
+                        static_cast<uint32_t>(b[3]) << 8 | b[4];
+    // A run of zeros xors to 0 as well.
+    if (folded != 0 || id == 0 || id == 0xFFFFFFFF) {
+        return false;
+    }
+    reading.protocolName = "Citroen";
+    reading.id = id;
+    reading.pressure = b[6] * 1.364f;
+    reading.temperature = b[7] - 50.0f;
+    reading.batteryLow = b[8] < CITROEN_BATTERY_LOW;
+    storeRaw(b, 10, reading);
+    return true;
+}
+
+const TpmsLayout tpmsLayouts[] = {
+    {"Renault", 52, 0x0001, 16, 9, parseRenault},
+    {"Citroen", 52, 0x0001, 16, 10, parseCitroen},
+};
+
+const size_t tpmsLayoutCount = sizeof(tpmsLayouts) / sizeof(tpmsLayouts[0]);
@@ -0,0 +1,33 @@
+#ifndef TPMS_PROTOCOLS_H
+#define TPMS_PROTOCOLS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "TPMSGenericData.h"
+
+#define TPMS_MAX_PAYLOAD 16     // bytes after the sync of the longest layout
+
+/**
+ * Where a TPMS protocol's packet sits in the Manchester chips of an FSK
+ * capture: the last bits of its preamble and sync, then a fixed-size
+ * payload that parse() checks and turns into a reading, pressure in kPa
+ * and temperature in degrees C. Formats without a battery flag leave
+ * batteryLow false.
+ */
+struct TpmsLayout {
+    const char* name;
+    uint16_t te;            // us per chip, half a bit
+    uint16_t sync;          // bits right before the payload
+    uint8_t syncBits;
+    uint8_t bytes;          // payload, check included
+    // Returns false if the check fails.
+    bool (*parse)(const uint8_t* payload, TPMSGenericData& reading);
+};
+
+extern const TpmsLayout tpmsLayouts[];
+extern const size_t tpmsLayoutCount;
+
+// CRC-8, MSB first, no reflection or final xor.
+uint8_t tpmsCrc8(const uint8_t* data, size_t length, uint8_t polynomial, uint8_t init);
+
+#endif // TPMS_PROTOCOLS_H
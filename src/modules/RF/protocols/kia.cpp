@@ -1,16 +1,15 @@
 #include "kia.hpp"
-#include "lvgl.h"
-#include "GUI/ScreenManager.h"
-#include "globals.h"
 #include "math.h"
 #include <bitset>
 
 
+const SubGhzBlockConst KiaProtocol::timing = {500, 250, 100, 61};
+
 KiaProtocol::KiaProtocol()
-     : te_short(250),
-       te_long(500),
-       te_delta(100),
-       min_count_bit(61)
+     : te_short(timing.te_short),
+       te_long(timing.te_long),
+       te_delta(timing.te_delta),
+       min_count_bit(timing.min_count_bit_for_found)
 {
 }
 
@@ -31,18 +30,18 @@ inline void KiaProtocol::addBit(uint8_t bit) {
     decodeCountBit++;
 }
 
-bool KiaProtocol::decode(long long int* samples, size_t sampleCount) {
+bool KiaProtocol::decode(PulseView samples) {
     reset();
-    for(size_t i = 0; i < sampleCount; i++) {
+    for (PulseDuration sample : samples) {
         ////Serial.print("Sample index ");
         ////Serial.print(i);
         ////Serial.print(": ");
-       ////Serial.println(samples[i]);
+       ////Serial.println(sample);
         
-        if(samples[i] > 0) {
-            feed(true, samples[i]);
+        if(sample > 0) {
+            feed(true, sample);
         } else {
-            feed(false, -samples[i]);
+            feed(false, -sample);
         }
         
         if(validCodeFound) {
@@ -191,7 +190,7 @@ uint32_t KiaProtocol::get_hash_data() {
 }
 
 
-void KiaProtocol::get_string(uint64_t shortPulse, uint64_t longPulse) {
+std::string KiaProtocol::get_string(uint64_t shortPulse, uint64_t longPulse) {
 
     char buf[128];    
     check_remote_controller();
@@ -199,28 +198,19 @@ void KiaProtocol::get_string(uint64_t shortPulse, uint64_t longPulse) {
     uint32_t code_found_hi = data >> 32;
     uint32_t code_found_lo = data & 0x00000000ffffffff;
 
-    sprintf(
+    snprintf(
         buf,
-        "%s %dbit\r\n"
+        sizeof(buf),
+        "%s %ubit\r\n"
         "Key:%08lX%08lX\r\n"
-        "Sn:%07lX Btn:%X Cnt:%04lX\r\n",
+        "Sn:%07lX Btn:%X Cnt:%04X\r\n",
         protocolName,
-        data_count_bit,
-        code_found_hi,
-        code_found_lo,
-        serial,
+        (unsigned)data_count_bit,
+        (unsigned long)code_found_hi,
+        (unsigned long)code_found_lo,
+        (unsigned long)serial,
         btn,
         cnt);
 
-
-        ScreenManager& screenMgr = ScreenManager::getInstance();
-        lv_obj_t * textarea;
-if(C1101preset == CUSTOM){
-   textarea = screenMgr.text_area_SubGHzCustom;        
-} else {
-   textarea = screenMgr.getTextArea();
-}
-
-lv_textarea_set_text(textarea, buf); 
-
+    return std::string(buf);
 }
@@ -3,6 +3,9 @@
 #define KIA_H
 
 #include <stdio.h>
+#include "../PackedPulses.h"
+#include "math.h"
+#include <string>
 
 
 struct DecoderKIA;
@@ -30,8 +33,18 @@ public:
     uint8_t crc8(uint8_t* data, size_t len);
     void check_remote_controller();
     uint32_t get_hash_data();
-    void get_string(uint64_t shortPulse, uint64_t longPulse);
-    bool decode(long long int* samples, size_t sampleCount);
+    std::string get_string(uint64_t shortPulse, uint64_t longPulse);
+    bool decode(PulseView samples);
+
+    // Key and bit count of the last valid code.
+    uint64_t getCode() const { return data; }
+    uint8_t getBitCount() const { return static_cast<uint8_t>(data_count_bit); }
+    bool hasValidCode() const { return validCodeFound; }
+    bool isSynced() const { return state != KIADecoderStepReset; }
+    std::string getCodeString(uint64_t shortPulse, uint64_t longPulse) { return get_string(shortPulse, longPulse); }
+
+    // Timing the protocol registry indexes this decoder by.
+    static const SubGhzBlockConst timing;
 
 private:
     // Timing parameters
@@ -1,19 +1,90 @@
 #include "math.h"
 
-int64_t computeMedian(vector<int64_t>* nums) {
-    if (nums->empty()) return 0; 
-    sort(nums->begin(), nums->end());
-    size_t n = nums->size();
-    if (n % 2 == 1)
-        return (*nums)[n / 2]; 
-    return ((*nums)[n / 2 - 1] + (*nums)[n / 2]) / 2;
-}
-
 int64_t medianOfTwo(int64_t a, int64_t b) {
     return (a + b) / 2;  
 }
 
 
+StreamingQuantile::StreamingQuantile(float quantile) : quantile(quantile), samples(0) {}
+
+void StreamingQuantile::reset() {
+    samples = 0;
+}
+
+void StreamingQuantile::add(float sample) {
+    if (samples < 5) {
+        heights[samples++] = sample;
+        if (samples == 5) {
+            sort(heights, heights + 5);
+            for (int i = 0; i < 5; i++) {
+                positions[i] = i;
+            }
+            desired[0] = 0;
+            desired[1] = 2 * quantile;
+            desired[2] = 4 * quantile;
+            desired[3] = 2 + 2 * quantile;
+            desired[4] = 4;
+        }
+        return;
+    }
+    samples++;
+
+    // Cell the sample falls in, widening the extremes if needed.
+    int cell;
+    if (sample < heights[0]) {
+        heights[0] = sample;
+        cell = 0;
+    } else if (sample >= heights[4]) {
+        heights[4] = sample;
+        cell = 3;
+    } else {
+        cell = 0;
+        while (sample >= heights[cell + 1]) {
+            cell++;
+        }
+    }
+    for (int i = cell + 1; i < 5; i++) {
+        positions[i]++;
+    }
+    const float step[5] = {0, quantile / 2, quantile, (1 + quantile) / 2, 1};
+    for (int i = 0; i < 5; i++) {
+        desired[i] += step[i];
+    }
+
+    // Move the middle markers one position towards where they should be.
+    for (int i = 1; i < 4; i++) {
+        const float offset = desired[i] - positions[i];
+        if ((offset >= 1 && positions[i + 1] - positions[i] > 1) ||
+            (offset <= -1 && positions[i - 1] - positions[i] < -1)) {
+            const int d = offset > 0 ? 1 : -1;
+            const float below = positions[i] - positions[i - 1];
+            const float above = positions[i + 1] - positions[i];
+            float height = heights[i] + d / (below + above) *
+                                            ((below + d) * (heights[i + 1] - heights[i]) / above +
+                                             (above - d) * (heights[i] - heights[i - 1]) / below);
+            if (!(heights[i - 1] < height && height < heights[i + 1])) {
+                height = heights[i] + d * (heights[i + d] - heights[i]) / (positions[i + d] - positions[i]);
+            }
+            heights[i] = height;
+            positions[i] += d;
+        }
+    }
+}
+
+float StreamingQuantile::value() const {
+    if (samples == 0) {
+        return 0;
+    }
+    if (samples < 5) {
+        float sorted[5];
+        copy(heights, heights + samples, sorted);
+        sort(sorted, sorted + samples);
+        const size_t index = static_cast<size_t>(quantile * samples);
+        return sorted[index < samples ? index : samples - 1];
+    }
+    return heights[2];
+}
+
 uint32_t getHashDataLong(uint64_t &decodeData, size_t len) {
     union {
         uint32_t full;
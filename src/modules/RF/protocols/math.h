@@ -16,14 +16,46 @@ struct Sample {
 };
 
 typedef struct {
-    const uint16_t te_long;
-    const uint16_t te_short;
-    const uint16_t te_delta;
-    const uint8_t min_count_bit_for_found;
+    uint16_t te_long;
+    uint16_t te_short;
+    uint16_t te_delta;
+    uint8_t min_count_bit_for_found;
 } SubGhzBlockConst;
 
+/**
+ * Running estimate of one quantile of a sample stream in constant memory, the
+ * P-square algorithm of Jain and Chlamtac: five markers follow the minimum,
+ * the quantile, the maximum and two points halfway, and each sample nudges
+ * them along a parabola through their neighbours. Exact up to five samples.
+ *
+ * Suited to streams with a single mode, such as UI frame times (FrameTimeStats).
+ * On a mix of short and long pulses the middle marker settles between the two,
+ * which is why TeEstimator keeps its exact quartile over a short window and
+ * FrameSegmenter bins each pulse on a PulseHistogram as it splits a capture.
+ */
+class StreamingQuantile {
+public:
+    explicit StreamingQuantile(float quantile = 0.5f);
+
+    void add(float sample);
+    void reset();
+
+    // 0 before the first sample.
+    float value() const;
+
+    uint32_t count() const {
+        return samples;
+    }
+
+private:
+    float quantile;
+    float heights[5];
+    int32_t positions[5];
+    float desired[5];
+    uint32_t samples;
+};
+
 // Function Declarations (Prototypes)
-int64_t computeMedian(vector<int64_t>* nums);
 int64_t medianOfTwo(int64_t a, int64_t b);
 uint32_t getHashDataLong(uint64_t &decodeData, size_t len);
 
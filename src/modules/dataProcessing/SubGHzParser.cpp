@@ -1,4 +1,5 @@
 #include "SubGHzParser.h"
+#include "modules/RF/BinRawAnalyzer.h"
 
 int codesSend = 0;
 
@@ -85,22 +86,90 @@ bool SubGHzParser::processHeader(File32* file) {
 
 void SubGHzParser::processRawDataBlocks(File32* file) {
     String line;
+    RepeatInfo repeats;
+    std::vector<RawDataElement> repeated;
     updatetransmitLabel = true;
     // For each line that starts with "RAW_Data:" we treat it as a separate block.
+    // Files written with a Repeat: line hold one copy of the frame; those are
+    // collected and sent once, expanded to the original repeat count.
     while (file->available()) {
         line = file->readStringUntil('\n');
         line.trim();
         
-        if (line.startsWith("RAW_Data:")) {
+        if (line.startsWith("Repeat:")) {
+            repeats = parseRepeat(line.substring(7));
+        } else if (line.startsWith("RAW_Data:")) {
             std::vector<RawDataElement> rawDataBuffer = parseRawData(line.substring(9));
             Serial.println(rawDataBuffer.size());
             data.raw_data_list.push_back(rawDataBuffer);
+            if (repeats.repeated()) {
+                repeated.insert(repeated.end(), rawDataBuffer.begin(), rawDataBuffer.end());
+                continue;
+            }
             sendRawData(rawDataBuffer);
             codesSend++;
+        } else if (line.startsWith("TE:")) {
+            data.te = line.substring(3);
+            data.te.trim();
+        } else if (line.startsWith("Bit_RAW:")) {
+            data.bit_raw = line.substring(8);
+            data.bit_raw.trim();
+        } else if (line.startsWith("Data_RAW:")) {
+            std::vector<RawDataElement> rawDataBuffer = parseBinRaw(line.substring(9));
+            data.raw_data_list.push_back(rawDataBuffer);
+            if (!rawDataBuffer.empty()) {
+                sendRawData(rawDataBuffer);
+                codesSend++;
+            }
         } else if (line.length() > 0) {
             Serial.println(line);
         }
     }
+    if (!repeated.empty()) {
+        sendRawData(expandRepeats(repeated, repeats));
+        codesSend++;
+    }
+}
+
+RepeatInfo SubGHzParser::parseRepeat(const String& line) {
+    RepeatInfo repeats;
+    unsigned start = 0;
+    unsigned length = 0;
+    unsigned count = 1;
+    if (sscanf(line.c_str(), "%u %u %u", &start, &length, &count) == 3 && count > 1) {
+        repeats.start = start;
+        repeats.length = length;
+        repeats.count = static_cast<uint16_t>(count);
+    }
+    return repeats;
+}
+
+std::vector<RawDataElement> SubGHzParser::parseBinRaw(const String& line) {
+    BinRawFrame frame;
+    const long bits = data.bit_raw.toInt();
+    frame.bits = static_cast<uint16_t>(bits > 0 && bits < BINRAW_MAX_SLOT_BYTES * 8 ? bits : BINRAW_MAX_SLOT_BYTES * 8);
+    const char* hex = line.c_str();
+    char* next = nullptr;
+    size_t bytes = 0;
+    while (bytes < frame.bytes()) {
+        const unsigned long value = strtoul(hex, &next, 16);
+        if (next == hex) {
+            break;
+        }
+        frame.data[bytes++] = static_cast<uint8_t>(value);
+        hex = next;
+    }
+    frame.bits = static_cast<uint16_t>(bytes * 8 < frame.bits ? bytes * 8 : frame.bits);
+
+    std::vector<PulseDuration> pulses(frame.bits);
+    pulses.resize(BinRawAnalyzer::toPulses(frame, static_cast<uint32_t>(data.te.toInt()), pulses.data(), pulses.size()));
+    // RAW playback takes 16-bit durations; a gap can only be cut short.
+    std::vector<RawDataElement> result;
+    result.reserve(pulses.size());
+    for (PulseDuration pulse : pulses) {
+        result.push_back(static_cast<RawDataElement>(pulse > INT16_MAX ? INT16_MAX : pulse < -INT16_MAX ? -INT16_MAX : pulse));
+    }
+    return result;
 }
 
 std::vector<RawDataElement> SubGHzParser::parseRawData(const String& line) {
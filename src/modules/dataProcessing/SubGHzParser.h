@@ -53,6 +53,11 @@ private:
     SubGHzData data;
     
     std::vector<RawDataElement> parseRawData(const String& line);
+
+    RepeatInfo parseRepeat(const String& line);
+
+    // Pulses of a BinRAW Data_RAW line at the file's TE and Bit_RAW.
+    std::vector<RawDataElement> parseBinRaw(const String& line);
     
     std::vector<CustomPresetElement> parseCustomPresetData(const String& line);
     
@@ -0,0 +1,124 @@
+#ifndef TEST_FRAMES_H
+#define TEST_FRAMES_H
+
+// Pulse trains of the remotes the RF tests decode, and the random numbers
+// behind their jitter and noise. Durations are signed: high > 0, low < 0.
+
+#include <cstdint>
+#include <vector>
+#include "../src/modules/RF/PackedPulses.h"
+#include "../src/modules/RF/protocols/LinearProtocol.h"
+
+// Linear congruential generator; returns the next 16 random bits.
+inline uint32_t nextRandom(uint32_t& seed) {
+    seed = seed * 1103515245u + 12345u;
+    return seed >> 16;
+}
+
+// duration with uniform jitter of up to jitterPercent.
+inline int jittered(int duration, int jitterPercent, uint32_t& seed) {
+    const int span = duration * jitterPercent / 100;
+    const uint32_t random = nextRandom(seed);
+    return span ? duration + static_cast<int>(random % (2 * span + 1)) - span : duration;
+}
+
+// Pulses with uniform jitter of up to jitterPercent; one level in a row is
+// one pulse, as on air.
+class PulseTrain {
+public:
+    explicit PulseTrain(int jitterPercent = 0, uint32_t seed = 1) : jitterPercent(jitterPercent), seed(seed) {}
+
+    void high(int duration) {
+        add(jittered(duration, jitterPercent, seed));
+    }
+
+    void low(int duration) {
+        add(-jittered(duration, jitterPercent, seed));
+    }
+
+    // frame sent repeats times back to back, jittered like the rest.
+    void append(const std::vector<PulseDuration>& frame, int repeats = 1) {
+        for (int r = 0; r < repeats; r++) {
+            for (PulseDuration pulse : frame) {
+                if (pulse > 0) {
+                    high(pulse);
+                } else {
+                    low(-pulse);
+                }
+            }
+        }
+    }
+
+    uint32_t next() {
+        return nextRandom(seed);
+    }
+
+    std::vector<PulseDuration> pulses;
+
+private:
+    void add(PulseDuration pulse) {
+        if (!pulses.empty() && (pulses.back() > 0) == (pulse > 0)) {
+            pulses.back() += pulse;
+        } else {
+            pulses.push_back(pulse);
+        }
+    }
+
+    int jitterPercent;
+    uint32_t seed;
+};
+
+// Came/Holtek style: a gapTe low header, a start bit, then long low and short
+// high for 1. The next frame's header, or a closing low, ends it.
+inline void cameFrame(PulseTrain& train, uint32_t code, int bits, int te, int gapTe = 36) {
+    train.low(te * gapTe);
+    train.high(te);
+    for (int i = bits - 1; i >= 0; i--) {
+        const bool one = (code >> i) & 1;
+        train.low(one ? 2 * te : te);
+        train.high(one ? te : 2 * te);
+    }
+}
+
+// High first: long high and short low for 1, ratio times te apart.
+inline void pwmBits(PulseTrain& train, uint64_t code, int bits, int te, int ratio) {
+    for (int i = bits - 1; i >= 0; i--) {
+        const bool one = (code >> i) & 1;
+        train.high(one ? te * ratio : te);
+        train.low(one ? te : te * ratio);
+    }
+}
+
+// One Linear frame as LinearProtocol encodes it, gap included.
+inline std::vector<PulseDuration> linearFrame(uint32_t code) {
+    LinearProtocol encoder;
+    encoder.startEncoding(code, 10);
+    std::vector<PulseDuration> frame;
+    for (long long int sample : encoder.getEncodedSamples()) {
+        frame.push_back(static_cast<PulseDuration>(sample));
+    }
+    return frame;
+}
+
+// One KeeLoq transmission as KeeLoqProtocolEncoder lays it out, less its
+// 40 te guard gap: 23 pulses of preamble, a 10 te header gap, then the 64
+// data bits and 2 status bits of short-high/long-low or long-high/short-low,
+// and a closing high.
+inline std::vector<PulseDuration> keeloqFrame(uint64_t data, PulseDuration te) {
+    std::vector<PulseDuration> frame;
+    for (int i = 0; i < 11; i++) {
+        frame.push_back(te);
+        frame.push_back(-te);
+    }
+    frame.push_back(te);
+    frame.push_back(-te * 10);
+    for (int i = 63; i >= -2; i--) {
+        const bool bit = i >= 0 ? (data >> i) & 1 : true;
+        frame.push_back(bit ? te : 2 * te);
+        frame.push_back(bit ? -2 * te : -te);
+    }
+    frame.push_back(te);
+    return frame;
+}
+
+#endif // TEST_FRAMES_H
@@ -0,0 +1,293 @@
+#include "../src/modules/RF/BatchDecoder.h"
+#include "../src/modules/RF/CaptureDecoder.h"
+#include "../src/modules/RF/FlexDecoder.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Came frames repeated as a remote sends them, then the gap.
+static std::vector<PulseDuration> cameCapture(int te, uint32_t code, int bits, int repeats) {
+    PulseTrain train;
+    for (int r = 0; r < repeats; r++) {
+        cameFrame(train, code, bits, te);
+    }
+    train.low(36 * te);
+    return train.pulses;
+}
+
+static void writeSub(const std::filesystem::path& path, const std::vector<PulseDuration>& pulses) {
+    std::ofstream out(path, std::ios::binary);
+    out << "Filetype: Flipper SubGhz RAW File\r\nVersion: 1\r\nFrequency: 433920000\r\n"
+        << "Preset: FuriHalSubGhzPresetOok650Async\r\nProtocol: RAW\r\nRAW_Data:";
+    for (size_t i = 0; i < pulses.size(); i++) {
+        if (i != 0 && i % 512 == 0) {
+            out << "\r\nRAW_Data:";
+        }
+        out << ' ' << pulses[i];
+    }
+    out << "\r\n";
+}
+
+// A scratch directory, removed with everything in it.
+class ScratchDir {
+public:
+    explicit ScratchDir(const char* name) : path(std::filesystem::temp_directory_path() / name) {
+        std::filesystem::remove_all(path);
+        std::filesystem::create_directories(path);
+    }
+
+    ~ScratchDir() {
+        std::error_code error;
+        std::filesystem::remove_all(path, error);
+    }
+
+    std::filesystem::path path;
+};
+
+// The registry the tests decode through: Came's 12-bit code as a flex spec.
+class BatchDecoderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        FlexSpec spec;
+        ASSERT_TRUE(parseFlexSpec("name=Came12,mod=pwm,short=320,long=640,sync=320,gap=5000,tolerance=150,bits=12",
+                                  spec));
+        ASSERT_TRUE(came.compile(spec));
+        protocols.add(came);
+        protocols.build();
+    }
+
+    FlexDecoder came;
+    ProtocolRegistry protocols;
+    PulseHistogram histogram;
+    DecoderMetrics metrics;
+    CaptureDecoder decoder{protocols, histogram, &metrics};
+};
+
+TEST_F(BatchDecoderTest, CaptureDecoderVotesOverFrames) {
+    const std::vector<PulseDuration> pulses = cameCapture(320, 0xA53, 12, 4);
+    FrameSegmenter segmenter(FRAME_GAP_MULTIPLIER, 5, 16);
+    const DecodeResult result = decoder.decode(pulses.data(), pulses.size(), segmenter);
+    ASSERT_TRUE(result.valid());
+    EXPECT_STREQ(result.protocol, "Came12");
+    EXPECT_EQ(result.code, 0xA53u);
+    EXPECT_EQ(result.bits, 12u);
+    EXPECT_EQ(result.frames, 4u);
+    EXPECT_NEAR(result.te, 320, 10);
+
+    // The timing left behind is that of the frame the text came from.
+    const FrameTiming& timing = decoder.timing();
+    EXPECT_TRUE(timing.measured());
+    EXPECT_NEAR(timing.shortPulse, 320, 10);
+    EXPECT_NEAR(timing.longPulse, 640, 20);
+    EXPECT_FALSE(timing.reversed);
+
+    const DecoderCounters* row = metrics.find("Came12");
+    ASSERT_NE(row, nullptr);
+    // Four frames voted on, plus the one run for the text, which is not booked.
+    EXPECT_EQ(row->offered, 4u);
+    EXPECT_EQ(row->decoded, 4u);
+}
+
+// A frame of a single width has no long pulse and reaches no decoder.
+TEST_F(BatchDecoderTest, UnmeasuredFrameIsNotFed) {
+    std::vector<PulseDuration> frame;
+    for (int i = 0; i < 32; i++) {
+        frame.push_back(i % 2 ? -400 : 400);
+    }
+    EXPECT_FALSE(decoder.measure(frame).measured());
+    DecodeVote vote;
+    vote.reset(1);
+    EXPECT_EQ(decoder.decodeFrame(frame, 0, vote), 0u);
+    EXPECT_EQ(metrics.find("Came12"), nullptr);
+}
+
+TEST_F(BatchDecoderTest, IndexesDirectory) {
+    ScratchDir dir("batch_decoder_index");
+    writeSub(dir.path / "b_came.sub", cameCapture(320, 0x5A3, 12, 5));
+    // Too slow for Came12, so only its line code is found.
+    writeSub(dir.path / "c_slow.SUB", cameCapture(500, 0x0F0, 12, 3));
+    std::ofstream(dir.path / "a_key.sub") << "Filetype: Flipper SubGhz Key File\nVersion: 1\nProtocol: Came\n"
+                                             "Bit: 12\nKey: 00 00 00 00 00 00 05 A3\n";
+    std::ofstream(dir.path / "notes.txt") << "RAW_Data: 320 -640\n";
+    std::filesystem::create_directory(dir.path / "d_dir.sub");
+
+    BatchDecoder batch(protocols, histogram);
+    std::vector<BatchEntry> entries;
+    ASSERT_TRUE(batch.run(dir.path.string().c_str(), [&](const BatchEntry& entry) { entries.push_back(entry); }));
+    ASSERT_EQ(entries.size(), 3u);
+
+    // By name on a host.
+    EXPECT_STREQ(entries[0].file, "a_key.sub");
+    EXPECT_FALSE(entries[0].result.valid());
+    EXPECT_EQ(entries[0].binRaw.bits, 0u);
+    EXPECT_EQ(entries[0].pulses, 0u);
+
+    EXPECT_STREQ(entries[1].file, "b_came.sub");
+    ASSERT_TRUE(entries[1].result.valid());
+    EXPECT_EQ(entries[1].result.code, 0x5A3u);
+    EXPECT_EQ(entries[1].result.frames, 5u);
+    EXPECT_FALSE(entries[1].truncated);
+
+    EXPECT_STREQ(entries[2].file, "c_slow.SUB");
+    EXPECT_FALSE(entries[2].result.valid());
+    EXPECT_EQ(entries[2].binRaw.code, LineCode::Pwm);
+    EXPECT_EQ(entries[2].binRaw.bits, 12u);
+    EXPECT_NEAR(entries[2].binRaw.te, 500, 15);
+
+    const BatchProgress progress = batch.progress();
+    EXPECT_EQ(progress.files, 3u);
+    EXPECT_EQ(progress.done, 3u);
+    EXPECT_EQ(progress.decoded, 1u);
+    EXPECT_EQ(progress.binRaw, 1u);
+    EXPECT_FALSE(progress.running);
+
+    EXPECT_FALSE(batch.run((dir.path / "missing").string().c_str(), [](const BatchEntry&) {}));
+}
+
+// The batch decodes through the live registry but books what its decoders
+// do apart from the live counters, and starts them over on every run.
+TEST_F(BatchDecoderTest, KeepsItsOwnCounters) {
+    ScratchDir dir("batch_decoder_counters");
+    writeSub(dir.path / "came.sub", cameCapture(320, 0x5A3, 12, 3));
+
+    BatchDecoder batch(protocols, histogram);
+    for (int run = 0; run < 2; run++) {
+        ASSERT_TRUE(batch.run(dir.path.string().c_str(), [](const BatchEntry&) {}));
+        const DecoderCounters* row = batch.metrics().find("Came12");
+        ASSERT_NE(row, nullptr);
+        EXPECT_EQ(row->offered, 3u);
+        EXPECT_EQ(row->decoded, 3u);
+    }
+    EXPECT_EQ(metrics.find("Came12"), nullptr);
+}
+
+// A cancelled batch stops after the file it is on and is no longer running,
+// and the next one runs over every file again.
+TEST_F(BatchDecoderTest, CancelEndsBatch) {
+    ScratchDir dir("batch_decoder_cancel");
+    for (const char* name : {"a.sub", "b.sub", "c.sub"}) {
+        writeSub(dir.path / name, cameCapture(320, 0x5A3, 12, 3));
+    }
+
+    BatchDecoder batch(protocols, histogram);
+    EXPECT_FALSE(batch.running());
+    size_t seen = 0;
+    ASSERT_TRUE(batch.run(dir.path.string().c_str(), [&](const BatchEntry&) {
+        EXPECT_TRUE(batch.running());
+        seen++;
+        batch.cancel();
+    }));
+    EXPECT_EQ(seen, 1u);
+    EXPECT_FALSE(batch.running());
+    const BatchProgress progress = batch.progress();
+    EXPECT_EQ(progress.files, 3u);
+    EXPECT_EQ(progress.done, 1u);
+    EXPECT_FALSE(progress.running);
+
+    seen = 0;
+    ASSERT_TRUE(batch.run(dir.path.string().c_str(), [&](const BatchEntry&) { seen++; }));
+    EXPECT_EQ(seen, 3u);
+    EXPECT_FALSE(batch.running());
+}
+
+TEST_F(BatchDecoderTest, FormatsIndexLines) {
+    char line[256];
+    BatchDecoder::formatHeader(line, sizeof(line));
+    EXPECT_STREQ(line, "file,protocol,key,bits,te,confidence,frames,pulses\n");
+
+    BatchEntry entry;
+    snprintf(entry.file, sizeof(entry.file), "gate.sub");
+    entry.pulses = 130;
+    const int length = BatchDecoder::format(entry, line, sizeof(line));
+    EXPECT_EQ(length, static_cast<int>(strlen(line)));
+    EXPECT_STREQ(line, "gate.sub,,,,,,0,130\n");
+
+    entry.binRaw.code = LineCode::Pwm;
+    entry.binRaw.bits = 12;
+    entry.binRaw.te = 500;
+    entry.binRaw.data[0] = 0x0F;
+    entry.binRaw.data[1] = 0x00;
+    entry.result.frames = 3;
+    entry.truncated = true;
+    BatchDecoder::format(entry, line, sizeof(line));
+    EXPECT_STREQ(line, "gate.sub,BinRAW/PWM,0x0F00,12,500,,3,130+\n");
+
+    entry.result.protocol = "Came12";
+    entry.result.code = 0x5A3;
+    entry.result.bits = 12;
+    entry.result.te = 321;
+    entry.result.agreeing = 3;
+    entry.result.confidence = 100;
+    entry.truncated = false;
+    BatchDecoder::format(entry, line, sizeof(line));
+    EXPECT_STREQ(line, "gate.sub,Came12,0x5A3,12,321,100,3,130\n");
+}
+
+TEST(BatchDecoderNames, SubFilesOnly) {
+    EXPECT_TRUE(BatchDecoder::isSubFile("gate.sub"));
+    EXPECT_TRUE(BatchDecoder::isSubFile("GATE.Sub"));
+    EXPECT_FALSE(BatchDecoder::isSubFile(".sub"));
+    EXPECT_FALSE(BatchDecoder::isSubFile("gate.sub.bak"));
+    EXPECT_FALSE(BatchDecoder::isSubFile("decode_index.csv"));
+    // SDcard::readNextFileInDir() marks directories with a leading /.
+    EXPECT_FALSE(BatchDecoder::isSubFile("/captures.sub"));
+}
+
+// A file longer than the limit decodes from its first pulses.
+TEST_F(BatchDecoderTest, LongFileIsTruncated) {
+    const std::vector<PulseDuration> pulses = cameCapture(320, 0x5A3, 12, 20);
+    std::string text = "Filetype: Flipper SubGhz RAW File\nProtocol: RAW\nRAW_Data:";
+    for (PulseDuration pulse : pulses) {
+        text += ' ' + std::to_string(pulse);
+    }
+    SubFileSource source;
+    source.setLimit(100);
+    source.parse(text.data(), text.size());
+    source.finish();
+    EXPECT_EQ(source.size(), 100u);
+    EXPECT_TRUE(source.wasTruncated());
+
+    BatchDecoder batch(protocols, histogram);
+    BatchEntry entry;
+    batch.decode(source, entry);
+    EXPECT_TRUE(entry.truncated);
+    EXPECT_EQ(entry.pulses, 100u);
+    ASSERT_TRUE(entry.result.valid());
+    EXPECT_EQ(entry.result.code, 0x5A3u);
+    // 26 pulses a frame: three whole frames of twenty, and a cut one.
+    EXPECT_EQ(entry.result.frames, 4u);
+    EXPECT_EQ(entry.result.agreeing, 3u);
+}
+
+// Files a second through the whole batch, from reading the file to the
+// index line, on a corpus of decodable and unknown captures.
+TEST_F(BatchDecoderTest, BatchDecoderPerformance) {
+    ScratchDir dir("batch_decoder_performance");
+    const int count = 200;
+    for (int i = 0; i < count; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "capture_%03d.sub", i);
+        writeSub(dir.path / name, cameCapture(i % 4 ? 320 : 500, 0x100u + i, 12, 8));
+    }
+
+    BatchDecoder batch(protocols, histogram);
+    char line[256];
+    size_t bytes = 0;
+    const auto start = std::chrono::steady_clock::now();
+    ASSERT_TRUE(batch.run(dir.path.string().c_str(),
+                          [&](const BatchEntry& entry) { bytes += BatchDecoder::format(entry, line, sizeof(line)); }));
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const BatchProgress progress = batch.progress();
+    EXPECT_EQ(progress.done, static_cast<uint32_t>(count));
+    EXPECT_EQ(progress.decoded, static_cast<uint32_t>(count * 3 / 4));
+    EXPECT_EQ(progress.binRaw, static_cast<uint32_t>(count / 4));
+    EXPECT_GT(bytes, 0u);
+    std::printf("[ BatchDecoder ] %d files of %zu pulses: %.0f files/s\n", count, cameCapture(320, 0, 12, 8).size(),
+                count / seconds);
+}
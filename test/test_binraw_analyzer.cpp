@@ -0,0 +1,190 @@
+#include "../src/modules/RF/BinRawAnalyzer.h"
+#include "../src/modules/RF/FrameSegmenter.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+
+static uint64_t dataBits(const BinRawSignal& signal) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < signal.bits && i < 64; i++) {
+        value = value << 1 | signal.bit(i);
+    }
+    return value;
+}
+
+TEST(BinRawAnalyzerTest, PwmFrameWithStartBit) {
+    const int te = 320;
+    PulseTrain capture(10, 1);
+    cameFrame(capture, 0xA53, 12, te);
+    capture.low(36 * te);
+    PulseHistogram histogram;
+    BinRawAnalyzer analyzer(histogram);
+    ASSERT_TRUE(analyzer.analyze(capture.pulses));
+    const BinRawSignal& signal = analyzer.signal();
+    EXPECT_NEAR(signal.te, 320, 10);
+    EXPECT_EQ(signal.code, LineCode::Pwm);
+    EXPECT_EQ(signal.preamble, 0u);
+    // The start bit is left over in front of the low/high pairs.
+    EXPECT_EQ(signal.sync, 1u);
+    ASSERT_EQ(signal.bits, 12u);
+    EXPECT_EQ(dataBits(signal), 0xA53u);
+    // Start bit, 12 pairs of 3 te, then the gap, which only rounds to te.
+    EXPECT_NEAR(signal.slots.bits, 1 + 36 + 36, 4);
+}
+
+TEST(BinRawAnalyzerTest, PreambleSyncAndPwmData) {
+    // KeeLoq style: 23 pulses of te, a 10 te header, then short-high/long-low
+    // for 1 with the last low running into the gap.
+    const int te = 400;
+    PulseTrain capture(8, 2);
+    for (int i = 0; i < 11; i++) {
+        capture.high(te);
+        capture.low(te);
+    }
+    capture.high(te);
+    capture.low(10 * te);
+    const uint32_t code = 0xC0FFEE;
+    for (int i = 23; i >= 0; i--) {
+        const bool one = (code >> i) & 1;
+        capture.high((one ? 1 : 2) * te);
+        capture.low((i == 0 ? 40 : one ? 2 : 1) * te);
+    }
+    PulseHistogram histogram;
+    BinRawAnalyzer analyzer(histogram);
+    ASSERT_TRUE(analyzer.analyze(capture.pulses));
+    const BinRawSignal& signal = analyzer.signal();
+    EXPECT_EQ(signal.code, LineCode::Pwm);
+    EXPECT_EQ(signal.preamble, 23u);
+    EXPECT_EQ(signal.sync, 1u);
+    ASSERT_EQ(signal.bits, 24u);
+    // Long first pulse is 1, so KeeLoq's bits come out inverted.
+    EXPECT_EQ(dataBits(signal), ~code & 0xFFFFFFu);
+}
+
+TEST(BinRawAnalyzerTest, PpmFrame) {
+    const int te = 500;
+    PulseTrain capture(10, 3);
+    capture.low(20 * te);
+    for (int i = 15; i >= 0; i--) {
+        capture.high(te);
+        capture.low(((0x9C31 >> i) & 1 ? 4 : 2) * te);
+    }
+    capture.high(te);
+    capture.low(20 * te);
+    PulseHistogram histogram;
+    BinRawAnalyzer analyzer(histogram);
+    ASSERT_TRUE(analyzer.analyze(capture.pulses));
+    EXPECT_EQ(analyzer.signal().code, LineCode::Ppm);
+    ASSERT_EQ(analyzer.signal().bits, 16u);
+    EXPECT_EQ(dataBits(analyzer.signal()), 0x9C31u);
+}
+
+TEST(BinRawAnalyzerTest, ManchesterAfterPreambleAndSync) {
+    const int te = 250;
+    PulseTrain capture(8, 4);
+    for (int i = 0; i < 8; i++) {
+        capture.high(te);
+        capture.low(te);
+    }
+    capture.high(4 * te);
+    // 0x6B2D as high-low for 1, low-high for 0, merging equal halves.
+    const uint32_t code = 0x6B2D;
+    std::vector<bool> halves;
+    for (int i = 15; i >= 0; i--) {
+        const bool one = (code >> i) & 1;
+        halves.push_back(one);
+        halves.push_back(!one);
+    }
+    // The sync ends high; a leading high half would merge into it.
+    ASSERT_FALSE(halves[0]);
+    size_t i = 0;
+    while (i < halves.size()) {
+        int width = 1;
+        while (i + width < halves.size() && halves[i + width] == halves[i]) {
+            width++;
+        }
+        halves[i] ? capture.high(width * te) : capture.low(width * te);
+        i += width;
+    }
+    capture.low(30 * te);
+    PulseHistogram histogram;
+    BinRawAnalyzer analyzer(histogram);
+    ASSERT_TRUE(analyzer.analyze(capture.pulses));
+    const BinRawSignal& signal = analyzer.signal();
+    EXPECT_EQ(signal.code, LineCode::Manchester);
+    EXPECT_EQ(signal.preamble, 16u);
+    EXPECT_EQ(signal.sync, 1u);
+    ASSERT_EQ(signal.bits, 16u);
+    EXPECT_EQ(dataBits(signal), code);
+}
+
+TEST(BinRawAnalyzerTest, NrzFallback) {
+    const int te = 100;
+    PulseTrain capture(5, 5);
+    const int widths[] = {1, 3, 2, 5, 1, 1, 4, 2, 3, 1, 2, 6, 1};
+    for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++) {
+        i % 2 ? capture.low(widths[i] * te) : capture.high(widths[i] * te);
+    }
+    capture.low(50 * te);
+    PulseHistogram histogram;
+    BinRawAnalyzer analyzer(histogram);
+    ASSERT_TRUE(analyzer.analyze(capture.pulses));
+    const BinRawSignal& signal = analyzer.signal();
+    EXPECT_EQ(signal.code, LineCode::Nrz);
+    // One bit per te up to the gap.
+    EXPECT_EQ(signal.bits, 32u);
+    EXPECT_EQ(dataBits(signal), 0x8C179D81u);
+}
+
+TEST(BinRawAnalyzerTest, RejectsPulsesOffAnyTe) {
+    std::vector<PulseDuration> noise;
+    uint32_t seed = 6;
+    for (int i = 0; i < 200; i++) {
+        const PulseDuration duration = 100 + static_cast<PulseDuration>(nextRandom(seed) % 2000);
+        noise.push_back(i % 2 ? -duration : duration);
+    }
+    PulseHistogram histogram;
+    BinRawAnalyzer analyzer(histogram);
+    EXPECT_FALSE(analyzer.analyze(noise));
+    EXPECT_FALSE(analyzer.analyze(std::vector<PulseDuration>()));
+}
+
+// Twenty repeats of a 24-bit frame as FrameSegmenter splits them: all come
+// out as the same data, and the pulses replayed from the slots of one of
+// them analyze to the very same slots.
+TEST(BinRawAnalyzerTest, SlotsReplayTheCapture) {
+    const int te = 320;
+    PulseTrain capture(10, 7);
+    for (int r = 0; r < 20; r++) {
+        cameFrame(capture, 0x5E3A71, 24, te);
+    }
+    capture.low(36 * te);
+    FrameSegmenter segmenter(FRAME_GAP_MULTIPLIER, 5, 8);
+    ASSERT_EQ(segmenter.split(capture.pulses.data(), capture.pulses.size()), 20u);
+    PulseHistogram histogram;
+    BinRawAnalyzer analyzer(histogram);
+    ASSERT_TRUE(analyzer.analyze(segmenter.frame(0)));
+    const BinRawSignal signal = analyzer.signal();
+    EXPECT_NEAR(signal.slots.bits, 1 + 72 + 36, 4);
+    for (size_t i = 1; i < segmenter.size(); i++) {
+        ASSERT_TRUE(analyzer.analyze(segmenter.frame(i))) << i;
+        EXPECT_NEAR(analyzer.signal().te, signal.te, 10) << i;
+        EXPECT_EQ(dataBits(analyzer.signal()), 0x5E3A71u) << i;
+        BinRawFrame slots;
+        EXPECT_TRUE(analyzer.encode(segmenter.frame(i), signal.te, slots)) << i;
+    }
+
+    PulseDuration replay[64];
+    const size_t count = BinRawAnalyzer::toPulses(signal.slots, signal.te, replay, 64);
+    // Equal slots merge, e.g. a 0's long high with nothing after it.
+    ASSERT_GT(count, 24u);
+    ASSERT_TRUE(analyzer.analyze(PulseView(replay, count)));
+    EXPECT_EQ(analyzer.signal().te, signal.te);
+    EXPECT_TRUE(analyzer.signal().slots.sameSlots(signal.slots));
+    EXPECT_EQ(analyzer.signal().code, LineCode::Pwm);
+    EXPECT_EQ(dataBits(analyzer.signal()), 0x5E3A71u);
+
+    std::printf("[ BinRAW ] %zu pulses captured, %zu bytes of slots at te %u us\n", capture.pulses.size(),
+                signal.slots.bytes(), static_cast<unsigned>(signal.te));
+}
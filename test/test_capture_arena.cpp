@@ -0,0 +1,101 @@
+#include "../src/modules/RF/CaptureArena.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static std::vector<PulseDuration> makeCapture(size_t pulses, PulseDuration base) {
+    std::vector<PulseDuration> capture;
+    for (size_t i = 0; i < pulses; i++) {
+        const PulseDuration duration = base + static_cast<PulseDuration>(i % 7) * 10;
+        capture.push_back((i & 1) ? -duration : duration);
+    }
+    return capture;
+}
+
+static std::vector<PulseDuration> collect(PulseView view) {
+    return std::vector<PulseDuration>(view.begin(), view.end());
+}
+
+TEST(CaptureArenaTest, StoresAndReturnsCaptures) {
+    CaptureArena<256, 8> arena;
+    const auto first = makeCapture(40, 300);
+    const auto second = makeCapture(20, 500);
+
+    CaptureHandle a = arena.store(first);
+    CaptureHandle b = arena.store(second);
+    ASSERT_TRUE(a.valid());
+    ASSERT_TRUE(b.valid());
+    EXPECT_EQ(arena.size(), 2u);
+    EXPECT_EQ(collect(arena.get(a)), first);
+    EXPECT_EQ(collect(arena.get(b)), second);
+    EXPECT_EQ(collect(arena.latest()), second);
+    EXPECT_EQ(collect(arena.at(0)), first);
+}
+
+TEST(CaptureArenaTest, EvictsOldestWhenFull) {
+    CaptureArena<100, 8> arena;
+    CaptureHandle h1 = arena.store(makeCapture(40, 300));
+    CaptureHandle h2 = arena.store(makeCapture(40, 400));
+    CaptureHandle h3 = arena.store(makeCapture(40, 500)); // wraps, must evict h1
+
+    EXPECT_TRUE(arena.get(h1).empty());
+    EXPECT_EQ(arena.get(h2).size(), 40u);
+    EXPECT_EQ(collect(arena.get(h3)), makeCapture(40, 500));
+    EXPECT_EQ(arena.evictions(), 1u);
+    EXPECT_LE(arena.usedBytes(), arena.capacityBytes());
+}
+
+TEST(CaptureArenaTest, EvictsWhenOutOfRecords) {
+    CaptureArena<1024, 3> arena;
+    CaptureHandle first = arena.store(makeCapture(10, 300));
+    for (int i = 0; i < 3; i++) {
+        arena.store(makeCapture(10, 400));
+    }
+    EXPECT_EQ(arena.size(), 3u);
+    EXPECT_TRUE(arena.get(first).empty());
+}
+
+TEST(CaptureArenaTest, RejectsOversizedCapture) {
+    CaptureArena<64, 4> arena;
+    EXPECT_FALSE(arena.store(makeCapture(65, 300)).valid());
+    EXPECT_FALSE(arena.store(PulseView()).valid());
+    EXPECT_EQ(arena.rejected(), 2u);
+    EXPECT_TRUE(arena.empty());
+}
+
+TEST(CaptureArenaTest, KeepsEscapedGaps) {
+    CaptureArena<64, 4> arena;
+    const std::vector<PulseDuration> capture = {400, -120000, 800, -40000};
+    CaptureHandle h = arena.store(capture);
+    EXPECT_EQ(collect(arena.get(h)), capture);
+    EXPECT_EQ(arena.usedBytes(), (2 + 2 * 3) * sizeof(int16_t));
+}
+
+// Long session with captures of varying length: every stored capture must read
+// back intact, and usage must stay within the fixed arena.
+TEST(CaptureArenaPerformance, LongSessionStore) {
+    static CaptureArena<16384, 32> arena;
+    const size_t sizes[] = {64, 300, 1200, 2048, 90, 700};
+    const uint32_t captures = 20000;
+
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < captures; i++) {
+        const auto capture = makeCapture(sizes[i % 6], 250 + static_cast<PulseDuration>(i % 50));
+        CaptureHandle h = arena.store(capture);
+        ASSERT_TRUE(h.valid());
+        ASSERT_EQ(arena.get(h).size(), capture.size());
+        ASSERT_LE(arena.usedBytes(), arena.capacityBytes());
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+
+    for (size_t i = 0; i < arena.size(); i++) {
+        EXPECT_FALSE(arena.at(i).empty());
+    }
+    std::printf("[ CaptureArena ] %u captures, %u evictions, high water %zu / %zu bytes, %.2f us/capture\n",
+                captures, arena.evictions(), arena.highWaterBytes(), arena.capacityBytes(),
+                static_cast<double>(elapsed) / captures);
+    EXPECT_LE(arena.highWaterBytes(), arena.capacityBytes());
+}
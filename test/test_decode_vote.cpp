@@ -0,0 +1,129 @@
+#include "../src/modules/RF/DecodeResult.h"
+#include "../src/modules/RF/FrameAssembler.h"
+#include "../src/modules/RF/FrameSegmenter.h"
+#include "../src/modules/RF/PulseSource.h"
+#include "../src/modules/RF/protocols/LinearProtocol.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+// Runs the capture through segmentation, Linear decoding and the vote, the way
+// CC1101_CLASS::analyse() does.
+static DecodeResult voteCapture(const std::vector<PulseDuration>& capture) {
+    FrameSegmenter segmenter(FRAME_GAP_MULTIPLIER, 5, 16);
+    const size_t frames = segmenter.split(capture.data(), capture.size());
+    DecodeVote vote;
+    vote.reset(static_cast<uint16_t>(frames));
+    LinearProtocol decoder;
+    for (size_t i = 0; i < frames; i++) {
+        FrameDecode decode;
+        if (decoder.decode(segmenter.frame(i))) {
+            decode.protocol = "Linear";
+            decode.code = decoder.getCode();
+            decode.bits = decoder.getBitCount();
+        }
+        vote.add(decode, static_cast<uint16_t>(i));
+    }
+    return vote.result();
+}
+
+TEST(DecodeVoteTest, CorruptedRepeatIsOutvoted) {
+    PulseTrain capture;
+    capture.append(linearFrame(0x2A5));
+    capture.append(linearFrame(0x2A4));  // one bit flipped in the air
+    capture.append(linearFrame(0x2A5), 3);
+
+    const DecodeResult result = voteCapture(capture.pulses);
+    ASSERT_TRUE(result.valid());
+    EXPECT_STREQ(result.protocol, "Linear");
+    EXPECT_EQ(result.code, 0x2A5u);
+    EXPECT_EQ(result.bits, 10u);
+    EXPECT_EQ(result.agreeing, 3u);
+    EXPECT_EQ(result.decoded, 4u);
+    EXPECT_EQ(result.frames, 5u);
+    EXPECT_EQ(result.confidence, 60u);
+}
+
+// The receive loop of CC1101_CLASS::CheckReceived(), with the limits of
+// CC1101.h; returns true once the collector holds a capture to submit.
+struct AnalyzerLoop {
+    FrameAssembler assembler{16, 2048, 5, FRAME_GAP_MULTIPLIER, 50000};
+    CaptureCollector collector{8, 2048, 50000, 1000000};
+    uint32_t lastEdge = 0;
+
+    bool drainEdges(PulseSource& source) {
+        Edge edge;
+        while (source.read(&edge, 1) == 1) {
+            lastEdge = edge.timestamp;
+            if (assembler.addEdge(edge)) {
+                return true;
+            }
+        }
+        return assembler.checkIdle(source.now());
+    }
+
+    bool checkReceived(PulseSource& source) {
+        bool complete = false;
+        while (!complete && drainEdges(source)) {
+            complete = collector.addFrame(assembler);
+            assembler.next();
+        }
+        return complete || collector.checkIdle(lastEdge, source.now());
+    }
+};
+
+// A press held long enough for three repeats is one analyzer capture, so
+// every repeat gets a vote instead of the first alone.
+TEST(DecodeVoteTest, AnalyzerCaptureVotesOverEveryRepeat) {
+    SyntheticPulseSource source;
+    source.setJitter(30);
+    source.addSilence(21000);   // Linear's guard gap heads the first frame too
+    source.addFrame(PulseView(linearFrame(0x2A5)), 3, 0);
+
+    AnalyzerLoop loop;
+    ASSERT_TRUE(loop.checkReceived(source));
+    const PulseView capture = loop.collector.capture();
+    const DecodeResult result = voteCapture(std::vector<PulseDuration>(capture.begin(), capture.end()));
+    ASSERT_TRUE(result.valid());
+    EXPECT_EQ(result.code, 0x2A5u);
+    EXPECT_EQ(result.frames, 3u);
+    EXPECT_GT(result.agreeing, 1u);
+    EXPECT_EQ(result.agreeing, 3u);
+    EXPECT_EQ(result.confidence, 75u);
+}
+
+TEST(DecodeVoteTest, MajorityBeatsFirstSeen) {
+    DecodeVote vote;
+    vote.reset(4);
+    FrameDecode a;
+    a.protocol = "Came";
+    a.code = 0x123;
+    a.bits = 12;
+    FrameDecode b = a;
+    b.code = 0x321;
+    vote.add(a, 0);
+    vote.add(b, 1);
+    vote.add(FrameDecode(), 2);
+    vote.add(b, 3);
+    EXPECT_EQ(vote.result().code, 0x321u);
+    EXPECT_EQ(vote.winningFrame(), 1u);
+    EXPECT_EQ(vote.result().agreeing, 2u);
+    EXPECT_EQ(vote.result().decoded, 3u);
+}
+
+TEST(DecodeVoteTest, ReverseBits) {
+    EXPECT_EQ(reverseBits(0x1, 1), 0x1u);
+    EXPECT_EQ(reverseBits(0x123, 12), 0xC48u);
+    EXPECT_EQ(reverseBits(0x8000000000000001ull, 64), 0x8000000000000001ull);
+    EXPECT_EQ(reverseBits(0xF0, 0), 0u);
+}
+
+TEST(DecodeVoteTest, NothingDecoded) {
+    DecodeVote vote;
+    vote.reset(3);
+    vote.add(FrameDecode(), 0);
+    const DecodeResult result = vote.result();
+    EXPECT_FALSE(result.valid());
+    EXPECT_EQ(result.frames, 3u);
+    EXPECT_EQ(result.confidence, 0u);
+}
@@ -0,0 +1,262 @@
+#include "../src/modules/RF/DecodeWorker.h"
+#include "../src/modules/RF/FrameSegmenter.h"
+#include "../src/modules/RF/FrameTimeStats.h"
+#include "../src/modules/RF/PulseHistogram.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Analysis stand-in that records what it was given.
+static bool echo(PulseView capture, DecodeOutcome& outcome) {
+    outcome.result.frames = static_cast<uint16_t>(capture.size());
+    outcome.result.code = static_cast<uint64_t>(*capture.begin());
+    return true;
+}
+
+static std::vector<PulseDuration> capture(PulseDuration first, size_t size) {
+    std::vector<PulseDuration> pulses(size, -300);
+    pulses[0] = first;
+    return pulses;
+}
+
+TEST(BoundedQueueTest, FifoUpToItsDepth) {
+    BoundedQueue<int, 3> queue;
+    int item = 0;
+    EXPECT_FALSE(queue.receive(item));
+    for (int i = 1; i <= 3; i++) {
+        EXPECT_TRUE(queue.send(i));
+    }
+    EXPECT_FALSE(queue.send(4));
+    EXPECT_EQ(queue.size(), 3u);
+    for (int i = 1; i <= 3; i++) {
+        ASSERT_TRUE(queue.receive(item));
+        EXPECT_EQ(item, i);
+    }
+    EXPECT_FALSE(queue.receive(item, 1));
+}
+
+TEST(BoundedQueueTest, ReceiveWaitsForASender) {
+    BoundedQueue<int, 1> queue;
+    std::thread sender([&queue] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        queue.send(7);
+    });
+    int item = 0;
+    EXPECT_TRUE(queue.receive(item, QUEUE_WAIT_FOREVER));
+    EXPECT_EQ(item, 7);
+    sender.join();
+}
+
+TEST(DecodeWorkerTest, OutcomesComeBackInOrder) {
+    DecodeWorker worker(echo);
+    EXPECT_TRUE(worker.submit(capture(100, 40), 1000));
+    EXPECT_TRUE(worker.submit(capture(200, 60), 2000));
+    EXPECT_TRUE(worker.busy());
+    DecodeOutcome outcome;
+    EXPECT_FALSE(worker.poll(outcome));
+
+    EXPECT_TRUE(worker.process(0));
+    EXPECT_TRUE(worker.process(0));
+    EXPECT_FALSE(worker.process(0));
+    EXPECT_FALSE(worker.busy());
+
+    ASSERT_TRUE(worker.poll(outcome));
+    EXPECT_EQ(outcome.result.code, 100u);
+    EXPECT_EQ(outcome.result.frames, 40u);
+    EXPECT_EQ(outcome.endTime, 1000u);
+    EXPECT_TRUE(outcome.found);
+    ASSERT_TRUE(worker.poll(outcome));
+    EXPECT_EQ(outcome.result.code, 200u);
+    EXPECT_EQ(outcome.endTime, 2000u);
+    EXPECT_FALSE(worker.poll(outcome));
+}
+
+TEST(DecodeWorkerTest, DropsCapturesOnceEverySlotIsTaken) {
+    DecodeWorker worker(echo);
+    for (int i = 0; i < DECODE_QUEUE_DEPTH; i++) {
+        EXPECT_TRUE(worker.submit(capture(100, 10), 0));
+    }
+    EXPECT_FALSE(worker.submit(capture(100, 10), 0));
+    EXPECT_EQ(worker.dropped(), 1u);
+    // Empty captures are not work, nor a drop.
+    EXPECT_FALSE(worker.submit(PulseView(), 0));
+    EXPECT_EQ(worker.dropped(), 1u);
+
+    // The slot stays taken until the UI is done with the outcome's capture.
+    EXPECT_TRUE(worker.process(0));
+    EXPECT_FALSE(worker.submit(capture(100, 10), 0));
+    DecodeOutcome outcome;
+    ASSERT_TRUE(worker.poll(outcome));
+    EXPECT_EQ(worker.capture(outcome.job).size(), 10u);
+    EXPECT_EQ(*worker.capture(outcome.job).begin(), 100);
+    worker.release(outcome.job);
+    EXPECT_TRUE(worker.submit(capture(100, 10), 0));
+}
+
+TEST(DecodeWorkerTest, CutsCapturesLongerThanASlot) {
+    DecodeWorker worker(echo);
+    EXPECT_TRUE(worker.submit(capture(100, DECODE_JOB_PULSES + 500), 0));
+    EXPECT_TRUE(worker.process(0));
+    DecodeOutcome outcome;
+    ASSERT_TRUE(worker.poll(outcome));
+    EXPECT_EQ(outcome.result.frames, DECODE_JOB_PULSES);
+}
+
+// A capture nothing matched is shown and timed like any other.
+TEST(DecodeWorkerTest, NothingToSaveIsStillQueued) {
+    DecodeWorker worker([](PulseView, DecodeOutcome&) { return false; });
+    EXPECT_TRUE(worker.submit(capture(100, 10), 1000));
+    EXPECT_TRUE(worker.process(0));
+    EXPECT_FALSE(worker.busy());
+    DecodeOutcome outcome;
+    ASSERT_TRUE(worker.poll(outcome));
+    EXPECT_FALSE(outcome.found);
+    EXPECT_FALSE(outcome.result.valid());
+    EXPECT_EQ(outcome.endTime, 1000u);
+    EXPECT_FALSE(worker.poll(outcome));
+    worker.release(outcome.job);
+    for (int i = 0; i < DECODE_QUEUE_DEPTH; i++) {
+        EXPECT_TRUE(worker.submit(capture(100, 10), 0));
+    }
+}
+
+// The worker in its own thread, as the task is on the ESP32: every capture
+// the UI side gets a slot for comes back, in order.
+TEST(DecodeWorkerTest, WorkerThread) {
+    DecodeWorker worker([](PulseView capture, DecodeOutcome& outcome) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        return echo(capture, outcome);
+    });
+    std::atomic<bool> stop(false);
+    std::thread thread([&] {
+        while (!stop) {
+            worker.process(5);
+        }
+    });
+
+    const int total = 50;
+    int submitted = 0;
+    int received = 0;
+    DecodeOutcome outcome;
+    while (received < total) {
+        if (submitted < total && worker.submit(capture(static_cast<PulseDuration>(1000 + submitted), 20), 0)) {
+            submitted++;
+        }
+        while (worker.poll(outcome)) {
+            EXPECT_EQ(outcome.result.code, static_cast<uint64_t>(1000 + received));
+            EXPECT_EQ(*worker.capture(outcome.job).begin(), static_cast<PulseDuration>(1000 + received));
+            worker.release(outcome.job);
+            received++;
+        }
+        std::this_thread::yield();
+    }
+    stop = true;
+    thread.join();
+    EXPECT_FALSE(worker.busy());
+}
+
+TEST(FrameTimeStatsTest, KeepsIdleAndAnalysingApart) {
+    FrameTimeStats stats;
+    for (uint32_t i = 0; i < 1000; i++) {
+        stats.add(1000 + i % 100, false);
+        stats.add(50000 + i % 1000, true);
+    }
+    EXPECT_EQ(stats.frames(), 2000u);
+    EXPECT_NEAR(stats.idle().p50.value(), 1050, 10);
+    EXPECT_NEAR(stats.idle().p99.value(), 1099, 10);
+    EXPECT_EQ(stats.idle().max, 1099u);
+    EXPECT_NEAR(stats.analysing().p95.value(), 50950, 50);
+    stats.addLatency(12000);
+    stats.addLatency(15000);
+    EXPECT_EQ(stats.latency().count(), 2u);
+    EXPECT_EQ(stats.latency().max, 15000u);
+    EXPECT_EQ(stats.frames(), 2000u);
+    char line[256];
+    EXPECT_GT(stats.format(line, sizeof(line)), 0);
+    EXPECT_NE(strstr(line, "capture latency"), nullptr);
+    stats.reset();
+    EXPECT_EQ(stats.frames(), 0u);
+    EXPECT_EQ(stats.latency().count(), 0u);
+}
+
+// A PWM capture of the size FrameAssembler hands over, several frames of
+// 66 bits with gaps, and the analysis a decode does on it.
+static std::vector<PulseDuration> pwmCapture() {
+    PulseTrain capture(0, 9);
+    while (capture.pulses.size() + 140 < DECODE_JOB_PULSES) {
+        for (int bit = 0; bit < 66; bit++) {
+            pwmBits(capture, capture.next() & 1, 1, 400, 2);
+        }
+        capture.low(12000);
+    }
+    return capture.pulses;
+}
+
+static bool analyseFrames(PulseView capture, DecodeOutcome& outcome) {
+    FrameSegmenter segmenter(FRAME_GAP_MULTIPLIER, 5, 16);
+    PulseHistogram histogram;
+    BinRawAnalyzer analyzer(histogram);
+    std::vector<PulseDuration> copy(capture.begin(), capture.end());
+    const size_t frames = segmenter.split(copy.data(), copy.size());
+    for (size_t i = 0; i < frames; i++) {
+        if (analyzer.analyze(segmenter.frame(i))) {
+            outcome.binRaw = analyzer.signal();
+        }
+    }
+    return outcome.binRaw.bits != 0;
+}
+
+// UI frame times with analysis done inline in the frame, as loop() used to,
+// against handing it to the worker. The worker's share runs between frames
+// here, where on the ESP32 it runs on the other core at the same time.
+TEST(DecodeWorkerPerformance, UiFrameTimes) {
+    const std::vector<PulseDuration> pulses = pwmCapture();
+    auto clockUs = [] {
+        return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    };
+    const int frames = 2000;
+    const int captureEvery = 10;
+
+    FrameTimeStats inlineStats;
+    for (int frame = 0; frame < frames; frame++) {
+        const bool analysing = frame % captureEvery == 0;
+        const uint32_t start = clockUs();
+        if (analysing) {
+            DecodeOutcome outcome;
+            analyseFrames(pulses, outcome);
+        }
+        inlineStats.add(clockUs() - start, analysing);
+    }
+
+    FrameTimeStats workerStats;
+    DecodeWorker worker(analyseFrames);
+    int shown = 0;
+    for (int frame = 0; frame < frames; frame++) {
+        const uint32_t start = clockUs();
+        if (frame % captureEvery == 0) {
+            worker.submit(pulses, start);
+        }
+        DecodeOutcome outcome;
+        while (worker.poll(outcome)) {
+            worker.release(outcome.job);
+            shown++;
+        }
+        workerStats.add(clockUs() - start, worker.busy());
+        worker.process(0);
+    }
+
+    EXPECT_EQ(shown, frames / captureEvery);
+    EXPECT_LT(workerStats.analysing().p95.value(), inlineStats.analysing().p50.value());
+    char line[256];
+    inlineStats.format(line, sizeof(line));
+    std::printf("[ DecodeWorker ] inline: %s\n", line);
+    workerStats.format(line, sizeof(line));
+    std::printf("[ DecodeWorker ] worker: %s\n", line);
+}
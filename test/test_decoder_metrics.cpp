@@ -0,0 +1,209 @@
+#include "../src/modules/RF/DecoderMetrics.h"
+#include "../src/modules/RF/DecodeResult.h"
+#include "../src/modules/RF/PulseReceiver.h"
+#include "../src/modules/RF/protocols/PwmDecoder.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Came's timing and hooks on the PWM base, which reports isSynced().
+class MetricsCame : public PwmDecoder<MetricsCame> {
+public:
+    static constexpr SubGhzBlockConst timing = {640, 320, 150, 12};
+
+    std::string getCodeString(uint64_t shortPulse, uint64_t longPulse) const {
+        return "Came";
+    }
+
+private:
+    friend class PwmDecoder<MetricsCame>;
+
+    static constexpr bool isHeader(uint32_t low) {
+        return within(low, timing.te_short * 56u, timing.te_delta * 52u);
+    }
+
+    static constexpr bool isGap(uint32_t low) {
+        return low > 5000;
+    }
+
+    static constexpr bool acceptBitCount(uint8_t bits) {
+        return bits == 12;
+    }
+};
+
+// Header and start bit, then the first `bits` of a 12-bit code, closed by a
+// gap if complete.
+static std::vector<PulseDuration> cameStart(uint32_t code, int bits) {
+    PulseTrain train;
+    cameFrame(train, code, 12, 320, 56);
+    train.pulses.resize(2 + 2 * bits);
+    if (bits == 12) {
+        train.low(12000);
+    }
+    return train.pulses;
+}
+
+static std::vector<PulseDuration> noise() {
+    std::vector<PulseDuration> frame;
+    for (int i = 0; i < 20; i++) {
+        frame.push_back(i % 2 ? -330 : 650);
+    }
+    return frame;
+}
+
+TEST(DecoderMetricsTest, RowsByName) {
+    DecoderMetrics metrics;
+    DecoderCounters* came = metrics.row("Came");
+    ASSERT_NE(came, nullptr);
+    came->decoded = 3;
+    // Names are compared, not pointers: a reloaded decoder finds its row.
+    const std::string again = "Came";
+    EXPECT_EQ(metrics.row(again.c_str()), came);
+    EXPECT_EQ(metrics.find("Kia"), nullptr);
+
+    char name[PROTOCOL_REGISTRY_SIZE][8];
+    for (int i = 1; i < PROTOCOL_REGISTRY_SIZE; i++) {
+        snprintf(name[i], sizeof(name[i]), "D%d", i);
+        EXPECT_NE(metrics.row(name[i]), nullptr);
+    }
+    EXPECT_EQ(metrics.size(), static_cast<size_t>(PROTOCOL_REGISTRY_SIZE));
+    EXPECT_EQ(metrics.row("One too many"), nullptr);
+    metrics.reject("One too many", DecodeReject::NoSync);
+
+    metrics.reject("Came", DecodeReject::Outvoted, 2);
+    EXPECT_EQ(metrics.find("Came")->rejects(DecodeReject::Outvoted), 2u);
+    metrics.reset();
+    EXPECT_EQ(metrics.size(), static_cast<size_t>(PROTOCOL_REGISTRY_SIZE));
+    EXPECT_EQ(metrics.find("Came"), came);
+    EXPECT_EQ(came->decoded, 0u);
+    EXPECT_EQ(came->rejects(DecodeReject::Outvoted), 0u);
+}
+
+TEST(DecoderMetricsTest, FormatsCsv) {
+    DecoderMetrics metrics;
+    DecoderCounters* kia = metrics.row("Kia");
+    kia->offered = 10;
+    kia->synced = 4;
+    kia->decoded = 2;
+    kia->rejected[static_cast<size_t>(DecodeReject::Timing)] = 6;
+    kia->pulses = 100;
+    kia->cycles = 2500;
+    metrics.row("Came");
+
+    char text[512];
+    const int length = metrics.format(text, sizeof(text));
+    EXPECT_EQ(std::string(text), "decoder,offered,synced,decoded,timing,nosync,incomplete,outvoted,pulses,"
+                                 "cycles_per_pulse\n"
+                                 "Kia,10,4,2,6,0,0,0,100,25\n"
+                                 "Came,0,0,0,0,0,0,0,0,0\n");
+    EXPECT_EQ(length, static_cast<int>(std::strlen(text)));
+
+    // Like snprintf, a short buffer gets the full length back.
+    char small[32];
+    EXPECT_EQ(metrics.format(small, sizeof(small)), length);
+    EXPECT_EQ(std::strlen(small), sizeof(small) - 1);
+}
+
+// Each frame is booked once per decoder it was fed to: decoded, got past
+// the header but not to a code, or never found the header.
+TEST(DecoderMetricsTest, ReceiverBooksEachFrame) {
+    MetricsCame came;
+    DecoderAdapter<MetricsCame> entry("Came", came);
+    SubGhzDecoder* decoders[] = {&entry};
+    PulseQuantizer quantizer;
+    quantizer.configure(320, 640);
+    DecoderMetrics metrics;
+    PulseReceiver receiver;
+    receiver.setMetrics(&metrics);
+
+    const std::vector<std::vector<PulseDuration>> frames = {cameStart(0x5A3, 12), cameStart(0x5A3, 5), noise(),
+                                                            cameStart(0x0F0, 12)};
+    size_t fed = 0;
+    for (const auto& frame : frames) {
+        receiver.begin(decoders, 1, quantizer, false);
+        receiver.run(frame);
+        fed += frame.size();
+    }
+    const DecoderCounters* row = metrics.find("Came");
+    ASSERT_NE(row, nullptr);
+    EXPECT_EQ(row->decoded, 2u);
+    EXPECT_EQ(row->synced, 3u);
+    EXPECT_EQ(row->rejects(DecodeReject::Incomplete), 1u);
+    EXPECT_EQ(row->rejects(DecodeReject::NoSync), 1u);
+    EXPECT_EQ(row->pulses, fed);
+    EXPECT_GT(row->cycles, 0u);
+
+    // Without metrics nothing is counted.
+    receiver.setMetrics(nullptr);
+    receiver.begin(decoders, 1, quantizer, false);
+    receiver.run(frames[0]);
+    EXPECT_EQ(row->decoded, 2u);
+    EXPECT_EQ(row->pulses, fed);
+}
+
+TEST(DecoderMetricsTest, VoteListsEveryCandidate) {
+    FrameDecode a;
+    a.protocol = "Came";
+    a.code = 0x5A3;
+    a.bits = 12;
+    FrameDecode b = a;
+    b.code = 0x5A2;
+    DecodeVote vote;
+    vote.reset(4);
+    vote.add(a, 0);
+    vote.add(b, 1);
+    vote.add(a, 2);
+    ASSERT_EQ(vote.candidateCount(), 2u);
+    EXPECT_TRUE(vote.candidate(0).sameCode(a));
+    EXPECT_EQ(vote.votes(0), 2u);
+    EXPECT_TRUE(vote.candidate(1).sameCode(b));
+    EXPECT_EQ(vote.votes(1), 1u);
+}
+
+// What counting costs the receiver: the same frames with and without
+// metrics, four decoders each. On the ESP32 the clock is one register read.
+TEST(DecoderMetricsPerformance, CountingOverhead) {
+    std::vector<MetricsCame> cames(4);
+    std::vector<DecoderAdapter<MetricsCame>> entries;
+    std::vector<SubGhzDecoder*> decoders;
+    entries.reserve(cames.size());
+    for (MetricsCame& came : cames) {
+        entries.emplace_back("Came", came);
+    }
+    for (auto& entry : entries) {
+        decoders.push_back(&entry);
+    }
+    std::vector<PulseDuration> capture = noise();
+    const std::vector<PulseDuration> frame = cameStart(0x5A3, 12);
+    capture.insert(capture.end(), frame.begin(), frame.end());
+    PulseQuantizer quantizer;
+    quantizer.configure(320, 640);
+
+    const int rounds = 20000;
+    DecoderMetrics metrics;
+    PulseReceiver receiver;
+    double us[2];
+    size_t hits[2] = {};
+    for (int counting = 0; counting < 2; counting++) {
+        receiver.setMetrics(counting ? &metrics : nullptr);
+        const auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            receiver.begin(decoders.data(), decoders.size(), quantizer, false);
+            hits[counting] += receiver.run(capture);
+        }
+        us[counting] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+                       rounds;
+    }
+
+    EXPECT_EQ(hits[0], hits[1]);
+    const DecoderCounters* row = metrics.find("Came");
+    ASSERT_NE(row, nullptr);
+    EXPECT_EQ(row->decoded, static_cast<uint32_t>(rounds * decoders.size()));
+    std::printf("[ DecoderMetrics ] %zu pulses x %zu decoders: %.2f us plain, %.2f us counting, %llu ns/pulse\n",
+                capture.size(), decoders.size(), us[0], us[1],
+                static_cast<unsigned long long>(row->cycles / row->pulses));
+}
@@ -0,0 +1,123 @@
+#include "../src/modules/RF/EdgeRing.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+TEST(EdgeRingTest, PreservesOrder) {
+    EdgeRing<8> ring;
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(ring.push(i, (i % 2) ? -100 * i : 100 * i));
+    }
+    EXPECT_EQ(ring.size(), 5u);
+
+    Edge edge;
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(ring.pop(edge));
+        EXPECT_EQ(edge.timestamp, static_cast<uint32_t>(i));
+        EXPECT_EQ(edge.duration, (i % 2) ? -100 * i : 100 * i);
+    }
+    EXPECT_FALSE(ring.pop(edge));
+}
+
+TEST(EdgeRingTest, CountsDropsWhenFull) {
+    EdgeRing<4> ring;
+    for (int i = 0; i < 6; i++) {
+        ring.push(i, 200);
+    }
+    EXPECT_EQ(ring.size(), 4u);
+    EXPECT_EQ(ring.dropped(), 2u);
+
+    ring.clear();
+    ring.resetDropped();
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.dropped(), 0u);
+}
+
+TEST(EdgeRingTest, WrapsAround) {
+    EdgeRing<4> ring;
+    Edge edges[4];
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 3; i++) {
+            ring.push(round * 3 + i, 300);
+        }
+        ASSERT_EQ(ring.popMany(edges, 4), 3u);
+        EXPECT_EQ(edges[0].timestamp, static_cast<uint32_t>(round * 3));
+        EXPECT_EQ(edges[2].timestamp, static_cast<uint32_t>(round * 3 + 2));
+    }
+    EXPECT_EQ(ring.dropped(), 0u);
+}
+
+// Drives the ring from a producer thread at a fixed edge rate while the
+// consumer drains it on a fixed poll period, like the ISR and the loop do.
+TEST(EdgeRingPerformance, SyntheticEdgeRates) {
+    const unsigned rates[] = {10000, 50000, 100000, 200000};
+    const std::chrono::milliseconds pollPeriods[] = {std::chrono::milliseconds(5), std::chrono::milliseconds(100)};
+    const auto runTime = std::chrono::milliseconds(200);
+
+    for (auto pollPeriod : pollPeriods)
+    for (unsigned rate : rates) {
+        static EdgeRing<2048> ring;
+        ring.clear();
+        ring.resetDropped();
+
+        std::atomic<bool> producing(true);
+        uint32_t produced = 0;
+        uint64_t consumed = 0;
+
+        std::thread consumer([&]() {
+            Edge edges[256];
+            for (;;) {
+                const bool more = producing.load();
+                size_t n;
+                while ((n = ring.popMany(edges, 256)) > 0) {
+                    consumed += n;
+                }
+                if (!more) {
+                    break;
+                }
+                std::this_thread::sleep_for(pollPeriod);
+            }
+        });
+
+        const auto period = std::chrono::nanoseconds(1000000000ull / rate);
+        const auto start = Clock::now();
+        auto next = start;
+        while (Clock::now() - start < runTime) {
+            while (Clock::now() < next) {
+            }
+            ring.push(produced, (produced & 1) ? -static_cast<int32_t>(1000000 / rate) : 1000000 / rate);
+            produced++;
+            next += period;
+        }
+        producing.store(false);
+        consumer.join();
+
+        std::printf("[ EdgeRing ] %6u edges/s: produced %u, consumed %llu, dropped %u (poll %lld ms)\n",
+                    rate, produced, static_cast<unsigned long long>(consumed), ring.dropped(),
+                    static_cast<long long>(pollPeriod.count()));
+        EXPECT_EQ(consumed + ring.dropped(), produced);
+    }
+}
+
+TEST(EdgeRingPerformance, PerEdgeCost) {
+    static EdgeRing<2048> ring;
+    const uint32_t edges = 4000000;
+    Edge edge = {0, 0};
+    int64_t checksum = 0;
+
+    const auto start = Clock::now();
+    for (uint32_t i = 0; i < edges; i++) {
+        ring.push(i, static_cast<int32_t>(i & 0x3FF));
+        ring.pop(edge);
+        checksum += edge.duration;
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+    std::printf("[ EdgeRing ] push+pop: %.2f ns/edge (checksum %lld)\n",
+                static_cast<double>(elapsed) / edges, static_cast<long long>(checksum));
+    EXPECT_EQ(ring.dropped(), 0u);
+}
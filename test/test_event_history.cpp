@@ -0,0 +1,254 @@
+#include "../src/modules/RF/EventHistory.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static DecodedEvent event(const char* protocol, uint64_t key) {
+    DecodedEvent event;
+    snprintf(event.protocol, sizeof(event.protocol), "%s", protocol);
+    event.key = key;
+    event.bits = 24;
+    event.frequency = 433920000;
+    event.preset = 1;
+    event.rssi = -62;
+    return event;
+}
+
+// A history file in the temp directory, removed afterwards.
+class HistoryFile {
+public:
+    explicit HistoryFile(const char* name) : path((std::filesystem::temp_directory_path() / name).string()) {
+        std::filesystem::remove(path);
+    }
+
+    ~HistoryFile() {
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+
+    // Overwrites one byte, as a write cut short would leave it.
+    void corrupt(size_t slot, size_t byte) const {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(slot * HISTORY_RECORD_SIZE + byte));
+        file.put('\x5A');
+    }
+
+    std::string path;
+};
+
+static std::vector<DecodedEvent> all(EventHistory& history, const HistoryQuery& query) {
+    std::vector<DecodedEvent> events;
+    history.query(query, [&](const DecodedEvent& event) { events.push_back(event); });
+    return events;
+}
+
+TEST(EventHistoryTest, RecordRoundTripsUnderCrc) {
+    DecodedEvent original = event("KeeLoq", 0x0123456789ABCDEFull);
+    original.seq = 7;
+    original.time = 1700000000;
+    original.bits = 66;
+    uint8_t data[HISTORY_RECORD_SIZE];
+    original.encode(data);
+
+    DecodedEvent copy;
+    ASSERT_TRUE(copy.decode(data));
+    EXPECT_EQ(copy.seq, 7u);
+    EXPECT_EQ(copy.time, 1700000000u);
+    EXPECT_EQ(copy.frequency, 433920000u);
+    EXPECT_EQ(copy.key, 0x0123456789ABCDEFull);
+    EXPECT_EQ(copy.bits, 66u);
+    EXPECT_EQ(copy.preset, 1u);
+    EXPECT_EQ(copy.rssi, -62);
+    EXPECT_STREQ(copy.protocol, "KeeLoq");
+
+    // An all-zero slot, as a file extended by a cut write leaves it.
+    uint8_t check[HISTORY_RECORD_SIZE] = {};
+    EXPECT_FALSE(copy.decode(check));
+    for (size_t i = 0; i < HISTORY_RECORD_SIZE; i++) {
+        uint8_t flipped[HISTORY_RECORD_SIZE];
+        memcpy(flipped, data, sizeof(flipped));
+        flipped[i] ^= 0x10;
+        EXPECT_FALSE(copy.decode(flipped)) << i;
+    }
+}
+
+TEST(EventHistoryTest, QueriesByTimeAndProtocol) {
+    HistoryFile file("history_query.bin");
+    EventHistory history(file.path.c_str(), 64);
+    ASSERT_TRUE(history.begin(1000));
+    const char* protocols[] = {"Came", "NiceFlo", "Came", "BinRAW/PWM"};
+    for (uint32_t i = 0; i < 40; i++) {
+        DecodedEvent added = event(protocols[i % 4], i);
+        ASSERT_TRUE(history.append(added, 1000 + i * 10));
+        EXPECT_EQ(added.seq, i);
+        EXPECT_EQ(added.time, 1000 + i * 10);
+    }
+    EXPECT_EQ(history.size(), 40u);
+
+    HistoryQuery query;
+    query.from = 1095;
+    query.to = 1195;
+    std::vector<DecodedEvent> events = all(history, query);
+    ASSERT_EQ(events.size(), 10u);
+    EXPECT_EQ(events.front().key, 10u);
+    EXPECT_EQ(events.back().key, 19u);
+
+    query.protocol = "Came";
+    events = all(history, query);
+    ASSERT_EQ(events.size(), 5u);
+    for (const DecodedEvent& found : events) {
+        EXPECT_STREQ(found.protocol, "Came");
+        EXPECT_EQ(found.key % 2, 0u);
+    }
+
+    query.limit = 2;
+    EXPECT_EQ(all(history, query).size(), 2u);
+    query = HistoryQuery();
+    query.from = 5000;
+    EXPECT_TRUE(all(history, query).empty());
+
+    std::vector<uint64_t> keys;
+    EXPECT_EQ(history.latest(3, [&](const DecodedEvent& found) { keys.push_back(found.key); }), 3u);
+    EXPECT_EQ(keys, (std::vector<uint64_t>{39, 38, 37}));
+}
+
+// Times never go back, also when the clock restarts after a reboot.
+TEST(EventHistoryTest, TimesContinueAcrossClockReset) {
+    HistoryFile file("history_clock.bin");
+    {
+        EventHistory history(file.path.c_str(), 16);
+        ASSERT_TRUE(history.begin(0));
+        DecodedEvent added = event("Came", 1);
+        ASSERT_TRUE(history.append(added, 5000));
+        ASSERT_TRUE(history.append(added, 4000));
+        EXPECT_EQ(added.time, 5000u);
+    }
+    EventHistory history(file.path.c_str(), 16);
+    ASSERT_TRUE(history.begin(3));
+    DecodedEvent added = event("Came", 2);
+    ASSERT_TRUE(history.append(added, 13));
+    EXPECT_EQ(added.seq, 2u);
+    EXPECT_EQ(added.time, 5010u);
+}
+
+TEST(EventHistoryTest, RingKeepsTheNewest) {
+    HistoryFile file("history_ring.bin");
+    EventHistory history(file.path.c_str(), 16);
+    ASSERT_TRUE(history.begin(0));
+    for (uint32_t i = 0; i < 40; i++) {
+        DecodedEvent added = event("Came", i);
+        ASSERT_TRUE(history.append(added, i));
+    }
+    EXPECT_EQ(history.size(), 16u);
+    EXPECT_EQ(std::filesystem::file_size(file.path), 16u * HISTORY_RECORD_SIZE);
+
+    const std::vector<DecodedEvent> events = all(history, HistoryQuery());
+    ASSERT_EQ(events.size(), 16u);
+    for (uint32_t i = 0; i < 16; i++) {
+        EXPECT_EQ(events[i].seq, 24 + i);
+        EXPECT_EQ(events[i].key, 24u + i);
+    }
+    HistoryQuery query;
+    query.from = 30;
+    query.to = 33;
+    EXPECT_EQ(all(history, query).size(), 4u);
+}
+
+// A write cut short fails its CRC: recovery continues after the newest whole
+// record, and queries step over the broken slot.
+TEST(EventHistoryTest, RecoversAfterPowerLoss) {
+    HistoryFile file("history_recover.bin");
+    {
+        EventHistory history(file.path.c_str(), 8);
+        ASSERT_TRUE(history.begin(0));
+        for (uint32_t i = 0; i < 12; i++) {
+            DecodedEvent added = event("Came", i);
+            ASSERT_TRUE(history.append(added, 100 + i));
+        }
+    }
+    // Seq 11 in slot 3 was being written; seq 9 in slot 1 was hit earlier.
+    file.corrupt(3, 30);
+    file.corrupt(1, 5);
+
+    EventHistory history(file.path.c_str(), 8);
+    ASSERT_TRUE(history.begin(0));
+    EXPECT_EQ(history.size(), 8u);
+    std::vector<DecodedEvent> events = all(history, HistoryQuery());
+    std::vector<uint32_t> seqs;
+    for (const DecodedEvent& found : events) {
+        seqs.push_back(found.seq);
+    }
+    // Neither broken slot reads back, and seq 3 was overwritten by seq 11.
+    EXPECT_EQ(seqs, (std::vector<uint32_t>{4, 5, 6, 7, 8, 10}));
+
+    DecodedEvent added = event("NiceFlo", 99);
+    ASSERT_TRUE(history.append(added, 0));
+    EXPECT_EQ(added.seq, 11u);
+    EXPECT_EQ(added.time, 110u);
+    HistoryQuery query;
+    query.from = 110;
+    events = all(history, query);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[1].key, 99u);
+
+    // A file cut mid-record loses only that record.
+    std::filesystem::resize_file(file.path, 8 * HISTORY_RECORD_SIZE - 10);
+    ASSERT_TRUE(history.begin(0));
+    added = event("Came", 100);
+    ASSERT_TRUE(history.append(added, 0));
+    EXPECT_EQ(added.seq, 12u);
+}
+
+TEST(EventHistoryTest, RefusesUnusablePath) {
+    HistoryFile file("history_missing_dir.bin");
+    const std::string path = file.path + ".d/missing/history.bin";
+    EventHistory history(path.c_str(), 8);
+    EXPECT_FALSE(history.begin(0));
+    DecodedEvent added = event("Came", 1);
+    EXPECT_FALSE(history.append(added, 0));
+    EXPECT_EQ(history.latest(1, [](const DecodedEvent&) {}), 0u);
+}
+
+// Appends into a full ring and a one-protocol query over a time window; the
+// query reads about log2(capacity) records to find the window, then the
+// window itself.
+TEST(EventHistoryPerformance, AppendAndQuery) {
+    HistoryFile file("history_performance.bin");
+    EventHistory history(file.path.c_str(), HISTORY_CAPACITY);
+    ASSERT_TRUE(history.begin(0));
+    const uint32_t appends = HISTORY_CAPACITY * 2;
+    const char* protocols[] = {"Came", "NiceFlo", "Kia", "BinRAW/PWM"};
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < appends; i++) {
+        DecodedEvent added = event(protocols[i % 4], i);
+        ASSERT_TRUE(history.append(added, i * 30));
+    }
+    const double appendUs =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / appends;
+
+    HistoryQuery query;
+    query.from = (appends - 1000) * 30;
+    query.to = query.from + 3600;
+    query.protocol = "Kia";
+    const uint32_t readsBefore = history.recordReads();
+    const auto queryStart = std::chrono::steady_clock::now();
+    const size_t found = history.query(query, [](const DecodedEvent&) {});
+    const double queryUs =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - queryStart).count();
+    EXPECT_EQ(found, 30u);
+    const uint32_t reads = history.recordReads() - readsBefore;
+    EXPECT_LT(reads, 200u);
+
+    const auto recoverStart = std::chrono::steady_clock::now();
+    ASSERT_TRUE(history.begin(0));
+    const double recoverMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recoverStart).count();
+    EXPECT_EQ(history.size(), static_cast<size_t>(HISTORY_CAPACITY));
+    std::printf("[ EventHistory ] %u slots: %.1f us/append, query %.0f us over %u records, recovery %.2f ms\n",
+                HISTORY_CAPACITY, appendUs, queryUs, reads, recoverMs);
+}
@@ -0,0 +1,286 @@
+#include "../src/modules/RF/FingerprintIndex.h"
+#include "../src/modules/RF/FrameSegmenter.h"
+#include "../src/modules/RF/KeeLoqEntry.h"
+#include "../src/modules/RF/PulseSource.h"
+#include "../src/modules/RF/SignalFingerprint.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+static DecodeResult decoded(const char* protocol, uint64_t code, uint8_t bits, uint32_t te) {
+    DecodeResult result;
+    result.protocol = protocol;
+    result.code = code;
+    result.identity = code;
+    result.bits = bits;
+    result.te = te;
+    result.agreeing = 3;
+    return result;
+}
+
+static FrameTiming timing(uint32_t shortPulse, uint32_t longPulse) {
+    FrameTiming timing;
+    timing.shortPulse = shortPulse;
+    timing.longPulse = longPulse;
+    return timing;
+}
+
+// Distinct remotes for the index tests: code i, te spread over 200..700 us.
+static SignalFingerprint remote(uint32_t i) {
+    const uint32_t te = 200 + i % 500;
+    return fingerprint(decoded("Came", i, 24, te), timing(te, 2 * te));
+}
+
+// A scratch directory, removed with everything in it.
+class FingerprintDir {
+public:
+    explicit FingerprintDir(const char* name) : path(std::filesystem::temp_directory_path() / name) {
+        std::filesystem::remove_all(path);
+    }
+
+    ~FingerprintDir() {
+        std::error_code error;
+        std::filesystem::remove_all(path, error);
+    }
+
+    std::string file(const char* name) const {
+        return (path / name).string();
+    }
+
+    std::filesystem::path path;
+};
+
+TEST(SignalFingerprintTest, SameRemoteMatchesWithinTolerance) {
+    const SignalFingerprint first = fingerprint(decoded("Came", 0x5A3, 12, 320), timing(320, 640));
+    ASSERT_TRUE(first.valid());
+    EXPECT_EQ(first.kind, FingerprintKind::Decoded);
+    EXPECT_EQ(first.te, 80u);
+    EXPECT_EQ(first.ratio, 20u);
+    EXPECT_EQ(first.bits, 12u);
+
+    // Captured again, a little slower.
+    EXPECT_TRUE(first.matches(fingerprint(decoded("Came", 0x5A3, 12, 350), timing(350, 690))));
+    // Another button, another protocol with the same code, another clock.
+    EXPECT_FALSE(first.matches(fingerprint(decoded("Came", 0x5A2, 12, 320), timing(320, 640))));
+    EXPECT_FALSE(first.matches(fingerprint(decoded("NiceFlo", 0x5A3, 12, 320), timing(320, 640))));
+    EXPECT_FALSE(first.matches(fingerprint(decoded("Came", 0x5A3, 12, 400), timing(400, 800))));
+    EXPECT_FALSE(first.matches(fingerprint(decoded("Came", 0x5A3, 12, 320), timing(320, 960))));
+    // A single pulse width leaves the ratio open.
+    EXPECT_TRUE(first.matches(fingerprint(decoded("Came", 0x5A3, 12, 320), timing(320, 0))));
+
+    EXPECT_FALSE(fingerprint(DecodeResult(), timing(320, 640)).valid());
+}
+
+// Each press of a KeeLoq remote sends a new hop word; serial and button stay.
+TEST(SignalFingerprintTest, KeeLoqMatchesAcrossHopWords) {
+    KeeLoqProtocolDecoder keeloq;
+    KeeLoqEntry entry(keeloq);
+    ProtocolRegistry protocols;
+    protocols.add(entry);
+    protocols.build();
+    PulseHistogram histogram;
+    CaptureDecoder decoder(protocols, histogram);
+    FrameSegmenter segmenter(FRAME_GAP_MULTIPLIER, 5, 16);
+
+    auto press = [&](uint32_t fix, uint32_t hop) {
+        SyntheticPulseSource source;
+        const std::vector<PulseDuration> frame =
+            keeloqFrame(KeeLoqData::reverseBits(static_cast<uint64_t>(fix) << 32 | hop), 400);
+        source.addFrame(PulseView(frame), 3, 16000);
+        const DecodeResult result = decoder.decode(source.data(), source.size(), segmenter);
+        EXPECT_STREQ(result.protocol, "KeeLoq");
+        EXPECT_EQ(result.identity, fix);
+        return fingerprint(result, decoder.timing());
+    };
+
+    const SignalFingerprint first = press(0x20ABCDEF, 0x12345678);
+    ASSERT_TRUE(first.valid());
+    EXPECT_TRUE(first.matches(press(0x20ABCDEF, 0x9E3779B9)));
+    // Another button on the same remote.
+    EXPECT_FALSE(first.matches(press(0x40ABCDEF, 0x12345678)));
+}
+
+TEST(SignalFingerprintTest, BinRawHashesLineCodeAndData) {
+    BinRawSignal signal;
+    signal.te = 500;
+    signal.code = LineCode::Pwm;
+    signal.bits = 12;
+    signal.data[0] = 0x0F;
+    signal.data[1] = 0x00;
+    const SignalFingerprint print = fingerprint(signal, timing(500, 1000));
+    ASSERT_TRUE(print.valid());
+    EXPECT_EQ(print.kind, FingerprintKind::BinRaw);
+
+    BinRawSignal other = signal;
+    other.data[0] = 0x0E;
+    EXPECT_FALSE(print.matches(fingerprint(other, timing(500, 1000))));
+    other = signal;
+    other.code = LineCode::Manchester;
+    EXPECT_FALSE(print.matches(fingerprint(other, timing(500, 1000))));
+    EXPECT_TRUE(print.matches(fingerprint(signal, timing(520, 1040))));
+
+    EXPECT_FALSE(fingerprint(BinRawSignal(), timing(500, 1000)).valid());
+}
+
+TEST(SignalFingerprintTest, RecordRoundTrips) {
+    FingerprintRecord record;
+    record.print = fingerprint(decoded("Kia", 0x0123456789ABCDEFull, 61, 250), timing(250, 500));
+    snprintf(record.label, sizeof(record.label), "43392_DEADBEEF");
+    uint8_t data[FINGERPRINT_RECORD_SIZE];
+    record.encode(data);
+
+    FingerprintRecord copy;
+    copy.decode(data);
+    EXPECT_EQ(copy.print.hash, record.print.hash);
+    EXPECT_EQ(copy.print.te, record.print.te);
+    EXPECT_EQ(copy.print.bits, record.print.bits);
+    EXPECT_EQ(copy.print.ratio, record.print.ratio);
+    EXPECT_EQ(copy.print.kind, record.print.kind);
+    EXPECT_STREQ(copy.label, "43392_DEADBEEF");
+
+    // Whatever is on the card, the label comes back terminated.
+    memset(data + 10, 'x', FINGERPRINT_RECORD_SIZE - 10);
+    copy.decode(data);
+    EXPECT_EQ(strlen(copy.label), static_cast<size_t>(FINGERPRINT_LABEL_SIZE - 1));
+}
+
+// Enough remotes to merge the pending file several times; every one is found
+// again, also after a restart, and none that was not stored.
+TEST(FingerprintIndexTest, FindsEveryStoredRemote) {
+    FingerprintDir dir("fingerprint_index");
+    const uint32_t count = FINGERPRINT_PENDING_MAX * 5 + 7;
+    {
+        FingerprintIndex index(dir.path.string().c_str());
+        ASSERT_TRUE(index.begin());
+        EXPECT_EQ(index.size(), 0u);
+        for (uint32_t i = 0; i < count; i++) {
+            char label[FINGERPRINT_LABEL_SIZE];
+            snprintf(label, sizeof(label), "remote_%u", i);
+            ASSERT_TRUE(index.add(remote(i), label));
+        }
+        EXPECT_EQ(index.size(), count);
+        FingerprintRecord found;
+        ASSERT_TRUE(index.find(remote(count - 1), found));
+        EXPECT_EQ(std::string(found.label), "remote_" + std::to_string(count - 1));
+    }
+    EXPECT_EQ(std::filesystem::file_size(dir.file(FINGERPRINT_INDEX_FILE)),
+              static_cast<uintmax_t>(FINGERPRINT_PENDING_MAX * 5 * FINGERPRINT_RECORD_SIZE));
+    EXPECT_EQ(std::filesystem::file_size(dir.file(FINGERPRINT_PENDING_FILE)),
+              static_cast<uintmax_t>(7 * FINGERPRINT_RECORD_SIZE));
+
+    FingerprintIndex index(dir.path.string().c_str());
+    ASSERT_TRUE(index.begin());
+    EXPECT_EQ(index.size(), count);
+    for (uint32_t i = 0; i < count; i++) {
+        FingerprintRecord found;
+        ASSERT_TRUE(index.find(remote(i), found)) << i;
+        EXPECT_EQ(std::string(found.label), "remote_" + std::to_string(i));
+    }
+    for (uint32_t i = count; i < count + 100; i++) {
+        FingerprintRecord found;
+        EXPECT_FALSE(index.find(remote(i), found)) << i;
+    }
+    // One block a lookup, two when a hash is just past a fence.
+    EXPECT_LE(index.blockReads(), (count + 100) * 2);
+
+    ASSERT_TRUE(index.merge());
+    EXPECT_EQ(std::filesystem::file_size(dir.file(FINGERPRINT_PENDING_FILE)), 0u);
+    FingerprintRecord found;
+    EXPECT_TRUE(index.find(remote(count - 3), found));
+}
+
+TEST(FingerprintIndexTest, FinishesInterruptedMerge) {
+    FingerprintDir dir("fingerprint_merge");
+    {
+        FingerprintIndex index(dir.path.string().c_str());
+        ASSERT_TRUE(index.begin());
+        for (uint32_t i = 0; i < 10; i++) {
+            ASSERT_TRUE(index.add(remote(i), "before"));
+        }
+        ASSERT_TRUE(index.merge());
+    }
+    // Cut after the old index was dropped, before the new one was renamed.
+    std::filesystem::rename(dir.file(FINGERPRINT_INDEX_FILE), dir.file(FINGERPRINT_MERGE_FILE));
+    {
+        FingerprintIndex index(dir.path.string().c_str());
+        ASSERT_TRUE(index.begin());
+        EXPECT_EQ(index.size(), 10u);
+        FingerprintRecord found;
+        EXPECT_TRUE(index.find(remote(4), found));
+    }
+    // Cut while the new index was written: the old one stands.
+    std::ofstream(dir.file(FINGERPRINT_MERGE_FILE)) << "partial";
+    FingerprintIndex index(dir.path.string().c_str());
+    ASSERT_TRUE(index.begin());
+    EXPECT_EQ(index.size(), 10u);
+    EXPECT_FALSE(std::filesystem::exists(dir.file(FINGERPRINT_MERGE_FILE)));
+}
+
+// A merge that fails leaves the pending records full: add() retries it and
+// refuses new records, without writing past the full ones, until it works.
+TEST(FingerprintIndexTest, RetriesFailedMerge) {
+    FingerprintDir dir("fingerprint_merge_failed");
+    FingerprintIndex index(dir.path.string().c_str());
+    ASSERT_TRUE(index.begin());
+    // A directory in place of the merge file makes every merge fail.
+    std::filesystem::create_directories(dir.file(FINGERPRINT_MERGE_FILE));
+    for (uint32_t i = 0; i < FINGERPRINT_PENDING_MAX; i++) {
+        ASSERT_TRUE(index.add(remote(i), "pending"));
+    }
+    EXPECT_FALSE(index.add(remote(1000), "refused"));
+    EXPECT_FALSE(index.add(remote(1001), "refused"));
+    EXPECT_EQ(index.size(), static_cast<size_t>(FINGERPRINT_PENDING_MAX));
+    FingerprintRecord found;
+    EXPECT_TRUE(index.find(remote(5), found));
+    EXPECT_FALSE(index.find(remote(1000), found));
+
+    std::filesystem::remove(dir.file(FINGERPRINT_MERGE_FILE));
+    EXPECT_TRUE(index.add(remote(1002), "merged"));
+    EXPECT_EQ(index.size(), FINGERPRINT_PENDING_MAX + 1u);
+    EXPECT_TRUE(index.find(remote(5), found));
+    ASSERT_TRUE(index.find(remote(1002), found));
+    EXPECT_STREQ(found.label, "merged");
+}
+
+TEST(FingerprintIndexTest, RefusesWithoutDirectory) {
+    FingerprintDir dir("fingerprint_blocked");
+    std::ofstream(dir.path.string()) << "a file where the directory should be";
+    FingerprintIndex index(dir.path.string().c_str());
+    EXPECT_FALSE(index.begin());
+    EXPECT_FALSE(index.add(remote(1), "x"));
+    FingerprintRecord found;
+    EXPECT_FALSE(index.find(remote(1), found));
+}
+
+// Lookups among thousands of stored remotes, half of them hits; on the card
+// each is one block read of FINGERPRINT_BLOCK_RECORDS records.
+TEST(FingerprintIndexPerformance, LookupAmongThousands) {
+    FingerprintDir dir("fingerprint_performance");
+    FingerprintIndex index(dir.path.string().c_str());
+    ASSERT_TRUE(index.begin());
+    const uint32_t count = 5000;
+    const auto addStart = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < count; i++) {
+        ASSERT_TRUE(index.add(remote(i), "remote"));
+    }
+    const double addUs =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - addStart).count() / count;
+
+    const uint32_t lookups = 2000;
+    uint32_t hits = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < lookups; i++) {
+        FingerprintRecord found;
+        hits += index.find(remote(i * 5), found);
+    }
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+                      lookups;
+    EXPECT_EQ(hits, count / 5);
+    std::printf("[ FingerprintIndex ] %u records: %.1f us/add, %.1f us/find, %.2f blocks/find\n", count, addUs, us,
+                static_cast<double>(index.blockReads()) / lookups);
+}
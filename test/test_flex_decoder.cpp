@@ -0,0 +1,216 @@
+#include "../src/modules/RF/FlexDecoder.h"
+#include "../src/modules/RF/PackedPulses.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+static FlexDecoder compiled(const char* line) {
+    FlexSpec spec;
+    EXPECT_TRUE(parseFlexSpec(line, spec)) << line;
+    FlexDecoder decoder;
+    EXPECT_TRUE(decoder.compile(spec)) << line;
+    return decoder;
+}
+
+// Feeds pulses from a reset; returns the code or ~0 if none was found.
+static uint64_t decode(FlexDecoder& decoder, const std::vector<PulseDuration>& pulses) {
+    decoder.reset();
+    for (PulseDuration pulse : pulses) {
+        if (decoder.feed(pulse > 0, static_cast<uint32_t>(pulse > 0 ? pulse : -pulse))) {
+            return decoder.code();
+        }
+    }
+    return ~0ull;
+}
+
+TEST(FlexDecoderTest, ParsesSpecAndFillsDefaults) {
+    FlexSpec spec;
+    ASSERT_TRUE(parseFlexSpec(" name=Door, mod=manchester ,short=500,gap=3000,bits=16 ,check=even", spec));
+    EXPECT_STREQ(spec.name, "Door");
+    EXPECT_EQ(spec.modulation, FlexModulation::Manchester);
+    EXPECT_EQ(spec.longWidth, 1000u);
+    EXPECT_EQ(spec.pulseWidth, 500u);
+    EXPECT_EQ(spec.tolerance, 250u);
+    EXPECT_EQ(spec.check, FlexCheck::EvenParity);
+    EXPECT_FALSE(spec.invert);
+}
+
+TEST(FlexDecoderTest, RejectsMalformedSpecs) {
+    FlexSpec spec;
+    EXPECT_FALSE(parseFlexSpec("name=A,mod=pwm,short=400,long=800,gap=4000,bits=12,color=red", spec));
+    EXPECT_FALSE(parseFlexSpec("name=A,mod=fsk,short=400,long=800,gap=4000,bits=12", spec));
+    EXPECT_FALSE(parseFlexSpec("name=A,mod=pwm,short=400,long=800,bits=12", spec));
+    EXPECT_FALSE(parseFlexSpec("name=A,mod=pwm,short=4x0,long=800,gap=4000,bits=12", spec));
+    EXPECT_FALSE(parseFlexSpec("name=A,mod=pwm,short=400,long=800,gap=4000,bits=65", spec));
+    EXPECT_FALSE(parseFlexSpec("name=ThisNameIsFarTooLong,mod=pwm,short=400,long=800,gap=4000,bits=12", spec));
+    EXPECT_FALSE(parseFlexSpec("", spec));
+}
+
+TEST(FlexDecoderTest, CompileRejectsAmbiguousWidths) {
+    FlexSpec spec;
+    FlexDecoder decoder;
+    // A sync 50 us off short cannot be told from it at 200 us tolerance.
+    ASSERT_TRUE(parseFlexSpec("name=A,mod=pwm,short=400,long=800,sync=450,gap=4000,bits=12,tolerance=200", spec));
+    EXPECT_FALSE(decoder.compile(spec));
+    // Long reaching into the gap.
+    ASSERT_TRUE(parseFlexSpec("name=A,mod=pwm,short=400,long=800,gap=900,bits=12", spec));
+    EXPECT_FALSE(decoder.compile(spec));
+    // Byte checks need whole bytes.
+    ASSERT_TRUE(parseFlexSpec("name=A,mod=pwm,short=400,long=800,gap=4000,bits=12,check=xor8", spec));
+    EXPECT_FALSE(decoder.compile(spec));
+    // A sync equal to short shares its class.
+    ASSERT_TRUE(parseFlexSpec("name=A,mod=pwm,short=400,long=800,sync=400,gap=4000,bits=12", spec));
+    EXPECT_TRUE(decoder.compile(spec));
+    EXPECT_EQ(decoder.timing().te_short, 400u);
+    EXPECT_EQ(decoder.timing().te_long, 800u);
+}
+
+// What CameProtocol decodes, from a spec: random 24-bit codes at 15% jitter,
+// some frames cut short, each full frame found and no short one.
+TEST(FlexDecoderTest, PwmSpecDecodesCameFrames) {
+    FlexDecoder came = compiled("name=Came,mod=pwm,short=320,long=640,sync=320,gap=5000,tolerance=150,bits=24");
+    PulseTrain frames(15, 1);
+    int found = 0;
+    int expected = 0;
+    for (int f = 0; f < 200; f++) {
+        const uint64_t code = frames.next() << 8 | (frames.next() & 0xFF);
+        const bool cut = frames.next() % 4 == 0;
+        frames.pulses.clear();
+        cameFrame(frames, code, cut ? 12 : 24, 320);
+        frames.low(320 * 36);
+        const uint64_t decoded = decode(came, frames.pulses);
+        expected += !cut;
+        found += decoded == (cut ? ~0ull : code & 0xFFFFFF);
+        EXPECT_EQ(decoded, cut ? ~0ull : code & 0xFFFFFF) << f;
+    }
+    EXPECT_EQ(found, 200);
+    EXPECT_GT(expected, 100);
+    EXPECT_STREQ(came.name(), "Came");
+    EXPECT_EQ(came.bits(), 24u);
+}
+
+TEST(FlexDecoderTest, PwmWithoutSyncTakesFirstPulseAsBit) {
+    FlexDecoder decoder = compiled("name=Pt,mod=pwm,short=300,long=900,gap=6000,bits=8,invert=1");
+    PulseTrain frames(0, 2);
+    frames.low(9000);
+    for (int i = 7; i >= 0; i--) {
+        const bool one = (0xB4 >> i) & 1;
+        frames.high(one ? 900 : 300);
+        frames.low(i == 0 ? 9000 : one ? 300 : 900);
+    }
+    // Long high is 0 before inversion.
+    EXPECT_EQ(decode(decoder, frames.pulses), 0xB4u);
+}
+
+TEST(FlexDecoderTest, PpmWithSum8) {
+    FlexDecoder decoder = compiled("name=Nexus,mod=ppm,pulse=500,short=1000,long=2000,gap=4000,bits=24,check=sum8");
+    const uint32_t payload = 0x3A7C;
+    const uint32_t code = payload << 8 | ((0x3A + 0x7C) & 0xFF);
+    auto frame = [](uint32_t bits) {
+        PulseTrain frames(8, 3);
+        frames.low(8000);
+        for (int i = 23; i >= 0; i--) {
+            frames.high(500);
+            frames.low((bits >> i) & 1 ? 2000 : 1000);
+        }
+        frames.high(500);
+        frames.low(8000);
+        return frames.pulses;
+    };
+    EXPECT_EQ(decode(decoder, frame(code)), code);
+    // One flipped bit fails the sum.
+    EXPECT_EQ(decode(decoder, frame(code ^ 0x100)), ~0ull);
+}
+
+// Manchester from a sync and without one, where the gap swallows the low
+// half of a leading 0 and of a trailing 1.
+TEST(FlexDecoderTest, ManchesterHalvesMergeIntoGaps) {
+    const uint32_t code = 0x6B2D;
+    auto frame = [code](bool sync) {
+        std::vector<bool> halves;
+        for (int i = 15; i >= 0; i--) {
+            const bool one = (code >> i) & 1;
+            halves.push_back(one);
+            halves.push_back(!one);
+        }
+        PulseTrain frames(10, 4);
+        frames.low(5000);
+        if (sync) {
+            frames.high(1500);
+        }
+        size_t i = 0;
+        while (i < halves.size()) {
+            size_t width = 1;
+            while (i + width < halves.size() && halves[i + width] == halves[i]) {
+                width++;
+            }
+            halves[i] ? frames.high(static_cast<int>(width) * 250) : frames.low(static_cast<int>(width) * 250);
+            i += width;
+        }
+        frames.low(5000);
+        return frames.pulses;
+    };
+    FlexDecoder plain = compiled("name=Mc,mod=manchester,short=250,gap=2000,bits=16,check=odd");
+    EXPECT_EQ(decode(plain, frame(false)), code);
+    FlexDecoder synced = compiled("name=McSync,mod=manchester,short=250,sync=1500,gap=2000,bits=16");
+    EXPECT_EQ(decode(synced, frame(true)), code);
+    // No sync, no frame.
+    EXPECT_EQ(decode(synced, frame(false)), ~0ull);
+    // 0x6B2D has odd parity.
+    FlexDecoder even = compiled("name=McEven,mod=manchester,short=250,gap=2000,bits=16,check=even");
+    EXPECT_EQ(decode(even, frame(false)), ~0ull);
+}
+
+TEST(FlexDecoderTest, IndexedByRegistry) {
+    FlexDecoder ppm = compiled("name=Nexus,mod=ppm,pulse=500,short=1000,long=2000,gap=4000,bits=24");
+    FlexDecoder came = compiled("name=Came,mod=pwm,short=320,long=640,sync=320,gap=5000,tolerance=150,bits=24");
+    ProtocolRegistry registry;
+    registry.add(ppm);
+    registry.add(came);
+    registry.build();
+    SubGhzDecoder* out[PROTOCOL_REGISTRY_SIZE];
+    ASSERT_EQ(registry.candidates(510, 990, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_STREQ(out[0]->name(), "Nexus");
+    ASSERT_EQ(registry.candidates(330, 650, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_STREQ(out[0]->name(), "Came");
+    EXPECT_TRUE(ppm.rawInput());
+}
+
+// Per-pulse feed() cost is one table step whatever the spec; compare the
+// two-state PWM table with the five-state Manchester one on the same kind of
+// traffic through the registry interface.
+TEST(FlexDecoderPerformance, FeedCostPerSpec) {
+    FlexDecoder pwm = compiled("name=Came,mod=pwm,short=320,long=640,sync=320,gap=5000,tolerance=150,bits=24");
+    FlexDecoder manchester = compiled("name=Mc,mod=manchester,short=320,gap=5000,bits=24");
+    PulseTrain frames(10, 5);
+    for (int f = 0; f < 50; f++) {
+        cameFrame(frames, frames.next(), 24, 320);
+    }
+    frames.low(320 * 36);
+    auto feedNs = [&frames](SubGhzDecoder& decoder, uint64_t& sink) {
+        const int rounds = 40;
+        const auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; r++) {
+            decoder.reset();
+            for (PulseDuration pulse : frames.pulses) {
+                decoder.feed(pulse > 0, static_cast<uint32_t>(pulse > 0 ? pulse : -pulse));
+            }
+            sink += decoder.code();
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+               (static_cast<double>(rounds) * frames.pulses.size());
+    };
+    uint64_t sink = 0;
+    double pwmNs = 1e9;
+    double manchesterNs = 1e9;
+    for (int run = 0; run < 7; run++) {
+        pwmNs = std::min(pwmNs, feedNs(pwm, sink));
+        manchesterNs = std::min(manchesterNs, feedNs(manchester, sink));
+    }
+    std::printf("[ FlexDecoder ] %zu pulses: %.2f ns/pulse PWM spec, %.2f ns/pulse Manchester spec\n",
+                frames.pulses.size(), pwmNs, manchesterNs);
+    EXPECT_GT(sink, 0u);
+}
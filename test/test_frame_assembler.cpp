@@ -0,0 +1,281 @@
+#include "../src/modules/RF/FrameAssembler.h"
+#include "../src/modules/RF/FrameTimeStats.h"
+#include "../src/modules/RF/PulseSource.h"
+#include "../src/modules/RF/protocols/LinearProtocol.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+
+// Same limits the receiver uses (CC1101.h).
+static FrameAssembler makeAssembler() {
+    return FrameAssembler(16, 1024, 5, FRAME_GAP_MULTIPLIER, 50000);
+}
+
+static std::vector<PulseDuration> toVector(PulseView view) {
+    return std::vector<PulseDuration>(view.begin(), view.end());
+}
+
+struct Timeline {
+    std::vector<Edge> edges;
+    uint32_t clock = 0;
+
+    void pulse(PulseDuration duration) {
+        clock += static_cast<uint32_t>(duration < 0 ? -duration : duration);
+        edges.push_back({clock, duration});
+    }
+
+    void frame(const std::vector<PulseDuration>& pulses) {
+        for (PulseDuration duration : pulses) {
+            pulse(duration);
+        }
+    }
+};
+
+TEST(FrameAssemblerTest, EstimatesTeFromShortHighPulses) {
+    TeEstimator estimator;
+    EXPECT_EQ(estimator.te(5), 0u);
+    const uint32_t highs[] = {310, 900, 295, 305, 910, 300, 890, 302};
+    for (uint32_t high : highs) {
+        estimator.add(high);
+    }
+    EXPECT_GE(estimator.te(5), 295u);
+    EXPECT_LE(estimator.te(5), 310u);
+}
+
+TEST(FrameAssemblerTest, GapClosesFrameAndStartsNext) {
+    FrameAssembler assembler = makeAssembler();
+    Timeline timeline;
+    for (int i = 0; i < 20; i++) {
+        timeline.pulse(400);
+        timeline.pulse(-800);
+    }
+    timeline.pulse(-12000);
+    timeline.pulse(400);
+
+    size_t closedAt = 0;
+    for (size_t i = 0; i < timeline.edges.size(); i++) {
+        if (assembler.addEdge(timeline.edges[i])) {
+            closedAt = i;
+            break;
+        }
+    }
+    EXPECT_EQ(closedAt, 40u);
+    ASSERT_TRUE(assembler.complete());
+    const auto frame = toVector(assembler.frame());
+    EXPECT_EQ(frame.size(), 41u);
+    EXPECT_EQ(frame[40], -12000);
+    EXPECT_EQ(assembler.dataEndTime(), timeline.edges[39].timestamp);
+
+    // The gap carries over as the header of the next frame.
+    assembler.next();
+    EXPECT_FALSE(assembler.complete());
+    EXPECT_FALSE(assembler.addEdge(timeline.edges[41]));
+    EXPECT_EQ(assembler.frame().size(), 2u);
+    EXPECT_EQ(toVector(assembler.frame())[0], -12000);
+}
+
+TEST(FrameAssemblerTest, IdleLineClosesFrame) {
+    FrameAssembler assembler = makeAssembler();
+    Timeline timeline;
+    for (int i = 0; i < 15; i++) {
+        timeline.pulse(-800);
+        timeline.pulse(400);
+    }
+    for (const Edge& edge : timeline.edges) {
+        assembler.addEdge(edge);
+    }
+    EXPECT_FALSE(assembler.checkIdle(timeline.clock + 20000));
+    EXPECT_TRUE(assembler.checkIdle(timeline.clock + 60000));
+    const auto frame = toVector(assembler.frame());
+    ASSERT_EQ(frame.size(), 31u);
+    EXPECT_EQ(frame[30], -60000);
+}
+
+TEST(FrameAssemblerTest, ShortBurstsRestartTheFrame) {
+    FrameAssembler assembler = makeAssembler();
+    Timeline timeline;
+    for (int i = 0; i < 6; i++) {
+        timeline.pulse(300);
+        timeline.pulse(-300);
+    }
+    timeline.pulse(-9000);
+    for (const Edge& edge : timeline.edges) {
+        EXPECT_FALSE(assembler.addEdge(edge));
+    }
+    ASSERT_EQ(assembler.frame().size(), 1u);
+    EXPECT_EQ(toVector(assembler.frame())[0], -9000);
+}
+
+// Repeats are joined into one capture: the gap that closes a frame is kept
+// once, and the capture is complete once it holds maxFrames frames.
+TEST(FrameAssemblerTest, CollectorJoinsRepeatsUpToMaxFrames) {
+    FrameAssembler assembler = makeAssembler();
+    CaptureCollector collector(3, 1024, 50000, 1000000);
+    Timeline timeline;
+    for (int r = 0; r < 4; r++) {
+        for (int i = 0; i < 10; i++) {
+            timeline.pulse(400);
+            timeline.pulse(-800);
+        }
+        timeline.pulse(400);
+        timeline.pulse(-12000);
+    }
+
+    size_t closed = 0;
+    for (const Edge& edge : timeline.edges) {
+        if (assembler.addEdge(edge)) {
+            closed++;
+            EXPECT_EQ(assembler.continues(), closed > 1);
+            const bool complete = collector.addFrame(assembler);
+            assembler.next();
+            if (complete) {
+                break;
+            }
+        }
+    }
+    ASSERT_TRUE(collector.complete());
+    EXPECT_EQ(collector.frames(), 3u);
+    const auto capture = toVector(collector.capture());
+    ASSERT_EQ(capture.size(), 3 * 22u);
+    EXPECT_EQ(capture[21], -12000);
+    EXPECT_EQ(capture[22], 400);
+    EXPECT_EQ(capture.back(), -12000);
+
+    collector.next();
+    EXPECT_FALSE(collector.complete());
+    EXPECT_FALSE(collector.checkIdle(timeline.clock, timeline.clock + 60000));
+}
+
+// A single frame is submitted once the line stays quiet after it.
+TEST(FrameAssemblerTest, CollectorClosesOnSilence) {
+    FrameAssembler assembler = makeAssembler();
+    CaptureCollector collector(8, 1024, 50000, 1000000);
+    Timeline timeline;
+    for (int i = 0; i < 20; i++) {
+        timeline.pulse(400);
+        timeline.pulse(-800);
+    }
+    timeline.pulse(-12000);
+    bool closed = false;
+    for (const Edge& edge : timeline.edges) {
+        closed = closed || assembler.addEdge(edge);
+    }
+    ASSERT_TRUE(closed);
+    EXPECT_FALSE(collector.addFrame(assembler));
+    assembler.next();
+    EXPECT_FALSE(collector.checkIdle(timeline.clock, timeline.clock + 20000));
+    EXPECT_TRUE(collector.checkIdle(timeline.clock, timeline.clock + 60000));
+    EXPECT_EQ(collector.frames(), 1u);
+    EXPECT_EQ(collector.capture().size(), 41u);
+}
+
+// A remote held down keeps the line busy; the capture is still complete
+// maxWaitUs after its first frame closed, with the repeats in by then.
+TEST(FrameAssemblerTest, CollectorStopsWaitingAfterMaxWait) {
+    FrameAssembler assembler = makeAssembler();
+    CaptureCollector collector(8, 1024, 50000, 30000);
+    Timeline timeline;
+    for (int r = 0; r < 3; r++) {
+        for (int i = 0; i < 10; i++) {
+            timeline.pulse(400);
+            timeline.pulse(-800);
+        }
+        timeline.pulse(400);
+        timeline.pulse(-12000);
+    }
+    uint32_t firstEnd = 0;
+    for (const Edge& edge : timeline.edges) {
+        if (assembler.addEdge(edge)) {
+            if (firstEnd == 0) {
+                firstEnd = assembler.dataEndTime();
+            }
+            EXPECT_FALSE(collector.addFrame(assembler));
+            assembler.next();
+        }
+    }
+    ASSERT_EQ(collector.frames(), 3u);
+    EXPECT_EQ(collector.firstEndTime(), firstEnd);
+    EXPECT_GT(collector.dataEndTime(), firstEnd);
+    // Edges keep coming, so silence never closes it.
+    EXPECT_FALSE(collector.checkIdle(firstEnd + 29000, firstEnd + 30000));
+    EXPECT_TRUE(collector.checkIdle(firstEnd + 29000, firstEnd + 30001));
+    EXPECT_EQ(collector.frames(), 3u);
+}
+
+// KeeLoq's header gap is 10 te and follows a preamble of te pulses, so with
+// some jitter on the air a close threshold of 10 te cut most frames right
+// after the preamble. Every frame has to close at its guard gap instead.
+TEST(FrameAssemblerTest, KeeLoqHeaderGapStaysInTheFrame) {
+    const PulseDuration te = 400;
+    const std::vector<PulseDuration> frame = keeloqFrame(0x5A5AC3C3F00F1234ull, te);
+    const size_t runs = 200;
+    size_t whole = 0;
+    for (uint32_t seed = 1; seed <= runs; seed++) {
+        SyntheticPulseSource source;
+        source.setJitter(40, seed);
+        source.addFrame(PulseView(frame), 2, 40 * te);
+
+        FrameAssembler assembler = makeAssembler();
+        Edge edges[64];
+        bool complete = false;
+        for (size_t count; !complete && (count = source.read(edges, 64)) != 0;) {
+            for (size_t i = 0; i < count && !complete; i++) {
+                complete = assembler.addEdge(edges[i]);
+            }
+        }
+        ASSERT_TRUE(complete) << seed;
+        const auto closed = toVector(assembler.frame());
+        if (closed.size() == frame.size() + 1 && closed[23] < -9 * te && closed.back() < -30 * te) {
+            whole++;
+        }
+    }
+    EXPECT_EQ(whole, runs);
+}
+
+// Linear remote presses (three repeats each), polled every 5 ms as the main
+// loop does: time from the last data edge of a frame to the frame being handed
+// to the decoder, against the old fixed 1 s timeout. The first repeat of each
+// press has no header in front of it, so only the later two decode.
+TEST(FrameAssemblerPerformance, FrameCloseLatency) {
+    const int presses = 50;
+    Timeline timeline;
+    for (int p = 0; p < presses; p++) {
+        const auto frame = linearFrame(static_cast<uint32_t>(p * 19 + 3));
+        for (int r = 0; r < 3; r++) {
+            timeline.frame(frame);
+        }
+        timeline.pulse(-60000);
+        timeline.pulse(300);
+        timeline.pulse(-40000);
+    }
+
+    FrameAssembler assembler = makeAssembler();
+    FrameTimeStats stats;
+    LinearProtocol decoder;
+    size_t closed = 0;
+    size_t decoded = 0;
+    const uint32_t pollUs = 5000;
+    size_t position = 0;
+    for (uint32_t poll = pollUs; position < timeline.edges.size(); poll += pollUs) {
+        bool complete = false;
+        while (position < timeline.edges.size() && timeline.edges[position].timestamp <= poll && !complete) {
+            complete = assembler.addEdge(timeline.edges[position++]);
+        }
+        complete = complete || assembler.checkIdle(poll);
+        if (complete) {
+            closed++;
+            stats.addLatency(poll - assembler.dataEndTime());
+            decoded += decoder.decode(assembler.frame()) ? 1 : 0;
+            assembler.next();
+        }
+    }
+
+    const FrameTimePercentiles& latency = stats.latency();
+    std::printf("[ Frames  ] closed %zu, decoded %zu, latency p50 %.0f us, max %u us (was 1000000 us)\n",
+                closed, decoded, latency.p50.value(), latency.max);
+    EXPECT_EQ(closed, static_cast<size_t>(presses * 3));
+    EXPECT_EQ(decoded, static_cast<size_t>(presses * 2));
+    EXPECT_EQ(latency.count(), closed);
+    EXPECT_LT(latency.max, 100000u);
+}
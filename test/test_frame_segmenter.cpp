@@ -0,0 +1,150 @@
+#include "../src/modules/RF/CaptureDecoder.h"
+#include "../src/modules/RF/FrameSegmenter.h"
+#include "../src/modules/RF/KeeLoqEntry.h"
+#include "../src/modules/RF/PulseSource.h"
+#include "../src/modules/RF/protocols/LinearProtocol.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+// Same settings as the receiver (BIN_RAW_GAP_MULTIPLIER, BIN_RAW_TE_MIN_COUNT,
+// FRAME_MIN_EDGES in CC1101.h).
+static FrameSegmenter makeSegmenter() {
+    return FrameSegmenter(FRAME_GAP_MULTIPLIER, 5, 16);
+}
+
+// 24-bit PWM remote with a 300 us TE and a 31 TE gap after each frame.
+static void appendPwm(PulseTrain& capture, uint32_t code, int repeats) {
+    for (int r = 0; r < repeats; r++) {
+        pwmBits(capture, code, 24, 300, 3);
+        capture.high(300);
+        capture.low(9300);
+    }
+}
+
+TEST(FrameSegmenterTest, SplitsRepeatsAtGaps) {
+    PulseTrain train;
+    train.append(linearFrame(0x155), 4);
+    const std::vector<PulseDuration>& capture = train.pulses;
+
+    FrameSegmenter segmenter = makeSegmenter();
+    ASSERT_EQ(segmenter.split(capture.data(), capture.size()), 4u);
+
+    // Views point into the capture; later frames start with the gap before them.
+    PulseView first = segmenter.frame(0);
+    EXPECT_EQ(*first.begin(), capture[0]);
+    EXPECT_EQ(first.size(), 20u);
+    for (size_t i = 1; i < 4; i++) {
+        PulseView frame = segmenter.frame(i);
+        EXPECT_EQ(frame.size(), 21u);
+        EXPECT_LT(*frame.begin(), -20000);
+        EXPECT_EQ(segmenter.te(i), 500u);
+        LinearProtocol decoder;
+        EXPECT_TRUE(decoder.decode(frame));
+    }
+}
+
+TEST(FrameSegmenterTest, SeparatesRemotesWithDifferentTe) {
+    PulseTrain train;
+    train.append(linearFrame(0x2A5), 3);
+    appendPwm(train, 0xA5F00F, 3);
+    train.append(linearFrame(0x0F3), 3);
+    const std::vector<PulseDuration>& capture = train.pulses;
+
+    FrameSegmenter segmenter = makeSegmenter();
+    ASSERT_EQ(segmenter.split(capture.data(), capture.size()), 9u);
+
+    size_t linear = 0;
+    size_t pwm = 0;
+    for (size_t i = 0; i < segmenter.size(); i++) {
+        LinearProtocol decoder;
+        if (decoder.decode(segmenter.frame(i))) {
+            linear++;
+        }
+        if (segmenter.te(i) == 300) {
+            pwm++;
+        }
+    }
+    // The first frame of each Linear burst has no Linear header in front of it.
+    EXPECT_EQ(linear, 4u);
+    EXPECT_EQ(pwm, 3u);
+}
+
+// With a histogram, split() times every frame in its one pass, the same as
+// clustering the frame on its own afterwards would.
+TEST(FrameSegmenterTest, ClustersEachFrameWhileSplitting) {
+    PulseTrain train(10, 7);
+    train.append(linearFrame(0x2A5), 3);
+    appendPwm(train, 0xA5F00F, 3);
+    const std::vector<PulseDuration>& capture = train.pulses;
+
+    PulseHistogram histogram;
+    FrameSegmenter segmenter(FRAME_GAP_MULTIPLIER, 5, 16, &histogram);
+    ASSERT_TRUE(segmenter.clustered());
+    const size_t frames = segmenter.split(capture.data(), capture.size());
+    ASSERT_EQ(frames, 6u);
+    PulseHistogram whole;
+    for (size_t i = 0; i < frames; i++) {
+        whole.build(segmenter.frame(i));
+        const PulseWidths expected = whole.widths();
+        EXPECT_EQ(segmenter.widths(i).clusters, expected.clusters) << i;
+        EXPECT_EQ(segmenter.widths(i).first, expected.first) << i;
+        EXPECT_EQ(segmenter.widths(i).second, expected.second) << i;
+    }
+    EXPECT_FALSE(makeSegmenter().clustered());
+}
+
+TEST(FrameSegmenterTest, WholeCaptureWithoutGapIsOneFrame) {
+    std::vector<PulseDuration> capture;
+    for (int i = 0; i < 40; i++) {
+        capture.push_back(400);
+        capture.push_back(-800);
+    }
+    FrameSegmenter segmenter = makeSegmenter();
+    ASSERT_EQ(segmenter.split(capture.data(), capture.size()), 1u);
+    EXPECT_EQ(segmenter.frame(0).size(), capture.size());
+}
+
+TEST(FrameSegmenterTest, DropsNoiseBetweenFrames) {
+    PulseTrain train;
+    train.append(linearFrame(0x133), 2);
+    for (int i = 0; i < 3; i++) {
+        train.high(200);
+        train.low(30000);
+    }
+    train.append(linearFrame(0x133), 2);
+
+    FrameSegmenter segmenter = makeSegmenter();
+    EXPECT_EQ(segmenter.split(train.pulses.data(), train.pulses.size()), 4u);
+}
+
+// KeeLoq's 10 te header gap follows a preamble of te pulses: a cut at 10 te
+// splits the preamble from the data on about nine captures in ten.
+TEST(FrameSegmenterTest, KeeLoqDecodesFromJitteredRepeats) {
+    const std::vector<PulseDuration> frame = keeloqFrame(0x5A5AC3C3F00F1234ull, 400);
+    KeeLoqProtocolDecoder keeloq;
+    KeeLoqEntry entry(keeloq);
+    ProtocolRegistry protocols;
+    protocols.add(entry);
+    protocols.build();
+    PulseHistogram histogram;
+    CaptureDecoder decoder(protocols, histogram);
+
+    SyntheticPulseSource clean;
+    clean.addFrame(PulseView(frame), 3, 16000);
+    FrameSegmenter segmenter = makeSegmenter();
+    const DecodeResult expected = decoder.decode(clean.data(), clean.size(), segmenter);
+    ASSERT_TRUE(expected.valid());
+    EXPECT_STREQ(expected.protocol, "KeeLoq");
+    EXPECT_EQ(expected.bits, 64u);
+
+    for (uint32_t seed = 1; seed <= 100; seed++) {
+        SyntheticPulseSource source;
+        source.setJitter(40, seed);
+        source.addFrame(PulseView(frame), 3, 16000);
+        const DecodeResult result = decoder.decode(source.data(), source.size(), segmenter);
+        EXPECT_EQ(segmenter.size(), 3u) << seed;
+        ASSERT_TRUE(result.valid()) << seed;
+        EXPECT_EQ(result.code, expected.code) << seed;
+    }
+}
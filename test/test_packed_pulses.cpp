@@ -0,0 +1,67 @@
+#include "../src/modules/RF/PackedPulses.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+
+static std::vector<PulseDuration> collect(PulseView view) {
+    return std::vector<PulseDuration>(view.begin(), view.end());
+}
+
+TEST(PackedPulsesTest, RoundTripsShortPulses) {
+    const std::vector<PulseDuration> pulses = {320, -640, 320, -320, 640, -11520};
+    PackedPulseBuffer packed;
+    packed.assign(pulses);
+
+    EXPECT_EQ(packed.size(), pulses.size());
+    EXPECT_EQ(packed.bytes(), pulses.size() * sizeof(int16_t));
+    EXPECT_EQ(packed.front(), 320);
+    EXPECT_EQ(collect(packed), pulses);
+}
+
+TEST(PackedPulsesTest, EscapesLongGaps) {
+    const std::vector<PulseDuration> pulses = {500, -32767, 32767, -32768, 32768, -1000000, 2000000000, -400};
+    PackedPulseBuffer packed;
+    for (PulseDuration pulse : pulses) {
+        packed.push_back(pulse);
+    }
+
+    EXPECT_EQ(packed.size(), pulses.size());
+    // Four plain words plus four escaped values at three words each; -32768 is
+    // the escape word itself, so it has to be escaped too.
+    EXPECT_EQ(packed.bytes(), (4 + 4 * 3) * sizeof(int16_t));
+    EXPECT_EQ(collect(packed.view()), pulses);
+}
+
+TEST(PackedPulsesTest, ViewsVectorWithoutCopy) {
+    const std::vector<PulseDuration> pulses = {250, -500, 250};
+    PulseView view(pulses);
+    EXPECT_EQ(view.size(), 3u);
+    EXPECT_EQ(*view.begin(), 250);
+    EXPECT_EQ(collect(view), pulses);
+    EXPECT_TRUE(PulseView().empty());
+}
+
+// Compares what one captured edge costs in RAM before and after the switch:
+// previously samples, filtered and the stored Signal were each int64_t vectors.
+TEST(PackedPulsesPerformance, MemoryPerEdge) {
+    const size_t edges = 4096;
+    std::vector<PulseDuration> samples;
+    for (size_t i = 0; i < edges; i++) {
+        PulseDuration duration = (i % 3 == 0) ? 400 : 800;
+        if (i % 64 == 63) {
+            duration = 40000; // inter-frame gap, needs an escape
+        }
+        samples.push_back((i & 1) ? -duration : duration);
+    }
+    const std::vector<PulseDuration> filtered = samples;
+    PackedPulseBuffer stored;
+    stored.assign(samples);
+
+    const double legacy = 3.0 * sizeof(int64_t);
+    const double current = static_cast<double>(samples.size() * sizeof(PulseDuration) +
+                                               filtered.size() * sizeof(PulseDuration) +
+                                               stored.bytes()) / edges;
+    std::printf("[ PackedPulses ] bytes per edge: legacy %.1f, current %.2f (stored copy %.2f)\n",
+                legacy, current, static_cast<double>(stored.bytes()) / edges);
+    EXPECT_LT(current, legacy / 2);
+}
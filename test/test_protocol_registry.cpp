@@ -0,0 +1,297 @@
+#include "../src/modules/RF/ProtocolRegistry.h"
+#include "../src/modules/RF/DecodeResult.h"
+#include "../src/modules/RF/ShippedProtocols.h"
+#include "../src/modules/RF/protocols/LinearProtocol.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Stands in for a decoder that only declares its timing and completes on the
+// first pulse.
+class FakeDecoder : public SubGhzDecoder {
+public:
+    FakeDecoder(const char* label, uint16_t teShort, uint16_t teLong, uint16_t teDelta, uint64_t key)
+        : label(label), spec{teLong, teShort, teDelta, 8}, key(key), pulses(0), adaptive(false) {}
+
+    const char* name() const override {
+        return label;
+    }
+
+    const SubGhzBlockConst& timing() const override {
+        return spec;
+    }
+
+    bool adaptiveTe() const override {
+        return adaptive;
+    }
+
+    void reset() override {
+        pulses = 0;
+    }
+
+    bool feed(bool level, uint32_t duration) override {
+        pulses++;
+        return true;
+    }
+
+    bool hasResult() const override {
+        return pulses > 0;
+    }
+
+    uint64_t code() const override {
+        return key;
+    }
+
+    uint8_t bits() const override {
+        return 8;
+    }
+
+    std::string describe(uint64_t shortPulse, uint64_t longPulse) override {
+        return name();
+    }
+
+    const char* label;
+    SubGhzBlockConst spec;
+    uint64_t key;
+    int pulses;
+    bool adaptive;
+};
+
+TEST(ProtocolRegistryTest, MatchesShortAndLongWindows) {
+    FakeDecoder came("Came", 320, 640, 150, 1);
+    FakeDecoder hormann("Hormann", 500, 1000, 200, 2);
+    FakeDecoder nice("NiceFlo", 700, 1400, 200, 3);
+    ProtocolRegistry registry;
+    registry.add(came);
+    registry.add(hormann);
+    registry.add(nice);
+    registry.build();
+
+    SubGhzDecoder* out[PROTOCOL_REGISTRY_SIZE];
+    ASSERT_EQ(registry.candidates(510, 1020, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_STREQ(out[0]->name(), "Hormann");
+
+    // Edges of the window are inclusive.
+    EXPECT_EQ(registry.candidates(300, 800, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_EQ(registry.candidates(700, 1000, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_EQ(registry.candidates(701, 1000, out, PROTOCOL_REGISTRY_SIZE), 0u);
+
+    // Short pulse fits but long pulse does not.
+    EXPECT_EQ(registry.candidates(400, 1500, out, PROTOCOL_REGISTRY_SIZE), 0u);
+    EXPECT_EQ(registry.candidates(50, 100, out, PROTOCOL_REGISTRY_SIZE), 0u);
+    EXPECT_EQ(registry.candidates(5000, 10000, out, PROTOCOL_REGISTRY_SIZE), 0u);
+}
+
+TEST(ProtocolRegistryTest, OverlappingWindowsReturnAllInOrder) {
+    FakeDecoder came("Came", 320, 640, 150, 1);
+    FakeDecoder smc("SMC5326", 300, 900, 200, 2);
+    FakeDecoder kia("Kia", 250, 500, 100, 3);
+    FakeDecoder keeloq("KeeLoq", 400, 800, 200, 4);
+    ProtocolRegistry registry;
+    registry.add(came);
+    registry.add(smc);
+    registry.add(kia);
+    registry.add(keeloq);
+    registry.build();
+
+    SubGhzDecoder* out[PROTOCOL_REGISTRY_SIZE];
+    const size_t found = registry.candidates(330, 700, out, PROTOCOL_REGISTRY_SIZE);
+    const std::vector<const char*> expected = {"Came", "SMC5326", "KeeLoq"};
+    ASSERT_EQ(found, expected.size());
+    for (size_t i = 0; i < found; i++) {
+        EXPECT_STREQ(out[i]->name(), expected[i]);
+    }
+
+    // The output is capped, keeping the first matches.
+    ASSERT_EQ(registry.candidates(330, 700, out, 2), 2u);
+    EXPECT_STREQ(out[1]->name(), "SMC5326");
+
+    EXPECT_EQ(registry.find("Kia"), &kia);
+    EXPECT_EQ(registry.find("Linear"), nullptr);
+}
+
+TEST(ProtocolRegistryTest, AdaptiveDecodersScaleLongWindow) {
+    FakeDecoder fixed("Fixed", 320, 640, 150, 1);
+    FakeDecoder adaptive("Adaptive", 320, 640, 150, 2);
+    adaptive.adaptive = true;
+    ProtocolRegistry registry;
+    registry.add(fixed);
+    registry.add(adaptive);
+    registry.build();
+
+    SubGhzDecoder* out[PROTOCOL_REGISTRY_SIZE];
+    EXPECT_EQ(registry.candidates(320, 640, out, PROTOCOL_REGISTRY_SIZE), 2u);
+
+    // A remote running 30% slow: only the decoder that scales its windows
+    // to te still sees its long pulse.
+    ASSERT_EQ(registry.candidates(416, 832, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_STREQ(out[0]->name(), "Adaptive");
+    // te_delta scales along: 195 us around 832 at te 416.
+    EXPECT_EQ(registry.candidates(416, 1027, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_EQ(registry.candidates(416, 1028, out, PROTOCOL_REGISTRY_SIZE), 0u);
+    // The short window widens by te_delta scaled to its edges, 91 to 690 us.
+    EXPECT_EQ(registry.candidates(480, 960, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_EQ(registry.candidates(690, 1380, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_EQ(registry.candidates(691, 1382, out, PROTOCOL_REGISTRY_SIZE), 0u);
+    EXPECT_EQ(registry.candidates(91, 182, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_EQ(registry.candidates(90, 180, out, PROTOCOL_REGISTRY_SIZE), 0u);
+}
+
+TEST(ProtocolRegistryTest, AdaptiveDecodersIndexedPastNominalWindow) {
+    // te_delta is 25% of te_short, so a remote 30% off misses the nominal
+    // window.
+    FakeDecoder fixed("Fixed", 400, 800, 100, 1);
+    FakeDecoder adaptive("Adaptive", 400, 800, 100, 2);
+    adaptive.adaptive = true;
+    ProtocolRegistry registry;
+    registry.add(fixed);
+    registry.add(adaptive);
+    registry.build();
+
+    SubGhzDecoder* out[PROTOCOL_REGISTRY_SIZE];
+    ASSERT_EQ(registry.candidates(520, 1040, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_STREQ(out[0]->name(), "Adaptive");
+    ASSERT_EQ(registry.candidates(280, 560, out, PROTOCOL_REGISTRY_SIZE), 1u);
+    EXPECT_STREQ(out[0]->name(), "Adaptive");
+    // The long pulse still has to be in proportion.
+    EXPECT_EQ(registry.candidates(520, 1300, out, PROTOCOL_REGISTRY_SIZE), 0u);
+}
+
+TEST(ProtocolRegistryTest, LinearDecodesThroughAdapter) {
+    LinearProtocol encoder;
+    encoder.startEncoding(0x1B3, 10);
+    // Linear needs the guard gap of a previous copy in front of the frame.
+    std::vector<PulseDuration> frame;
+    for (int copy = 0; copy < 2; copy++) {
+        for (long long int sample : encoder.getEncodedSamples()) {
+            frame.push_back(static_cast<PulseDuration>(sample));
+        }
+    }
+
+    LinearProtocol linear;
+    DecoderAdapter<LinearProtocol> entry("Linear", linear);
+    FakeDecoder other("Other", 480, 1450, 100, 9);
+    ProtocolRegistry registry;
+    registry.add(entry);
+    registry.add(other);
+    registry.build();
+    EXPECT_EQ(entry.timing().te_short, 500u);
+    EXPECT_EQ(entry.timing().min_count_bit_for_found, 10u);
+    // Linear reads at its nominal te.
+    EXPECT_FALSE(entry.adaptiveTe());
+    EXPECT_EQ(entry.te(), 0u);
+
+    // Both candidates are tried; the frame counts once in the vote.
+    SubGhzDecoder* out[PROTOCOL_REGISTRY_SIZE];
+    const size_t found = registry.candidates(500, 1500, out, PROTOCOL_REGISTRY_SIZE);
+    ASSERT_EQ(found, 2u);
+    DecodeVote vote;
+    vote.reset(1);
+    for (size_t i = 0; i < found; i++) {
+        out[i]->reset();
+        for (PulseDuration pulse : frame) {
+            if (out[i]->feed(pulse > 0, static_cast<uint32_t>(pulse > 0 ? pulse : -pulse))) {
+                FrameDecode decoded;
+                decoded.protocol = out[i]->name();
+                decoded.code = out[i]->code();
+                decoded.bits = out[i]->bits();
+                vote.add(decoded, 0);
+                break;
+            }
+        }
+    }
+    EXPECT_EQ(other.pulses, 1);
+    const DecodeResult result = vote.result();
+    EXPECT_STREQ(result.protocol, "Linear");
+    EXPECT_EQ(result.code, 0x1B3u);
+    EXPECT_EQ(result.reversed, 0x336u);
+    EXPECT_EQ(result.decoded, 1u);
+    // The description is plain text, no display needed.
+    EXPECT_EQ(entry.describe(500, 1500).rfind("Linear 10bit\r\nKey:0x000001B3", 0), 0u);
+}
+
+// Hormann, Ansonic and SMC5326 register on the host too.
+TEST(ProtocolRegistryTest, ShippedHormannDecodesOnTheHost) {
+    const uint64_t key = 0xFF12345678FULL;
+    std::vector<PulseDuration> frame = {12000, -500};
+    for (int bit = 43; bit >= 0; bit--) {
+        const bool one = (key >> bit) & 1;
+        frame.push_back(one ? 1000 : 500);
+        frame.push_back(one ? -500 : -1000);
+    }
+    frame.push_back(2500);
+
+    ShippedProtocols shipped;
+    ProtocolRegistry registry;
+    shipped.registerAll(registry);
+    registry.build();
+
+    SubGhzDecoder* out[PROTOCOL_REGISTRY_SIZE];
+    const size_t found = registry.candidates(500, 1000, out, PROTOCOL_REGISTRY_SIZE);
+    SubGhzDecoder* hormann = nullptr;
+    for (size_t i = 0; i < found; i++) {
+        if (std::string(out[i]->name()) == "Hormann") {
+            hormann = out[i];
+        }
+    }
+    ASSERT_NE(hormann, nullptr);
+    hormann->reset();
+    bool decoded = false;
+    for (PulseDuration pulse : frame) {
+        decoded = hormann->feed(pulse > 0, static_cast<uint32_t>(pulse > 0 ? pulse : -pulse));
+        if (decoded) {
+            break;
+        }
+    }
+    ASSERT_TRUE(decoded);
+    EXPECT_EQ(hormann->code(), key);
+    EXPECT_EQ(hormann->bits(), 44u);
+}
+
+// Sixteen decoders with staggered windows; index lookup against checking
+// every window in turn.
+TEST(ProtocolRegistryPerformance, CandidateLookup) {
+    std::vector<FakeDecoder> decoders;
+    decoders.reserve(PROTOCOL_REGISTRY_SIZE);
+    for (uint16_t i = 0; i < PROTOCOL_REGISTRY_SIZE; i++) {
+        const uint16_t te = static_cast<uint16_t>(200 + i * 70);
+        decoders.emplace_back("Fake", te, static_cast<uint16_t>(te * 2), 60, i);
+    }
+    ProtocolRegistry registry;
+    for (FakeDecoder& decoder : decoders) {
+        registry.add(decoder);
+    }
+    registry.build();
+
+    const int rounds = 200000;
+    SubGhzDecoder* out[PROTOCOL_REGISTRY_SIZE];
+    size_t indexed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        const uint32_t te = 150 + static_cast<uint32_t>(r % 1300);
+        indexed += registry.candidates(te, te * 2, out, PROTOCOL_REGISTRY_SIZE);
+    }
+    const double indexedNs =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+    size_t linear = 0;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        const uint32_t te = 150 + static_cast<uint32_t>(r % 1300);
+        for (size_t i = 0; i < registry.size(); i++) {
+            const SubGhzBlockConst& timing = registry[i].timing();
+            if (DURATION_DIFF(te, timing.te_short) <= timing.te_delta &&
+                DURATION_DIFF(te * 2, timing.te_long) <= timing.te_delta) {
+                out[linear % PROTOCOL_REGISTRY_SIZE] = &registry[i];
+                linear++;
+            }
+        }
+    }
+    const double linearNs =
+        std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+    std::printf("[ Registry ] candidates per frame: %.1f ns indexed, %.1f ns scanning %zu decoders\n", indexedNs,
+                linearNs, registry.size());
+    EXPECT_EQ(indexed, linear);
+}
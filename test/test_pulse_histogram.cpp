@@ -0,0 +1,175 @@
+#include "../src/modules/RF/PulseHistogram.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+// The grouping filterSignal() did before: sort all durations, cut a group
+// whenever a pulse exceeds 1.3x the group's first, take the two most populated
+// groups' medians.
+static std::pair<int64_t, int64_t> sortAndGroup(const std::vector<PulseDuration>& frame) {
+    std::vector<int64_t> absArr;
+    for (PulseDuration x : frame) {
+        absArr.push_back(std::abs(static_cast<int64_t>(x)));
+    }
+    std::sort(absArr.begin(), absArr.end());
+    std::vector<std::vector<int64_t>> groups;
+    std::vector<int64_t> currGroup = {absArr[0]};
+    int64_t groupMin = absArr[0];
+    for (size_t i = 1; i < absArr.size(); i++) {
+        if (absArr[i] * 10 <= groupMin * 13) {
+            currGroup.push_back(absArr[i]);
+        } else {
+            groups.push_back(std::move(currGroup));
+            currGroup = {absArr[i]};
+            groupMin = absArr[i];
+        }
+    }
+    groups.push_back(std::move(currGroup));
+    std::vector<std::pair<int64_t, int64_t>> stats;
+    for (auto& g : groups) {
+        const size_t n = g.size();
+        stats.push_back({static_cast<int64_t>(n), n % 2 ? g[n / 2] : (g[n / 2 - 1] + g[n / 2]) / 2});
+    }
+    std::sort(stats.begin(), stats.end(), [](const std::pair<int64_t, int64_t>& a, const std::pair<int64_t, int64_t>& b) {
+        return a.first == b.first ? a.second < b.second : a.first > b.first;
+    });
+    if (stats.size() < 2) {
+        return {stats[0].second, 0};
+    }
+    return {std::min(stats[0].second, stats[1].second), std::max(stats[0].second, stats[1].second)};
+}
+
+static std::pair<int64_t, int64_t> histogramGroup(PulseHistogram& histogram, const std::vector<PulseDuration>& frame) {
+    if (histogram.build(frame) < 2) {
+        return {histogram.size() ? histogram.cluster(0).median : 0, 0};
+    }
+    const int64_t a = histogram.cluster(0).median;
+    const int64_t b = histogram.cluster(1).median;
+    return {std::min(a, b), std::max(a, b)};
+}
+
+// PWM frame of the given bit count after a guard gap and closed by a te high,
+// with uniform jitter of up to jitterPercent on every pulse and a few noise
+// pulses in front.
+static std::vector<PulseDuration> pwmCapture(uint32_t te, uint32_t ratio, int bits, int repeats, int jitterPercent,
+                                             uint32_t& seed) {
+    PulseTrain capture(jitterPercent, seed);
+    capture.high(130);
+    capture.low(210);
+    capture.high(90);
+    for (int r = 0; r < repeats; r++) {
+        capture.low(te * 36);
+        for (int b = 0; b < bits; b++) {
+            pwmBits(capture, capture.next() & 1, 1, te, ratio);
+        }
+        capture.high(te);
+    }
+    seed = capture.next();
+    return capture.pulses;
+}
+
+TEST(PulseHistogramTest, BinsCoverTheirDurations) {
+    for (uint32_t d : {1u, 7u, 15u, 16u, 17u, 250u, 499u, 500u, 1501u, 65535u, 1000000u, 0x7FFFFFFFu, 0x80000000u}) {
+        const size_t bin = PulseHistogram::binOf(d);
+        ASSERT_LT(bin, static_cast<size_t>(HISTOGRAM_BINS)) << d;
+        EXPECT_LE(PulseHistogram::binStart(bin), d) << d;
+        // Below 16 us several bins share a duration.
+        if (d >= 16 && bin + 1 < HISTOGRAM_BINS) {
+            EXPECT_GT(PulseHistogram::binStart(bin + 1), d) << d;
+        }
+    }
+}
+
+TEST(PulseHistogramTest, FindsShortLongAndGap) {
+    uint32_t seed = 7;
+    const auto capture = pwmCapture(500, 3, 12, 4, 10, seed);
+    PulseHistogram histogram;
+    ASSERT_GE(histogram.build(capture), 3u);
+    // Short and long both make up about half the bit pulses; the shorter one,
+    // which also closes every frame, ranks first.
+    EXPECT_NEAR(histogram.cluster(0).median, 500, 25);
+    EXPECT_NEAR(histogram.cluster(1).median, 1500, 75);
+    EXPECT_EQ(histogram.cluster(0).count + histogram.cluster(1).count, 4u * 25u);
+    EXPECT_EQ(histogram.cluster(2).count, 4u);
+    EXPECT_NEAR(histogram.cluster(2).median, 18000, 1800);
+}
+
+TEST(PulseHistogramTest, EmptyAndSingleDuration) {
+    PulseHistogram histogram;
+    EXPECT_EQ(histogram.build(std::vector<PulseDuration>()), 0u);
+    EXPECT_EQ(histogram.build(std::vector<PulseDuration>{0, 0}), 0u);
+
+    const std::vector<PulseDuration> flat = {400, -410, 395, -405};
+    ASSERT_EQ(histogram.build(flat), 1u);
+    EXPECT_EQ(histogram.cluster(0).count, 4u);
+    EXPECT_NEAR(histogram.cluster(0).median, 402, 10);
+
+    // Nothing of the previous frame is left over.
+    const std::vector<PulseDuration> other = {2000, -2000, 2010};
+    ASSERT_EQ(histogram.build(other), 1u);
+    EXPECT_EQ(histogram.cluster(0).count, 3u);
+}
+
+// Assorted PWM remotes with 15% jitter: short/long found by the histogram
+// against the sort-and-group it replaces, both for agreement and speed.
+TEST(PulseHistogramPerformance, AgainstSortAndGroup) {
+    const uint32_t tes[] = {250, 320, 400, 500, 555, 700};
+    std::vector<std::vector<PulseDuration>> captures;
+    std::vector<std::pair<int64_t, int64_t>> truth;
+    uint32_t seed = 1;
+    for (int i = 0; i < 120; i++) {
+        const uint32_t te = tes[i % 6];
+        const uint32_t ratio = 2 + i % 2;
+        captures.push_back(pwmCapture(te, ratio, 24, 5, 15, seed));
+        truth.push_back({te, te * ratio});
+    }
+
+    PulseHistogram histogram;
+    double histogramError = 0;
+    double referenceError = 0;
+    int disagreements = 0;
+    for (size_t i = 0; i < captures.size(); i++) {
+        const auto fast = histogramGroup(histogram, captures[i]);
+        const auto slow = sortAndGroup(captures[i]);
+        histogramError += std::abs(fast.first - truth[i].first) + std::abs(fast.second - truth[i].second);
+        referenceError += std::abs(slow.first - truth[i].first) + std::abs(slow.second - truth[i].second);
+        // Same clusters picked, medians within a bin of each other.
+        if (std::abs(fast.first - slow.first) * 10 > slow.first || std::abs(fast.second - slow.second) * 10 > slow.second) {
+            disagreements++;
+        }
+    }
+
+    const int rounds = 20;
+    volatile int64_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (const auto& capture : captures) {
+            sink = sink + histogramGroup(histogram, capture).first;
+        }
+    }
+    const double histogramUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+                               (rounds * captures.size());
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (const auto& capture : captures) {
+            sink = sink + sortAndGroup(capture).first;
+        }
+    }
+    const double referenceUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+                               (rounds * captures.size());
+
+    const double pairs = 2.0 * captures.size();
+    std::printf("[ Histogram ] %zu pulses/capture: %.2f us histogram, %.2f us sort-and-group; "
+                "mean error %.1f us vs %.1f us, %d of %zu disagree\n",
+                captures[0].size(), histogramUs, referenceUs, histogramError / pairs, referenceError / pairs,
+                disagreements, captures.size());
+    // At 15% jitter the short pulses now and then spread past a cluster's 1.3x
+    // span, and the histogram splits off their longest.
+    EXPECT_LE(disagreements, 2);
+    EXPECT_LT(histogramError / pairs, 40.0);
+}
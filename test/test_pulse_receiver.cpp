@@ -0,0 +1,213 @@
+#include "../src/modules/RF/PulseReceiver.h"
+#include "../src/modules/RF/protocols/LinearProtocol.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Records what it is fed; completes after a set number of pulses, or never.
+class RecordingDecoder : public SubGhzDecoder {
+public:
+    RecordingDecoder(bool raw, size_t completeAfter) : raw(raw), completeAfter(completeAfter) {}
+
+    const char* name() const override {
+        return "Recording";
+    }
+
+    const SubGhzBlockConst& timing() const override {
+        return spec;
+    }
+
+    bool rawInput() const override {
+        return raw;
+    }
+
+    void reset() override {
+        levels.clear();
+        durations.clear();
+    }
+
+    bool feed(bool level, uint32_t duration) override {
+        levels.push_back(level);
+        durations.push_back(duration);
+        return hasResult();
+    }
+
+    bool hasResult() const override {
+        return completeAfter && durations.size() >= completeAfter;
+    }
+
+    uint64_t code() const override {
+        return durations.size();
+    }
+
+    uint8_t bits() const override {
+        return 0;
+    }
+
+    std::string describe(uint64_t shortPulse, uint64_t longPulse) override {
+        return name();
+    }
+
+    SubGhzBlockConst spec{1000, 500, 100, 1};
+    bool raw;
+    size_t completeAfter;
+    std::vector<bool> levels;
+    std::vector<uint32_t> durations;
+};
+
+static std::vector<PulseDuration> linearBurst(uint32_t code, int repeats, int jitterPercent) {
+    PulseTrain capture(jitterPercent, code);
+    capture.append(linearFrame(code), repeats);
+    return capture.pulses;
+}
+
+TEST(PulseQuantizerTest, SnapsOntoBands) {
+    PulseQuantizer quantizer;
+    EXPECT_FALSE(quantizer.enabled());
+    quantizer.configure(500, 1500);
+    ASSERT_TRUE(quantizer.enabled());
+
+    PulseDuration out = 0;
+    ASSERT_TRUE(quantizer.apply(430, out));
+    EXPECT_EQ(out, 500);
+    ASSERT_TRUE(quantizer.apply(-1800, out));
+    EXPECT_EQ(out, -1500);
+    ASSERT_TRUE(quantizer.apply(-21000, out));
+    EXPECT_EQ(out, -27000);
+    // Between the bands and below the short band.
+    EXPECT_FALSE(quantizer.apply(900, out));
+    EXPECT_FALSE(quantizer.apply(-300, out));
+}
+
+TEST(PulseReceiverTest, FansOutInOnePass) {
+    const auto capture = linearBurst(0x2C4, 3, 12);
+    RecordingDecoder first(false, 40);
+    RecordingDecoder quantized(false, 0);
+    RecordingDecoder raw(true, 0);
+    SubGhzDecoder* decoders[] = {&raw, &first, &quantized};
+
+    std::vector<const char*> emitted;
+    size_t emittedAt = 0;
+    PulseReceiver receiver;
+    receiver.setDecodeCallback([&](SubGhzDecoder& decoder) {
+        emitted.push_back(decoder.name());
+        emittedAt = raw.durations.size();
+    });
+    PulseQuantizer quantizer;
+    quantizer.configure(500, 1500);
+    receiver.begin(decoders, 3, quantizer, false);
+    EXPECT_EQ(receiver.run(capture), 1u);
+
+    // Reported the moment it completes, not at the end of the frame.
+    ASSERT_EQ(emitted.size(), 1u);
+    EXPECT_EQ(emittedAt, 40u);
+    EXPECT_EQ(first.code(), 40u);
+
+    // The rest saw every pulse, snapped or as received.
+    ASSERT_EQ(raw.durations.size(), capture.size());
+    ASSERT_EQ(quantized.durations.size(), capture.size());
+    for (size_t i = 0; i < capture.size(); i++) {
+        EXPECT_EQ(raw.levels[i], capture[i] > 0);
+        EXPECT_EQ(static_cast<PulseDuration>(raw.durations[i]), capture[i] > 0 ? capture[i] : -capture[i]);
+        PulseDuration snapped = 0;
+        ASSERT_TRUE(quantizer.apply(capture[i], snapped));
+        EXPECT_EQ(quantized.levels[i], snapped > 0);
+        EXPECT_EQ(static_cast<PulseDuration>(quantized.durations[i]), snapped > 0 ? snapped : -snapped);
+    }
+}
+
+TEST(PulseReceiverTest, ReversedFrameInvertsLevels) {
+    const std::vector<PulseDuration> frame = {500, -1500, 1500, -500};
+    RecordingDecoder raw(true, 0);
+    SubGhzDecoder* decoders[] = {&raw};
+    PulseReceiver receiver;
+    receiver.begin(decoders, 1, PulseQuantizer(), true);
+    receiver.run(frame);
+    const std::vector<bool> expected = {false, true, false, true};
+    EXPECT_EQ(raw.levels, expected);
+}
+
+TEST(PulseReceiverTest, StopsWhenEveryDecoderCompleted) {
+    const auto capture = linearBurst(0x155, 2, 0);
+    RecordingDecoder early(true, 3);
+    RecordingDecoder later(false, 7);
+    RecordingDecoder unmeasured(false, 1);
+    SubGhzDecoder* decoders[] = {&early, &later};
+
+    PulseQuantizer quantizer;
+    quantizer.configure(500, 1500);
+    PulseReceiver receiver;
+    receiver.begin(decoders, 2, quantizer, false);
+    EXPECT_EQ(receiver.run(capture), 2u);
+    EXPECT_EQ(early.durations.size(), 3u);
+    EXPECT_EQ(later.durations.size(), 7u);
+
+    // Quantized decoders sit out frames whose timing was not measured.
+    SubGhzDecoder* alone[] = {&unmeasured};
+    receiver.begin(alone, 1, PulseQuantizer(), false);
+    EXPECT_EQ(receiver.run(capture), 0u);
+    EXPECT_TRUE(unmeasured.durations.empty());
+}
+
+// Eight decoders over a capture none of them accepts: a filtered copy plus one
+// decode() walk per decoder against a single lockstep pass.
+TEST(PulseReceiverPerformance, SinglePassFanOut) {
+    auto capture = linearBurst(0x0F0, 10, 8);
+    // Break every guard gap so no copy ever completes.
+    for (PulseDuration& pulse : capture) {
+        if (pulse < -5000) {
+            pulse = -1500;
+        }
+    }
+    const size_t decoderCount = 8;
+    std::vector<LinearProtocol> linears(decoderCount);
+    std::vector<DecoderAdapter<LinearProtocol>> entries;
+    std::vector<SubGhzDecoder*> decoders;
+    entries.reserve(decoderCount);
+    for (LinearProtocol& linear : linears) {
+        entries.emplace_back("Linear", linear);
+    }
+    for (auto& entry : entries) {
+        decoders.push_back(&entry);
+    }
+    PulseQuantizer quantizer;
+    quantizer.configure(500, 1500);
+
+    // Filtered copy first, then every decoder resets and walks it.
+    const int rounds = 2000;
+    size_t separateHits = 0;
+    std::vector<PulseDuration> filtered;
+    filtered.reserve(capture.size());
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        filtered.clear();
+        PulseDuration snapped;
+        for (PulseDuration pulse : capture) {
+            if (quantizer.apply(pulse, snapped)) {
+                filtered.push_back(snapped);
+            }
+        }
+        for (LinearProtocol& linear : linears) {
+            separateHits += linear.decode(filtered);
+        }
+    }
+    const double separateUs =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+    PulseReceiver receiver;
+    size_t lockstepHits = 0;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        receiver.begin(decoders.data(), decoders.size(), quantizer, false);
+        lockstepHits += receiver.run(capture);
+    }
+    const double lockstepUs =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+
+    std::printf("[ Receiver ] %zu decoders, %zu pulses: %.2f us walking once per decoder, %.2f us in one pass\n",
+                decoderCount, capture.size(), separateUs, lockstepUs);
+    EXPECT_EQ(separateHits, 0u);
+    EXPECT_EQ(lockstepHits, 0u);
+}
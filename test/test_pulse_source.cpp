@@ -0,0 +1,144 @@
+#include "../src/modules/RF/PulseSource.h"
+#include "../src/modules/RF/protocols/LinearProtocol.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+#define TEST_FRAME_GAP 30000
+
+// Writes pulses the way FlipperSubFile does: 512 values per RAW_Data line.
+static std::string toSubFile(PulseView pulses) {
+    std::ostringstream out;
+    out << "Filetype: Flipper SubGhz RAW File\r\nVersion: 1\r\nFrequency: 433920000\r\n"
+        << "Preset: FuriHalSubGhzPresetOok650Async\r\nProtocol: RAW\r\nRAW_Data: ";
+    size_t n = 0;
+    for (PulseDuration pulse : pulses) {
+        if (n > 0 && n % 512 == 0) {
+            out << "\r\nRAW_Data: ";
+        }
+        out << pulse << ' ';
+        n++;
+    }
+    out << "\r\n";
+    return out.str();
+}
+
+// Frames the source exactly like CC1101_CLASS::pollStream() and decodes every block.
+static size_t decodeAll(PulseSource& source, size_t& blocksSeen) {
+    static PulseBlockBuffer blocks;
+    blocks.reset();
+    LinearProtocol decoder;
+    size_t decoded = 0;
+    blocksSeen = 0;
+    for (;;) {
+        if (!readBlock(source, blocks, TEST_FRAME_GAP)) {
+            if (source.finished()) {
+                break;
+            }
+            continue;
+        }
+        const PulseBlock* block = blocks.completed();
+        blocksSeen++;
+        if (decoder.decode(PulseView(block->data(), block->size()))) {
+            decoded++;
+        }
+        blocks.release();
+    }
+    return decoded;
+}
+
+TEST(PulseSourceTest, ParsesSubFileInChunks) {
+    const std::string text =
+        "Filetype: Flipper SubGhz RAW File\r\nVersion: 1\r\nFrequency: 433920000\r\n"
+        "Preset: FuriHalSubGhzPresetOok650Async\r\nProtocol: RAW\r\n"
+        "RAW_Data: 500 -1500 1500 -500\r\nRAW_Data: 300 -40000";
+    SubFileSource source;
+    for (char c : text) {
+        source.parse(&c, 1);
+    }
+    source.finish();
+
+    EXPECT_TRUE(source.isRaw());
+    EXPECT_EQ(source.getFrequency(), 433920000u);
+    EXPECT_EQ(source.getPreset(), "FuriHalSubGhzPresetOok650Async");
+    const std::vector<PulseDuration> expected = {500, -1500, 1500, -500, 300, -40000};
+    EXPECT_EQ(std::vector<PulseDuration>(source.pulses().begin(), source.pulses().end()), expected);
+
+    Edge edges[8];
+    ASSERT_EQ(source.read(edges, 8), 6u);
+    EXPECT_EQ(edges[1].timestamp, 2000u);
+    EXPECT_EQ(edges[5].duration, -40000);
+    EXPECT_TRUE(source.finished());
+}
+
+TEST(PulseSourceTest, RejectsKeyFile) {
+    std::istringstream in("Filetype: Flipper SubGhz Key File\nVersion: 1\nProtocol: Custom\nKey: 00 00 3C 00\n");
+    SubFileSource source;
+    EXPECT_FALSE(source.load(in));
+    EXPECT_FALSE(source.isRaw());
+}
+
+TEST(PulseSourceTest, SyntheticAlternatingWithJitter) {
+    SyntheticPulseSource source;
+    source.setJitter(50);
+    source.addAlternating({400, 800, 800, 400}, true, 2, 10000);
+
+    const std::vector<PulseDuration> nominal = {400, -800, 800, -10400, 400, -800, 800, -10400};
+    ASSERT_EQ(source.size(), nominal.size());
+    size_t i = 0;
+    for (PulseDuration pulse : source.pulses()) {
+        EXPECT_EQ(pulse > 0, nominal[i] > 0);
+        EXPECT_LE(std::abs(pulse - nominal[i]), 50);
+        i++;
+    }
+}
+
+TEST(PulseSourceTest, DecodesLinearThroughStreamFraming) {
+    SyntheticPulseSource source;
+    for (uint32_t code = 1; code <= 20; code++) {
+        source.addFrame(linearFrame(code), 3, 0);
+        source.addSilence(60000);
+    }
+    size_t blocks = 0;
+    EXPECT_EQ(decodeAll(source, blocks), 20u);
+    EXPECT_EQ(blocks, 20u);
+}
+
+// Replays thousands of jittered transmissions, directly and through a .sub
+// round trip, and reports decode rate and time per frame.
+TEST(PulseSourcePerformance, ReplayDecodeRate) {
+    const uint32_t transmissions = 2000;
+    SyntheticPulseSource synthetic;
+    synthetic.setJitter(80);
+    for (uint32_t i = 0; i < transmissions; i++) {
+        synthetic.addFrame(linearFrame(i & 0x3FF), 3, 0);
+        synthetic.addSilence(60000);
+    }
+
+    SubFileSource replay;
+    std::istringstream file(toSubFile(synthetic.pulses()));
+    ASSERT_TRUE(replay.load(file));
+    ASSERT_EQ(replay.size(), synthetic.size());
+
+    PulseSource* sources[] = {&synthetic, &replay};
+    const char* names[] = {"synthetic", ".sub replay"};
+    for (int s = 0; s < 2; s++) {
+        size_t blocks = 0;
+        const auto start = Clock::now();
+        const size_t decoded = decodeAll(*sources[s], blocks);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+
+        std::printf("[ PulseSource ] %-11s %zu/%u decoded (%.1f%%), %.2f us/frame\n",
+                    names[s], decoded, transmissions, 100.0 * decoded / transmissions,
+                    static_cast<double>(elapsed) / 1000.0 / blocks);
+        EXPECT_EQ(blocks, transmissions);
+        EXPECT_EQ(decoded, transmissions);
+    }
+}
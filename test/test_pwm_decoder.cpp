@@ -0,0 +1,313 @@
+#include "../src/modules/RF/protocols/PwmDecoder.h"
+#include "../src/modules/RF/ProtocolRegistry.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Came's timing and hooks on the template base.
+class TemplateCame : public PwmDecoder<TemplateCame> {
+public:
+    static constexpr SubGhzBlockConst timing = {640, 320, 150, 12};
+
+    std::string getCodeString(uint64_t shortPulse, uint64_t longPulse) const {
+        return "Came";
+    }
+
+private:
+    friend class PwmDecoder<TemplateCame>;
+
+    static constexpr bool isHeader(uint32_t low) {
+        return within(low, timing.te_short * 56u, timing.te_delta * 52u);
+    }
+
+    static constexpr bool isGap(uint32_t low) {
+        return low > 5000;
+    }
+
+    static constexpr bool acceptBitCount(uint8_t bits) {
+        return bits == 12 || bits == 18 || bits == 24 || bits == 25;
+    }
+};
+
+// CameProtocol::feed() as it was before the base: timing in const members.
+class RuntimeCame {
+public:
+    RuntimeCame() : te_short(320), te_long(640), te_delta(150), min_count_bit(12) {
+        reset();
+    }
+
+    void reset() {
+        state = StepReset;
+        decodeData = 0;
+        decodeCountBit = 0;
+        te_last = 0;
+        validCodeFound = false;
+        finalCode = 0;
+        finalBitCount = 0;
+    }
+
+    void feed(bool level, uint32_t duration) {
+        switch (state) {
+        case StepReset:
+            if (!level && DURATION_DIFF(duration, te_short * 56) < te_delta * 52) {
+                state = StepFoundStartBit;
+            }
+            break;
+        case StepFoundStartBit:
+            if (!level) {
+                break;
+            } else if (DURATION_DIFF(duration, te_short) < te_delta) {
+                state = StepSaveDuration;
+                decodeData = 0;
+                decodeCountBit = 0;
+            } else {
+                state = StepReset;
+            }
+            break;
+        case StepSaveDuration:
+            if (!level) {
+                if (duration > 5000) {
+                    state = StepFoundStartBit;
+                    if (decodeCountBit == min_count_bit || decodeCountBit == 18 || decodeCountBit == 25 ||
+                        decodeCountBit == 24) {
+                        validCodeFound = true;
+                        finalCode = decodeData;
+                        finalBitCount = decodeCountBit;
+                    }
+                    break;
+                }
+                te_last = duration;
+                state = StepCheckDuration;
+            } else {
+                state = StepReset;
+            }
+            break;
+        case StepCheckDuration:
+            if (level) {
+                if (DURATION_DIFF(te_last, te_short) < te_delta && DURATION_DIFF(duration, te_long) < te_delta) {
+                    decodeData = decodeData << 1;
+                    decodeCountBit++;
+                    state = StepSaveDuration;
+                } else if (DURATION_DIFF(te_last, te_long) < te_delta &&
+                           DURATION_DIFF(duration, te_short) < te_delta) {
+                    decodeData = decodeData << 1 | 1;
+                    decodeCountBit++;
+                    state = StepSaveDuration;
+                } else {
+                    state = StepReset;
+                }
+            } else {
+                state = StepReset;
+            }
+            break;
+        }
+    }
+
+    bool hasValidCode() const {
+        return validCodeFound;
+    }
+
+    uint64_t getCode() const {
+        return finalCode;
+    }
+
+    uint8_t getBitCount() const {
+        return finalBitCount;
+    }
+
+    std::string getCodeString(uint64_t shortPulse, uint64_t longPulse) const {
+        return "Came";
+    }
+
+    static const SubGhzBlockConst timing;
+
+private:
+    enum Step { StepReset, StepFoundStartBit, StepSaveDuration, StepCheckDuration };
+
+    const uint32_t te_short;
+    const uint32_t te_long;
+    const uint32_t te_delta;
+    const uint8_t min_count_bit;
+    Step state;
+    uint32_t decodeData;
+    uint8_t decodeCountBit;
+    uint32_t te_last;
+    bool validCodeFound;
+    uint32_t finalCode;
+    uint8_t finalBitCount;
+};
+
+const SubGhzBlockConst RuntimeCame::timing = {640, 320, 150, 12};
+
+// Came frames the way CameProtocol::yield() sends them, with jitter of up to
+// jitterPercent and some frames cut short.
+static std::vector<PulseDuration> cameCapture(int frames, int bits, int jitterPercent, uint32_t seed) {
+    PulseTrain capture(jitterPercent, seed);
+    for (int f = 0; f < frames; f++) {
+        const uint32_t code = capture.next() << 16 | capture.next();
+        const int length = capture.next() % 4 == 0 ? bits / 2 : bits;
+        cameFrame(capture, code, length, 320);
+    }
+    capture.low(11520);
+    return capture.pulses;
+}
+
+TEST(PwmDecoderTest, DecodesCameFrame) {
+    // 0b1010'0000'0011, most significant bit first.
+    std::vector<PulseDuration> frame = {-11520, 320};
+    for (int i = 11; i >= 0; i--) {
+        const bool one = (0xA03 >> i) & 1;
+        frame.push_back(one ? -640 : -320);
+        frame.push_back(one ? 320 : 640);
+    }
+    frame.push_back(-11520);
+
+    TemplateCame decoder;
+    ASSERT_TRUE(decoder.decode(frame));
+    EXPECT_EQ(decoder.getCode(), 0xA03u);
+    EXPECT_EQ(decoder.getBitCount(), 12u);
+
+    // 13 bits is no Came length.
+    frame.insert(frame.begin() + 2, {-320, 640});
+    EXPECT_FALSE(decoder.decode(frame));
+}
+
+// On nominal timing without jitter the start bit is te_short exactly, so the
+// scaled windows are the nominal ones.
+TEST(PwmDecoderTest, MatchesRuntimeTimingAtNominalTe) {
+    const std::vector<PulseDuration> capture = cameCapture(200, 24, 0, 3);
+    TemplateCame fast;
+    RuntimeCame reference;
+    int found = 0;
+    for (PulseDuration pulse : capture) {
+        const bool level = pulse > 0;
+        const uint32_t duration = static_cast<uint32_t>(level ? pulse : -pulse);
+        fast.feed(level, duration);
+        reference.feed(level, duration);
+        ASSERT_EQ(fast.hasValidCode(), reference.hasValidCode());
+        ASSERT_EQ(fast.getCode(), reference.getCode());
+        ASSERT_EQ(fast.getBitCount(), reference.getBitCount());
+        if (reference.hasValidCode()) {
+            EXPECT_EQ(fast.getTe(), 320u);
+            found++;
+            fast.reset();
+            reference.reset();
+        }
+    }
+    EXPECT_GT(found, 50);
+}
+
+// One Came frame of code at the given te, header included, with jitter of up
+// to jitterPercent on every pulse.
+static std::vector<PulseDuration> cameAt(uint32_t code, int bits, int te, int jitterPercent, uint32_t seed) {
+    PulseTrain frame(jitterPercent, seed);
+    cameFrame(frame, code, bits, te, 56);
+    frame.low(te * 56);
+    return frame.pulses;
+}
+
+TEST(PwmDecoderTest, ScalesWindowsToStartBit) {
+    // 30% slow: the long pulses are past te_long + te_delta.
+    const std::vector<PulseDuration> frame = cameAt(0x5A3, 12, 416, 0, 1);
+    RuntimeCame reference;
+    bool found = false;
+    for (PulseDuration pulse : frame) {
+        reference.feed(pulse > 0, static_cast<uint32_t>(pulse > 0 ? pulse : -pulse));
+        found = found || reference.hasValidCode();
+    }
+    EXPECT_FALSE(found);
+
+    TemplateCame decoder;
+    ASSERT_TRUE(decoder.decode(frame));
+    EXPECT_EQ(decoder.getCode(), 0x5A3u);
+    EXPECT_EQ(decoder.getTe(), 416u);
+
+    // The start bit itself still has to be a nominal short pulse.
+    EXPECT_FALSE(decoder.decode(cameAt(0x5A3, 12, 480, 0, 1)));
+}
+
+// Remotes whose te drifted from 25% fast to 35% slow, with 10% jitter: how
+// many frames decode to the code that was sent, at nominal windows and at
+// windows scaled to each frame's start bit.
+TEST(PwmDecoderTest, DriftedCorpusDecodeRate) {
+    const int tes[] = {240, 280, 320, 360, 400, 432};
+    const int framesPerTe = 200;
+    uint32_t seed = 17;
+    int nominalOk = 0;
+    int adaptiveOk = 0;
+    int adaptiveAtTe[6] = {};
+    int nominalAtTe[6] = {};
+    for (int t = 0; t < 6; t++) {
+        for (int f = 0; f < framesPerTe; f++) {
+            const int bits = f % 2 ? 24 : 12;
+            const uint32_t code = (nextRandom(seed) << 8 ^ nextRandom(seed)) & ((1u << bits) - 1);
+            const std::vector<PulseDuration> frame = cameAt(code, bits, tes[t], 10, seed);
+
+            TemplateCame adaptive;
+            if (adaptive.decode(frame)) {
+                ASSERT_EQ(adaptive.getCode(), code);
+                ASSERT_EQ(adaptive.getBitCount(), bits);
+                adaptiveAtTe[t]++;
+            }
+            RuntimeCame nominal;
+            for (PulseDuration pulse : frame) {
+                nominal.feed(pulse > 0, static_cast<uint32_t>(pulse > 0 ? pulse : -pulse));
+                if (nominal.hasValidCode()) {
+                    ASSERT_EQ(nominal.getCode(), code);
+                    nominalAtTe[t]++;
+                    break;
+                }
+            }
+        }
+        nominalOk += nominalAtTe[t];
+        adaptiveOk += adaptiveAtTe[t];
+        std::printf("[ PwmDecoder ] te %d us: %d/%d nominal, %d/%d adaptive\n", tes[t], nominalAtTe[t], framesPerTe,
+                    adaptiveAtTe[t], framesPerTe);
+        // Never worse, nominal te included.
+        EXPECT_GE(adaptiveAtTe[t], nominalAtTe[t]) << tes[t];
+    }
+    std::printf("[ PwmDecoder ] drifted corpus: %d/%d nominal, %d/%d adaptive\n", nominalOk, 6 * framesPerTe,
+                adaptiveOk, 6 * framesPerTe);
+    EXPECT_GT(adaptiveOk, nominalOk + framesPerTe);
+}
+
+// Through the registry interface, as PulseReceiver calls it, so the decoder
+// is not inlined into the loop with its constants.
+__attribute__((noinline)) static double feedNs(SubGhzDecoder& decoder, const std::vector<PulseDuration>& capture,
+                                               int rounds, uint64_t& sink) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (PulseDuration pulse : capture) {
+            decoder.feed(pulse > 0, static_cast<uint32_t>(pulse > 0 ? pulse : -pulse));
+        }
+        sink += decoder.code();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+           (static_cast<double>(rounds) * capture.size());
+}
+
+// Per-pulse feed() cost of the template base, windows scaled once per frame,
+// against the fixed-window state machine it replaced in Came and Nice FLO.
+TEST(PwmDecoderPerformance, FeedCost) {
+    const std::vector<PulseDuration> capture = cameCapture(400, 12, 20, 9);
+    const int rounds = 40;
+    uint64_t sink = 0;
+    TemplateCame fast;
+    RuntimeCame reference;
+    DecoderAdapter<TemplateCame> fastEntry("Came", fast);
+    DecoderAdapter<RuntimeCame> referenceEntry("Came", reference);
+    // Best of several interleaved runs, so neither side pays for warm-up.
+    double templateNs = 1e9;
+    double runtimeNs = 1e9;
+    for (int run = 0; run < 7; run++) {
+        templateNs = std::min(templateNs, feedNs(fastEntry, capture, rounds, sink));
+        runtimeNs = std::min(runtimeNs, feedNs(referenceEntry, capture, rounds, sink));
+    }
+    std::printf("[ PwmDecoder ] %zu pulses: %.2f ns/pulse adaptive template, %.2f ns/pulse fixed windows\n",
+                capture.size(), templateNs, runtimeNs);
+    EXPECT_GT(sink, 0u);
+}
@@ -0,0 +1,135 @@
+#include "../src/modules/RF/RepeatedCapture.h"
+#include "../src/modules/RF/CaptureArena.h"
+#include "../src/modules/RF/PulseSource.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+static FrameSegmenter makeSegmenter() {
+    return FrameSegmenter(FRAME_GAP_MULTIPLIER, 5, 16);
+}
+
+// Linear frame repeated with up to 5% jitter per pulse, as the slicer would
+// deliver it.
+static std::vector<PulseDuration> linearBurst(uint32_t code, int repeats, uint32_t seed) {
+    PulseTrain capture(5, seed);
+    capture.append(linearFrame(code), repeats);
+    return capture.pulses;
+}
+
+static std::vector<PulseDuration> toVector(const RepeatedView& view) {
+    return std::vector<PulseDuration>(view.begin(), view.end());
+}
+
+TEST(RepeatedCaptureTest, FindsRepeatsWithinTolerance) {
+    const auto capture = linearBurst(0x1B3, 6, 1);
+    FrameSegmenter segmenter = makeSegmenter();
+    segmenter.split(capture.data(), capture.size());
+    const RepeatInfo repeats = findRepeats(capture.data(), capture.size(), segmenter);
+    EXPECT_EQ(repeats.start, 0u);
+    EXPECT_EQ(repeats.length, 20u);
+    EXPECT_EQ(repeats.count, 6u);
+    EXPECT_EQ(repeats.elided(), 100u);
+}
+
+TEST(RepeatedCaptureTest, DifferentFramesAreNotMerged) {
+    auto capture = linearBurst(0x1B3, 1, 1);
+    const auto other = linearBurst(0x1B2, 1, 2);
+    capture.insert(capture.end(), other.begin(), other.end());
+    FrameSegmenter segmenter = makeSegmenter();
+    segmenter.split(capture.data(), capture.size());
+    EXPECT_FALSE(findRepeats(capture.data(), capture.size(), segmenter).repeated());
+}
+
+TEST(RepeatedCaptureTest, KeepsPrefixAndSuffix) {
+    std::vector<PulseDuration> capture = {300, -200, 450, -25000};
+    const auto burst = linearBurst(0x2C4, 4, 3);
+    capture.insert(capture.end(), burst.begin(), burst.end());
+    capture.push_back(500);
+    capture.push_back(-700);
+
+    FrameSegmenter segmenter = makeSegmenter();
+    segmenter.split(capture.data(), capture.size());
+    const RepeatInfo repeats = findRepeats(capture.data(), capture.size(), segmenter);
+    // The first copy shares its frame with the noise in front of it.
+    ASSERT_EQ(repeats.count, 3u);
+    EXPECT_EQ(repeats.start, 24u);
+
+    CaptureArena<1024, 4> arena;
+    const CaptureHandle handle = arena.store(capture, repeats);
+    const RepeatedView view(arena.get(handle), arena.repeats(handle));
+    EXPECT_EQ(view.stored().size(), capture.size() - 40);
+    EXPECT_EQ(view.size(), capture.size());
+
+    // Expanded pulses replay the first copy of the frame each time.
+    const auto expanded = toVector(view);
+    ASSERT_EQ(expanded.size(), capture.size());
+    for (size_t i = 0; i < capture.size(); i++) {
+        EXPECT_TRUE(pulsesMatch(expanded[i], capture[i])) << i;
+    }
+    EXPECT_EQ(expanded.front(), 300);
+    EXPECT_EQ(expanded.back(), -700);
+}
+
+TEST(RepeatedCaptureTest, SubFileRepeatLineIsExpanded) {
+    std::istringstream file(
+        "Filetype: Flipper SubGhz RAW File\n"
+        "Version: 1\n"
+        "Frequency: 433920000\n"
+        "Preset: FuriHalSubGhzPresetOok650Async\n"
+        "Protocol: RAW\n"
+        "Repeat: 1 4 3\n"
+        "RAW_Data: 900 500 -500 1500 -9000 -100\n");
+    SubFileSource source;
+    ASSERT_TRUE(source.load(file));
+    const std::vector<PulseDuration> expected = {900, 500, -500, 1500, -9000, 500, -500, 1500, -9000,
+                                                 500, -500, 1500, -9000, -100};
+    EXPECT_EQ(std::vector<PulseDuration>(source.pulses().begin(), source.pulses().end()), expected);
+}
+
+// A source cleared for the next file forgets the last one, and expands
+// a Repeat: line up to its limit in the buffer it kept.
+TEST(RepeatedCaptureTest, ClearedSourceReadsTheNextFile) {
+    SubFileSource source;
+    source.setLimit(10);
+    std::istringstream first("Frequency: 315000000\nProtocol: RAW\nRAW_Data: 1 2 3 4 5 6 7 8 9 10 11 12\n");
+    ASSERT_TRUE(source.load(first));
+    EXPECT_TRUE(source.wasTruncated());
+
+    source.clear();
+    EXPECT_FALSE(source.isRaw());
+    EXPECT_EQ(source.getFrequency(), 0u);
+    EXPECT_EQ(source.size(), 0u);
+    std::istringstream second("Protocol: RAW\nRepeat: 1 4 3\nRAW_Data: 900 500 -500 1500 -9000 -100\n");
+    ASSERT_TRUE(source.load(second));
+    const std::vector<PulseDuration> expected = {900, 500, -500, 1500, -9000, 500, -500, 1500, -9000, 500};
+    EXPECT_EQ(std::vector<PulseDuration>(source.pulses().begin(), source.pulses().end()), expected);
+    EXPECT_TRUE(source.wasTruncated());
+}
+
+// Twenty button presses of ten repeats each, into the capture arena with and
+// without repeat detection.
+TEST(RepeatedCapturePerformance, ArenaBytesPerCapture) {
+    CaptureArena<16384, 32> plain;
+    CaptureArena<16384, 32> compact;
+    FrameSegmenter segmenter = makeSegmenter();
+    size_t plainBytes = 0;
+    size_t compactBytes = 0;
+    for (uint32_t press = 0; press < 20; press++) {
+        const auto capture = linearBurst(press * 41 + 7, 10, press + 1);
+        segmenter.split(capture.data(), capture.size());
+        const RepeatInfo repeats = findRepeats(capture.data(), capture.size(), segmenter);
+        plain.clear();
+        compact.clear();
+        plain.store(capture);
+        compact.store(capture, repeats);
+        plainBytes += plain.usedBytes();
+        compactBytes += compact.usedBytes();
+        EXPECT_EQ(repeats.count, 10u);
+    }
+    std::printf("[ Repeats ] arena bytes per capture: %zu plain, %zu with repeat detection\n",
+                plainBytes / 20, compactBytes / 20);
+    EXPECT_LE(compactBytes * 8, plainBytes);
+}
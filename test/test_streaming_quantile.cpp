@@ -0,0 +1,129 @@
+#include "../src/modules/RF/PulseHistogram.h"
+#include "../src/modules/RF/protocols/math.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Pulse widths around te with uniform jitter of up to jitterPercent.
+static std::vector<int64_t> widthsAround(uint32_t te, int jitterPercent, size_t count, uint32_t& seed) {
+    std::vector<int64_t> widths;
+    for (size_t i = 0; i < count; i++) {
+        widths.push_back(jittered(static_cast<int>(te), jitterPercent, seed));
+    }
+    return widths;
+}
+
+// Exact median the streaming estimate is held against; the mean of the
+// middle two for an even count.
+static int64_t computeMedian(std::vector<int64_t> values) {
+    if (values.empty()) {
+        return 0;
+    }
+    const auto middle = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    if (values.size() % 2 == 1) {
+        return *middle;
+    }
+    return (*std::max_element(values.begin(), middle) + *middle) / 2;
+}
+
+static int64_t sortedQuantile(std::vector<int64_t> values, float quantile) {
+    std::sort(values.begin(), values.end());
+    return values[static_cast<size_t>(quantile * values.size())];
+}
+
+TEST(StreamingQuantileTest, ExactForFirstSamples) {
+    StreamingQuantile median;
+    EXPECT_EQ(median.value(), 0.0f);
+    median.add(700);
+    EXPECT_EQ(median.value(), 700.0f);
+    median.add(300);
+    median.add(500);
+    EXPECT_EQ(median.value(), 500.0f);
+    EXPECT_EQ(median.count(), 3u);
+
+    median.reset();
+    EXPECT_EQ(median.count(), 0u);
+    EXPECT_EQ(median.value(), 0.0f);
+}
+
+TEST(StreamingQuantileTest, TracksJitteredPulseWidth) {
+    uint32_t seed = 11;
+    for (uint32_t te : {250u, 400u, 555u, 1400u}) {
+        const std::vector<int64_t> widths = widthsAround(te, 15, 200, seed);
+        StreamingQuantile median(0.5f);
+        StreamingQuantile quartile(0.25f);
+        for (int64_t width : widths) {
+            median.add(static_cast<float>(width));
+            quartile.add(static_cast<float>(width));
+        }
+        EXPECT_NEAR(median.value(), sortedQuantile(widths, 0.5f), te * 0.03) << te;
+        EXPECT_NEAR(quartile.value(), sortedQuantile(widths, 0.25f), te * 0.03) << te;
+    }
+}
+
+TEST(StreamingQuantileTest, HistogramFedPerPulseMatchesBuild) {
+    const std::vector<PulseDuration> frame = {-9000, 400, -1200, 1190, -410, 395, -1210, 405, -1195};
+    PulseHistogram whole;
+    PulseHistogram streamed;
+    ASSERT_EQ(whole.build(frame), 3u);
+
+    streamed.clear();
+    for (size_t i = 0; i < frame.size(); i++) {
+        streamed.add(frame[i]);
+        // The clusters so far are available mid-frame.
+        if (i == 2) {
+            EXPECT_EQ(streamed.finish(), 3u);
+        }
+    }
+    ASSERT_EQ(streamed.finish(), whole.size());
+    for (size_t i = 0; i < whole.size(); i++) {
+        EXPECT_EQ(streamed.cluster(i).count, whole.cluster(i).count);
+        EXPECT_EQ(streamed.cluster(i).median, whole.cluster(i).median);
+    }
+}
+
+// Median kept up to date after every sample of a 200-sample stream: P-square
+// per sample against re-running computeMedian() on everything seen so far.
+TEST(StreamingQuantilePerformance, AgainstComputeMedian) {
+    uint32_t seed = 5;
+    const std::vector<int64_t> widths = widthsAround(500, 15, 200, seed);
+    const int rounds = 50;
+    volatile float sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        StreamingQuantile median;
+        for (int64_t width : widths) {
+            median.add(static_cast<float>(width));
+            sink = sink + median.value();
+        }
+    }
+    const double streamingNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                               (rounds * widths.size());
+
+    start = std::chrono::steady_clock::now();
+    std::vector<int64_t> seen;
+    for (int r = 0; r < rounds; r++) {
+        seen.clear();
+        for (int64_t width : widths) {
+            seen.push_back(width);
+            sink = sink + static_cast<float>(computeMedian(seen));
+        }
+    }
+    const double batchNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                           (rounds * widths.size());
+
+    StreamingQuantile median;
+    for (int64_t width : widths) {
+        median.add(static_cast<float>(width));
+    }
+    const int64_t exact = computeMedian(widths);
+    std::printf("[ Quantile ] per-pulse median over %zu pulses: %.1f ns streaming, %.1f ns recomputed; "
+                "final %.1f us vs %lld us exact\n",
+                widths.size(), streamingNs, batchNs, median.value(), static_cast<long long>(exact));
+    EXPECT_NEAR(median.value(), exact, 15);
+}
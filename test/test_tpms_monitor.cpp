@@ -0,0 +1,241 @@
+#include "../src/modules/RF/TpmsMonitor.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// FSK demodulator output: packets as Manchester chips of te with jitter, and
+// noise in between. Adjacent pulses of one level merge, as on the GDO pin.
+class FskStream {
+public:
+    explicit FskStream(uint32_t seed) : seed(seed) {}
+
+    uint32_t next() {
+        return nextRandom(seed);
+    }
+
+    void noise(int pulses) {
+        for (int i = 0; i < pulses; i++) {
+            add(static_cast<int>(20 + next() % 400), (next() & 1) != 0);
+        }
+    }
+
+    // Zeros of preamble, then bits of sync and the payload, high-low for 1.
+    void packet(uint32_t te, int jitterPercent, int preambleBits, uint16_t sync, int syncBits,
+                const std::vector<uint8_t>& payload) {
+        std::vector<bool> bits(preambleBits, false);
+        for (int i = syncBits - 1; i >= 0; i--) {
+            bits.push_back((sync >> i) & 1);
+        }
+        for (uint8_t byte : payload) {
+            for (int i = 7; i >= 0; i--) {
+                bits.push_back((byte >> i) & 1);
+            }
+        }
+        for (bool bit : bits) {
+            chip(te, jitterPercent, bit);
+            chip(te, jitterPercent, !bit);
+        }
+    }
+
+    std::vector<PulseDuration> pulses;
+
+private:
+    void chip(uint32_t te, int jitterPercent, bool level) {
+        const int span = static_cast<int>(te) * jitterPercent / 100;
+        add(static_cast<int>(te) + (span ? static_cast<int>(next() % (2 * span + 1)) - span : 0), level);
+    }
+
+    void add(int duration, bool level) {
+        if (!pulses.empty() && (pulses.back() > 0) == level) {
+            pulses.back() += level ? duration : -duration;
+        } else {
+            pulses.push_back(level ? duration : -duration);
+        }
+    }
+
+    uint32_t seed;
+};
+
+static std::vector<uint8_t> renault(uint32_t id, uint16_t pressure, int temperature) {
+    std::vector<uint8_t> b = {static_cast<uint8_t>(0x0C | (pressure >> 8 & 0x03)), static_cast<uint8_t>(pressure),
+                              static_cast<uint8_t>(temperature + 30), static_cast<uint8_t>(id),
+                              static_cast<uint8_t>(id >> 8), static_cast<uint8_t>(id >> 16), 0xFF, 0xFF};
+    b.push_back(tpmsCrc8(b.data(), 8, 0x07, 0x00));
+    return b;
+}
+
+static std::vector<uint8_t> citroen(uint32_t id, uint8_t pressure, int temperature, uint8_t battery = 0x07) {
+    std::vector<uint8_t> b = {0x80,     static_cast<uint8_t>(id >> 24), static_cast<uint8_t>(id >> 16),
+                              static_cast<uint8_t>(id >> 8), static_cast<uint8_t>(id), 0x01, pressure,
+                              static_cast<uint8_t>(temperature + 50), battery};
+    uint8_t folded = 0;
+    for (size_t i = 1; i < b.size(); i++) {
+        folded ^= b[i];
+    }
+    b.push_back(folded);
+    return b;
+}
+
+// Feeds the whole stream, timestamps in pulse order.
+static int feedAll(TpmsMonitor& monitor, const std::vector<PulseDuration>& pulses) {
+    int readings = 0;
+    uint32_t now = 0;
+    for (PulseDuration pulse : pulses) {
+        readings += monitor.feed(pulse, ++now);
+    }
+    return readings;
+}
+
+TEST(ManchesterSlicerTest, FindsSyncAndDecodesPayload) {
+    FskStream stream(1);
+    stream.noise(30);
+    stream.packet(100, 0, 24, 0x5, 4, {0xA5, 0x3C});
+    stream.noise(30);
+    ManchesterSlicer slicer;
+    slicer.configure(100);
+    int packets = 0;
+    uint8_t payload[3] = {};
+    for (PulseDuration pulse : stream.pulses) {
+        if (slicer.feed(pulse > 0, static_cast<uint32_t>(pulse > 0 ? pulse : -pulse))) {
+            packets++;
+            const size_t at = slicer.find(0x5, 4, 0);
+            ASSERT_NE(at, SIZE_MAX);
+            // Asking for more than the packet holds fails instead of reading on.
+            EXPECT_FALSE(slicer.decode(at, payload, 3));
+            EXPECT_TRUE(slicer.decode(at, payload, 2));
+        }
+    }
+    EXPECT_EQ(packets, 1);
+    EXPECT_EQ(payload[0], 0xA5);
+    EXPECT_EQ(payload[1], 0x3C);
+}
+
+TEST(TpmsMonitorTest, RenaultPacketInNoise) {
+    FskStream stream(2);
+    stream.noise(200);
+    stream.packet(52, 15, 8, 0x0001, 16, renault(0xABCDEF, 300, 21));
+    stream.noise(200);
+    TpmsMonitor monitor;
+    EXPECT_EQ(feedAll(monitor, stream.pulses), 1);
+    ASSERT_EQ(monitor.sensors().size(), 1u);
+    const TPMSGenericData& reading = monitor.last().reading;
+    EXPECT_EQ(reading.protocolName, "Renault");
+    EXPECT_EQ(reading.id, 0xABCDEFu);
+    EXPECT_FLOAT_EQ(reading.pressure, 225.0f);
+    EXPECT_FLOAT_EQ(reading.temperature, 21.0f);
+    EXPECT_FALSE(reading.batteryLow);
+}
+
+TEST(TpmsMonitorTest, CitroenAtItsOwnTe) {
+    FskStream stream(3);
+    stream.noise(100);
+    stream.packet(52, 15, 8, 0x0001, 16, citroen(0x8F3A10C2, 176, -5));
+    stream.noise(100);
+    TpmsMonitor monitor;
+    EXPECT_EQ(feedAll(monitor, stream.pulses), 1);
+    const TpmsSensor* sensor = monitor.sensors().find(0x8F3A10C2);
+    ASSERT_NE(sensor, nullptr);
+    EXPECT_EQ(sensor->reading.protocolName, "Citroen");
+    EXPECT_NEAR(sensor->reading.pressure, 240.1f, 0.1f);
+    EXPECT_FLOAT_EQ(sensor->reading.temperature, -5.0f);
+    EXPECT_FALSE(sensor->reading.batteryLow);
+
+    // The battery byte counts down as the cell drains.
+    stream.pulses.clear();
+    stream.noise(100);
+    stream.packet(52, 15, 8, 0x0001, 16, citroen(0x8F3A10C2, 176, -5, 0x01));
+    stream.noise(100);
+    EXPECT_EQ(feedAll(monitor, stream.pulses), 1);
+    EXPECT_TRUE(monitor.sensors().find(0x8F3A10C2)->reading.batteryLow);
+}
+
+TEST(TpmsMonitorTest, RejectsPacketsFailingTheirCheck) {
+    TpmsMonitor monitor;
+    for (size_t byte = 0; byte < 9; byte++) {
+        std::vector<uint8_t> payload = renault(0x123456, 300, 30);
+        payload[byte] ^= 0x10;
+        FskStream stream(4 + static_cast<uint32_t>(byte));
+        stream.noise(50);
+        stream.packet(52, 10, 8, 0x0001, 16, payload);
+        stream.noise(50);
+        EXPECT_EQ(feedAll(monitor, stream.pulses), 0) << byte;
+    }
+    EXPECT_EQ(monitor.validPackets(), 0u);
+    EXPECT_GE(monitor.slicedPackets(), 9u);
+    EXPECT_EQ(monitor.sensors().size(), 0u);
+}
+
+// More sensors than the table holds: each keeps its latest reading and packet
+// count, and the ones heard least recently make room.
+TEST(TpmsMonitorTest, TracksSensorsById) {
+    TpmsMonitor monitor;
+    FskStream stream(5);
+    uint32_t now = 0;
+    auto transmit = [&](uint32_t id, uint16_t pressure) {
+        stream.pulses.clear();
+        stream.noise(40);
+        stream.packet(52, 10, 8, 0x0001, 16, renault(id, pressure, 20));
+        stream.noise(40);
+        for (PulseDuration pulse : stream.pulses) {
+            monitor.feed(pulse, ++now);
+        }
+    };
+    for (uint32_t id = 1; id <= TPMS_MAX_SENSORS; id++) {
+        transmit(id, 280);
+    }
+    // Sensor 1 again, so sensor 2 is now the one heard least recently.
+    transmit(1, 300);
+    transmit(100, 290);
+    EXPECT_EQ(monitor.sensors().size(), static_cast<size_t>(TPMS_MAX_SENSORS));
+    ASSERT_NE(monitor.sensors().find(1), nullptr);
+    EXPECT_EQ(monitor.sensors().find(1)->packets, 2u);
+    EXPECT_FLOAT_EQ(monitor.sensors().find(1)->reading.pressure, 225.0f);
+    EXPECT_EQ(monitor.sensors().find(2), nullptr);
+    ASSERT_NE(monitor.sensors().find(100), nullptr);
+    EXPECT_EQ(monitor.sensors().find(100)->packets, 1u);
+    EXPECT_EQ(monitor.validPackets(), TPMS_MAX_SENSORS + 2u);
+}
+
+// A drive past a car park: eight sensors of both protocols, each sending
+// three repeats per burst, with noise everywhere else. Every sensor ends up
+// in the table with its last reading; prints the per-pulse cost.
+TEST(TpmsMonitorPerformance, SustainedMultiSensor) {
+    FskStream stream(6);
+    const uint32_t ids[] = {0x0100001, 0x0200002, 0x0300003, 0x0400004,
+                            0x91000005, 0x92000006, 0x93000007, 0x94000008};
+    int sent = 0;
+    for (int burst = 0; burst < 5; burst++) {
+        for (int s = 0; s < 8; s++) {
+            for (int repeat = 0; repeat < 3; repeat++) {
+                stream.noise(20 + static_cast<int>(stream.next() % 200));
+                const uint8_t pressure = static_cast<uint8_t>(80 + burst + s);
+                if (s < 4) {
+                    stream.packet(52, 15, 8, 0x0001, 16, renault(ids[s], pressure, 10 + s));
+                } else {
+                    stream.packet(52, 15, 8, 0x0001, 16, citroen(ids[s], pressure, 10 + s));
+                }
+                sent++;
+            }
+        }
+    }
+    stream.noise(100);
+
+    TpmsMonitor monitor;
+    const auto start = std::chrono::steady_clock::now();
+    feedAll(monitor, stream.pulses);
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                      stream.pulses.size();
+    ASSERT_EQ(monitor.sensors().size(), 8u);
+    for (int s = 0; s < 8; s++) {
+        const TpmsSensor* sensor = monitor.sensors().find(ids[s]);
+        ASSERT_NE(sensor, nullptr) << s;
+        EXPECT_FLOAT_EQ(sensor->reading.temperature, 10.0f + s) << s;
+        EXPECT_GE(sensor->packets, 12u) << s;
+    }
+    EXPECT_GE(monitor.validPackets(), static_cast<uint32_t>(sent * 9 / 10));
+    std::printf("[ TPMS ] %zu pulses: %u of %d packets valid, %zu sensors, %.1f ns/pulse\n", stream.pulses.size(),
+                static_cast<unsigned>(monitor.validPackets()), sent, monitor.sensors().size(), ns);
+}
@@ -0,0 +1,148 @@
+#include "../src/modules/RF/TriggeredCapture.h"
+#include "../src/modules/RF/protocols/LinearProtocol.h"
+#include "TestFrames.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <vector>
+
+// Edge stream on a microsecond clock, with the RSSI the radio would report.
+struct Timeline {
+    std::vector<Edge> edges;
+    uint32_t clock = 0;
+
+    void pulse(PulseDuration duration) {
+        clock += static_cast<uint32_t>(duration < 0 ? -duration : duration);
+        edges.push_back({clock, duration});
+    }
+
+    // Short random-ish edges like the slicer produces on an empty channel.
+    void noise(uint32_t us, uint32_t& seed) {
+        const uint32_t end = clock + us;
+        bool high = true;
+        while (clock < end) {
+            const PulseDuration duration = 120 + static_cast<PulseDuration>(nextRandom(seed) % 400);
+            pulse(high ? duration : -duration);
+            high = !high;
+        }
+    }
+};
+
+// Feeds the timeline, sampling RSSI every pollUs; signal is "on" between the
+// given edge indices. Returns the captures in order.
+static std::vector<std::vector<PulseDuration>> run(TriggeredCapture& trigger, const Timeline& timeline,
+                                                   const std::vector<std::pair<size_t, size_t>>& bursts,
+                                                   uint32_t pollUs) {
+    std::vector<std::vector<PulseDuration>> captures;
+    uint32_t nextPoll = pollUs;
+    for (size_t i = 0; i < timeline.edges.size(); i++) {
+        const Edge& edge = timeline.edges[i];
+        while (edge.timestamp > nextPoll) {
+            bool on = false;
+            for (const auto& burst : bursts) {
+                on = on || (timeline.edges[burst.first].timestamp <= nextPoll &&
+                            nextPoll <= timeline.edges[burst.second].timestamp);
+            }
+            if (trigger.updateRssi(on ? -45 : -100, nextPoll)) {
+                PulseView capture = trigger.capture();
+                captures.emplace_back(capture.begin(), capture.end());
+                trigger.release();
+            }
+            nextPoll += pollUs;
+        }
+        trigger.addEdge(edge);
+    }
+    return captures;
+}
+
+TEST(TriggeredCaptureTest, KeepsPreambleFromBeforeTrigger) {
+    uint32_t seed = 1;
+    Timeline timeline;
+    timeline.noise(300000, seed);
+    const size_t burstStart = timeline.edges.size();
+    for (int r = 0; r < 3; r++) {
+        for (PulseDuration pulse : linearFrame(0x2A5)) {
+            timeline.pulse(pulse);
+        }
+    }
+    const size_t burstEnd = timeline.edges.size() - 1;
+    timeline.noise(300000, seed);
+
+    TriggeredCapture trigger;
+    TriggerConfig config;
+    config.preTriggerUs = 120000;
+    trigger.setConfig(config);
+    const auto captures = run(trigger, timeline, {{burstStart, burstEnd}}, 100000);
+
+    ASSERT_EQ(captures.size(), 1u);
+    LinearProtocol decoder;
+    EXPECT_TRUE(decoder.decode(captures[0]));
+    // Much less than everything seen since the receiver was enabled.
+    EXPECT_LT(captures[0].size(), timeline.edges.size() / 4);
+}
+
+TEST(TriggeredCaptureTest, DropsShortBursts) {
+    TriggeredCapture trigger;
+    for (uint32_t t = 1; t <= 10; t++) {
+        trigger.addEdge({t * 1000, 500});
+    }
+    EXPECT_FALSE(trigger.updateRssi(-40, 10000));
+    EXPECT_TRUE(trigger.recording());
+    EXPECT_FALSE(trigger.updateRssi(-100, 20000));
+    EXPECT_FALSE(trigger.updateRssi(-100, 50000));
+    EXPECT_FALSE(trigger.complete());
+    EXPECT_EQ(trigger.captures(), 0u);
+}
+
+TEST(TriggeredCaptureTest, TrimsEdgesAfterSignalDrops) {
+    TriggeredCapture trigger;
+    EXPECT_FALSE(trigger.updateRssi(-40, 0));
+    for (uint32_t t = 1; t <= 30; t++) {
+        trigger.addEdge({t * 1000, 500});
+    }
+    EXPECT_FALSE(trigger.updateRssi(-100, 31000));
+    for (uint32_t t = 32; t <= 50; t++) {
+        trigger.addEdge({t * 1000, 200});
+    }
+    EXPECT_TRUE(trigger.updateRssi(-100, 60000));
+    EXPECT_EQ(trigger.capture().size(), 30u);
+}
+
+// One minute of channel noise with a transmission every 3 s: compares the edges
+// handed to the decoders against recording everything, as the analyzer did.
+TEST(TriggeredCapturePerformance, NoiseEdgesPerCapture) {
+    uint32_t seed = 7;
+    Timeline timeline;
+    std::vector<std::pair<size_t, size_t>> bursts;
+    for (int t = 0; t < 20; t++) {
+        timeline.noise(3000000, seed);
+        const size_t start = timeline.edges.size();
+        for (int r = 0; r < 4; r++) {
+            for (PulseDuration pulse : linearFrame(static_cast<uint32_t>(t * 37))) {
+                timeline.pulse(pulse);
+            }
+        }
+        bursts.push_back({start, timeline.edges.size() - 1});
+    }
+    timeline.noise(500000, seed);
+
+    TriggeredCapture trigger;
+    const auto captures = run(trigger, timeline, bursts, 100000);
+    LinearProtocol decoder;
+    size_t decoded = 0;
+    size_t signalEdges = 0;
+    for (const auto& capture : captures) {
+        decoded += decoder.decode(capture) ? 1 : 0;
+    }
+    for (const auto& burst : bursts) {
+        signalEdges += burst.second - burst.first + 1;
+    }
+
+    const double legacy = static_cast<double>(timeline.edges.size()) / bursts.size();
+    const double triggered = static_cast<double>(trigger.edgesCaptured()) / captures.size();
+    const double signal = static_cast<double>(signalEdges) / bursts.size();
+    std::printf("[ Trigger ] edges per capture: record-all %.0f, triggered %.0f (signal %.0f), decoded %zu/%zu\n",
+                legacy, triggered, signal, decoded, bursts.size());
+    EXPECT_EQ(captures.size(), bursts.size());
+    EXPECT_EQ(decoded, bursts.size());
+    EXPECT_LT(triggered, legacy / 10);
+}
@@ -0,0 +1,88 @@
+// Host build of the SD card batch decode, for regression runs over a corpus
+// of .sub captures:
+//
+//     batch_decode <directory> [flex_specs.txt] > index.csv
+//
+// Writes the index to stdout and progress, totals and the per-decoder
+// counters to stderr. Decodes with the firmware's decoders (see
+// ShippedProtocols.h), Linear, and the flex specs given, in the format of
+// src/modules/RF/flex_decoders.example.
+#include "modules/RF/BatchDecoder.h"
+#include "modules/RF/FlexDecoder.h"
+#include "modules/RF/ShippedProtocols.h"
+#include "modules/RF/protocols/LinearProtocol.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static size_t loadSpecs(const char* path, FlexDecoder* decoders, ProtocolRegistry& protocols) {
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "cannot read %s\n", path);
+        return 0;
+    }
+    size_t loaded = 0;
+    std::string line;
+    int lineNumber = 0;
+    while (loaded < FLEX_MAX_DECODERS && std::getline(in, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#' || line[0] == '\r') {
+            continue;
+        }
+        FlexSpec spec;
+        if (!parseFlexSpec(line.c_str(), spec) || !decoders[loaded].compile(spec)) {
+            std::fprintf(stderr, "%s:%d rejected: %s\n", path, lineNumber, line.c_str());
+            continue;
+        }
+        protocols.add(decoders[loaded++]);
+    }
+    return loaded;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        std::fprintf(stderr, "usage: %s <directory> [flex_specs.txt] > index.csv\n", argv[0]);
+        return 2;
+    }
+    static ShippedProtocols shipped;
+    static LinearProtocol linear;
+    static DecoderAdapter<LinearProtocol> linearEntry("Linear", linear);
+    static FlexDecoder flexDecoders[FLEX_MAX_DECODERS];
+    static ProtocolRegistry protocols;
+    static PulseHistogram histogram;
+    shipped.registerAll(protocols);
+    protocols.add(linearEntry);
+    if (argc == 3) {
+        loadSpecs(argv[2], flexDecoders, protocols);
+    }
+    protocols.build();
+
+    static BatchDecoder batch(protocols, histogram);
+    char line[512];
+    BatchDecoder::formatHeader(line, sizeof(line));
+    std::fputs(line, stdout);
+    const bool ok = batch.run(argv[1], [&](const BatchEntry& entry) {
+        BatchDecoder::format(entry, line, sizeof(line));
+        std::fputs(line, stdout);
+        const BatchProgress progress = batch.progress();
+        std::fprintf(stderr, "\r%lu/%lu", static_cast<unsigned long>(progress.done),
+                     static_cast<unsigned long>(progress.files));
+    });
+    if (!ok) {
+        std::fprintf(stderr, "cannot read directory %s\n", argv[1]);
+        return 1;
+    }
+
+    const BatchProgress progress = batch.progress();
+    std::fprintf(stderr, "\r%lu files: %lu decoded, %lu BinRAW\n", static_cast<unsigned long>(progress.files),
+                 static_cast<unsigned long>(progress.decoded), static_cast<unsigned long>(progress.binRaw));
+    std::vector<char> table(4096);
+    const int length = batch.metrics().format(table.data(), table.size());
+    if (length >= static_cast<int>(table.size())) {
+        table.resize(static_cast<size_t>(length) + 1);
+        batch.metrics().format(table.data(), table.size());
+    }
+    std::fputs(table.data(), stderr);
+    return 0;
+}